@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+
+#include <boost/asio/io_context.hpp>
+
+#include "store/column_file.h"
+
+using service::store::ColumnWriter;
+
+namespace {
+
+constexpr uint16_t kColumns = 8;
+constexpr uint32_t kBlockRows = 4096;
+
+std::string bench_path(const char* name) {
+  return (std::filesystem::temp_directory_path() / "qitrader_bench" / name).string();
+}
+
+/// 模拟Tick行：时间戳递增，价格小幅波动
+void fill_row(int64_t* row, int64_t i) {
+  row[0] = 1700000000000 + i * 10;
+  for (uint16_t c = 1; c < kColumns; ++c) {
+    row[c] = 6000000000 + (i * 7919 + c * 104729) % 20000;
+  }
+}
+
+}  // namespace
+
+// 事件循环线程上每行的耗时，包括攒满一块后的编码和写入；
+// 参数 0 为 std::ofstream 同步写入，1 为 random_access_file 异步写入（io_uring）
+static void BM_ColumnWriterAppend(benchmark::State& state) {
+  bool async = state.range(0) != 0;
+#ifndef BOOST_ASIO_HAS_FILE
+  if (async) {
+    state.SkipWithError("asio built without BOOST_ASIO_HAS_FILE");
+    return;
+  }
+#endif
+  boost::asio::io_context ctx;
+  auto path = bench_path(async ? "async.col" : "sync.col");
+  std::filesystem::remove(path);
+
+  int64_t row[kColumns];
+  int64_t i = 0;
+  {
+    ColumnWriter writer(path, kColumns, 0, kBlockRows,
+                        async ? boost::asio::any_io_executor(ctx.get_executor()) : boost::asio::any_io_executor());
+    for (auto _ : state) {
+      fill_row(row, i);
+      writer.append(row);
+      // 事件循环在处理行情的间隙收取写完成
+      if (++i % kBlockRows == 0) {
+        ctx.poll();
+      }
+    }
+    // 计时已结束，写入块索引并等待未完成的写入
+    writer.close();
+    ctx.run();
+  }
+
+  state.SetItemsProcessed(i);
+  state.SetBytesProcessed(i * kColumns * sizeof(int64_t));
+  state.counters["file_bytes"] = double(std::filesystem::file_size(path));
+  std::filesystem::remove(path);
+}
+BENCHMARK(BM_ColumnWriterAppend)->Arg(0)->Arg(1)->ArgName("async");
+
+// 单个数据块 flush 的耗时，即事件循环被写盘占用的最长一次
+static void BM_ColumnWriterFlushBlock(benchmark::State& state) {
+  bool async = state.range(0) != 0;
+#ifndef BOOST_ASIO_HAS_FILE
+  if (async) {
+    state.SkipWithError("asio built without BOOST_ASIO_HAS_FILE");
+    return;
+  }
+#endif
+  boost::asio::io_context ctx;
+  auto path = bench_path(async ? "async_block.col" : "sync_block.col");
+  std::filesystem::remove(path);
+
+  int64_t row[kColumns];
+  int64_t i = 0;
+  {
+    // 块大小大于每次写入的行数，只有显式 flush 才写块
+    ColumnWriter writer(path, kColumns, 0, kBlockRows * 2,
+                        async ? boost::asio::any_io_executor(ctx.get_executor()) : boost::asio::any_io_executor());
+    for (auto _ : state) {
+      state.PauseTiming();
+      for (uint32_t r = 0; r < kBlockRows; ++r) {
+        fill_row(row, i++);
+        writer.append(row);
+      }
+      ctx.poll();
+      state.ResumeTiming();
+      writer.flush();
+    }
+    // 计时已结束，写入块索引并等待未完成的写入
+    writer.close();
+    ctx.run();
+  }
+  std::filesystem::remove(path);
+}
+BENCHMARK(BM_ColumnWriterFlushBlock)->Arg(0)->Arg(1)->ArgName("async");
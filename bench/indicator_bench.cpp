@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+
+#include "indicator/indicator.hpp"
+
+using namespace Common::indicator;
+
+namespace {
+
+std::vector<double> series(size_t n) {
+  std::vector<double> v(n);
+  for (size_t i = 0; i < n; ++i) {
+    v[i] = 100.0 + std::sin(i * 0.1) * 5;
+  }
+  return v;
+}
+
+constexpr size_t kRows = 1 << 16;
+
+}  // namespace
+
+// 流式指标单次 update 的耗时
+static void BM_StreamEma(benchmark::State& state) {
+  auto in = series(kRows);
+  Ema ema(20);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ema.update(in[i++ & (kRows - 1)]));
+  }
+}
+BENCHMARK(BM_StreamEma);
+
+static void BM_StreamZScore(benchmark::State& state) {
+  auto in = series(kRows);
+  ZScore z(100);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(z.update(in[i++ & (kRows - 1)]));
+  }
+}
+BENCHMARK(BM_StreamZScore);
+
+static void BM_StreamFixedEma(benchmark::State& state) {
+  auto price = Common::Fixed::from_double(65000.5);
+  Ema ema(20);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ema.update(price));
+  }
+}
+BENCHMARK(BM_StreamFixedEma);
+
+// 批量版本，吞吐以每秒处理的元素数计
+static void BM_BatchEma(benchmark::State& state) {
+  auto in = series(kRows);
+  std::vector<double> out(kRows);
+  for (auto _ : state) {
+    batch::ema(in.data(), out.data(), kRows, 20);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_BatchEma);
+
+static void BM_BatchSma(benchmark::State& state) {
+  auto in = series(kRows);
+  std::vector<double> out(kRows);
+  for (auto _ : state) {
+    batch::sma(in.data(), out.data(), kRows, 20);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_BatchSma);
+
+static void BM_BatchBookImbalance(benchmark::State& state) {
+  auto bid = series(kRows);
+  auto ask = series(kRows);
+  std::vector<double> out(kRows);
+  for (auto _ : state) {
+    batch::book_imbalance(bid.data(), ask.data(), out.data(), kRows);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_BatchBookImbalance);
+
+static void BM_BatchVwap(benchmark::State& state) {
+  auto price = series(kRows);
+  auto volume = series(kRows);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(batch::vwap(price.data(), volume.data(), kRows));
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_BatchVwap);
@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <chrono>
+#include <thread>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/write.hpp>
+
+#include "utils/io_loop.h"
+
+namespace asio = boost::asio;
+using asio::ip::tcp;
+
+namespace {
+
+constexpr size_t kMessageSize = 64;
+
+/// 回显一条连接上收到的数据
+asio::awaitable<void> echo(tcp::socket socket) {
+  std::array<char, kMessageSize> data;
+  try {
+    for (;;) {
+      co_await asio::async_read(socket, asio::buffer(data), asio::use_awaitable);
+      co_await asio::async_write(socket, asio::buffer(data), asio::use_awaitable);
+    }
+  } catch (const std::exception&) {
+    // 客户端断开
+  }
+}
+
+/**
+ * @brief 在独立线程上以指定方式运行回显服务，模拟网关所在的事件循环
+ *
+ * 客户端在基准线程上用阻塞套接字发送并等待回显，一次往返包含服务端事件循环的一次唤醒。
+ * spin/hybrid 的自旋与客户端争用同一个核时结果没有意义，至少需要两个空闲核。
+ */
+class EchoServer {
+ public:
+  EchoServer(Common::IoMode mode, int64_t idle_spin_us)
+      : acceptor_(ctx_, tcp::endpoint(asio::ip::address_v4::loopback(), 0)) {
+    asio::co_spawn(
+        ctx_,
+        [this]() -> asio::awaitable<void> {
+          auto socket = co_await acceptor_.async_accept(asio::use_awaitable);
+          socket.set_option(tcp::no_delay(true));
+          co_await echo(std::move(socket));
+        },
+        asio::detached);
+    thread_ = std::thread([this, mode, idle_spin_us] { Common::run_io_loop(ctx_, mode, idle_spin_us); });
+  }
+
+  ~EchoServer() {
+    ctx_.stop();
+    thread_.join();
+  }
+
+  tcp::endpoint endpoint() const { return acceptor_.local_endpoint(); }
+
+ private:
+  asio::io_context ctx_;
+  tcp::acceptor acceptor_;
+  std::thread thread_;
+};
+
+}  // namespace
+
+// 连续往返：参数为运行方式 0 block / 1 spin / 2 hybrid，hybrid 空闲自旋 1ms
+static void BM_LoopbackEcho(benchmark::State& state) {
+  auto mode = static_cast<Common::IoMode>(state.range(0));
+  EchoServer server(mode, 1000);
+
+  asio::io_context client_ctx;
+  tcp::socket socket(client_ctx);
+  socket.connect(server.endpoint());
+  socket.set_option(tcp::no_delay(true));
+
+  std::array<char, kMessageSize> data{};
+  for (auto _ : state) {
+    asio::write(socket, asio::buffer(data));
+    asio::read(socket, asio::buffer(data));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoopbackEcho)->Arg(0)->Arg(1)->Arg(2)->ArgName("mode")->UseRealTime();
+
+// 稀疏往返：每次往返前客户端空闲 gap_us，hybrid 空闲超过自旋时长后会休眠，
+// 体现三种方式在行情稀疏时的差别；只计往返时间
+static void BM_LoopbackEchoSparse(benchmark::State& state) {
+  auto mode = static_cast<Common::IoMode>(state.range(0));
+  auto gap = std::chrono::microseconds(state.range(1));
+  EchoServer server(mode, 1000);
+
+  asio::io_context client_ctx;
+  tcp::socket socket(client_ctx);
+  socket.connect(server.endpoint());
+  socket.set_option(tcp::no_delay(true));
+
+  std::array<char, kMessageSize> data{};
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::this_thread::sleep_for(gap);
+    state.ResumeTiming();
+    asio::write(socket, asio::buffer(data));
+    asio::read(socket, asio::buffer(data));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoopbackEchoSparse)
+    ->ArgsProduct({{0, 1, 2}, {200, 5000}})
+    ->ArgNames({"mode", "gap_us"})
+    ->UseRealTime();
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include "risk/risk_gate.h"
+
+using Common::Fixed;
+using service::risk::RiskGate;
+
+namespace {
+
+/// 开启全部检查，频率不设上限以免基准测试被限流
+std::shared_ptr<RiskGate> make_gate() {
+  auto pt = std::make_shared<Config::ptree>();
+  pt->put("risk.enable", true);
+  pt->put("risk.max_order_volume", "10");
+  pt->put("risk.max_order_notional", "1000000");
+  pt->put("risk.price_band_bps", 200);
+  pt->put("risk.max_open_orders", 1000);
+  pt->put("risk.max_symbol_open_orders", 1000);
+  pt->put("risk.symbol_limits", "BTC-USDT-SWAP:5:1000000");
+  risk_config->load(pt);
+
+  auto gate = std::make_shared<RiskGate>(nullptr);
+  gate->set_reference("BTC-USDT-SWAP", Fixed::from_int(60000));
+  return gate;
+}
+
+}  // namespace
+
+// 下单路径上的一次检查：dec_float 转定点数 + 全部限额比较，目标 < 1us
+static void BM_RiskCheckOrderItem(benchmark::State& state) {
+  auto gate = make_gate();
+  engine::OrderDataItem item;
+  item.symbol = "BTC-USDT-SWAP";
+  item.otype = engine::OrderType::LIMIT;
+  item.volume = dec_float("0.25");
+  item.price = dec_float("60100.5");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(gate->check(item, 10, 2));
+  }
+}
+BENCHMARK(BM_RiskCheckOrderItem);
+
+// 只有定点数比较的部分
+static void BM_RiskCheckFixed(benchmark::State& state) {
+  auto gate = make_gate();
+  const std::string symbol = "BTC-USDT-SWAP";
+  auto volume = Fixed::from_double(0.25);
+  auto price = Fixed::from_double(60100.5);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(gate->check(symbol, engine::OrderType::LIMIT, volume, price, 10, 2));
+  }
+}
+BENCHMARK(BM_RiskCheckFixed);
+
+// 入口处的 dec_float 转换开销
+static void BM_FixedFromDec(benchmark::State& state) {
+  dec_float value("60100.5");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Fixed::from_dec(value));
+  }
+}
+BENCHMARK(BM_FixedFromDec);
@@ -24,6 +24,12 @@ class ConfigTree {
     return m_ptree->get<T>(m_prefix + "." + key);
   }
 
+  /// 读取可选配置项，缺失时返回默认值
+  template <typename T>
+  T get(const std::string& key, const T& default_value) {
+    return m_ptree->get<T>(m_prefix + "." + key, default_value);
+  }
+
   virtual void load(std::shared_ptr<Config::ptree> pt) = 0;
 
  protected:
@@ -50,6 +56,46 @@ class CommonConfig : public ConfigTree {
 
 #define common_config ::Common::SingletonPtr<::Config::CommonConfig>::get_instance()
 
+/**
+ * @brief 主线程事件循环配置
+ *
+ * mode 取值：
+ * - block：io_context.run()，空闲时在 epoll 中休眠，省电但每次唤醒有调度延迟
+ * - spin：循环 poll()，空闲时自旋不让出CPU，独占一个核
+ * - hybrid：有事件后自旋 idle_spin_us，仍无事件时以 run_one_for 休眠
+ */
+class IoConfig : public ConfigTree {
+ public:
+  IoConfig() : ConfigTree("io") {};
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+    m_mode = this->get<std::string>("mode", "block");
+    m_idle_spin_us = this->get<int64_t>("idle_spin_us", 1000);
+    m_cpu = this->get<int>("cpu", -1);
+    m_busy_poll_us = this->get<int>("busy_poll_us", 0);
+  }
+
+  const std::string& mode() const { return m_mode; }
+
+  /// hybrid 模式下最后一个事件后继续自旋的时长（微秒）
+  int64_t idle_spin_us() const { return m_idle_spin_us; }
+
+  /// 主线程绑定的CPU核，-1 表示不绑定
+  int cpu() const { return m_cpu; }
+
+  /// 期望的套接字忙轮询时长（微秒），0 表示不使用
+  int busy_poll_us() const { return m_busy_poll_us; }
+
+ private:
+  std::string m_mode = "block";
+  int64_t m_idle_spin_us = 1000;
+  int m_cpu = -1;
+  int m_busy_poll_us = 0;
+};
+
+#define io_config ::Common::SingletonPtr<::Config::IoConfig>::get_instance()
+
 class Config {
  public:
   Config(const std::string& config_file = "") {
@@ -0,0 +1,420 @@
+#ifndef __COMMON_INDICATOR_INDICATOR_HPP__
+#define __COMMON_INDICATOR_INDICATOR_HPP__
+
+/**
+ * @file indicator.hpp
+ * @brief 流式技术指标库（纯头文件）
+ *
+ * 所有指标都是增量计算，每次 update 为 O(1)，不做动态分配（窗口缓冲区在构造时分配）。
+ * 输入可以是 double、Common::Fixed 或 dec_float，内部统一用 double 计算。
+ *
+ * batch 命名空间提供面向回测的批量版本，省去逐次调用和类型转换的开销：
+ * - book_imbalance、microprice 是逐元素运算（__restrict 指针、无分支），可以自动向量化
+ * - ema、sma、zscore 每一项依赖上一项的结果，是串行递推，不能向量化
+ * - vwap 的浮点求和归约需要 -ffast-math（或 -fassociative-math）才会向量化，默认按顺序累加
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "utils/fixed_point.hpp"
+#include "utils/utils.h"
+
+namespace Common::indicator {
+
+/// 输入统一转换为double
+inline double to_double(double v) { return v; }
+inline double to_double(Common::Fixed v) { return v.to_double(); }
+inline double to_double(const dec_float& v) { return v.convert_to<double>(); }
+
+/**
+ * @brief 指数移动平均
+ *
+ * alpha = 2 / (period + 1)，第一个输入作为初始值。
+ */
+class Ema {
+ public:
+  explicit Ema(size_t period) : alpha_(2.0 / (period + 1.0)) {}
+
+  /// 直接指定平滑系数
+  static Ema with_alpha(double alpha) {
+    Ema e(1);
+    e.alpha_ = alpha;
+    return e;
+  }
+
+  template <typename T>
+  double update(const T& input) {
+    double x = to_double(input);
+    value_ = count_++ == 0 ? x : value_ + alpha_ * (x - value_);
+    return value_;
+  }
+
+  double value() const { return value_; }
+  bool ready() const { return count_ > 0; }
+  void reset() {
+    value_ = 0;
+    count_ = 0;
+  }
+
+ private:
+  double alpha_;
+  double value_ = 0;
+  size_t count_ = 0;
+};
+
+/**
+ * @brief 定长环形缓冲区，窗口类指标的基础
+ */
+class RingBuffer {
+ public:
+  explicit RingBuffer(size_t capacity) : data_(capacity == 0 ? 1 : capacity) {}
+
+  /**
+   * @brief 写入新值
+   * @return 被挤出的旧值，窗口未满时为0
+   */
+  double push(double v) {
+    double old = full() ? data_[head_] : 0.0;
+    data_[head_] = v;
+    head_ = head_ + 1 == data_.size() ? 0 : head_ + 1;
+    if (size_ < data_.size()) {
+      ++size_;
+    }
+    return old;
+  }
+
+  /// 第i新的值，0为最新
+  double at(size_t i) const {
+    size_t idx = (head_ + data_.size() - 1 - i) % data_.size();
+    return data_[idx];
+  }
+
+  size_t size() const { return size_; }
+  size_t capacity() const { return data_.size(); }
+  bool full() const { return size_ == data_.size(); }
+  bool wrapped() const { return head_ == 0; }  ///< 刚好写满一圈
+  const std::vector<double>& data() const { return data_; }
+
+  void reset() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+ private:
+  std::vector<double> data_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
+/**
+ * @brief 简单移动平均
+ *
+ * 维护窗口内的和，每写满一圈重新求和一次，消除浮点累计误差，均摊O(1)。
+ */
+class Sma {
+ public:
+  explicit Sma(size_t period) : buf_(period) {}
+
+  template <typename T>
+  double update(const T& input) {
+    double x = to_double(input);
+    double old = buf_.push(x);
+    sum_ += x - old;
+    if (buf_.wrapped()) {
+      sum_ = 0;
+      for (auto v : buf_.data()) sum_ += v;
+    }
+    return value();
+  }
+
+  double value() const { return buf_.size() == 0 ? 0.0 : sum_ / buf_.size(); }
+  bool ready() const { return buf_.full(); }
+  void reset() {
+    buf_.reset();
+    sum_ = 0;
+  }
+
+ private:
+  RingBuffer buf_;
+  double sum_ = 0;
+};
+
+/**
+ * @brief 滚动方差/标准差/Z分数
+ *
+ * 维护窗口内的和与平方和，写满一圈时重新计算，避免相消误差累积。
+ */
+class RollingVariance {
+ public:
+  explicit RollingVariance(size_t period) : buf_(period) {}
+
+  template <typename T>
+  void update(const T& input) {
+    double x = to_double(input);
+    double old = buf_.push(x);
+    sum_ += x - old;
+    sum_sq_ += x * x - old * old;
+    if (buf_.wrapped()) {
+      sum_ = sum_sq_ = 0;
+      for (auto v : buf_.data()) {
+        sum_ += v;
+        sum_sq_ += v * v;
+      }
+    }
+  }
+
+  double mean() const { return buf_.size() == 0 ? 0.0 : sum_ / buf_.size(); }
+
+  /// 样本方差
+  double variance() const {
+    auto n = buf_.size();
+    if (n < 2) return 0.0;
+    double var = (sum_sq_ - sum_ * sum_ / n) / (n - 1);
+    return var < 0 ? 0.0 : var;
+  }
+
+  double stddev() const { return std::sqrt(variance()); }
+
+  /// 输入值相对窗口的Z分数，标准差为0时返回0
+  template <typename T>
+  double zscore(const T& input) const {
+    double sd = stddev();
+    return sd == 0.0 ? 0.0 : (to_double(input) - mean()) / sd;
+  }
+
+  bool ready() const { return buf_.full(); }
+  void reset() {
+    buf_.reset();
+    sum_ = sum_sq_ = 0;
+  }
+
+ private:
+  RingBuffer buf_;
+  double sum_ = 0;
+  double sum_sq_ = 0;
+};
+
+/**
+ * @brief 滚动Z分数：先用历史窗口计算，再把新值加入窗口
+ */
+class ZScore {
+ public:
+  explicit ZScore(size_t period) : var_(period) {}
+
+  template <typename T>
+  double update(const T& input) {
+    double x = to_double(input);
+    value_ = var_.zscore(x);
+    var_.update(x);
+    return value_;
+  }
+
+  double value() const { return value_; }
+  bool ready() const { return var_.ready(); }
+
+ private:
+  RollingVariance var_;
+  double value_ = 0;
+};
+
+/**
+ * @brief 成交量加权平均价
+ *
+ * period 为0时为累计VWAP（可调用reset按交易日重置），否则为最近period笔的滚动VWAP。
+ */
+class Vwap {
+ public:
+  explicit Vwap(size_t period = 0) : pv_(period), vol_(period), rolling_(period > 0) {}
+
+  template <typename P, typename V>
+  double update(const P& price, const V& volume) {
+    double p = to_double(price);
+    double v = to_double(volume);
+    if (rolling_) {
+      sum_pv_ += p * v - pv_.push(p * v);
+      sum_v_ += v - vol_.push(v);
+      if (pv_.wrapped()) {
+        sum_pv_ = sum_v_ = 0;
+        for (size_t i = 0; i < pv_.capacity(); ++i) {
+          sum_pv_ += pv_.data()[i];
+          sum_v_ += vol_.data()[i];
+        }
+      }
+    } else {
+      sum_pv_ += p * v;
+      sum_v_ += v;
+    }
+    return value();
+  }
+
+  double value() const { return sum_v_ == 0.0 ? 0.0 : sum_pv_ / sum_v_; }
+  double volume() const { return sum_v_; }
+  void reset() {
+    pv_.reset();
+    vol_.reset();
+    sum_pv_ = sum_v_ = 0;
+  }
+
+ private:
+  RingBuffer pv_;
+  RingBuffer vol_;
+  bool rolling_;
+  double sum_pv_ = 0;
+  double sum_v_ = 0;
+};
+
+/**
+ * @brief 平均真实波幅（Wilder平滑）
+ */
+class Atr {
+ public:
+  explicit Atr(size_t period) : period_(period == 0 ? 1 : period) {}
+
+  template <typename T>
+  double update(const T& high, const T& low, const T& close) {
+    double h = to_double(high);
+    double l = to_double(low);
+    double c = to_double(close);
+    double tr = count_ == 0 ? h - l : std::max(h - l, std::max(std::abs(h - prev_close_), std::abs(l - prev_close_)));
+    prev_close_ = c;
+
+    // 前period个用简单平均，之后Wilder平滑
+    if (count_ < period_) {
+      value_ = (value_ * count_ + tr) / (count_ + 1);
+    } else {
+      value_ = (value_ * (period_ - 1) + tr) / period_;
+    }
+    ++count_;
+    return value_;
+  }
+
+  double value() const { return value_; }
+  bool ready() const { return count_ >= period_; }
+
+ private:
+  size_t period_;
+  size_t count_ = 0;
+  double value_ = 0;
+  double prev_close_ = 0;
+};
+
+/**
+ * @brief 买卖盘量不平衡度 (bid - ask) / (bid + ask)，范围[-1, 1]
+ */
+template <typename T>
+inline double book_imbalance(const T& bid_size, const T& ask_size) {
+  double b = to_double(bid_size);
+  double a = to_double(ask_size);
+  double total = b + a;
+  return total == 0.0 ? 0.0 : (b - a) / total;
+}
+
+/**
+ * @brief 多档不平衡度，levels 元素需要有 volume 字段（如 engine::BookItem）
+ * @param depth 使用的档位数
+ */
+template <typename Levels>
+inline double depth_imbalance(const Levels& bids, const Levels& asks, size_t depth) {
+  double b = 0, a = 0;
+  for (size_t i = 0; i < depth && i < bids.size(); ++i) b += to_double(bids[i].volume);
+  for (size_t i = 0; i < depth && i < asks.size(); ++i) a += to_double(asks[i].volume);
+  return book_imbalance(b, a);
+}
+
+/**
+ * @brief 微观价格：按对手盘量加权的中间价
+ *
+ * microprice = (bid_px * ask_sz + ask_px * bid_sz) / (bid_sz + ask_sz)
+ */
+template <typename T>
+inline double microprice(const T& bid_px, const T& bid_sz, const T& ask_px, const T& ask_sz) {
+  double bp = to_double(bid_px), bs = to_double(bid_sz);
+  double ap = to_double(ask_px), as = to_double(ask_sz);
+  double total = bs + as;
+  return total == 0.0 ? (bp + ap) / 2 : (bp * as + ap * bs) / total;
+}
+
+/**
+ * @brief 批量版本，用于回测
+ */
+namespace batch {
+
+/// EMA，out[i]为处理完in[i]后的值
+inline void ema(const double* __restrict in, double* __restrict out, size_t n, size_t period) {
+  if (n == 0) return;
+  double alpha = 2.0 / (period + 1.0);
+  double v = in[0];
+  out[0] = v;
+  for (size_t i = 1; i < n; ++i) {
+    v += alpha * (in[i] - v);
+    out[i] = v;
+  }
+}
+
+/// SMA，窗口未满时为已有数据的均值
+inline void sma(const double* __restrict in, double* __restrict out, size_t n, size_t period) {
+  double sum = 0;
+  for (size_t i = 0; i < n; ++i) {
+    sum += in[i];
+    if (i >= period) sum -= in[i - period];
+    out[i] = sum / (i + 1 < period ? i + 1 : period);
+  }
+}
+
+/// 逐元素不平衡度，可向量化
+inline void book_imbalance(const double* __restrict bid_sz, const double* __restrict ask_sz, double* __restrict out,
+                           size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    double total = bid_sz[i] + ask_sz[i];
+    double diff = bid_sz[i] - ask_sz[i];
+    out[i] = total == 0.0 ? 0.0 : diff / total;
+  }
+}
+
+/// 逐元素微观价格，可向量化
+inline void microprice(const double* __restrict bid_px, const double* __restrict bid_sz,
+                       const double* __restrict ask_px, const double* __restrict ask_sz, double* __restrict out,
+                       size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    double total = bid_sz[i] + ask_sz[i];
+    double weighted = bid_px[i] * ask_sz[i] + ask_px[i] * bid_sz[i];
+    out[i] = total == 0.0 ? (bid_px[i] + ask_px[i]) * 0.5 : weighted / total;
+  }
+}
+
+/// 整段数据的VWAP，浮点归约默认不向量化
+inline double vwap(const double* __restrict price, const double* __restrict volume, size_t n) {
+  double pv = 0, v = 0;
+  for (size_t i = 0; i < n; ++i) {
+    pv += price[i] * volume[i];
+    v += volume[i];
+  }
+  return v == 0.0 ? 0.0 : pv / v;
+}
+
+/// 滚动Z分数，out[i]为in[i]相对前period个值的Z分数
+inline void zscore(const double* __restrict in, double* __restrict out, size_t n, size_t period) {
+  double sum = 0, sum_sq = 0;
+  for (size_t i = 0; i < n; ++i) {
+    size_t cnt = i < period ? i : period;
+    double var = cnt < 2 ? 0.0 : (sum_sq - sum * sum / cnt) / (cnt - 1);
+    double sd = var > 0 ? std::sqrt(var) : 0.0;
+    out[i] = sd == 0.0 ? 0.0 : (in[i] - sum / cnt) / sd;
+
+    sum += in[i];
+    sum_sq += in[i] * in[i];
+    if (i >= period) {
+      sum -= in[i - period];
+      sum_sq -= in[i - period] * in[i - period];
+    }
+  }
+}
+
+}  // namespace batch
+
+}  // namespace Common::indicator
+
+#endif  // __COMMON_INDICATOR_INDICATOR_HPP__
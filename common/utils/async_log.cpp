@@ -0,0 +1,95 @@
+#include "async_log.h"
+
+#include <glog/logging.h>
+
+#include <chrono>
+
+namespace Common {
+
+AsyncLogger::AsyncLogger() : slots_(std::make_unique<Slot[]>(kSlots)) {
+  for (size_t i = 0; i < kSlots; ++i) {
+    slots_[i].seq.store(i, std::memory_order_relaxed);
+  }
+  dropped_ = &metrics_registry.counter("qitrader_log_dropped_total", "Async log records dropped on full buffer");
+}
+
+AsyncLogger::~AsyncLogger() { stop(); }
+
+void AsyncLogger::start() {
+  if (running_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  worker_ = std::thread([this] { drain(); });
+}
+
+void AsyncLogger::stop() {
+  if (!running_.exchange(false, std::memory_order_acq_rel)) {
+    return;
+  }
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+AsyncLogger::Slot* AsyncLogger::claim(size_t& pos) {
+  pos = enqueue_pos_.load(std::memory_order_relaxed);
+  while (true) {
+    auto& slot = slots_[pos & (kSlots - 1)];
+    auto seq = slot.seq.load(std::memory_order_acquire);
+    auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        return &slot;
+      }
+    } else if (diff < 0) {
+      // 消费者还没取走上一轮的记录，队列已满
+      return nullptr;
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void AsyncLogger::drain() {
+  // 停止后继续取完已提交的记录再退出
+  while (true) {
+    auto& slot = slots_[dequeue_pos_ & (kSlots - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+      if (!running_.load(std::memory_order_acquire)) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+
+    auto text = slot.decode(*slot.site, slot.payload, slot.size);
+    auto delay_us = (now_ns() - slot.ts_ns) / 1000;
+    auto site = slot.site;
+    slot.seq.store(dequeue_pos_ + kSlots, std::memory_order_release);
+    ++dequeue_pos_;
+
+    // 积压明显时标注记录与输出的时间差
+    if (delay_us >= 1000) {
+      text += fmt::format(" (+{}us)", delay_us);
+    }
+    write(*site, text);
+  }
+}
+
+void AsyncLogger::write(const LogSite& site, const std::string& text) {
+  google::LogSeverity severity = google::GLOG_INFO;
+  switch (site.level) {
+    case LogLevel::kINFO:
+      severity = google::GLOG_INFO;
+      break;
+    case LogLevel::kWARNING:
+      severity = google::GLOG_WARNING;
+      break;
+    case LogLevel::kERROR:
+      severity = google::GLOG_ERROR;
+      break;
+  }
+  google::LogMessage(site.file, site.line, severity).stream() << text;
+}
+
+}  // namespace Common
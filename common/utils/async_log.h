@@ -0,0 +1,221 @@
+#ifndef __COMMON_UTILS_ASYNC_LOG_H__
+#define __COMMON_UTILS_ASYNC_LOG_H__
+
+/**
+ * @file async_log.h
+ * @brief 异步二进制日志
+ *
+ * 热路径上只把日志位置（格式串、级别、文件行号的静态描述）和参数的二进制拷贝写入无锁环形缓冲区，
+ * 后台线程取出后再格式化并交给 glog 输出，事件循环不再被格式化和 stderr 写入阻塞。
+ * 缓冲区满时丢弃并计数，不阻塞调用方。
+ *
+ * 用法：QLOG(INFO, "recv_book {}: ask {} bid {}", symbol, asks, bids);
+ * 参数支持算术类型和字符串（std::string / std::string_view / const char*），字符串超长时截断。
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+#include <fmt/format.h>
+
+#include "latency.h"
+#include "metrics.h"
+
+namespace Common {
+
+enum class LogLevel {
+  kINFO,
+  kWARNING,
+  kERROR,
+};
+
+/**
+ * @brief 日志位置，每个 QLOG 调用点一个静态实例，地址即格式ID
+ */
+struct LogSite {
+  LogLevel level;
+  const char* file;
+  int line;
+  const char* format;
+};
+
+/**
+ * @brief 日志参数在环形缓冲区中的存储类型
+ */
+template <typename T>
+using log_arg_t = std::conditional_t<std::is_arithmetic_v<T>, T, std::string>;
+
+/**
+ * @brief 异步日志
+ *
+ * 多生产者单消费者的有界队列（按槽位序号同步），每个槽位定长，
+ * 记录头之后紧跟参数的二进制编码。
+ */
+class AsyncLogger {
+ public:
+  static constexpr size_t kSlots = 8192;  ///< 必须是2的幂
+  static constexpr size_t kPayloadSize = 224;
+
+  static AsyncLogger& instance() {
+    static AsyncLogger logger;
+    return logger;
+  }
+
+  /// 启动后台输出线程，需在 glog 初始化之后调用
+  void start();
+
+  /// 输出剩余日志并停止后台线程，需在 glog 关闭之前调用
+  void stop();
+
+  /**
+   * @brief 记录一条日志
+   *
+   * 未启动后台线程时直接同步输出，保证启动前和退出后的日志不丢失。
+   */
+  template <typename... Args>
+  void log(const LogSite& site, const Args&... args) {
+    static_assert((... && (std::is_arithmetic_v<std::decay_t<Args>> ||
+                           std::is_convertible_v<const Args&, std::string_view>)),
+                  "QLOG arguments must be arithmetic or string");
+    if (!running_.load(std::memory_order_acquire)) {
+      write(site, fmt::format(fmt::runtime(site.format), to_arg(args)...));
+      return;
+    }
+
+    size_t pos = 0;
+    auto slot = claim(pos);
+    if (slot == nullptr) {
+      dropped_->inc();
+      return;
+    }
+    slot->site = &site;
+    slot->decode = &decode<log_arg_t<std::decay_t<Args>>...>;
+    slot->ts_ns = now_ns();
+    size_t offset = 0;
+    (encode(slot->payload, offset, to_arg(args)), ...);
+    slot->size = static_cast<uint16_t>(offset);
+    slot->seq.store(pos + 1, std::memory_order_release);
+  }
+
+  /// 被丢弃的日志数
+  uint64_t dropped() const { return dropped_->value(); }
+
+ private:
+  using DecodeFn = std::string (*)(const LogSite& site, const std::byte* data, size_t size);
+
+  struct alignas(kCacheLine) Slot {
+    std::atomic<size_t> seq{0};
+    const LogSite* site = nullptr;
+    DecodeFn decode = nullptr;
+    int64_t ts_ns = 0;
+    uint16_t size = 0;
+    std::byte payload[kPayloadSize];
+  };
+
+  AsyncLogger();
+  ~AsyncLogger();
+
+  /**
+   * @brief 申请一个可写槽位
+   * @param pos 输出该槽位的写入序号
+   * @return Slot* 队列满时返回 nullptr
+   */
+  Slot* claim(size_t& pos);
+
+  /// 后台线程主循环
+  void drain();
+
+  /// 输出一条已格式化的日志
+  static void write(const LogSite& site, const std::string& text);
+
+  template <typename T>
+  static auto to_arg(const T& value) {
+    if constexpr (std::is_arithmetic_v<T>) {
+      return value;
+    } else {
+      return std::string_view(value);
+    }
+  }
+
+  template <typename T>
+  static void encode(std::byte* payload, size_t& offset, const T& value) {
+    if constexpr (std::is_arithmetic_v<T>) {
+      if (offset + sizeof(T) <= kPayloadSize) {
+        std::memcpy(payload + offset, &value, sizeof(T));
+      }
+      offset += sizeof(T);
+      if (offset > kPayloadSize) {
+        offset = kPayloadSize;
+      }
+    } else {
+      // 长度 + 内容，剩余空间不足时截断
+      uint16_t len = 0;
+      if (offset + sizeof(len) <= kPayloadSize) {
+        len = static_cast<uint16_t>(std::min(value.size(), kPayloadSize - offset - sizeof(len)));
+        std::memcpy(payload + offset, &len, sizeof(len));
+        std::memcpy(payload + offset + sizeof(len), value.data(), len);
+      }
+      offset = std::min(offset + sizeof(len) + len, kPayloadSize);
+    }
+  }
+
+  template <typename T>
+  static T read(const std::byte* data, size_t size, size_t& offset) {
+    if constexpr (std::is_arithmetic_v<T>) {
+      T value{};
+      if (offset + sizeof(T) <= size) {
+        std::memcpy(&value, data + offset, sizeof(T));
+      }
+      offset += sizeof(T);
+      return value;
+    } else {
+      uint16_t len = 0;
+      if (offset + sizeof(len) > size) {
+        return T();
+      }
+      std::memcpy(&len, data + offset, sizeof(len));
+      offset += sizeof(len);
+      T value(reinterpret_cast<const char*>(data + offset), len);
+      offset += len;
+      return value;
+    }
+  }
+
+  template <typename... Stored>
+  static std::string decode(const LogSite& site, [[maybe_unused]] const std::byte* data, [[maybe_unused]] size_t size) {
+    [[maybe_unused]] size_t offset = 0;
+    // 花括号初始化保证按参数顺序读取
+    std::tuple<Stored...> values{read<Stored>(data, size, offset)...};
+    return std::apply([&](const auto&... v) { return fmt::format(fmt::runtime(site.format), v...); }, values);
+  }
+
+  std::unique_ptr<Slot[]> slots_;
+  alignas(kCacheLine) std::atomic<size_t> enqueue_pos_{0};
+  alignas(kCacheLine) size_t dequeue_pos_ = 0;
+
+  std::atomic<bool> running_{false};
+  std::thread worker_;
+  Counter* dropped_ = nullptr;
+};
+
+#define async_logger ::Common::AsyncLogger::instance()
+
+/// 异步日志，severity 取 INFO / WARNING / ERROR
+#define QLOG(severity, format, ...)                                                                      \
+  do {                                                                                                   \
+    static constexpr ::Common::LogSite qlog_site_{::Common::LogLevel::k##severity, __FILE__, __LINE__, \
+                                                  format};                                               \
+    async_logger.log(qlog_site_ __VA_OPT__(, ) __VA_ARGS__);                                             \
+  } while (0)
+
+}  // namespace Common
+
+#endif  // __COMMON_UTILS_ASYNC_LOG_H__
@@ -0,0 +1,147 @@
+#ifndef __COMMON_UTILS_FIXED_POINT_HPP__
+#define __COMMON_UTILS_FIXED_POINT_HPP__
+
+/**
+ * @file fixed_point.hpp
+ * @brief 定点数类型
+ *
+ * dec_float 精度高但运算慢，热路径（风控、持仓、指标、存储）统一使用
+ * 64位整数表示的定点数，固定8位小数，足够覆盖交易所的价格和数量精度。
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "utils/utils.h"
+
+namespace Common {
+
+/**
+ * @brief 固定8位小数的定点数
+ *
+ * 内部以 raw = value * 1e8 的 int64 保存，加减为整数运算，
+ * 乘除使用128位中间结果避免溢出。
+ */
+class Fixed {
+ public:
+  static constexpr int64_t kScale = 100000000;  ///< 缩放系数 1e8
+  static constexpr int kDigits = 8;             ///< 小数位数
+
+  constexpr Fixed() = default;
+
+  /// 从原始整数构造
+  static constexpr Fixed from_raw(int64_t raw) {
+    Fixed f;
+    f.raw_ = raw;
+    return f;
+  }
+
+  /// 从整数构造
+  static constexpr Fixed from_int(int64_t v) { return from_raw(v * kScale); }
+
+  /// 从浮点数构造（四舍五入）
+  static Fixed from_double(double v) { return from_raw(static_cast<int64_t>(std::llround(v * kScale))); }
+
+  /// 从dec_float构造（四舍五入），仅在边界处调用
+  static Fixed from_dec(const dec_float& v) {
+    static const dec_float half("0.5");
+    dec_float scaled = v * kScale;
+    if (scaled < 0) {
+      scaled -= half;
+    } else {
+      scaled += half;
+    }
+    return from_raw(scaled.convert_to<int64_t>());
+  }
+
+  /// 从十进制字符串解析，不经过dec_float，用于行情解析的快速路径
+  static Fixed from_string(std::string_view s) {
+    int64_t int_part = 0;
+    int64_t frac_part = 0;
+    int frac_digits = 0;
+    bool neg = false;
+    bool in_frac = false;
+    size_t i = 0;
+    if (i < s.size() && (s[i] == '-' || s[i] == '+')) {
+      neg = s[i] == '-';
+      ++i;
+    }
+    for (; i < s.size(); ++i) {
+      char c = s[i];
+      if (c == '.') {
+        in_frac = true;
+        continue;
+      }
+      if (c < '0' || c > '9') {
+        break;
+      }
+      if (!in_frac) {
+        int_part = int_part * 10 + (c - '0');
+      } else if (frac_digits < kDigits) {
+        frac_part = frac_part * 10 + (c - '0');
+        ++frac_digits;
+      }
+    }
+    for (; frac_digits < kDigits; ++frac_digits) {
+      frac_part *= 10;
+    }
+    int64_t raw = int_part * kScale + frac_part;
+    return from_raw(neg ? -raw : raw);
+  }
+
+  constexpr int64_t raw() const { return raw_; }
+  double to_double() const { return static_cast<double>(raw_) / kScale; }
+  dec_float to_dec() const { return dec_float(raw_) / kScale; }
+
+  std::string str() const {
+    int64_t a = raw_ < 0 ? -raw_ : raw_;
+    std::string s = fmt::format("{}{}.{:08d}", raw_ < 0 ? "-" : "", a / kScale, a % kScale);
+    // 去掉末尾多余的0
+    while (s.back() == '0') s.pop_back();
+    if (s.back() == '.') s.pop_back();
+    return s;
+  }
+
+  constexpr bool is_zero() const { return raw_ == 0; }
+  constexpr Fixed abs() const { return from_raw(raw_ < 0 ? -raw_ : raw_); }
+
+  constexpr Fixed operator-() const { return from_raw(-raw_); }
+  constexpr Fixed operator+(Fixed o) const { return from_raw(raw_ + o.raw_); }
+  constexpr Fixed operator-(Fixed o) const { return from_raw(raw_ - o.raw_); }
+  constexpr Fixed& operator+=(Fixed o) {
+    raw_ += o.raw_;
+    return *this;
+  }
+  constexpr Fixed& operator-=(Fixed o) {
+    raw_ -= o.raw_;
+    return *this;
+  }
+
+  /// 定点乘法，128位中间结果
+  constexpr Fixed operator*(Fixed o) const {
+    return from_raw(static_cast<int64_t>(static_cast<__int128>(raw_) * o.raw_ / kScale));
+  }
+
+  /// 定点除法，除数为0时返回0
+  constexpr Fixed operator/(Fixed o) const {
+    if (o.raw_ == 0) {
+      return Fixed();
+    }
+    return from_raw(static_cast<int64_t>(static_cast<__int128>(raw_) * kScale / o.raw_));
+  }
+
+  constexpr auto operator<=>(const Fixed&) const = default;
+
+  static constexpr Fixed max() { return from_raw(std::numeric_limits<int64_t>::max()); }
+  static constexpr Fixed min() { return from_raw(std::numeric_limits<int64_t>::min()); }
+
+ private:
+  int64_t raw_ = 0;
+};
+
+}  // namespace Common
+
+#endif  // __COMMON_UTILS_FIXED_POINT_HPP__
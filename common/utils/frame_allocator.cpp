@@ -0,0 +1,83 @@
+#include "frame_allocator.h"
+
+#include <array>
+
+#include "metrics.h"
+
+namespace Common {
+
+namespace {
+
+struct FreeNode {
+  FreeNode* next;
+};
+
+/// 当前线程的 FreeLists 已析构。没有析构函数，线程退出期间一直可读
+thread_local bool lists_destroyed = false;
+
+/// 线程退出时把缓存的块归还全局堆
+struct FreeLists {
+  std::array<FreeNode*, FramePool::kClasses> heads{};
+  std::array<size_t, FramePool::kClasses> counts{};
+
+  ~FreeLists() {
+    for (size_t i = 0; i < FramePool::kClasses; ++i) {
+      while (auto node = heads[i]) {
+        heads[i] = node->next;
+        ::operator delete(node);
+      }
+    }
+    // 之后其他线程本地对象析构时分配和释放的块直接使用全局堆，不再访问本对象
+    lists_destroyed = true;
+  }
+};
+
+FreeLists& free_lists() {
+  thread_local FreeLists lists;
+  return lists;
+}
+
+/// 从全局堆分配的次数，稳态下应不再增长
+Counter& heap_allocs() {
+  static Counter& counter =
+      metrics_registry.counter("qitrader_frame_pool_heap_allocs_total", "Frame pool allocations served by the heap");
+  return counter;
+}
+
+inline size_t size_class(size_t n) { return n == 0 ? 0 : (n - 1) / FramePool::kGranularity; }
+
+}  // namespace
+
+void* FramePool::allocate(size_t n) {
+  auto index = size_class(n);
+  if (index < kClasses && !lists_destroyed) {
+    auto& lists = free_lists();
+    if (auto node = lists.heads[index]) {
+      lists.heads[index] = node->next;
+      --lists.counts[index];
+      return node;
+    }
+    // 按级别上限分配，释放后可被同级别的任意请求复用
+    heap_allocs().inc();
+    return ::operator new((index + 1) * kGranularity);
+  }
+  heap_allocs().inc();
+  return ::operator new(n);
+}
+
+void FramePool::deallocate(void* p, size_t n) noexcept {
+  auto index = size_class(n);
+  if (index < kClasses && !lists_destroyed) {
+    auto& lists = free_lists();
+    if (lists.counts[index] < kMaxCached) {
+      auto node = static_cast<FreeNode*>(p);
+      node->next = lists.heads[index];
+      lists.heads[index] = node;
+      ++lists.counts[index];
+      return;
+    }
+  }
+  ::operator delete(p);
+}
+
+}  // namespace Common
@@ -0,0 +1,76 @@
+#ifndef __COMMON_UTILS_FRAME_ALLOCATOR_H__
+#define __COMMON_UTILS_FRAME_ALLOCATOR_H__
+
+/**
+ * @file frame_allocator.h
+ * @brief 线程本地的分级回收分配器
+ *
+ * 引擎每分发一个事件都要为每个回调 co_spawn 一个协程，并分配 Event 对象，
+ * 这些内存大小固定、生命周期短。按64字节分级的线程本地空闲链表回收它们，
+ * 稳态下不再进入全局堆：
+ * - 释放的块挂回当前线程对应级别的链表，在另一线程释放时归入该线程
+ * - 每级缓存的块数有上限，超出的直接归还全局堆
+ * - 超过最大级别的请求直接使用全局堆
+ *
+ * 通过 asio::bind_allocator 关联到 co_spawn 的完成处理器，或用于 std::allocate_shared。
+ */
+
+#include <cstddef>
+#include <new>
+
+namespace Common {
+
+/**
+ * @brief 分级空闲链表，线程本地
+ */
+class FramePool {
+ public:
+  static constexpr size_t kGranularity = 64;  ///< 级别间隔
+  static constexpr size_t kClasses = 16;      ///< 级别数，最大回收1024字节
+  static constexpr size_t kMaxCached = 1024;  ///< 每级最多缓存的块数
+
+  /// 分配 n 字节，按 max_align_t 对齐
+  static void* allocate(size_t n);
+
+  /// 释放 allocate 返回的块，n 必须与分配时相同
+  static void deallocate(void* p, size_t n) noexcept;
+};
+
+/**
+ * @brief 基于 FramePool 的标准分配器
+ */
+template <typename T>
+class FrameAllocator {
+ public:
+  typedef T value_type;
+
+  FrameAllocator() noexcept = default;
+
+  template <typename U>
+  FrameAllocator(const FrameAllocator<U>&) noexcept {}
+
+  T* allocate(size_t n) {
+    if constexpr (alignof(T) > alignof(std::max_align_t)) {
+      return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    } else {
+      return static_cast<T*>(FramePool::allocate(n * sizeof(T)));
+    }
+  }
+
+  void deallocate(T* p, size_t n) noexcept {
+    if constexpr (alignof(T) > alignof(std::max_align_t)) {
+      ::operator delete(p, std::align_val_t(alignof(T)));
+    } else {
+      FramePool::deallocate(p, n * sizeof(T));
+    }
+  }
+
+  template <typename U>
+  bool operator==(const FrameAllocator<U>&) const noexcept {
+    return true;
+  }
+};
+
+}  // namespace Common
+
+#endif  // __COMMON_UTILS_FRAME_ALLOCATOR_H__
@@ -0,0 +1,66 @@
+#include "io_loop.h"
+
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+
+#include "latency.h"
+#include "metrics.h"
+#include "utils.h"
+
+namespace Common {
+
+IoMode parse_io_mode(const std::string& name) {
+  if (name == "block") {
+    return IoMode::kBlock;
+  }
+  if (name == "spin") {
+    return IoMode::kSpin;
+  }
+  if (name == "hybrid") {
+    return IoMode::kHybrid;
+  }
+  throw std::runtime_error("invalid io mode: " + name);
+}
+
+size_t run_io_loop(boost::asio::io_context& ctx, IoMode mode, int64_t idle_spin_us) {
+  if (mode == IoMode::kBlock) {
+    return ctx.run();
+  }
+
+  auto& parks = metrics_registry.counter("qitrader_io_parks_total", "Times the hybrid io loop went to sleep");
+  auto idle_spin_ns = idle_spin_us * 1000;
+  size_t handlers = 0;
+  int64_t last_ns = now_ns();
+  // 没有剩余工作时 poll() 会让 io_context 进入停止状态，与 run() 返回的条件一致
+  while (!ctx.stopped()) {
+    auto n = ctx.poll();
+    if (n > 0) {
+      handlers += n;
+      if (mode == IoMode::kHybrid) {
+        last_ns = now_ns();
+      }
+      continue;
+    }
+    if (mode == IoMode::kSpin || now_ns() - last_ns < idle_spin_ns) {
+      cpu_relax();
+      continue;
+    }
+    // 空闲已久，休眠到下一个事件，醒来后重新开始自旋
+    parks.inc();
+    handlers += ctx.run_one_for(std::chrono::milliseconds(100));
+    last_ns = now_ns();
+  }
+  return handlers;
+}
+
+int busy_read_us() {
+  std::ifstream in("/proc/sys/net/core/busy_read");
+  int value = -1;
+  if (!(in >> value)) {
+    return -1;
+  }
+  return value;
+}
+
+}  // namespace Common
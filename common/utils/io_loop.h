@@ -0,0 +1,54 @@
+#ifndef __COMMON_UTILS_IO_LOOP_H__
+#define __COMMON_UTILS_IO_LOOP_H__
+
+/**
+ * @file io_loop.h
+ * @brief 主线程事件循环的运行方式
+ *
+ * io_context.run() 空闲时在 epoll_wait 中休眠，每一帧行情到达都要经过一次内核唤醒和调度，
+ * 延迟通常在几到几十微秒且抖动大。自旋模式用 poll() 轮询，不进入休眠，代价是独占一个CPU核。
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <boost/asio/io_context.hpp>
+
+namespace Common {
+
+enum class IoMode {
+  kBlock,   ///< run()，空闲时休眠
+  kSpin,    ///< 一直 poll()，从不休眠
+  kHybrid,  ///< 空闲不足 idle_spin_us 时自旋，超过后 run_one_for 休眠
+};
+
+/**
+ * @brief 解析运行方式名称
+ * @param name block、spin 或 hybrid
+ * @return IoMode 运行方式
+ * @throws std::runtime_error 名称无效
+ */
+IoMode parse_io_mode(const std::string& name);
+
+/**
+ * @brief 在当前线程运行事件循环，直到 io_context 停止或没有剩余工作，语义与 run() 相同
+ * @param ctx IO上下文
+ * @param mode 运行方式
+ * @param idle_spin_us hybrid 模式下最后一个事件后继续自旋的时长（微秒）
+ * @return size_t 执行的处理函数数量
+ */
+size_t run_io_loop(boost::asio::io_context& ctx, IoMode mode, int64_t idle_spin_us);
+
+/**
+ * @brief 读取系统默认的套接字忙轮询时长 net.core.busy_read
+ *
+ * 该值是未单独设置 SO_BUSY_POLL 的套接字在阻塞读时的忙轮询时长。
+ *
+ * @return int 微秒，无法读取时返回-1
+ */
+int busy_read_us();
+
+}  // namespace Common
+
+#endif  // __COMMON_UTILS_IO_LOOP_H__
@@ -0,0 +1,94 @@
+#include "latency.h"
+
+#include <fmt/format.h>
+
+namespace Common {
+
+uint64_t LatencyHistogram::bucket_lower(int index) {
+  if (index < kSubBuckets) {
+    return static_cast<uint64_t>(index);
+  }
+  int shift = (index - kSubBuckets) / kSubBuckets;
+  uint64_t sub = (index - kSubBuckets) % kSubBuckets;
+  return (kSubBuckets + sub) << shift;
+}
+
+uint64_t LatencyHistogram::bucket_upper(int index) {
+  if (index < kSubBuckets) {
+    return static_cast<uint64_t>(index) + 1;
+  }
+  int shift = (index - kSubBuckets) / kSubBuckets;
+  return bucket_lower(index) + (uint64_t(1) << shift);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot(bool reset) {
+  Snapshot snap;
+  snap.counts.resize(kBuckets);
+  for (int i = 0; i < kBuckets; ++i) {
+    auto count = reset ? counts_[i].exchange(0, std::memory_order_relaxed) : counts_[i].load(std::memory_order_relaxed);
+    snap.counts[i] = count;
+    snap.total += count;
+  }
+  snap.max = reset ? max_.exchange(0, std::memory_order_relaxed) : max_.load(std::memory_order_relaxed);
+  return snap;
+}
+
+uint64_t LatencyHistogram::Snapshot::percentile(double q) const {
+  if (total == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(q * total);
+  if (rank >= total) {
+    rank = total - 1;
+  }
+  uint64_t seen = 0;
+  for (int i = 0; i < kBuckets; ++i) {
+    seen += counts[i];
+    if (seen > rank) {
+      // 取桶中点，且不超过观测到的最大值
+      auto mid = (bucket_lower(i) + bucket_upper(i)) / 2;
+      return max > 0 && mid > max ? max : mid;
+    }
+  }
+  return max;
+}
+
+const char* LatencyStats::stage_name(LatencyStage stage) {
+  switch (stage) {
+    case LatencyStage::kWsParse:
+      return "ws_parse";
+    case LatencyStage::kGatewayDeal:
+      return "gateway_deal";
+    case LatencyStage::kEngineQueue:
+      return "engine_queue";
+    case LatencyStage::kCallback:
+      return "callback";
+    case LatencyStage::kStrategyQueue:
+      return "strategy_queue";
+    case LatencyStage::kTickToOrder:
+      return "tick_to_order";
+    case LatencyStage::kTickToWire:
+      return "tick_to_wire";
+    case LatencyStage::kOrderRtt:
+      return "order_rtt";
+    case LatencyStage::kCount:
+      break;
+  }
+  return "unknown";
+}
+
+std::string LatencyStats::dump() {
+  std::string out;
+  for (size_t i = 0; i < histograms_.size(); ++i) {
+    auto snap = histograms_[i].snapshot(true);
+    if (snap.total == 0) {
+      continue;
+    }
+    out += fmt::format("{:<14} n={} p50={:.1f}us p99={:.1f}us p99.9={:.1f}us max={:.1f}us\n",
+                       stage_name(static_cast<LatencyStage>(i)), snap.total, snap.percentile(0.5) / 1e3,
+                       snap.percentile(0.99) / 1e3, snap.percentile(0.999) / 1e3, snap.max / 1e3);
+  }
+  return out;
+}
+
+}  // namespace Common
@@ -0,0 +1,146 @@
+#ifndef __COMMON_UTILS_LATENCY_H__
+#define __COMMON_UTILS_LATENCY_H__
+
+/**
+ * @file latency.h
+ * @brief 延迟打点与直方图
+ *
+ * 行情从WebSocket收到开始，经解析、引擎排队、回调、策略下单到订单往返，
+ * 每个阶段记录一次耗时到对应的直方图，定期输出 p50/p99/p99.9，
+ * 用于度量生产环境中 tick-to-trade 的延迟预算。
+ */
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Common {
+
+/// 单调时钟当前时间（纳秒），作为所有延迟打点的时间基准
+inline int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief 对数线性直方图（HDR风格）
+ *
+ * 每个2的幂区间再等分为32个子桶，相对误差约3%，覆盖 0 ~ 2^40 纳秒（约18分钟），
+ * 更大的值计入最后一个桶。记录只有一次原子加，无锁、不分配内存，可在任意线程调用。
+ */
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBits = 5;
+  static constexpr int kSubBuckets = 1 << kSubBits;
+  static constexpr int kMaxBits = 40;
+  static constexpr int kBuckets = kSubBuckets + (kMaxBits - kSubBits) * kSubBuckets;
+
+  /**
+   * @brief 某一时刻的直方图快照
+   */
+  struct Snapshot {
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t max = 0;
+
+    /// 分位数（纳秒），q 取值 0~1
+    uint64_t percentile(double q) const;
+  };
+
+  /// 记录一个耗时（纳秒），负值按0处理
+  void record(int64_t value_ns) {
+    uint64_t v = value_ns > 0 ? static_cast<uint64_t>(value_ns) : 0;
+    counts_[bucket_of(v)].fetch_add(1, std::memory_order_relaxed);
+    auto cur = max_.load(std::memory_order_relaxed);
+    while (v > cur && !max_.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * @brief 取出快照
+   * @param reset 是否同时清零，用于按周期统计
+   */
+  Snapshot snapshot(bool reset);
+
+  /// 桶序号
+  static int bucket_of(uint64_t v) {
+    if (v < kSubBuckets) {
+      return static_cast<int>(v);
+    }
+    int exp = 63 - std::countl_zero(v);
+    if (exp >= kMaxBits) {
+      return kBuckets - 1;
+    }
+    int shift = exp - kSubBits;
+    return kSubBuckets + shift * kSubBuckets + static_cast<int>((v >> shift) - kSubBuckets);
+  }
+
+  /// 桶的取值范围 [lower, upper)
+  static uint64_t bucket_lower(int index);
+  static uint64_t bucket_upper(int index);
+
+ private:
+  std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+  std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief 延迟统计阶段
+ */
+enum class LatencyStage {
+  kWsParse,        ///< WebSocket消息JSON解析
+  kGatewayDeal,    ///< 收到原始消息到转换为统一格式发给引擎
+  kEngineQueue,    ///< 事件在引擎通道中排队
+  kCallback,       ///< 单个事件回调执行
+  kStrategyQueue,  ///< 事件在独立策略线程的输入队列中排队
+  kTickToOrder,    ///< 行情收到到策略下单（订单管理收到）
+  kTickToWire,     ///< 行情收到到网关发出下单请求
+  kOrderRtt,       ///< 下单请求往返
+  kCount,
+};
+
+/**
+ * @brief 全部阶段的延迟直方图
+ */
+class LatencyStats {
+ public:
+  static LatencyStats& instance() {
+    static LatencyStats stats;
+    return stats;
+  }
+
+  /// 记录某阶段耗时（纳秒）
+  void record(LatencyStage stage, int64_t value_ns) { histograms_[static_cast<size_t>(stage)].record(value_ns); }
+
+  /// 记录某阶段从 start_ns 到现在的耗时，start_ns 为0时表示未打点，不记录
+  void record_since(LatencyStage stage, int64_t start_ns) {
+    if (start_ns > 0) {
+      record(stage, now_ns() - start_ns);
+    }
+  }
+
+  LatencyHistogram& histogram(LatencyStage stage) { return histograms_[static_cast<size_t>(stage)]; }
+
+  /**
+   * @brief 输出各阶段统计并清零
+   * @return std::string 每个有数据的阶段一行
+   */
+  std::string dump();
+
+  static const char* stage_name(LatencyStage stage);
+
+ private:
+  LatencyStats() = default;
+
+  std::array<LatencyHistogram, static_cast<size_t>(LatencyStage::kCount)> histograms_;
+};
+
+#define latency_stats ::Common::LatencyStats::instance()
+
+}  // namespace Common
+
+#endif  // __COMMON_UTILS_LATENCY_H__
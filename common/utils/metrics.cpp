@@ -0,0 +1,105 @@
+#include "metrics.h"
+
+#include <fmt/format.h>
+
+namespace Common {
+
+namespace {
+
+/// 直方图输出的桶边界（秒）
+constexpr double kBucketBounds[] = {1e-6, 5e-6, 1e-5, 5e-5, 1e-4, 5e-4, 1e-3, 5e-3, 1e-2, 5e-2, 0.1, 0.5, 1, 5, 10};
+
+/// 名称加标签
+std::string series(const std::string& name, const std::string& labels, const std::string& extra = "") {
+  if (labels.empty() && extra.empty()) {
+    return name;
+  }
+  if (labels.empty()) {
+    return fmt::format("{}{{{}}}", name, extra);
+  }
+  if (extra.empty()) {
+    return fmt::format("{}{{{}}}", name, labels);
+  }
+  return fmt::format("{}{{{},{}}}", name, labels, extra);
+}
+
+}  // namespace
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, const std::string& help, const char* type) {
+  auto& fam = families_[name];
+  if (fam.type.empty()) {
+    fam.help = help;
+    fam.type = type;
+  }
+  return fam;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& slot = family(name, help, "counter").counters[labels];
+  if (!slot) {
+    slot = std::make_unique<Counter>();
+  }
+  return *slot;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& slot = family(name, help, "gauge").gauges[labels];
+  if (!slot) {
+    slot = std::make_unique<Gauge>();
+  }
+  return *slot;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const std::string& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& slot = family(name, help, "histogram").histograms[labels];
+  if (!slot) {
+    slot = std::make_unique<Histogram>();
+  }
+  return *slot;
+}
+
+void MetricsRegistry::gauge_fn(const std::string& name, const std::string& help, std::function<double()> fn,
+                               const std::string& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  family(name, help, "gauge").gauge_fns[labels] = std::move(fn);
+}
+
+std::string MetricsRegistry::expose() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string out;
+  for (auto& [name, fam] : families_) {
+    out += fmt::format("# HELP {} {}\n# TYPE {} {}\n", name, fam.help, name, fam.type);
+
+    for (auto& [labels, counter] : fam.counters) {
+      out += fmt::format("{} {}\n", series(name, labels), counter->value());
+    }
+    for (auto& [labels, gauge] : fam.gauges) {
+      out += fmt::format("{} {}\n", series(name, labels), gauge->value());
+    }
+    for (auto& [labels, fn] : fam.gauge_fns) {
+      out += fmt::format("{} {}\n", series(name, labels), fn());
+    }
+    for (auto& [labels, hist] : fam.histograms) {
+      auto snap = hist->snapshot();
+      // 按边界累计，细分桶的上界不超过边界即计入，跨越边界的桶计入下一个边界
+      size_t bucket = 0;
+      uint64_t cumulative = 0;
+      for (auto bound : kBucketBounds) {
+        auto bound_ns = static_cast<uint64_t>(bound * 1e9);
+        while (bucket < snap.counts.size() && LatencyHistogram::bucket_upper(static_cast<int>(bucket)) <= bound_ns) {
+          cumulative += snap.counts[bucket++];
+        }
+        out += fmt::format("{} {}\n", series(name + "_bucket", labels, fmt::format("le=\"{}\"", bound)), cumulative);
+      }
+      out += fmt::format("{} {}\n", series(name + "_bucket", labels, "le=\"+Inf\""), snap.total);
+      out += fmt::format("{} {}\n", series(name + "_sum", labels), hist->sum_ns() / 1e9);
+      out += fmt::format("{} {}\n", series(name + "_count", labels), snap.total);
+    }
+  }
+  return out;
+}
+
+}  // namespace Common
@@ -0,0 +1,148 @@
+#ifndef __COMMON_UTILS_METRICS_H__
+#define __COMMON_UTILS_METRICS_H__
+
+/**
+ * @file metrics.h
+ * @brief 运行指标
+ *
+ * 计数器、仪表和直方图，以 Prometheus 文本格式输出。
+ * 指标在启动或首次使用时注册并缓存引用，热路径上只有原子操作；
+ * 注册表的互斥锁只在注册和抓取时使用。
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "latency.h"
+
+namespace Common {
+
+/// 缓存行大小，分片之间填充避免伪共享
+constexpr size_t kCacheLine = 64;
+
+/**
+ * @brief 分片计数器
+ *
+ * 每个线程固定写入一个分片，读取时求和，多线程高频累加时没有缓存行争用。
+ */
+class Counter {
+ public:
+  static constexpr size_t kShards = 16;
+
+  void inc(uint64_t n = 1) { shards_[shard_index()].value.fetch_add(n, std::memory_order_relaxed); }
+
+  uint64_t value() const {
+    uint64_t total = 0;
+    for (auto& shard : shards_) {
+      total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  /// 当前线程使用的分片
+  static size_t shard_index() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed) % kShards;
+    return index;
+  }
+
+ private:
+  struct alignas(kCacheLine) Shard {
+    std::atomic<uint64_t> value{0};
+  };
+  std::array<Shard, kShards> shards_;
+};
+
+/**
+ * @brief 仪表，可设置或增减的瞬时值
+ */
+class Gauge {
+ public:
+  void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+  void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+  int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  alignas(kCacheLine) std::atomic<int64_t> value_{0};
+};
+
+/**
+ * @brief 耗时直方图，单位纳秒，输出时换算为秒
+ *
+ * 内部使用对数线性直方图记录，输出时按固定边界累计为 Prometheus 的 le 桶。
+ */
+class Histogram {
+ public:
+  void observe(int64_t value_ns) {
+    hist_.record(value_ns);
+    sum_ns_.fetch_add(value_ns > 0 ? value_ns : 0, std::memory_order_relaxed);
+  }
+
+  /// 记录从 start_ns 到现在的耗时
+  void observe_since(int64_t start_ns) { observe(now_ns() - start_ns); }
+
+  LatencyHistogram::Snapshot snapshot() { return hist_.snapshot(false); }
+  uint64_t sum_ns() const { return sum_ns_.load(std::memory_order_relaxed); }
+
+ private:
+  LatencyHistogram hist_;
+  std::atomic<uint64_t> sum_ns_{0};
+};
+
+/**
+ * @brief 指标注册表
+ *
+ * 同名指标可以有多组标签，标签写成 Prometheus 格式，如 type="tick"。
+ * 返回的引用在进程生命周期内有效。
+ */
+class MetricsRegistry {
+ public:
+  static MetricsRegistry& instance() {
+    static MetricsRegistry registry;
+    return registry;
+  }
+
+  Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+  Gauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+  Histogram& histogram(const std::string& name, const std::string& help, const std::string& labels = "");
+
+  /**
+   * @brief 注册抓取时计算的仪表
+   * @param fn 抓取时调用，需要线程安全
+   */
+  void gauge_fn(const std::string& name, const std::string& help, std::function<double()> fn,
+                const std::string& labels = "");
+
+  /// 以 Prometheus 文本格式输出所有指标
+  std::string expose();
+
+ private:
+  MetricsRegistry() = default;
+
+  /// 同名指标的一组
+  struct Family {
+    std::string help;
+    std::string type;
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+    std::map<std::string, std::unique_ptr<Gauge>> gauges;
+    std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    std::map<std::string, std::function<double()>> gauge_fns;
+  };
+
+  Family& family(const std::string& name, const std::string& help, const char* type);
+
+  std::mutex mutex_;
+  std::map<std::string, Family> families_;
+};
+
+#define metrics_registry ::Common::MetricsRegistry::instance()
+
+}  // namespace Common
+
+#endif  // __COMMON_UTILS_METRICS_H__
@@ -0,0 +1,88 @@
+#ifndef __COMMON_UTILS_SPSC_QUEUE_HPP__
+#define __COMMON_UTILS_SPSC_QUEUE_HPP__
+
+/**
+ * @file spsc_queue.hpp
+ * @brief 单生产者单消费者无锁环形队列
+ *
+ * 用于两个固定线程之间传递事件：生产者只写 tail_，消费者只写 head_，
+ * 各自缓存对方的位置，只有缓存显示队列满或空时才读取对方的原子变量，减少缓存行来回同步。
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+#include "metrics.h"
+
+namespace Common {
+
+template <typename T>
+class SpscQueue {
+ public:
+  /**
+   * @param capacity 容量，向上取整为2的幂
+   */
+  explicit SpscQueue(size_t capacity)
+      : mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1), slots_(new T[mask_ + 1]) {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /**
+   * @brief 写入一个元素，只能在生产者线程调用
+   * @return bool 队列满时返回false，value 不被移动
+   */
+  bool try_push(T&& value) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ > mask_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ > mask_) {
+        return false;
+      }
+    }
+    slots_[tail & mask_] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief 取出一个元素，只能在消费者线程调用
+   * @return bool 队列空时返回false
+   */
+  bool try_pop(T& value) {
+    auto head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_) {
+        return false;
+      }
+    }
+    // 取出后重置槽位，及时释放元素持有的资源
+    value = std::move(slots_[head & mask_]);
+    slots_[head & mask_] = T();
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// 当前元素数，另一线程同时读写时只是近似值
+  size_t size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  const size_t mask_;
+  std::unique_ptr<T[]> slots_;
+
+  alignas(kCacheLine) std::atomic<size_t> head_{0};  ///< 消费者写
+  size_t tail_cache_ = 0;                            ///< 消费者缓存的 tail_
+
+  alignas(kCacheLine) std::atomic<size_t> tail_{0};  ///< 生产者写
+  size_t head_cache_ = 0;                            ///< 生产者缓存的 head_
+};
+
+}  // namespace Common
+
+#endif  // __COMMON_UTILS_SPSC_QUEUE_HPP__
@@ -1,6 +1,10 @@
 #include "utils.h"
 
 #include <ctime>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 #include <string>
 #include <cryptopp/base64.h>
 #include <cryptopp/hex.h>
@@ -30,10 +34,35 @@ std::string Common::sha256_hash_base64(const std::string& input, const std::stri
   return encoded;
 }
 
+std::string Common::sha256_hash_hex(const std::string& input, const std::string& key) {
+  std::string encoded;
+  CryptoPP::HMAC<CryptoPP::SHA256> hmac((const CryptoPP::byte*)key.data(), key.size());
+
+  // 计算SHA-256哈希值并转为小写十六进制
+  CryptoPP::StringSource stringSrc(
+      input, true, new CryptoPP::HashFilter(hmac, new CryptoPP::HexEncoder(new CryptoPP::StringSink(encoded), false)));
+
+  return encoded;
+}
+
 extern int64_t Common::get_current_time_s() {
   return std::time(nullptr);
 }
 
+extern bool Common::pin_current_thread(int cpu) {
+  if (cpu < 0) {
+    return false;
+  }
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
 extern std::string Common::time_format_iso(const int64_t& time) {
   std::time_t t = static_cast<std::time_t>(time);
   char buf[sizeof "2011-10-08T07:07:09.000Z"];
@@ -74,6 +74,14 @@ namespace Common {
  */
 extern std::string sha256_hash_base64(const std::string& input, const std::string& key);
 
+/**
+ * @brief 计算SHA256哈希并返回小写十六进制编码
+ * @param input 输入字符串
+ * @param key 密钥
+ * @return std::string 十六进制编码的哈希值
+ */
+extern std::string sha256_hash_hex(const std::string& input, const std::string& key);
+
 /**
  * @brief 获取当前时间戳（秒）
  * @return int64_t 当前时间戳
@@ -87,6 +95,24 @@ extern int64_t get_current_time_s();
  */
 extern std::string time_format_iso(const int64_t& time);
 
+/**
+ * @brief 把当前线程绑定到指定CPU核
+ * @param cpu CPU编号，小于0时不绑定
+ * @return bool 是否绑定成功，不支持的平台返回false
+ */
+extern bool pin_current_thread(int cpu);
+
+/**
+ * @brief 忙等循环中的让步提示，降低自旋对同核超线程和功耗的影响
+ */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
 /**
  * @brief 单例模式模板类
  * 
@@ -1,16 +1,74 @@
 #include "engine.h"
 #include "glog/logging.h"
 
+#include <boost/asio/bind_allocator.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "utils/async_log.h"
+#include "utils/frame_allocator.h"
+#include "utils/latency.h"
+
 namespace engine {
 
+const char* event_type_name(EventType type) {
+  switch (type) {
+    case EventType::kQuit: return "quit";
+    case EventType::kSubscribeTick: return "subscribe_tick";
+    case EventType::kTick: return "tick";
+    case EventType::kSubscribeBook: return "subscribe_book";
+    case EventType::kBook: return "book";
+    case EventType::kConsolidatedQuote: return "consolidated_quote";
+    case EventType::kBar: return "bar";
+    case EventType::kSendOrder: return "send_order";
+    case EventType::kSubmitOrder: return "submit_order";
+    case EventType::kCancelOrder: return "cancel_order";
+    case EventType::kRouteOrder: return "route_order";
+    case EventType::kParentOrder: return "parent_order";
+    case EventType::kAlgoOrder: return "algo_order";
+    case EventType::kCancelAlgo: return "cancel_algo";
+    case EventType::kAlgoStatus: return "algo_status";
+    case EventType::kQueryOrder: return "query_order";
+    case EventType::kOrder: return "order";
+    case EventType::kSubscribeTrade: return "subscribe_trade";
+    case EventType::kTrade: return "trade";
+    case EventType::kFill: return "fill";
+    case EventType::kRiskReject: return "risk_reject";
+    case EventType::kQueryPosition: return "query_position";
+    case EventType::kPosition: return "position";
+    case EventType::kQueryAccount: return "query_account";
+    case EventType::kAccount: return "account";
+    case EventType::kMessage: return "message";
+    case EventType::kRateLimit: return "rate_limit";
+    case EventType::kAll: return "all";
+  }
+  return "unknown";
+}
+
 // 初始化引擎，创建容量为1000的并发事件通道
-Engine::Engine(asio::io_context& ctx, size_t channel_size) : channel_(ctx, channel_size) {}
+Engine::Engine(asio::io_context& ctx, size_t channel_size)
+    : channel_(ctx, channel_size), timers_(steady_now_ms()), timer_driver_(ctx) {
+  for (size_t i = 0; i < kEventTypes; ++i) {
+    auto label = fmt::format("type=\"{}\"", event_type_name(static_cast<EventType>(i)));
+    event_counters_[i] = &metrics_registry.counter("qitrader_events_total", "Events dispatched by type", label);
+    callback_errors_[i] =
+        &metrics_registry.counter("qitrader_callback_errors_total", "Event callbacks that threw by type", label);
+  }
+  queue_depth_ = &metrics_registry.gauge("qitrader_engine_queue_depth", "Events waiting in the engine channel");
+  metrics_registry.gauge_fn("qitrader_timers", "Pending engine timers", [this] { return double(timers_.size()); });
+}
 
 Engine::~Engine() {}
 
 // 将事件发送到并发通道，由主事件循环处理
 asio::awaitable<void> Engine::on_event(EventType etype, std::shared_ptr<const BaseData> event) {
-  co_await channel_.async_send(boost::system::error_code(), std::make_shared<Event>(etype, event), asio::use_awaitable);
+  // Event 与控制块从线程本地的回收链表分配
+  auto ev = std::allocate_shared<Event>(Common::FrameAllocator<Event>(), etype, event);
+  ev->enqueue_ns = Common::now_ns();
+  queue_depth_->add(1);
+  co_await channel_.async_send(boost::system::error_code(), ev, asio::use_awaitable);
 }
 
 asio::awaitable<void> Engine::run() {
@@ -26,56 +84,75 @@ asio::awaitable<void> Engine::run() {
       try {
         co_await component->run();
       } catch (boost::system::system_error &e) {
-        LOG(ERROR) << fmt::format("Component run error: {}", e.what());
+        QLOG(ERROR, "Component run error: {}", e.what());
       } catch (std::runtime_error &e) {
-        LOG(ERROR) << fmt::format("Component run error: {}", e.what());
+        QLOG(ERROR, "Component run error: {}", e.what());
       } catch (...) {
-        LOG(ERROR) << fmt::format("Component run error: unknown error");
+        QLOG(ERROR, "Component run error: unknown error");
       }
     }, asio::detached);
   }
 
+  // 启动时间轮驱动
+  asio::co_spawn(co_await asio::this_coro::executor, timer_loop(), asio::detached);
+
   LOG(INFO) << "Engine start";
 
   // 第三阶段：进入主事件循环，从通道中接收并分发事件
   auto executor = co_await asio::this_coro::executor;
+  // 回调协程的完成处理器关联回收分配器，协程帧本身由 asio 的线程本地缓存回收
+  auto detached = asio::bind_allocator(Common::FrameAllocator<void>(), asio::detached);
   while (true) {
     try {
       // 从通道中异步接收事件
       auto event = co_await channel_.async_receive(asio::use_awaitable);
+      latency_stats.record_since(Common::LatencyStage::kEngineQueue, event->enqueue_ns);
+      queue_depth_->add(-1);
+      auto index = static_cast<size_t>(event->type);
+      event_counters_[index]->inc();
+      auto errors = callback_errors_[index];
       // 获取该事件类型对应的所有回调函数
       auto& callbacks = callbacks_[event->type];
       // 为每个回调函数启动一个独立的协程
       for (auto& callback : callbacks) {
         // 异步执行回调，并捕获异常防止单个回调失败影响整个系统
-        asio::co_spawn(executor, [callback, event]() -> asio::awaitable<void> {
+        asio::co_spawn(executor, [callback, event, errors]() -> asio::awaitable<void> {
+          auto start_ns = Common::now_ns();
           try {
-            co_await callback(event);
+            co_await (*callback)(event);
           } catch (boost::system::system_error &e) {
-            LOG(ERROR) << fmt::format("Type {} callback error: {}", int(event->type), e.what());
+            errors->inc();
+            QLOG(ERROR, "{} callback error: {}", event_type_name(event->type), e.what());
           } catch (std::runtime_error &e) {
-            LOG(ERROR) << fmt::format("Type {} callback error: {}", int(event->type), e.what());
+            errors->inc();
+            QLOG(ERROR, "{} callback error: {}", event_type_name(event->type), e.what());
           } catch (...) {
-            LOG(ERROR) << fmt::format("Type {} callback error: unknown error", int(event->type)); 
+            errors->inc();
+            QLOG(ERROR, "{} callback error: unknown error", event_type_name(event->type));
           }
+          // 包含回调中异步等待的时间
+          latency_stats.record_since(Common::LatencyStage::kCallback, start_ns);
           co_return;
-        }, asio::detached);
+        }, detached);
       }
 
       // 处理注册了kAll类型的回调，这些回调会接收所有类型的事件
       auto& all_callbacks = callbacks_[EventType::kAll];
       for (auto& callback : all_callbacks) {
-        asio::co_spawn(executor, [callback, event]() -> asio::awaitable<void> {
+        asio::co_spawn(executor, [callback, event, errors]() -> asio::awaitable<void> {
           try {
-            co_await callback(event);
+            co_await (*callback)(event);
           } catch (boost::system::system_error &e) {
-            LOG(ERROR) << fmt::format("Type {} callback error: {}", int(event->type), e.what());
+            errors->inc();
+            QLOG(ERROR, "{} callback error: {}", event_type_name(event->type), e.what());
           } catch (std::runtime_error &e) {
-            LOG(ERROR) << fmt::format("Type {} callback error: {}", int(event->type), e.what());
+            errors->inc();
+            QLOG(ERROR, "{} callback error: {}", event_type_name(event->type), e.what());
           } catch (...) {
-            LOG(ERROR) << fmt::format("Type {} callback error: unknown error", int(event->type)); 
+            errors->inc();
+            QLOG(ERROR, "{} callback error: unknown error", event_type_name(event->type));
           }
-        }, asio::detached);
+        }, detached);
       }
     } catch (...) {
       // 忽略事件接收异常，继续处理下一个事件
@@ -88,4 +165,66 @@ void Engine::register_component(std::shared_ptr<Component> component) {
   components_.push_back(component);
 }
 
+int64_t Engine::steady_now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+TimerWheel::TimerId Engine::schedule_timer(int64_t delay_ms, TimerWheel::Callback callback) {
+  sync_timers();
+  auto id = timers_.schedule(delay_ms, std::move(callback));
+  wake_timer_driver();
+  return id;
+}
+
+bool Engine::cancel_timer(TimerWheel::TimerId id) {
+  // 驱动协程按旧的截止时间醒来后重新计算，不需要唤醒
+  return timers_.cancel(id);
+}
+
+bool Engine::reschedule_timer(TimerWheel::TimerId id, int64_t delay_ms) {
+  sync_timers();
+  if (!timers_.reschedule(id, delay_ms)) {
+    return false;
+  }
+  wake_timer_driver();
+  return true;
+}
+
+void Engine::sync_timers() {
+  // 驱动协程休眠期间时间轮不推进，先对齐到当前时间再计算到期时间；
+  // 只推进到最早到期时间之前，不在调用方的上下文里触发回调
+  auto now = steady_now_ms();
+  if (!timers_.empty()) {
+    now = std::min(now, timers_.next_deadline() - 1);
+  }
+  timers_.advance(now);
+}
+
+void Engine::wake_timer_driver() {
+  // 新的最早到期时间早于驱动协程的休眠截止时间时提前唤醒
+  if (timers_.next_deadline() < timer_wake_ms_) {
+    timer_wake_ms_ = 0;
+    timer_driver_.cancel();
+  }
+}
+
+asio::awaitable<void> Engine::timer_loop() {
+  while (true) {
+    // 休眠到最早的到期时间，没有定时器时一直挂起
+    timer_wake_ms_ = timers_.next_deadline();
+    if (timer_wake_ms_ == std::numeric_limits<int64_t>::max()) {
+      timer_driver_.expires_at(asio::steady_timer::time_point::max());
+    } else {
+      timer_driver_.expires_at(asio::steady_timer::time_point(std::chrono::milliseconds(timer_wake_ms_)));
+    }
+
+    // 被 schedule_timer 取消时同样返回，重新计算截止时间
+    boost::system::error_code ec;
+    co_await timer_driver_.async_wait(asio::redirect_error(asio::use_awaitable, ec));
+    timer_wake_ms_ = 0;
+    timers_.advance(steady_now_ms());
+  }
+}
+
 }
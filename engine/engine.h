@@ -2,10 +2,14 @@
 #define __MARKET_BASE_ENGINE_H__
 
 #include <boost/asio/experimental/concurrent_channel.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <memory>
 #include <string>
 #include "utils/utils.h"
 #include "object.h"
+#include "timer_wheel.h"
+#include "utils/metrics.h"
+#include <array>
 #include <map>
 #include <set>
 #include <glog/logging.h>
@@ -33,6 +37,9 @@ public:
   virtual asio::awaitable<void> init() = 0;
 };
 
+/// 事件类型名称，用于日志和指标标签
+const char* event_type_name(EventType type);
+
 /// 事件回调函数类型，用于处理特定类型的事件
 typedef std::function<asio::awaitable<void>(EventPtr)> EventCallback;
 
@@ -87,11 +94,11 @@ public:
   template<typename EventDataType>
   void register_callback(EventType type, std::function<asio::awaitable<void>(std::shared_ptr<const EventDataType>)> callback) {
     // 将类型化的回调函数封装为通用回调，并添加到回调列表
-    callbacks_[type].push_back([callback](EventPtr event) -> asio::awaitable<void> {
+    callbacks_[type].push_back(std::make_shared<const EventCallback>([callback](EventPtr event) -> asio::awaitable<void> {
       auto data = std::dynamic_pointer_cast<const EventDataType>(event->data);
       co_await callback(data);
       co_return;
-    });
+    }));
   }
 
   /**
@@ -99,16 +106,73 @@ public:
    * @param component 要注册的组件
    */
   void register_component(std::shared_ptr<Component> component);
+
+  /**
+   * @brief 添加定时器
+   *
+   * 所有定时器由引擎的分层时间轮统一管理，回调在引擎执行器上批量触发。
+   * 回调是同步函数，需要异步操作时自行 co_spawn。
+   *
+   * @param delay_ms 延迟（毫秒）
+   * @param callback 到期回调
+   * @return TimerWheel::TimerId 定时器ID
+   */
+  TimerWheel::TimerId schedule_timer(int64_t delay_ms, TimerWheel::Callback callback);
+
+  /**
+   * @brief 取消定时器
+   * @param id 定时器ID
+   * @return bool 定时器是否存在
+   */
+  bool cancel_timer(TimerWheel::TimerId id);
+
+  /**
+   * @brief 修改定时器到期时间
+   * @param id 定时器ID
+   * @param delay_ms 从当前时间起的新延迟（毫秒）
+   * @return bool 定时器是否存在
+   */
+  bool reschedule_timer(TimerWheel::TimerId id, int64_t delay_ms);
+
+  /// 单调时钟当前时间（毫秒）
+  static int64_t steady_now_ms();
   
 private:
+  /// 时间轮驱动协程，休眠到最早的到期时间后推进，没有定时器时挂起
+  asio::awaitable<void> timer_loop();
+
+  /// 把时间轮对齐到当前时间，不触发回调
+  void sync_timers();
+
+  /// 最早到期时间提前时唤醒驱动协程
+  void wake_timer_driver();
+
   /// 并发事件通道，用于在协程间传递事件，容量为1000
   boost::asio::experimental::concurrent_channel<void(boost::system::error_code, EventPtr)> channel_;
   
-  /// 事件类型到回调函数列表的映射
-  std::map<EventType, std::vector<EventCallback>> callbacks_;
+  /// 事件类型到回调函数列表的映射，分发时只复制指针，不复制 std::function
+  std::map<EventType, std::vector<std::shared_ptr<const EventCallback>>> callbacks_;
   
   /// 所有注册的组件列表
   std::vector<std::shared_ptr<Component>> components_;
+
+  /// 分层时间轮
+  TimerWheel timers_;
+
+  /// 驱动时间轮的asio定时器
+  asio::steady_timer timer_driver_;
+
+  /// 驱动协程当前休眠到的时间（毫秒），0 表示已醒来、即将重新计算
+  int64_t timer_wake_ms_ = 0;
+
+  static constexpr size_t kEventTypes = static_cast<size_t>(EventType::kAll) + 1;
+
+  /// 按事件类型统计的事件数和回调异常数，构造时注册
+  std::array<Common::Counter*, kEventTypes> event_counters_{};
+  std::array<Common::Counter*, kEventTypes> callback_errors_{};
+
+  /// 通道中待处理（含等待发送）的事件数
+  Common::Gauge* queue_depth_ = nullptr;
 };
 
 typedef std::shared_ptr<Engine> EnginePtr;
@@ -31,6 +31,8 @@ class BaseData : public std::enable_shared_from_this<BaseData> {
   std::string symbol;    ///< 交易对符号，如"BTC-USDT"
   std::string exchange;  ///< 交易所名称，如"okx"
   int64_t timestamp_ms;  ///< 时间戳（毫秒）
+
+  int64_t recv_ns = 0;  ///< 网关收到原始消息的时间（单调时钟纳秒），下单时沿用触发行情的值，用于延迟统计
 };
 
 /**
@@ -46,12 +48,26 @@ enum class EventType {
 
   kSubscribeBook,  ///< 订阅订单簿请求
   kBook,           ///< 订单簿数据事件
-
-  kSendOrder,   ///< 发送订单请求
+  kConsolidatedQuote,  ///< 跨交易所合并最优买卖价事件
+
+  kBar,  ///< K线收盘事件
+
+  kSendOrder,    ///< 发送订单请求（策略发出，由订单管理处理）
+  kSubmitOrder,  ///< 提交订单请求（订单管理登记后发出，由网关处理）
+  kCancelOrder,  ///< 撤单请求（由网关处理）
+  kRouteOrder,   ///< 母单路由请求（策略发出，由智能路由拆分到各交易所）
+  kParentOrder,  ///< 母单状态事件（智能路由汇总子单回报后发出）
+  kAlgoOrder,    ///< 算法单请求（策略发出，由算法执行组件处理）
+  kCancelAlgo,   ///< 停止算法单请求
+  kAlgoStatus,   ///< 算法单状态事件
   kQueryOrder,  ///< 查询订单请求
   kOrder,       ///< 订单数据事件
 
-  kTrade,  ///< 成交数据事件
+  kSubscribeTrade,  ///< 订阅市场逐笔成交请求
+  kTrade,           ///< 成交数据事件（市场逐笔成交）
+  kFill,   ///< 本账户订单成交事件
+
+  kRiskReject,  ///< 订单被风控拒绝事件
 
   kQueryPosition,  ///< 查询持仓请求
   kPosition,       ///< 持仓数据事件
@@ -61,6 +77,8 @@ enum class EventType {
 
   kMessage,  ///< 通用消息事件
 
+  kRateLimit,  ///< 交易所接口剩余额度事件
+
   kAll,  ///< 特殊类型，表示接收所有类型的事件
 };
 
@@ -75,6 +93,7 @@ class Event : public std::enable_shared_from_this<Event> {
   }
   EventType type;                        ///< 事件类型
   std::shared_ptr<const BaseData> data;  ///< 事件数据
+  int64_t enqueue_ns = 0;                ///< 进入引擎通道的时间（单调时钟纳秒）
 };
 
 typedef std::shared_ptr<const Event> EventPtr;
@@ -104,6 +123,26 @@ class Book : public BaseData {
 
 typedef std::shared_ptr<const Book> BookPtr;
 
+/**
+ * @brief 跨交易所合并后的最优买卖价
+ *
+ * symbol 为统一后的交易对名称，exchange 为空。同一价格有多个交易所挂单时，
+ * 数量为各交易所之和，bid_exchange/ask_exchange 为其中数量最大的交易所。
+ */
+class ConsolidatedQuote : public BaseData {
+ public:
+  dec_float bid_price;       ///< 合并买一价
+  dec_float bid_volume;      ///< 合并买一价上各交易所数量之和
+  std::string bid_exchange;  ///< 买一价上数量最大的交易所
+  dec_float ask_price;       ///< 合并卖一价
+  dec_float ask_volume;      ///< 合并卖一价上各交易所数量之和
+  std::string ask_exchange;  ///< 卖一价上数量最大的交易所
+
+  const static EventType type = EventType::kConsolidatedQuote;
+};
+
+typedef std::shared_ptr<const ConsolidatedQuote> ConsolidatedQuotePtr;
+
 /**
  * @brief Tick数据，包含实时价格和成交信息
  */
@@ -112,6 +151,7 @@ class TickData : public BaseData {
   dec_float last_price;   ///< 最新成交价
   dec_float last_volume;  ///< 最新成交量
   dec_float turnover;     ///< 成交额
+  dec_float volume_24h;   ///< 24小时成交量，增加时表示本次推送包含新成交，交易所不提供时为0
 
   dec_float open_price;        ///< 24小时开盘价
   dec_float high_price;        ///< 24小时最高价
@@ -124,6 +164,8 @@ class TickData : public BaseData {
 
 /**
  * @brief K线数据（Bar数据）
+ *
+ * timestamp_ms 为K线开始时间，按周期对齐。
  */
 class BarData : public BaseData {
  public:
@@ -135,8 +177,14 @@ class BarData : public BaseData {
   dec_float high_price;   ///< 最高价
   dec_float low_price;    ///< 最低价
   dec_float close_price;  ///< 收盘价
+
+  bool history = false;  ///< 是否为启动时从历史数据回补的K线
+
+  const static EventType type = EventType::kBar;
 };
 
+typedef std::shared_ptr<const BarData> BarDataPtr;
+
 /**
  * @brief 交易方向
  */
@@ -159,20 +207,27 @@ enum class OrderStatus {
  */
 enum class OrderType { LIMIT, MARKET };
 
+class TradeData;
+
 /**
  * @brief 订单数据项
  */
 class OrderDataItem : public BaseData {
  public:
-  std::string order_id;  ///< 订单ID
+  std::string order_id;         ///< 订单ID（交易所分配）
+  std::string client_order_id;  ///< 客户端订单ID，未填写时由订单管理分配
 
   Direction direction;      ///< 交易方向
   dec_float price;          ///< 订单价格
   dec_float volume;         ///< 订单数量
   dec_float filled_volume;  ///< 已成交数量
+  dec_float avg_price;      ///< 成交均价
+
+  OrderType otype = OrderType::LIMIT;            ///< 订单类型
+  OrderStatus status = OrderStatus::SUBMITTING;  ///< 订单状态
 
-  OrderType otype;     ///< 订单类型
-  OrderStatus status;  ///< 订单状态
+  /// 本次回报对应的成交明细，交易所随订单推送成交时由网关填写，否则为空
+  std::shared_ptr<const TradeData> fill;
 };
 
 typedef std::shared_ptr<const OrderDataItem> OrderDataItemPtr;
@@ -183,27 +238,107 @@ typedef std::shared_ptr<const OrderDataItem> OrderDataItemPtr;
 class OrderData : public BaseData {
  public:
   std::vector<OrderDataItemPtr> items;  ///< 订单列表
+
+  /// 是否为全量挂单查询的结果：本交易所未包含在内的订单已不在挂单中
+  bool snapshot = false;
 };
 
 typedef std::shared_ptr<const OrderData> OrderDataPtr;
 
 /**
  * @brief 成交数据
+ *
+ * 市场逐笔成交以 kTrade 发出；本账户订单的成交以 kFill 发出，此时 order 指向所属订单。
  */
 class TradeData : public BaseData {
  public:
   std::string trade_id;  ///< 成交ID
 
-  Direction direction;  ///< 交易方向
+  Direction direction;  ///< 交易方向，市场逐笔成交中为主动成交方（taker）的方向
   dec_float price;      ///< 成交价格
   dec_float volume;     ///< 成交数量
   OrderDataPtr order;   ///< 关联的订单
 
+  dec_float fee;             ///< 手续费，负数为扣除、正数为返佣，仅本账户成交
+  std::string fee_currency;  ///< 手续费币种，仅本账户成交
+  bool maker = false;        ///< 是否为挂单方成交，仅本账户成交
+
   const static EventType type = EventType::kTrade;
 };
 
 typedef std::shared_ptr<const TradeData> TradeDataPtr;
 
+/**
+ * @brief 执行算法类型
+ */
+enum class AlgoType {
+  TWAP,     ///< 按时间均匀释放数量
+  VWAP,     ///< 按市场实时成交量的比例释放数量
+  ICEBERG,  ///< 一次只显示部分数量
+};
+
+/**
+ * @brief 算法单请求
+ *
+ * 算法把总数量拆成子单，以己方最优价挂出（买单挂买一、卖单挂卖一，不超过限价），
+ * 盘口移动后撤单重挂，不主动吃单。
+ */
+class AlgoOrderData : public BaseData {
+ public:
+  std::string algo_id;  ///< 算法单ID，未填写时由算法执行组件分配
+
+  AlgoType algo = AlgoType::TWAP;  ///< 算法类型
+  Direction direction;             ///< 交易方向
+  dec_float price;                 ///< 限价，0 表示只跟随盘口
+  dec_float volume;                ///< 总数量
+
+  int64_t duration_ms = 0;   ///< TWAP/VWAP 的执行时长，到期后释放全部剩余数量
+  int64_t interval_ms = 0;   ///< 检查盘口和释放数量的间隔，0 使用配置的默认值
+  dec_float display_volume;  ///< 每笔子单最大数量，0 表示不限制；冰山单为显示数量
+  dec_float participation;   ///< VWAP 跟随市场成交量的比例，如 0.1
+
+  const static EventType type = EventType::kAlgoOrder;
+};
+
+typedef std::shared_ptr<const AlgoOrderData> AlgoOrderDataPtr;
+
+/**
+ * @brief 算法单状态
+ *
+ * 成交量或状态变化时发出，进入 FILLED/CANCELLED 后算法单结束。
+ */
+class AlgoStatusData : public BaseData {
+ public:
+  std::string algo_id;  ///< 算法单ID
+
+  AlgoType algo;            ///< 算法类型
+  Direction direction;      ///< 交易方向
+  dec_float volume;         ///< 总数量
+  dec_float filled_volume;  ///< 已成交数量
+  dec_float avg_price;      ///< 成交均价
+  size_t child_orders = 0;  ///< 已发出的子单数
+
+  OrderStatus status = OrderStatus::PENDING;  ///< 状态，PENDING 表示执行中
+
+  const static EventType type = EventType::kAlgoStatus;
+};
+
+typedef std::shared_ptr<const AlgoStatusData> AlgoStatusDataPtr;
+
+/**
+ * @brief 风控拒单数据
+ */
+class RiskRejectData : public BaseData {
+ public:
+  OrderDataItemPtr order;  ///< 被拒绝的订单
+  int code;                ///< 拒绝原因代码
+  std::string reason;      ///< 拒绝原因说明
+
+  const static EventType type = EventType::kRiskReject;
+};
+
+typedef std::shared_ptr<const RiskRejectData> RiskRejectDataPtr;
+
 /**
  * @brief 持仓数据项
  */
@@ -228,6 +363,9 @@ class PositionData : public BaseData {
  public:
   std::vector<PositionItemPtr> items;  ///< 持仓列表
 
+  /// 是否为全量查询的结果：本交易所未包含在内的交易对没有持仓；推送通常只包含变化的部分
+  bool snapshot = false;
+
   const static EventType type = EventType::kPosition;
 };
 
@@ -278,9 +416,16 @@ class QueryPositionData : public BaseData {
 
 typedef std::shared_ptr<const QueryPositionData> QueryPositionDataPtr;
 
-/// 查询订单请求数据
+/**
+ * @brief 查询订单请求数据
+ *
+ * 未指定 client_order_id 时查询全部挂单，回报标记为快照；
+ * 指定时按 symbol + client_order_id 查询单笔订单，包括已完成的，交易所不存在该订单时以 REJECTED 回报。
+ */
 class QueryOrderData : public BaseData {
  public:
+  std::string client_order_id;  ///< 客户端订单ID
+
   const static EventType type = EventType::kQueryOrder;
 };
 
@@ -299,11 +444,35 @@ class MessageData : public BaseData {
 
 typedef std::shared_ptr<const MessageData> MessageDataPtr;
 
+/**
+ * @brief 交易所接口限速额度
+ *
+ * symbol 为限速的标的范围（如OKX的标的族），按账户限速的接口为空。
+ */
+class RateLimitData : public BaseData {
+ public:
+  std::string endpoint;  ///< 接口
+  double remaining;      ///< 当前窗口剩余请求数，负数表示已有请求排队
+  double capacity;       ///< 窗口容量
+  size_t queued;         ///< 网关中排队等待发送的请求数
+
+  const static EventType type = EventType::kRateLimit;
+};
+
+typedef std::shared_ptr<const RateLimitData> RateLimitDataPtr;
+
 /**
  * @brief 订阅请求数据
+ *
+ * 订阅订单簿时可以选择深度和推送速度，网关映射到最接近的频道，
+ * 例如只需要盘口时用逐笔的最优买卖价，避免全深度数据的解析开销。
  */
 class SubscribeData : public BaseData {
  public:
+  uint32_t depth = 400;       ///< 每侧需要的档位数，1 表示只要最优买卖价
+  bool tick_by_tick = false;  ///< 订单簿：是否需要逐笔推送（约10ms），否则为定时推送（约100ms）；
+                              ///< 成交：是否需要每一笔成交，否则同一主动单的成交可能合并推送
+
   const static EventType type = EventType::kSubscribeBook;
 };
 
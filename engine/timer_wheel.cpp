@@ -0,0 +1,230 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+
+#include "utils/async_log.h"
+
+namespace engine {
+
+TimerWheel::TimerWheel(int64_t now_ms) : now_(now_ms) {
+  for (auto& level : slots_) {
+    for (auto& slot : level) {
+      slot = kNil;
+    }
+  }
+}
+
+TimerWheel::TimerId TimerWheel::schedule(int64_t delay_ms, Callback callback) {
+  int32_t index;
+  if (free_head_ != kNil) {
+    index = free_head_;
+    free_head_ = nodes_[index].next;
+  } else {
+    index = static_cast<int32_t>(nodes_.size());
+    nodes_.emplace_back();
+  }
+
+  auto& node = nodes_[index];
+  node.deadline = now_ + (delay_ms > 0 ? delay_ms : 1);
+  node.callback = std::move(callback);
+  link(index);
+  ++size_;
+  return (static_cast<TimerId>(node.generation) << 32) | static_cast<uint32_t>(index);
+}
+
+bool TimerWheel::cancel(TimerId id) {
+  auto index = lookup(id);
+  if (index == kNil) {
+    return false;
+  }
+
+  unlink(index);
+  auto& node = nodes_[index];
+  node.callback = nullptr;
+  ++node.generation;  // 使旧ID失效
+  node.next = free_head_;
+  free_head_ = index;
+  --size_;
+  return true;
+}
+
+bool TimerWheel::reschedule(TimerId id, int64_t delay_ms) {
+  auto index = lookup(id);
+  if (index == kNil) {
+    return false;
+  }
+
+  unlink(index);
+  nodes_[index].deadline = now_ + (delay_ms > 0 ? delay_ms : 1);
+  link(index);
+  return true;
+}
+
+size_t TimerWheel::advance(int64_t now_ms) {
+  // 没有定时器时直接跳到目标时间
+  if (size_ == 0) {
+    now_ = std::max(now_, now_ms);
+    return 0;
+  }
+
+  firing_.clear();
+  while (now_ < now_ms) {
+    ++now_;
+
+    // 低层转完一圈时，把高层对应槽的定时器下放
+    if ((now_ & kSlotMask) == 0) {
+      int level = 1;
+      for (; level < kLevels; ++level) {
+        int64_t slot = (now_ >> (kSlotBits * level)) & kSlotMask;
+        cascade(level, slot);
+        if (slot != 0) {
+          break;
+        }
+      }
+      // 最高层也转完一圈，重新分配溢出列表
+      if (level == kLevels) {
+        auto index = overflow_;
+        overflow_ = kNil;
+        while (index != kNil) {
+          auto next = nodes_[index].next;
+          nodes_[index].head = nullptr;
+          link(index);
+          index = next;
+        }
+      }
+    }
+
+    // 摘下第0层当前槽的全部定时器
+    auto& slot = slots_[0][now_ & kSlotMask];
+    while (slot != kNil) {
+      auto index = slot;
+      auto& node = nodes_[index];
+      unlink(index);
+      firing_.push_back(std::move(node.callback));
+      node.callback = nullptr;
+      ++node.generation;
+      node.next = free_head_;
+      free_head_ = index;
+      --size_;
+    }
+
+    if (size_ == 0) {
+      now_ = std::max(now_, now_ms);
+      break;
+    }
+  }
+
+  // 全部摘下后移到局部再回调，回调中可以安全地添加或取消定时器；
+  // 回调经 Engine::schedule_timer 重入 advance 时会清空 firing_，不能在遍历它的同时回调
+  std::vector<Callback> firing;
+  firing.swap(firing_);
+  for (auto& callback : firing) {
+    try {
+      callback();
+    } catch (std::exception& e) {
+      QLOG(ERROR, "timer callback error: {}", e.what());
+    } catch (...) {
+      QLOG(ERROR, "timer callback error: unknown error");
+    }
+  }
+  auto fired = firing.size();
+  // 没有重入时归还缓冲区，保留容量
+  firing.clear();
+  if (firing_.capacity() < firing.capacity()) {
+    firing_.swap(firing);
+  }
+  return fired;
+}
+
+int64_t TimerWheel::next_deadline() const {
+  int64_t deadline = std::numeric_limits<int64_t>::max();
+  if (size_ == 0) {
+    return deadline;
+  }
+
+  for (int level = 0; level < kLevels; ++level) {
+    // 当前槽的定时器在本层最晚到期（第0层的当前槽已在推进时清空），放到最后检查
+    int64_t current = (now_ >> (kSlotBits * level)) & kSlotMask;
+    for (int64_t offset = 1; offset <= kSlots; ++offset) {
+      auto index = slots_[level][(current + offset) & kSlotMask];
+      if (index == kNil) {
+        continue;
+      }
+      for (; index != kNil; index = nodes_[index].next) {
+        deadline = std::min(deadline, nodes_[index].deadline);
+      }
+      break;
+    }
+  }
+  for (auto index = overflow_; index != kNil; index = nodes_[index].next) {
+    deadline = std::min(deadline, nodes_[index].deadline);
+  }
+  return deadline;
+}
+
+void TimerWheel::link(int32_t index) {
+  auto& node = nodes_[index];
+  int64_t delta = node.deadline - now_;
+
+  int32_t* head = &overflow_;
+  if (delta <= 0) {
+    // 下放时恰好到期，放入当前槽，本次推进中立即触发
+    head = &slots_[0][now_ & kSlotMask];
+  }
+  for (int level = 0; level < kLevels && delta > 0; ++level) {
+    if (delta < (int64_t(1) << (kSlotBits * (level + 1)))) {
+      head = &slots_[level][(node.deadline >> (kSlotBits * level)) & kSlotMask];
+      break;
+    }
+  }
+
+  node.head = head;
+  node.prev = kNil;
+  node.next = *head;
+  if (*head != kNil) {
+    nodes_[*head].prev = index;
+  }
+  *head = index;
+}
+
+void TimerWheel::unlink(int32_t index) {
+  auto& node = nodes_[index];
+  if (node.prev != kNil) {
+    nodes_[node.prev].next = node.next;
+  } else {
+    *node.head = node.next;
+  }
+  if (node.next != kNil) {
+    nodes_[node.next].prev = node.prev;
+  }
+  node.head = nullptr;
+  node.prev = node.next = kNil;
+}
+
+int32_t TimerWheel::lookup(TimerId id) const {
+  auto index = static_cast<int32_t>(id & 0xffffffff);
+  auto generation = static_cast<uint32_t>(id >> 32);
+  if (index < 0 || index >= static_cast<int32_t>(nodes_.size())) {
+    return kNil;
+  }
+  auto& node = nodes_[index];
+  if (node.generation != generation || node.head == nullptr) {
+    return kNil;
+  }
+  return index;
+}
+
+void TimerWheel::cascade(int level, int64_t slot) {
+  auto index = slots_[level][slot];
+  slots_[level][slot] = kNil;
+  while (index != kNil) {
+    auto next = nodes_[index].next;
+    nodes_[index].head = nullptr;
+    link(index);
+    index = next;
+  }
+}
+
+}  // namespace engine
@@ -0,0 +1,125 @@
+#ifndef __ENGINE_TIMER_WHEEL_H__
+#define __ENGINE_TIMER_WHEEL_H__
+
+/**
+ * @file timer_wheel.h
+ * @brief 分层时间轮
+ *
+ * 用于大量定时任务（订单超时、报价刷新、心跳检查等），
+ * 所有定时器共享一个asio定时器驱动，不再为每个截止时间创建 steady_timer。
+ */
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace engine {
+
+/**
+ * @brief 分层时间轮，精度1毫秒
+ *
+ * - 4层，每层64个槽，覆盖 64^4 毫秒（约4.6小时），更远的定时器放入溢出列表
+ * - 节点保存在连续数组中，空闲节点复用；槽内为基于下标的双向链表
+ * - schedule / cancel / reschedule 均为O(1)
+ * - advance 推进时间，同一批到期的定时器先全部摘下再依次回调
+ *
+ * 非线程安全，只能在引擎所在的执行器上使用。
+ */
+class TimerWheel {
+ public:
+  typedef uint64_t TimerId;                 ///< 定时器ID，高32位为代数，低32位为节点下标
+  typedef std::function<void()> Callback;   ///< 到期回调
+
+  static constexpr TimerId kInvalidTimer = 0;
+
+  /**
+   * @brief 构造函数
+   * @param now_ms 当前时间（毫秒，单调时钟）
+   */
+  explicit TimerWheel(int64_t now_ms);
+
+  /**
+   * @brief 添加定时器
+   * @param delay_ms 延迟（毫秒），小于等于0时在下一次advance触发
+   * @param callback 到期回调
+   * @return TimerId 定时器ID
+   */
+  TimerId schedule(int64_t delay_ms, Callback callback);
+
+  /**
+   * @brief 取消定时器
+   * @return bool 定时器是否存在（未触发且未取消）
+   */
+  bool cancel(TimerId id);
+
+  /**
+   * @brief 修改定时器的到期时间，ID不变
+   * @param delay_ms 从当前时间起的新延迟
+   * @return bool 定时器是否存在
+   */
+  bool reschedule(TimerId id, int64_t delay_ms);
+
+  /**
+   * @brief 推进时间到 now_ms，触发所有到期的定时器
+   * @return size_t 触发的定时器数量
+   */
+  size_t advance(int64_t now_ms);
+
+  /// 未触发的定时器数量
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /// 时间轮当前时间
+  int64_t now() const { return now_; }
+
+  /**
+   * @brief 最早的到期时间，用于驱动方按需休眠
+   *
+   * 各层从当前槽往后找第一个非空槽，取槽内最小值，溢出列表全量遍历；
+   * 最多扫描 4×64 个槽，只在驱动方休眠前调用一次。
+   *
+   * @return int64_t 到期时间（毫秒），没有定时器时返回 INT64_MAX
+   */
+  int64_t next_deadline() const;
+
+ private:
+  static constexpr int kLevels = 4;
+  static constexpr int kSlotBits = 6;
+  static constexpr int kSlots = 1 << kSlotBits;
+  static constexpr int64_t kSlotMask = kSlots - 1;
+  static constexpr int32_t kNil = -1;
+
+  /// 定时器节点
+  struct Node {
+    int64_t deadline = 0;
+    uint32_t generation = 1;
+    int32_t prev = kNil;
+    int32_t next = kNil;
+    int32_t* head = nullptr;  ///< 所在链表头，nullptr 表示空闲
+    Callback callback;
+  };
+
+  /// 根据到期时间把节点挂到对应的槽
+  void link(int32_t index);
+  /// 从所在链表摘下
+  void unlink(int32_t index);
+  /// 校验ID，返回节点下标，无效返回kNil
+  int32_t lookup(TimerId id) const;
+  /// 把某一层某个槽的节点重新分配到低层
+  void cascade(int level, int64_t slot);
+
+  int64_t now_;
+  size_t size_ = 0;
+
+  std::vector<Node> nodes_;
+  int32_t free_head_ = kNil;  ///< 空闲节点链表
+
+  int32_t slots_[kLevels][kSlots];
+  int32_t overflow_ = kNil;  ///< 超出时间轮范围的定时器
+
+  std::vector<Callback> firing_;  ///< 本批到期的回调，重复使用
+};
+
+}  // namespace engine
+
+#endif  // __ENGINE_TIMER_WHEEL_H__
@@ -3,7 +3,7 @@
  * @brief 比特币交易系统主程序入口
  * 
  * 该程序实现了一个基于事件驱动的比特币交易系统，主要功能包括：
- * - 连接OKX交易所获取市场数据
+ * - 按配置连接交易所（OKX、Binance U本位合约）获取市场数据
  * - 执行交易策略
  * - 通过企业微信发送通知
  */
@@ -20,9 +20,24 @@
 
 #include "config/config.h"
 #include "config/options.h"
+#include "utils/async_log.h"
+#include "utils/io_loop.h"
 #include "wework/wework.h"
+#include "base/pinned_runner.h"
 #include "testing/testing.h"
+#include "base/gateway_registry.h"
 #include "okx/okx.h"
+#include "binance/binance.h"
+#include "store/recorder.h"
+#include "bar/bar_engine.h"
+#include "order/order_manager.h"
+#include "risk/risk_gate.h"
+#include "position/position_keeper.h"
+#include "consolidated/consolidated_book.h"
+#include "router/smart_router.h"
+#include "algo/algo_engine.h"
+#include "monitor/latency_monitor.h"
+#include "monitor/metrics_server.h"
 
 /**
  * @brief 程序主入口函数
@@ -46,15 +61,31 @@ int main(int argc, char* argv[]) {
   google::InitGoogleLogging(argv[0]);
   FLAGS_minloglevel = google::INFO;  // 设置最小日志级别为INFO
   FLAGS_logtostderr = true;           // 日志输出到标准错误
+  // 热路径日志写入环形缓冲区，由后台线程格式化输出
+  async_logger.start();
 
   LOG(INFO) << "CONFIG FILE: " << AppOptions->config_file();
   // 初始化配置管理器并加载配置文件
   AppConfig->init(AppOptions->config_file());
-  // 加载各模块的配置：OKX交易所、企业微信、通用配置
+  // 加载各模块的配置：网关、OKX和Binance交易所、企业微信、通用配置
   AppConfig->load_config({
+    gateway_config,
     okx_config,
+    binance_config,
     wework_config,
     common_config,
+    io_config,
+    store_config,
+    bar_config,
+    order_config,
+    risk_config,
+    position_config,
+    consolidated_config,
+    router_config,
+    algo_config,
+    pinned_config,
+    latency_config,
+    metrics_config,
   });
 
   // 创建异步IO上下文，用于处理所有异步操作
@@ -65,18 +96,92 @@ int main(int argc, char* argv[]) {
   // 创建各个组件
   auto wework = std::make_shared<notice::wework::WeworkNotice>(engine);  // 企业微信通知组件
   auto testing = std::make_shared<strategy::testing::Testing>(engine);      // 测试策略组件
-  auto okx = std::make_shared<market::okx::Okx>(engine);
+  // 开启风控时，订单管理在转发前同步检查每笔订单
+  std::shared_ptr<service::risk::RiskGate> risk_gate;
+  if (risk_config->enable()) {
+    risk_gate = std::make_shared<service::risk::RiskGate>(engine);
+  }
+  auto order_manager = std::make_shared<service::order::OrderManager>(engine, risk_gate);  // 订单管理，策略下单经此转发到网关
 
   // 将所有组件注册到引擎
   engine->register_component(wework);
-  engine->register_component(testing);
-  engine->register_component(okx);
+  // 开启独立线程时策略运行在绑核的策略线程上，由运行器代为注册
+  if (pinned_config->enable()) {
+    engine->register_component(std::make_shared<strategy::base::PinnedRunner>(
+        engine, testing, pinned_config->cpu(), pinned_config->queue_size()));
+  } else {
+    engine->register_component(testing);
+  }
+  // 按配置创建交易所网关，请求按 exchange 字段路由到对应网关
+  gateway_registry->add("okx", [](engine::EnginePtr e) { return std::make_shared<market::okx::Okx>(e); });
+  gateway_registry->add("binance", [](engine::EnginePtr e) { return std::make_shared<market::binance::Binance>(e); });
+  for (auto& gateway : gateway_registry->create(engine)) {
+    engine->register_component(gateway);
+  }
+  engine->register_component(order_manager);
+  if (risk_gate) {
+    engine->register_component(risk_gate);
+  }
+
+  // 开启本地持仓时注册持仓与盈亏组件
+  if (position_config->enable()) {
+    engine->register_component(std::make_shared<service::position::PositionKeeper>(engine));
+  }
+
+  // 开启合并订单簿时注册跨交易所合并组件，智能路由依赖合并订单簿
+  if (consolidated_config->enable()) {
+    auto consolidated = std::make_shared<service::consolidated::ConsolidatedBook>(engine);
+    engine->register_component(consolidated);
+    if (router_config->enable()) {
+      engine->register_component(std::make_shared<service::router::SmartRouter>(engine, consolidated));
+    }
+  }
+
+  // 开启算法执行时注册TWAP/VWAP/冰山单组件
+  if (algo_config->enable()) {
+    engine->register_component(std::make_shared<service::algo::AlgoEngine>(engine));
+  }
+
+  // 开启延迟统计输出
+  if (latency_config->enable()) {
+    engine->register_component(std::make_shared<service::monitor::LatencyMonitor>(engine));
+  }
+
+  // 开启指标HTTP输出，供 Prometheus 抓取
+  if (metrics_config->enable()) {
+    engine->register_component(std::make_shared<service::monitor::MetricsServer>(engine));
+  }
+
+  // 开启行情落盘时注册记录组件
+  if (store_config->enable()) {
+    engine->register_component(std::make_shared<service::store::Recorder>(engine));
+  }
+
+  // 开启K线合成时注册K线组件
+  if (bar_config->enable()) {
+    engine->register_component(std::make_shared<service::bar::BarEngine>(engine));
+  }
 
   // 启动引擎协程，开始处理事件
   asio::co_spawn(io_context, engine->run(), asio::detached);
 
-  // 运行IO事件循环，阻塞直到所有异步操作完成
-  io_context.run();
+  // 运行IO事件循环，阻塞直到所有异步操作完成；自旋模式下不在 epoll 中休眠
+  auto io_mode = Common::parse_io_mode(io_config->mode());
+  if (io_mode != Common::IoMode::kBlock && io_config->cpu() >= 0 && !Common::pin_current_thread(io_config->cpu())) {
+    LOG(WARNING) << "failed to pin io thread to cpu " << io_config->cpu();
+  }
+  // 网关连接由 httpcpp 创建，无法逐个设置 SO_BUSY_POLL，依赖系统默认值 net.core.busy_read
+  if (io_config->busy_poll_us() > 0 && Common::busy_read_us() < io_config->busy_poll_us()) {
+    LOG(WARNING) << "net.core.busy_read is " << Common::busy_read_us() << ", set it to "
+                 << io_config->busy_poll_us() << " to busy poll gateway sockets";
+  }
+#ifdef BOOST_ASIO_HAS_IO_URING_AS_DEFAULT
+  LOG(INFO) << "IO MODE: " << io_config->mode() << ", backend io_uring";
+#else
+  LOG(INFO) << "IO MODE: " << io_config->mode() << ", backend epoll";
+#endif
+  Common::run_io_loop(io_context, io_mode, io_config->idle_spin_us());
+  async_logger.stop();
   google::ShutdownGoogleLogging();
   return 0;
 }
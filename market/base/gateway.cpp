@@ -1,37 +1,51 @@
 #include "gateway.h"
 
+#include "gateway_registry.h"
+
 namespace market::base {
 
 Gateway::Gateway(EnginePtr engine, const std::string& name) : _engine(engine), _name(name) {}
 
 Gateway::~Gateway() {}
 
-// 初始化网关，注册各类查询和订阅请求的回调函数
+bool Gateway::routes(const engine::BaseData& data, bool broadcast) const {
+  if (data.exchange.empty()) {
+    return broadcast || _name == gateway_config->default_venue();
+  }
+  return data.exchange == _name;
+}
+
+// 初始化网关，注册各类查询和订阅请求的回调函数，请求按交易所路由
 asio::awaitable<void> Gateway::init() {
   // 注册查询账户请求的回调
-  _engine->register_callback<engine::QueryAccountData>(engine::EventType::kQueryAccount,
-    std::bind(&Gateway::query_account, shared_from_this(), std::placeholders::_1));
-  
+  route<engine::QueryAccountData>(engine::EventType::kQueryAccount, true, &Gateway::query_account);
+
   // 注册查询持仓请求的回调
-  _engine->register_callback<engine::QueryPositionData>(engine::EventType::kQueryPosition,
-    std::bind(&Gateway::query_position, shared_from_this(), std::placeholders::_1));
-  
-  // 注册查询订单请求的回调
-  _engine->register_callback<engine::QueryOrderData>(engine::EventType::kQueryOrder,
-    std::bind(&Gateway::query_order, shared_from_this(), std::placeholders::_1));
+  route<engine::QueryPositionData>(engine::EventType::kQueryPosition, true, &Gateway::query_position);
+
+  // 注册查询订单请求的回调：查询全部挂单时广播，按客户端订单ID查询单笔时与下单的路由相同
+  _engine->register_callback<engine::QueryOrderData>(
+      engine::EventType::kQueryOrder, [self = shared_from_this()](engine::QueryOrderDataPtr data) -> asio::awaitable<void> {
+        if (self->routes(*data, data->client_order_id.empty())) {
+          co_await self->query_order(data);
+        }
+      });
 
   // 注册订阅订单簿请求的回调
-  _engine->register_callback<engine::SubscribeData>(engine::EventType::kSubscribeBook,
-    std::bind(&Gateway::subscribe_book, shared_from_this(), std::placeholders::_1));
-  
+  route<engine::SubscribeData>(engine::EventType::kSubscribeBook, false, &Gateway::subscribe_book);
+
   // 注册订阅Tick请求的回调
-  _engine->register_callback<engine::SubscribeData>(engine::EventType::kSubscribeTick,
-    std::bind(&Gateway::subscribe_tick, shared_from_this(), std::placeholders::_1));
+  route<engine::SubscribeData>(engine::EventType::kSubscribeTick, false, &Gateway::subscribe_tick);
+
+  // 注册订阅逐笔成交请求的回调
+  route<engine::SubscribeData>(engine::EventType::kSubscribeTrade, false, &Gateway::subscribe_trade);
+
+  // 注册提交订单请求的回调，订单由订单管理登记后转发
+  route<engine::OrderData>(engine::EventType::kSubmitOrder, false, &Gateway::send_orders);
+
+  // 注册撤单请求的回调，撤单结果通过订单推送回报
+  route<engine::OrderData>(engine::EventType::kCancelOrder, false, &Gateway::cancel_order);
 
-  // 注册发送订单请求的回调
-  _engine->register_callback<engine::OrderData>(engine::EventType::kSendOrder,
-    std::bind(&Gateway::send_orders, shared_from_this(), std::placeholders::_1));
-  
   // 调用子类实现的初始化逻辑（如连接WebSocket）
   co_await market_init();
   co_return;
@@ -61,4 +75,20 @@ asio::awaitable<void> Gateway::on_order(OrderDataPtr order) {
   return _engine->on_event(EventType::kOrder, order);
 }
 
+asio::awaitable<void> Gateway::on_rate_limit(RateLimitDataPtr limit) {
+  return _engine->on_event(EventType::kRateLimit, limit);
+}
+
+asio::awaitable<void> Gateway::on_message(const std::string& msg) {
+  return _engine->on_event(EventType::kMessage, std::make_shared<MessageData>(msg));
+}
+
+TimerWheel::TimerId Gateway::add_timer(int64_t delay_ms, TimerWheel::Callback callback) {
+  return _engine->schedule_timer(delay_ms, std::move(callback));
+}
+
+bool Gateway::cancel_timer(TimerWheel::TimerId id) {
+  return _engine->cancel_timer(id);
+}
+
 }
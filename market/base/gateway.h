@@ -26,6 +26,7 @@ using namespace engine;
  * 
  * 所有交易所网关必须继承此类并实现相应的虚函数。
  * 提供了与引擎交互的通用方法，如发送事件到引擎。
+ * 多个网关同时运行时，请求事件按 exchange 字段路由，只由对应的网关处理。
  */
 class Gateway : public engine::Component, public std::enable_shared_from_this<Gateway> {
 public:
@@ -49,6 +50,18 @@ public:
    */
   std::string name() const { return _name; }
 
+  /**
+   * @brief 请求是否由本网关处理
+   *
+   * exchange 与网关名称相同时处理；未指定交易所时，广播的请求（查询）所有网关都处理，
+   * 其他请求（订阅、下单）只由默认网关处理。
+   *
+   * @param data 请求数据
+   * @param broadcast 未指定交易所时是否广播
+   * @return bool 是否处理
+   */
+  bool routes(const engine::BaseData& data, bool broadcast) const;
+
   // ========== 以下方法用于将数据发送到引擎 ==========
   
   /// 发送Tick数据到引擎
@@ -69,6 +82,18 @@ public:
   /// 发送成交数据到引擎
   asio::awaitable<void> on_trade(TradeDataPtr trade);
 
+  /// 发送接口限速额度到引擎
+  asio::awaitable<void> on_rate_limit(RateLimitDataPtr limit);
+
+  /// 发送通知消息到引擎，如连接断开重连
+  asio::awaitable<void> on_message(const std::string& msg);
+
+  /// 添加定时器，回调在引擎执行器上触发
+  TimerWheel::TimerId add_timer(int64_t delay_ms, TimerWheel::Callback callback);
+
+  /// 取消定时器
+  bool cancel_timer(TimerWheel::TimerId id);
+
   // ========== 以下是子类必须实现的虚函数 ==========
   
   /// 连接到交易所
@@ -121,6 +146,13 @@ public:
    */
   virtual asio::awaitable<void> subscribe_tick(engine::SubscribeDataPtr data) = 0;
 
+  /**
+   * @brief 订阅市场逐笔成交
+   * @param data 订阅请求数据
+   * @return asio::awaitable<void> 异步协程
+   */
+  virtual asio::awaitable<void> subscribe_trade(engine::SubscribeDataPtr data) = 0;
+
   /**
    * @brief 市场网关初始化，在init()中被调用
    * @return asio::awaitable<void> 异步协程
@@ -128,6 +160,17 @@ public:
   virtual asio::awaitable<void> market_init() = 0;
   
 private:
+  /// 注册请求回调，只处理路由到本网关的请求
+  template <typename T>
+  void route(EventType type, bool broadcast, asio::awaitable<void> (Gateway::*handler)(std::shared_ptr<const T>)) {
+    _engine->register_callback<T>(
+        type, [self = shared_from_this(), broadcast, handler](std::shared_ptr<const T> data) -> asio::awaitable<void> {
+          if (self->routes(*data, broadcast)) {
+            co_await ((*self).*handler)(data);
+          }
+        });
+  }
+
   const std::string _name;  ///< 网关名称
   EnginePtr _engine;        ///< 引擎指针
 };
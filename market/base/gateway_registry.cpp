@@ -0,0 +1,39 @@
+#include "gateway_registry.h"
+
+#include <boost/algorithm/string.hpp>
+#include <stdexcept>
+
+namespace market::base {
+
+void GatewayConfig::load(std::shared_ptr<Config::ptree> pt) {
+  m_ptree = pt;
+
+  m_venues.clear();
+  std::vector<std::string> venues;
+  auto value = this->get<std::string>("venues", "okx");
+  boost::split(venues, value, boost::is_any_of(","));
+  for (auto& venue : venues) {
+    boost::trim(venue);
+    if (!venue.empty()) {
+      m_venues.push_back(venue);
+    }
+  }
+
+  m_default_venue = this->get<std::string>("default_venue", m_venues.empty() ? "" : m_venues[0]);
+}
+
+void GatewayRegistry::add(const std::string& name, Factory factory) { factories_[name] = std::move(factory); }
+
+std::vector<std::shared_ptr<Gateway>> GatewayRegistry::create(engine::EnginePtr engine) const {
+  std::vector<std::shared_ptr<Gateway>> gateways;
+  for (auto& venue : gateway_config->venues()) {
+    auto it = factories_.find(venue);
+    if (it == factories_.end()) {
+      throw std::runtime_error(fmt::format("unknown gateway: {}", venue));
+    }
+    gateways.push_back(it->second(engine));
+  }
+  return gateways;
+}
+
+}  // namespace market::base
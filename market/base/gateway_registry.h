@@ -0,0 +1,74 @@
+#ifndef __MARKET_BASE_GATEWAY_REGISTRY_H__
+#define __MARKET_BASE_GATEWAY_REGISTRY_H__
+
+/**
+ * @file gateway_registry.h
+ * @brief 交易所网关注册表
+ *
+ * 各交易所网关在启动时注册创建函数，按配置 [gateway] venues 创建启用的网关。
+ * 请求事件按 BaseData::exchange 路由到对应网关，未指定交易所时：
+ * - 订阅和下单发往默认网关
+ * - 查询发往所有网关
+ */
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "config/config.h"
+#include "engine.h"
+#include "gateway.h"
+
+namespace market::base {
+
+class GatewayConfig : public Config::ConfigTree {
+ public:
+  GatewayConfig() : ConfigTree("gateway") {};
+
+  void load(std::shared_ptr<Config::ptree> pt) override;
+
+  /// 启用的交易所，按配置顺序创建
+  const std::vector<std::string>& venues() const { return m_venues; }
+  /// 未指定交易所的订阅和下单发往的网关，默认为第一个启用的交易所
+  const std::string& default_venue() const { return m_default_venue; }
+
+ private:
+  std::vector<std::string> m_venues{"okx"};
+  std::string m_default_venue = "okx";
+};
+
+#define gateway_config ::Common::SingletonPtr<::market::base::GatewayConfig>::get_instance()
+
+/**
+ * @brief 网关注册表，按名称保存各交易所网关的创建函数
+ */
+class GatewayRegistry {
+ public:
+  /// 网关创建函数
+  typedef std::function<std::shared_ptr<Gateway>(engine::EnginePtr)> Factory;
+
+  /**
+   * @brief 注册交易所网关
+   * @param name 交易所名称，与网关 name() 及配置中的名称一致
+   * @param factory 创建函数
+   */
+  void add(const std::string& name, Factory factory);
+
+  /**
+   * @brief 按配置创建启用的网关，名称未注册时抛出异常
+   * @param engine 引擎指针
+   * @return std::vector<std::shared_ptr<Gateway>> 创建的网关
+   */
+  std::vector<std::shared_ptr<Gateway>> create(engine::EnginePtr engine) const;
+
+ private:
+  std::map<std::string, Factory> factories_;
+};
+
+#define gateway_registry ::Common::SingletonPtr<::market::base::GatewayRegistry>::get_instance()
+
+}  // namespace market::base
+
+#endif  // __MARKET_BASE_GATEWAY_REGISTRY_H__
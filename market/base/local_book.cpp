@@ -0,0 +1,38 @@
+#include "local_book.h"
+
+namespace market::base {
+
+void LocalBook::update_level(std::vector<BookLevel>& side, Common::Fixed price, Common::Fixed size, bool descending) {
+  auto it = descending ? std::lower_bound(side.begin(), side.end(), price,
+                                          [](const BookLevel& level, Common::Fixed p) { return level.price > p; })
+                       : std::lower_bound(side.begin(), side.end(), price,
+                                          [](const BookLevel& level, Common::Fixed p) { return level.price < p; });
+  bool found = it != side.end() && it->price == price;
+  if (size.is_zero()) {
+    if (found) {
+      side.erase(it);
+    }
+  } else if (found) {
+    it->size = size;
+  } else {
+    side.insert(it, {price, size});
+  }
+}
+
+void LocalBook::fill(engine::Book& book, size_t depth) const {
+  auto convert = [depth](const std::vector<BookLevel>& side, std::vector<engine::BookItem>& out) {
+    auto n = std::min(depth, side.size());
+    out.clear();
+    out.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      engine::BookItem item;
+      item.price = side[i].price.to_dec();
+      item.volume = side[i].size.to_dec();
+      out.push_back(std::move(item));
+    }
+  };
+  convert(bids_, book.bids);
+  convert(asks_, book.asks);
+}
+
+}  // namespace market::base
@@ -0,0 +1,96 @@
+#ifndef __MARKET_BASE_LOCAL_BOOK_H__
+#define __MARKET_BASE_LOCAL_BOOK_H__
+
+/**
+ * @file local_book.h
+ * @brief 本地订单簿
+ *
+ * 由交易所的全量快照和增量更新维护的价格档位，网关据此向引擎发布一致的订单簿。
+ * 价格和数量使用定点数，每一侧是按优先级排序的连续数组，
+ * 更新集中在盘口附近，二分查找加少量元素移动比树结构更快。
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "object.h"
+#include "utils/fixed_point.hpp"
+
+namespace market::base {
+
+/**
+ * @brief 一侧的价格档位
+ */
+struct BookLevel {
+  Common::Fixed price;
+  Common::Fixed size;
+};
+
+class LocalBook {
+ public:
+  /// 清空两侧
+  void clear() {
+    bids_.clear();
+    asks_.clear();
+  }
+
+  /**
+   * @brief 用全量快照替换两侧
+   * @param bids 买盘，元素需有 Fixed 类型的 price 和 size
+   * @param asks 卖盘
+   */
+  template <typename Levels>
+  void snapshot(const Levels& bids, const Levels& asks) {
+    clear();
+    for (auto& level : bids) {
+      if (!level.size.is_zero()) {
+        bids_.push_back({level.price, level.size});
+      }
+    }
+    for (auto& level : asks) {
+      if (!level.size.is_zero()) {
+        asks_.push_back({level.price, level.size});
+      }
+    }
+    std::sort(bids_.begin(), bids_.end(), [](auto& a, auto& b) { return a.price > b.price; });
+    std::sort(asks_.begin(), asks_.end(), [](auto& a, auto& b) { return a.price < b.price; });
+  }
+
+  /**
+   * @brief 应用增量更新，数量为0表示删除该档
+   * @param bids 买盘变化
+   * @param asks 卖盘变化
+   */
+  template <typename Levels>
+  void update(const Levels& bids, const Levels& asks) {
+    for (auto& level : bids) {
+      update_level(bids_, level.price, level.size, true);
+    }
+    for (auto& level : asks) {
+      update_level(asks_, level.price, level.size, false);
+    }
+  }
+
+  const std::vector<BookLevel>& bids() const { return bids_; }
+  const std::vector<BookLevel>& asks() const { return asks_; }
+
+  /// 买一价高于等于卖一价，说明更新丢失或乱序
+  bool crossed() const { return !bids_.empty() && !asks_.empty() && bids_.front().price >= asks_.front().price; }
+
+  /**
+   * @brief 把前 depth 档写入引擎订单簿
+   * @param book 目标订单簿，原有档位会被替换
+   * @param depth 每侧最多档位数
+   */
+  void fill(engine::Book& book, size_t depth) const;
+
+ private:
+  static void update_level(std::vector<BookLevel>& side, Common::Fixed price, Common::Fixed size, bool descending);
+
+  std::vector<BookLevel> bids_;  ///< 价格从高到低
+  std::vector<BookLevel> asks_;  ///< 价格从低到高
+};
+
+}  // namespace market::base
+
+#endif  // __MARKET_BASE_LOCAL_BOOK_H__
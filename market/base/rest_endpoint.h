@@ -0,0 +1,38 @@
+#ifndef __MARKET_BASE_REST_ENDPOINT_H__
+#define __MARKET_BASE_REST_ENDPOINT_H__
+
+/**
+ * @file rest_endpoint.h
+ * @brief 交易所REST接口描述
+ *
+ * 接口的耗时直方图在客户端构造时注册，请求时直接记录，不再按路径查找注册表。
+ */
+
+#include <fmt/format.h>
+#include <string>
+
+#include "utils/metrics.h"
+
+namespace market::base {
+
+struct RestEndpoint {
+  /**
+   * @param exchange 交易所名称，用作指标标签
+   * @param method 请求方法
+   * @param path 接口路径，不含查询参数
+   */
+  RestEndpoint(const char* exchange, const char* method, const char* path)
+      : method(method),
+        path(path),
+        latency(&metrics_registry.histogram(
+            "qitrader_http_request_seconds", "Exchange REST request latency",
+            fmt::format("exchange=\"{}\",method=\"{}\",path=\"{}\"", exchange, method, path))) {}
+
+  const std::string method;
+  const std::string path;
+  Common::Histogram* latency;  ///< 请求耗时
+};
+
+}  // namespace market::base
+
+#endif  // __MARKET_BASE_REST_ENDPOINT_H__
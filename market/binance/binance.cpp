@@ -0,0 +1,444 @@
+#include "binance.h"
+
+#include <boost/algorithm/string.hpp>
+
+#include "utils/async_log.h"
+#include "utils/latency.h"
+
+namespace market::binance {
+
+namespace {
+
+/// 数据流名称使用小写交易对
+std::string stream_name(const std::string& symbol, const std::string& stream) {
+  return boost::to_lower_copy(symbol) + "@" + stream;
+}
+
+int64_t now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+Binance::Binance(engine::EnginePtr engine, std::shared_ptr<BinanceHttp> http)
+    : base::Gateway(engine, "binance"), http_(std::move(http)) {}
+
+// 主运行循环，行情和用户数据流各一个处理协程
+asio::awaitable<void> Binance::run() {
+  auto executor = co_await asio::this_coro::executor;
+  if (ws_user_) {
+    asio::co_spawn(executor, watch(ws_user_), asio::detached);
+    asio::co_spawn(executor, keepalive_loop(), asio::detached);
+  }
+  co_await watch(ws_market_);
+}
+
+asio::awaitable<void> Binance::watch(std::shared_ptr<BinanceWs> ws) {
+  for (;;) {
+    try {
+      co_await ws_deal(ws);
+    } catch (boost::system::system_error& e) {
+      QLOG(ERROR, "binance watch error: {}", e.what());
+    } catch (std::exception& e) {
+      QLOG(ERROR, "binance watch error: {}", e.what());
+    } catch (...) {
+      QLOG(ERROR, "binance watch error: unknown error");
+    }
+  }
+}
+
+// 初始化市场网关，连接行情连接和用户数据流
+asio::awaitable<void> Binance::market_init() {
+  auto ctx = co_await asio::this_coro::executor;
+
+  ws_market_ = std::make_shared<BinanceWs>(ctx, 100, "market",
+                                           []() -> asio::awaitable<std::string> { co_return std::string("/ws"); });
+  ws_market_->set_on_reconnect([this]() { return resync_public(); });
+  co_await ws_market_->connect();
+  LOG(INFO) << "binance market ws connected";
+
+  // 没有配置密钥时只接收行情
+  if (binance_config->api_key().empty()) {
+    co_return;
+  }
+  ws_user_ = std::make_shared<BinanceWs>(ctx, 100, "user", [this]() { return user_stream_path(); });
+  ws_user_->set_on_reconnect([this]() { return resync_private(); });
+  co_await ws_user_->connect();
+  LOG(INFO) << "binance user ws connected";
+}
+
+asio::awaitable<std::string> Binance::user_stream_path() {
+  auto listen_key = co_await http_->new_listen_key();
+  co_return "/ws/" + listen_key;
+}
+
+asio::awaitable<void> Binance::keepalive_loop() {
+  auto ctx = co_await asio::this_coro::executor;
+  asio::steady_timer timer(ctx);
+  while (true) {
+    timer.expires_after(std::chrono::seconds(binance_config->listen_key_keepalive_s()));
+    co_await timer.async_wait(asio::use_awaitable);
+    try {
+      co_await http_->keepalive_listen_key();
+    } catch (const std::exception& e) {
+      // 续期失败时 listenKey 可能已失效，用户数据流断开后重连会重新获取
+      QLOG(ERROR, "binance listen key keepalive failed: {}", e.what());
+    }
+  }
+}
+
+asio::awaitable<void> Binance::resync_public() {
+  for (auto& [symbol, market] : markets_) {
+    market.bbo = BookState();
+    market.depth = BookState();
+    market.last_book = nullptr;
+  }
+  co_await on_message("binance market ws reconnected, subscriptions replayed");
+}
+
+asio::awaitable<void> Binance::resync_private() {
+  co_await on_message("binance user ws reconnected, resync orders and positions");
+  // 断线期间的订单和持仓推送可能丢失，通过REST查询补齐
+  co_await query_order(std::make_shared<engine::QueryOrderData>());
+  co_await query_position(std::make_shared<engine::QueryPositionData>());
+  co_await query_account(std::make_shared<engine::QueryAccountData>());
+}
+
+asio::awaitable<void> Binance::ws_deal(std::shared_ptr<BinanceWs> ws) {
+  auto msg = co_await ws->read();
+  co_await dispatch(msg);
+}
+
+asio::awaitable<void> Binance::dispatch(const WsMessage& msg) {
+  if (msg.event == "response") {
+    if (msg.code != 0) {
+      QLOG(ERROR, "binance ws request {} error code: {}, message: {}", msg.id, msg.code, msg.msg);
+    }
+  } else if (msg.event == "bookTicker") {
+    auto& data = std::any_cast<const WsBookTicker&>(msg.data);
+    co_await deal_book(msg.symbol, markets_[msg.symbol].bbo, data.updateId, data.bids, data.asks, data.ts, 1,
+                       msg.recv_ns);
+  } else if (msg.event == "depthUpdate") {
+    auto& data = std::any_cast<const WsDepth&>(msg.data);
+    co_await deal_book(msg.symbol, markets_[msg.symbol].depth, data.updateId, data.bids, data.asks, data.ts,
+                       book_depths_[msg.symbol], msg.recv_ns);
+  } else if (msg.event == "aggTrade") {
+    co_await deal_trade(msg.symbol, std::any_cast<const WsAggTrade&>(msg.data), msg.recv_ns);
+  } else if (msg.event == "24hrTicker") {
+    co_await deal_tick(msg.symbol, std::any_cast<const WsTicker&>(msg.data), msg.recv_ns);
+  } else if (msg.event == "ORDER_TRADE_UPDATE") {
+    co_await deal_order(std::any_cast<const OrderDetail&>(msg.data));
+  } else if (msg.event == "ACCOUNT_UPDATE") {
+    co_await deal_account(std::any_cast<const WsAccountUpdate&>(msg.data));
+  } else if (msg.event == "listenKeyExpired") {
+    QLOG(WARNING, "binance listen key expired");
+  } else {
+    QLOG(INFO, "binance unknown event: {}", msg.event);
+  }
+}
+
+// 处理订单簿推送，替换本地订单簿并把前N档发送到引擎
+asio::awaitable<void> Binance::deal_book(const std::string& symbol, BookState& state, int64_t update_id,
+                                         const std::vector<base::BookLevel>& bids,
+                                         const std::vector<base::BookLevel>& asks, int64_t ts, size_t depth,
+                                         int64_t recv_ns) {
+  if (update_id <= state.update_id) {
+    co_return;
+  }
+  state.update_id = update_id;
+  state.book.snapshot(bids, asks);
+
+  auto item = std::make_shared<engine::Book>();
+  item->symbol = symbol;    // 交易对
+  item->exchange = name();  // 交易所
+  item->timestamp_ms = ts;  // 时间戳
+  item->recv_ns = recv_ns;  // 收到时间
+  state.book.fill(*item, depth);
+  markets_[symbol].last_book = item;
+
+  latency_stats.record_since(Common::LatencyStage::kGatewayDeal, recv_ns);
+  co_await on_book(item);
+}
+
+// 处理归集成交，同一交易对的归集成交ID递增
+asio::awaitable<void> Binance::deal_trade(const std::string& symbol, const WsAggTrade& trade, int64_t recv_ns) {
+  auto& market = markets_[symbol];
+  if (trade.aggId <= market.agg_id) {
+    co_return;
+  }
+  market.agg_id = trade.aggId;
+
+  auto item = std::make_shared<engine::TradeData>();
+  item->symbol = symbol;                         // 交易对
+  item->exchange = name();                       // 交易所
+  item->timestamp_ms = trade.ts;                 // 成交时间
+  item->recv_ns = recv_ns;                       // 收到时间
+  item->trade_id = std::to_string(trade.aggId);  // 归集成交ID
+  item->price = trade.px.to_dec();               // 成交价
+  item->volume = trade.qty.to_dec();             // 成交量
+
+  // 买方是挂单方时主动方为卖方
+  item->direction = trade.buyerMaker ? engine::Direction::SELL : engine::Direction::BUY;
+
+  latency_stats.record_since(Common::LatencyStage::kGatewayDeal, recv_ns);
+  co_await on_trade(item);
+}
+
+// 处理24小时统计，转换为Tick数据
+asio::awaitable<void> Binance::deal_tick(const std::string& symbol, const WsTicker& ticker, int64_t recv_ns) {
+  auto item = std::make_shared<engine::TickData>();
+  item->symbol = symbol;           // 交易对
+  item->exchange = name();         // 交易所
+  item->timestamp_ms = ticker.ts;  // 时间戳
+  item->recv_ns = recv_ns;         // 收到时间
+
+  item->last_price = ticker.last.to_dec();                   // 最新价
+  item->last_volume = ticker.lastQty.to_dec();               // 最新成交量
+  item->turnover = (ticker.last * ticker.lastQty).to_dec();  // 成交额
+  item->volume_24h = ticker.volume.to_dec();                 // 24h成交量
+  item->last_close_price = ticker.open.to_dec();             // 昨收价（使用24h开盘价）
+  item->open_price = ticker.open.to_dec();                   // 24h开盘价
+  item->high_price = ticker.high.to_dec();                   // 24h最高价
+  item->low_price = ticker.low.to_dec();                     // 24h最低价
+  item->order_book = markets_[symbol].last_book;
+
+  latency_stats.record_since(Common::LatencyStage::kGatewayDeal, recv_ns);
+  co_await on_tick(item);
+}
+
+asio::awaitable<void> Binance::deal_order(const OrderDetail& order) {
+  auto data = std::make_shared<engine::OrderData>();
+  data->symbol = order.symbol;
+  data->exchange = name();
+  data->timestamp_ms = order.updateTime;
+  data->items.push_back(to_order_item(order));
+  co_await on_order(data);
+}
+
+asio::awaitable<void> Binance::deal_account(const WsAccountUpdate& update) {
+  // 推送只包含变化的持仓
+  if (!update.positions.empty()) {
+    auto position_data = std::make_shared<engine::PositionData>();
+    position_data->exchange = name();
+    position_data->symbol = update.positions[0].symbol;
+    position_data->timestamp_ms = update.ts;
+    for (auto& position : update.positions) {
+      position_data->items.push_back(to_position_item(position));
+    }
+    co_await on_position(position_data);
+  }
+
+  // 推送只包含变化的币种，账户总权益通过REST补齐
+  if (!update.balances.empty()) {
+    co_await query_account(std::make_shared<engine::QueryAccountData>());
+  }
+}
+
+engine::OrderDataItemPtr Binance::to_order_item(const OrderDetail& order) {
+  auto item = std::make_shared<engine::OrderDataItem>();
+  item->symbol = order.symbol;                       // 交易对
+  item->exchange = name();                           // 交易所
+  item->timestamp_ms = order.updateTime;             // 更新时间
+  item->order_id = std::to_string(order.orderId);    // 订单ID
+  item->client_order_id = order.clientOrderId;       // 客户端订单ID
+  item->price = order.price.to_dec();                // 委托价格
+  item->volume = order.origQty.to_dec();             // 委托数量
+  item->filled_volume = order.executedQty.to_dec();  // 已成交数量
+  item->avg_price = order.avgPrice.to_dec();         // 成交均价
+
+  item->direction = order.side == "BUY" ? engine::Direction::BUY : engine::Direction::SELL;
+  item->otype = order.type == "MARKET" ? engine::OrderType::MARKET : engine::OrderType::LIMIT;
+
+  // 随订单推送的成交明细，由订单管理关联到订单后以 kFill 发出
+  if (order.tradeId > 0 && order.lastQty.raw() > 0) {
+    auto fill = std::make_shared<engine::TradeData>();
+    fill->symbol = order.symbol;
+    fill->exchange = name();
+    fill->timestamp_ms = order.tradeTime;
+    fill->trade_id = std::to_string(order.tradeId);
+    fill->direction = item->direction;
+    fill->price = order.lastPx.to_dec();
+    fill->volume = order.lastQty.to_dec();
+    fill->fee = (-order.commission).to_dec();  // Binance 手续费正数为扣除
+    fill->fee_currency = order.commissionAsset;
+    fill->maker = order.maker;
+    item->fill = fill;
+  }
+
+  // 订单状态
+  if (order.status == "NEW") {
+    item->status = engine::OrderStatus::PENDING;
+  } else if (order.status == "PARTIALLY_FILLED") {
+    item->status = engine::OrderStatus::PARTIAL_FILLED;
+  } else if (order.status == "FILLED") {
+    item->status = engine::OrderStatus::FILLED;
+  } else if (order.status == "CANCELED" || order.status == "EXPIRED" || order.status == "EXPIRED_IN_MATCH") {
+    item->status = engine::OrderStatus::CANCELLED;
+  } else if (order.status == "REJECTED") {
+    item->status = engine::OrderStatus::REJECTED;
+  } else {
+    QLOG(WARNING, "binance unknown order status: {}, orderId: {}", order.status, order.orderId);
+    item->status = engine::OrderStatus::PENDING;
+  }
+
+  return item;
+}
+
+engine::PositionItemPtr Binance::to_position_item(const PositionRisk& position) {
+  auto item = std::make_shared<engine::PositionItem>();
+  item->symbol = position.symbol;                      // 交易对
+  item->volume = position.positionAmt.abs().to_dec();  // 持仓数量
+  item->price = position.entryPrice.to_dec();          // 均价
+  item->pnl = position.unRealizedProfit.to_dec();      // 盈亏
+
+  // 单向持仓（BOTH）按数量正负判断方向
+  if (position.positionSide == "BOTH") {
+    item->direction = position.positionAmt.raw() < 0 ? engine::Direction::SELL : engine::Direction::BUY;
+  } else {
+    item->direction = position.positionSide == "LONG" ? engine::Direction::BUY : engine::Direction::SELL;
+  }
+  return item;
+}
+
+asio::awaitable<void> Binance::query_account(engine::QueryAccountDataPtr data) {
+  auto account = co_await http_->get_account();
+
+  auto account_data = std::make_shared<engine::AccountData>();
+  account_data->balance = account.totalMarginBalance.to_dec();  // 总权益
+  account_data->exchange = name();
+  account_data->timestamp_ms = account.updateTime > 0 ? account.updateTime : now_ms();
+  for (auto& asset : account.assets) {
+    auto balance_item = std::make_shared<engine::BalanceItem>();
+    balance_item->symbol = asset.asset;
+    balance_item->balance = asset.marginBalance.to_dec();
+    account_data->items.push_back(balance_item);
+  }
+  co_await on_account(account_data);
+}
+
+asio::awaitable<void> Binance::query_position(engine::QueryPositionDataPtr data) {
+  auto positions = co_await http_->get_positions();
+
+  auto position_data = std::make_shared<engine::PositionData>();
+  position_data->exchange = name();
+  position_data->timestamp_ms = now_ms();
+  position_data->snapshot = true;
+  for (auto& position : positions) {
+    // 接口返回所有交易对，只保留有持仓的
+    if (position.positionAmt.is_zero()) {
+      continue;
+    }
+    position_data->items.push_back(to_position_item(position));
+  }
+  co_await on_position(position_data);
+}
+
+asio::awaitable<void> Binance::query_order(engine::QueryOrderDataPtr data) {
+  auto orders_data = std::make_shared<engine::OrderData>();
+  orders_data->exchange = name();
+
+  // 指定了客户端订单ID时只查询这一笔，交易所没有该订单说明未成功提交
+  if (!data->client_order_id.empty()) {
+    auto order = co_await http_->get_order(data->symbol, data->client_order_id);
+    if (order) {
+      orders_data->items.push_back(to_order_item(*order));
+    } else {
+      auto item = std::make_shared<engine::OrderDataItem>();
+      item->symbol = data->symbol;
+      item->exchange = name();
+      item->client_order_id = data->client_order_id;
+      item->timestamp_ms = now_ms();
+      item->status = engine::OrderStatus::REJECTED;
+      orders_data->items.push_back(item);
+    }
+    orders_data->symbol = data->symbol;
+    co_await on_order(orders_data);
+    co_return;
+  }
+
+  auto orders = co_await http_->get_open_orders();
+  orders_data->snapshot = true;
+  for (auto& order : orders) {
+    orders_data->items.push_back(to_order_item(order));
+  }
+  co_await on_order(orders_data);
+}
+
+asio::awaitable<void> Binance::send_orders(engine::OrderDataPtr order) {
+  latency_stats.record_since(Common::LatencyStage::kTickToWire, order->recv_ns);
+
+  // 提交失败的订单不会有用户数据流推送，直接回报拒绝
+  auto rejected = std::make_shared<engine::OrderData>();
+  rejected->exchange = name();
+  for (auto& item : order->items) {
+    SendOrderRequest req;
+    req.symbol = item->symbol;
+    req.side = item->direction == engine::Direction::BUY ? "BUY" : "SELL";
+    req.type = item->otype == engine::OrderType::MARKET ? "MARKET" : "LIMIT";
+    req.quantity = Common::Fixed::from_dec(item->volume).str();
+    req.price = Common::Fixed::from_dec(item->price).str();
+    req.newClientOrderId = item->client_order_id;
+
+    OrderResponse rsp;
+    try {
+      rsp = co_await http_->send_order(req);
+    } catch (const std::exception& e) {
+      rsp.code = -1;
+      rsp.msg = e.what();
+    }
+    if (rsp.code >= 0) {
+      continue;
+    }
+
+    QLOG(ERROR, "binance send order failed, code: {}, msg: {}", rsp.code, rsp.msg);
+    auto reject_item = std::make_shared<engine::OrderDataItem>(*item);
+    reject_item->exchange = name();
+    reject_item->timestamp_ms = now_ms();
+    reject_item->status = engine::OrderStatus::REJECTED;
+    rejected->items.push_back(reject_item);
+  }
+
+  if (!rejected->items.empty()) {
+    rejected->symbol = rejected->items[0]->symbol;
+    co_await on_order(rejected);
+  }
+}
+
+asio::awaitable<void> Binance::cancel_order(engine::OrderDataPtr order) {
+  // 撤单结果通过用户数据流推送，这里只记录失败
+  for (auto& item : order->items) {
+    try {
+      auto rsp = co_await http_->cancel_order(item->symbol, item->order_id, item->client_order_id);
+      if (rsp.code < 0) {
+        QLOG(ERROR, "binance cancel order failed, code: {}, msg: {}", rsp.code, rsp.msg);
+      }
+    } catch (const std::exception& e) {
+      QLOG(ERROR, "binance cancel order failed: {}", e.what());
+    }
+  }
+}
+
+// 订阅订单簿，1档用实时的 bookTicker，其余按档位选择5/10/20档深度
+asio::awaitable<void> Binance::subscribe_book(engine::SubscribeDataPtr data) {
+  if (data->depth <= 1) {
+    co_await ws_market_->subscribe(stream_name(data->symbol, "bookTicker"));
+    co_return;
+  }
+
+  size_t depth = data->depth <= 5 ? 5 : data->depth <= 10 ? 10 : 20;
+  book_depths_[data->symbol] = depth;
+  // 默认250ms推送一次，逐笔时使用最快的100ms
+  auto stream = fmt::format("depth{}{}", depth, data->tick_by_tick ? "@100ms" : "");
+  co_await ws_market_->subscribe(stream_name(data->symbol, stream));
+}
+
+asio::awaitable<void> Binance::subscribe_tick(engine::SubscribeDataPtr data) {
+  co_await ws_market_->subscribe(stream_name(data->symbol, "ticker"));
+}
+
+asio::awaitable<void> Binance::subscribe_trade(engine::SubscribeDataPtr data) {
+  co_await ws_market_->subscribe(stream_name(data->symbol, "aggTrade"));
+}
+
+}  // namespace market::binance
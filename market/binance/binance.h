@@ -0,0 +1,162 @@
+#ifndef MARKET_BINANCE_BINANCE_H_
+#define MARKET_BINANCE_BINANCE_H_
+
+/**
+ * @file binance.h
+ * @brief Binance U本位合约网关
+ *
+ * 行情通过一条公共连接订阅 bookTicker、有限档深度、归集成交和24小时统计；
+ * 订单、成交和持仓通过用户数据流推送，查询和下单使用REST接口。
+ * 交易对使用交易所原始名称，如 BTCUSDT。
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/gateway.h"
+#include "base/local_book.h"
+#include "binance_http.h"
+#include "binance_ws.h"
+#include "engine.h"
+
+namespace market::binance {
+
+class Binance : public base::Gateway {
+ public:
+  /**
+   * @param engine 引擎指针
+   * @param http REST客户端，测试时传入返回预置响应的实现
+   */
+  Binance(engine::EnginePtr engine, std::shared_ptr<BinanceHttp> http = std::make_shared<BinanceHttp>());
+  ~Binance() {}
+
+  /// 连接功能（当前未实现）
+  void connect() override{};
+
+  /// 关闭连接功能（当前未实现）
+  void close() override{};
+
+  /**
+   * @brief 主运行循环，持续从行情和用户数据流接收数据
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> run() override;
+
+  /**
+   * @brief 初始化市场网关，连接行情和用户数据流
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> market_init() override;
+
+  /// 取消订阅（当前未实现）
+  void unsubscribe(const std::string& symbol) override{};
+
+  /// 逐笔下单，失败的订单以 REJECTED 状态回报
+  asio::awaitable<void> send_orders(engine::OrderDataPtr order) override;
+
+  /// 撤销订单
+  asio::awaitable<void> cancel_order(engine::OrderDataPtr order) override;
+
+  asio::awaitable<void> query_account(engine::QueryAccountDataPtr data) override;
+  asio::awaitable<void> query_position(engine::QueryPositionDataPtr data) override;
+  asio::awaitable<void> query_order(engine::QueryOrderDataPtr data) override;
+
+  /**
+   * @brief 订阅订单簿，1档用 bookTicker，其余用5/10/20档深度
+   * @param data 订阅请求数据
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> subscribe_book(engine::SubscribeDataPtr data) override;
+
+  /// 订阅24小时统计作为Tick数据
+  asio::awaitable<void> subscribe_tick(engine::SubscribeDataPtr data) override;
+
+  /// 订阅归集成交，U本位合约没有公开的逐笔成交流
+  asio::awaitable<void> subscribe_trade(engine::SubscribeDataPtr data) override;
+
+  /**
+   * @brief 处理一条已解析的推送，行情和用户数据流共用
+   * @param msg 推送消息
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> dispatch(const WsMessage& msg);
+
+ private:
+  /// 一种订单簿推送的本地状态
+  struct BookState {
+    base::LocalBook book;    ///< 本地订单簿
+    int64_t update_id = -1;  ///< 已转发的最大更新ID，乱序的旧推送丢弃
+  };
+
+  /// 单个交易对的行情状态
+  struct SingleMarket {
+    BookState bbo;              ///< bookTicker 最优买卖价
+    BookState depth;            ///< 有限档深度
+    engine::BookPtr last_book;  ///< 最近一次接收的订单簿数据，供关联到Tick数据
+    int64_t agg_id = -1;        ///< 已转发的最大归集成交ID
+  };
+
+  /**
+   * @brief 处理一条连接上的消息，出错时记录并继续
+   * @param ws 连接
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> watch(std::shared_ptr<BinanceWs> ws);
+
+  asio::awaitable<void> ws_deal(std::shared_ptr<BinanceWs> ws);
+
+  /**
+   * @brief 处理订单簿推送，bookTicker 和有限档深度都是全量
+   * @param state 推送对应的本地订单簿
+   * @param depth 发给引擎的档位数
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> deal_book(const std::string& symbol, BookState& state, int64_t update_id,
+                                  const std::vector<base::BookLevel>& bids, const std::vector<base::BookLevel>& asks,
+                                  int64_t ts, size_t depth, int64_t recv_ns);
+  asio::awaitable<void> deal_trade(const std::string& symbol, const WsAggTrade& trade, int64_t recv_ns);
+  asio::awaitable<void> deal_tick(const std::string& symbol, const WsTicker& ticker, int64_t recv_ns);
+  asio::awaitable<void> deal_order(const OrderDetail& order);
+  asio::awaitable<void> deal_account(const WsAccountUpdate& update);
+
+  /// 将Binance订单转换为统一格式
+  engine::OrderDataItemPtr to_order_item(const OrderDetail& order);
+
+  /// 将Binance持仓转换为统一格式
+  engine::PositionItemPtr to_position_item(const PositionRisk& position);
+
+  /**
+   * @brief 每次连接用户数据流前获取 listenKey
+   * @return asio::awaitable<std::string> 连接路径
+   */
+  asio::awaitable<std::string> user_stream_path();
+
+  /**
+   * @brief 定期续期 listenKey
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> keepalive_loop();
+
+  /**
+   * @brief 行情连接重连后清除本地订单簿，等待新的推送
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> resync_public();
+
+  /**
+   * @brief 用户数据流重连后通过REST补齐订单、持仓和账户
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> resync_private();
+
+  std::shared_ptr<BinanceHttp> http_;         ///< REST客户端
+  std::shared_ptr<BinanceWs> ws_market_;      ///< 行情连接
+  std::shared_ptr<BinanceWs> ws_user_;        ///< 用户数据流，未配置密钥时为空
+  std::map<std::string, SingleMarket> markets_;
+  std::map<std::string, size_t> book_depths_;  ///< 交易对订阅的订单簿档位数
+};
+
+}  // namespace market::binance
+
+#endif  // MARKET_BINANCE_BINANCE_H_
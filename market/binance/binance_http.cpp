@@ -0,0 +1,104 @@
+#include "binance_http.h"
+
+#include <chrono>
+
+#include "httpcpp/request.h"
+#include "jsoncpp/jsoncpp.hpp"
+#include "utils/async_log.h"
+#include "utils/latency.h"
+
+namespace market::binance {
+
+namespace {
+
+/// 查询的订单不存在
+constexpr int64_t kOrderNotExistCode = -2013;
+
+int64_t now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+BinanceHttp::BinanceHttp() : api_key_(binance_config->api_key()), secret_key_(binance_config->secret_key()) {}
+
+asio::awaitable<std::string> BinanceHttp::request(const base::RestEndpoint& endpoint, std::string query, bool sign) {
+  if (sign) {
+    query += fmt::format("{}timestamp={}&recvWindow={}", query.empty() ? "" : "&", now_ms(),
+                         binance_config->recv_window_ms());
+    query += "&signature=" + Common::sha256_hash_hex(query, secret_key_);
+  }
+
+  auto url = binance_config->rest_url() + endpoint.path + (query.empty() ? "" : "?" + query);
+  cpphttp::HttpRequest request(url, endpoint.method, "");
+  request.set_header({
+      {"X-MBX-APIKEY", api_key_},
+      {"User-Agent", "qitrader"},
+  });
+
+  auto start_ns = Common::now_ns();
+  auto resp = co_await request.request();
+  endpoint.latency->observe_since(start_ns);
+
+  co_return resp;
+}
+
+asio::awaitable<Account> BinanceHttp::get_account() {
+  auto resp = co_await request(account_, "", true);
+  co_return *jsoncpp::from_json<Account>(resp);
+}
+
+asio::awaitable<std::vector<PositionRisk>> BinanceHttp::get_positions() {
+  auto resp = co_await request(position_risk_, "", true);
+  co_return *jsoncpp::from_json<std::vector<PositionRisk>>(resp);
+}
+
+asio::awaitable<std::vector<OrderDetail>> BinanceHttp::get_open_orders() {
+  auto resp = co_await request(open_orders_, "", true);
+  co_return *jsoncpp::from_json<std::vector<OrderDetail>>(resp);
+}
+
+asio::awaitable<std::optional<OrderDetail>> BinanceHttp::get_order(const std::string& symbol,
+                                                                   const std::string& client_order_id) {
+  auto query = fmt::format("symbol={}&origClientOrderId={}", symbol, client_order_id);
+  auto resp = co_await request(query_order_, query, true);
+  auto rsp = jsoncpp::from_json<OrderResponse>(resp);
+  if (rsp->code == kOrderNotExistCode) {
+    co_return std::nullopt;
+  }
+  if (rsp->code < 0) {
+    throw std::runtime_error(fmt::format("get order failed, code: {}, msg: {}", rsp->code, rsp->msg));
+  }
+  co_return rsp->order;
+}
+
+asio::awaitable<OrderResponse> BinanceHttp::send_order(const SendOrderRequest& req) {
+  auto query = fmt::format("symbol={}&side={}&type={}&quantity={}&newClientOrderId={}&newOrderRespType=ACK",
+                           req.symbol, req.side, req.type, req.quantity, req.newClientOrderId);
+  if (req.type == "LIMIT") {
+    query += fmt::format("&price={}&timeInForce=GTC", req.price);
+  }
+  auto resp = co_await request(new_order_, query, true);
+  co_return *jsoncpp::from_json<OrderResponse>(resp);
+}
+
+asio::awaitable<OrderResponse> BinanceHttp::cancel_order(const std::string& symbol, const std::string& order_id,
+                                                         const std::string& client_order_id) {
+  auto query = order_id.empty() ? fmt::format("symbol={}&origClientOrderId={}", symbol, client_order_id)
+                                : fmt::format("symbol={}&orderId={}", symbol, order_id);
+  auto resp = co_await request(cancel_order_, query, true);
+  co_return *jsoncpp::from_json<OrderResponse>(resp);
+}
+
+asio::awaitable<std::string> BinanceHttp::new_listen_key() {
+  auto resp = co_await request(new_listen_key_, "", false);
+  co_return jsoncpp::from_json<ListenKey>(resp)->listenKey;
+}
+
+asio::awaitable<void> BinanceHttp::keepalive_listen_key() {
+  auto resp = co_await request(keepalive_listen_key_, "", false);
+  jsoncpp::from_json<ListenKey>(resp);
+}
+
+}  // namespace market::binance
@@ -0,0 +1,83 @@
+#ifndef MARKET_BINANCE_BINANCE_HTTP_H_
+#define MARKET_BINANCE_BINANCE_HTTP_H_
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/rest_endpoint.h"
+#include "data.hpp"
+#include "utils/utils.h"
+
+namespace market::binance {
+
+/**
+ * @brief Binance U本位合约REST客户端
+ *
+ * 参数都放在查询字符串中，需要鉴权的接口追加 timestamp、recvWindow 和 HMAC-SHA256 十六进制签名。
+ * 所有接口经 request 发出，测试中由子类替换为返回预置响应。
+ */
+class BinanceHttp {
+ public:
+  BinanceHttp();
+  virtual ~BinanceHttp() {}
+
+  asio::awaitable<Account> get_account();
+  asio::awaitable<std::vector<PositionRisk>> get_positions();
+  asio::awaitable<std::vector<OrderDetail>> get_open_orders();
+
+  /**
+   * @brief 按客户端订单ID查询单笔订单，包括已完成的订单
+   * @return asio::awaitable<std::optional<OrderDetail>> 订单不存在时为空
+   */
+  asio::awaitable<std::optional<OrderDetail>> get_order(const std::string& symbol, const std::string& client_order_id);
+
+  /**
+   * @brief 下单，失败时返回的 code 为负数
+   * @param request 下单请求
+   * @return asio::awaitable<OrderResponse> 下单结果
+   */
+  asio::awaitable<OrderResponse> send_order(const SendOrderRequest& request);
+
+  /**
+   * @brief 撤单，优先按交易所订单ID，其次按客户端订单ID
+   * @return asio::awaitable<OrderResponse> 撤单结果
+   */
+  asio::awaitable<OrderResponse> cancel_order(const std::string& symbol, const std::string& order_id,
+                                              const std::string& client_order_id);
+
+  /// 创建用户数据流，已有有效的 listenKey 时返回同一个
+  asio::awaitable<std::string> new_listen_key();
+
+  /// 延长用户数据流有效期
+  asio::awaitable<void> keepalive_listen_key();
+
+ protected:
+  /**
+   * @brief 发送请求
+   * @param endpoint 接口
+   * @param query 查询参数，不含签名
+   * @param sign 是否需要签名
+   * @return asio::awaitable<std::string> 响应内容
+   */
+  virtual asio::awaitable<std::string> request(const base::RestEndpoint& endpoint, std::string query, bool sign);
+
+ private:
+
+  std::string api_key_;
+  std::string secret_key_;
+
+  base::RestEndpoint account_{"binance", "GET", "/fapi/v2/account"};
+  base::RestEndpoint position_risk_{"binance", "GET", "/fapi/v2/positionRisk"};
+  base::RestEndpoint open_orders_{"binance", "GET", "/fapi/v1/openOrders"};
+  base::RestEndpoint query_order_{"binance", "GET", "/fapi/v1/order"};
+  base::RestEndpoint new_order_{"binance", "POST", "/fapi/v1/order"};
+  base::RestEndpoint cancel_order_{"binance", "DELETE", "/fapi/v1/order"};
+  base::RestEndpoint new_listen_key_{"binance", "POST", "/fapi/v1/listenKey"};
+  base::RestEndpoint keepalive_listen_key_{"binance", "PUT", "/fapi/v1/listenKey"};
+};
+
+}  // namespace market::binance
+
+#endif  // MARKET_BINANCE_BINANCE_HTTP_H_
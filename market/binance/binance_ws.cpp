@@ -0,0 +1,223 @@
+#include "binance_ws.h"
+
+#include <boost/asio/redirect_error.hpp>
+
+#include "utils/async_log.h"
+#include "utils/latency.h"
+
+namespace market::binance {
+
+namespace {
+
+/// 重连退避初始值
+constexpr int64_t kBackoffMinMs = 500;
+
+/// 单个订阅请求最多包含的数据流数
+constexpr size_t kMaxStreamsPerRequest = 100;
+
+}  // namespace
+
+BinanceWs::BinanceWs(boost::asio::any_io_executor& ctx, size_t channel_size, std::string name, PathProvider path)
+    : name_(std::move(name)),
+      path_(std::move(path)),
+      read_channel_(ctx, channel_size),
+      write_channel_(ctx, channel_size),
+      wake_(ctx) {
+  auto label = fmt::format("exchange=\"binance\",uri=\"{}\",conn=\"0\"", name_);
+  connects_ = &metrics_registry.counter("qitrader_ws_connects_total", "WebSocket connects including reconnects", label);
+  reconnects_ = &metrics_registry.counter("qitrader_ws_reconnects_total", "WebSocket reconnect attempts", label);
+  messages_ = &metrics_registry.counter("qitrader_ws_messages_total", "WebSocket messages received", label);
+  errors_ = &metrics_registry.counter("qitrader_ws_errors_total", "WebSocket read and write errors", label);
+  connected_gauge_ = &metrics_registry.gauge("qitrader_ws_connected", "WebSocket connection is up", label);
+}
+
+asio::awaitable<void> BinanceWs::connect() {
+  auto ctx = co_await asio::this_coro::executor;
+
+  // 首次连接失败同样交给监督协程重试
+  try {
+    co_await open();
+  } catch (const std::exception& e) {
+    errors_->inc();
+    QLOG(ERROR, "binance {} connect failed: {}", name_, e.what());
+  }
+
+  co_spawn(
+      ctx, [this] { return write_loop(); }, asio::detached);
+  co_spawn(
+      ctx, [this] { return supervise(); }, asio::detached);
+}
+
+asio::awaitable<void> BinanceWs::open() {
+  auto ctx = co_await asio::this_coro::executor;
+
+  auto path = co_await path_();
+  auto ws = std::make_shared<cpphttp::WebSocket>(binance_config->ws_url() + path);
+  ws->add_header("User-Agent", "qitrader");
+  co_await ws->connect();
+
+  ws_ = ws;
+  ++generation_;
+  connected_ = true;
+  connects_->inc();
+  connected_gauge_->set(1);
+
+  co_spawn(ctx, read_loop(ws, generation_), asio::detached);
+}
+
+void BinanceWs::drop(uint64_t generation) {
+  if (generation != generation_ || !connected_) {
+    return;
+  }
+  connected_ = false;
+  connected_gauge_->set(0);
+
+  // 关闭旧连接：心跳超时时读协程还阻塞在 read 上，关闭后读出错退出，释放套接字和协程
+  if (auto ws = std::move(ws_)) {
+    try {
+      ws->close();
+    } catch (const std::exception& e) {
+      QLOG(WARNING, "binance {} close error: {}", name_, e.what());
+    }
+  }
+  wake_.cancel();
+}
+
+asio::awaitable<void> BinanceWs::supervise() {
+  auto ctx = co_await asio::this_coro::executor;
+  asio::steady_timer backoff_timer(ctx);
+
+  while (true) {
+    // 等待连接失效
+    if (connected_) {
+      boost::system::error_code ec;
+      wake_.expires_at(asio::steady_timer::time_point::max());
+      co_await wake_.async_wait(asio::redirect_error(asio::use_awaitable, ec));
+      continue;
+    }
+
+    // 指数退避重连
+    int64_t backoff_ms = kBackoffMinMs;
+    while (!connected_) {
+      reconnects_->inc();
+      QLOG(WARNING, "binance {} disconnected, reconnect in {}ms", name_, backoff_ms);
+      backoff_timer.expires_after(std::chrono::milliseconds(backoff_ms));
+      co_await backoff_timer.async_wait(asio::use_awaitable);
+      backoff_ms = std::min<int64_t>(backoff_ms * 2, binance_config->ws_backoff_max_ms());
+
+      try {
+        co_await open();
+      } catch (const std::exception& e) {
+        errors_->inc();
+        QLOG(ERROR, "binance {} reconnect failed: {}", name_, e.what());
+      } catch (...) {
+        errors_->inc();
+        QLOG(ERROR, "binance {} reconnect failed: unknown error", name_);
+      }
+    }
+
+    co_await send_subscribe(streams_);
+    QLOG(INFO, "binance {} reconnected, replayed {} streams", name_, streams_.size());
+
+    if (on_reconnect_) {
+      try {
+        co_await on_reconnect_();
+      } catch (const std::exception& e) {
+        QLOG(ERROR, "binance {} resync after reconnect failed: {}", name_, e.what());
+      }
+    }
+  }
+}
+
+asio::awaitable<WsMessage> BinanceWs::read() {
+  auto rsp = co_await read_channel_.async_receive();
+  co_return rsp;
+}
+
+asio::awaitable<void> BinanceWs::subscribe(const std::string& stream) {
+  if (!stream_set_.insert(stream).second) {
+    co_return;
+  }
+  streams_.push_back(stream);
+  std::vector<std::string> streams{stream};
+  co_await send_subscribe(streams);
+}
+
+asio::awaitable<void> BinanceWs::send_subscribe(const std::vector<std::string>& streams) {
+  for (size_t i = 0; i < streams.size(); i += kMaxStreamsPerRequest) {
+    auto end = std::min(streams.size(), i + kMaxStreamsPerRequest);
+    std::vector<std::string> params(streams.begin() + i, streams.begin() + end);
+    auto msg = fmt::format(R"({{"method":"SUBSCRIBE","params":{},"id":{}}})", jsoncpp::to_json(params), ++request_id_);
+    co_await write_channel_.async_send(boost::system::error_code{}, msg, asio::use_awaitable);
+  }
+}
+
+asio::awaitable<void> BinanceWs::read_loop(std::shared_ptr<cpphttp::WebSocket> ws, uint64_t generation) {
+  while (true) {
+    std::string rsp;
+    // 读失败说明连接已断开，交给监督协程重连
+    try {
+      rsp = co_await ws->read();
+    } catch (const boost::system::error_code& e) {
+      errors_->inc();
+      QLOG(ERROR, "binance {} Error in read_loop: code {} {}", name_, e.value(), e.what());
+      drop(generation);
+      co_return;
+    } catch (const std::exception& e) {
+      errors_->inc();
+      QLOG(ERROR, "binance {} Error in read_loop: {}", name_, e.what());
+      drop(generation);
+      co_return;
+    } catch (...) {
+      errors_->inc();
+      QLOG(ERROR, "binance {} Unknown error in read_loop", name_);
+      drop(generation);
+      co_return;
+    }
+
+    if (generation != generation_) {
+      co_return;
+    }
+
+    try {
+      auto recv_ns = Common::now_ns();
+      auto msg = jsoncpp::from_json<WsMessage>(rsp);
+      msg->recv_ns = recv_ns;
+      messages_->inc();
+      latency_stats.record_since(Common::LatencyStage::kWsParse, recv_ns);
+      co_await read_channel_.async_send(boost::system::error_code{}, *msg, asio::use_awaitable);
+    } catch (const std::exception& e) {
+      errors_->inc();
+      QLOG(ERROR, "binance {} Error parsing message: {}", name_, e.what());
+    }
+  }
+}
+
+asio::awaitable<void> BinanceWs::write_loop() {
+  while (true) {
+    auto msg = co_await write_channel_.async_receive();
+    // 断线期间的消息丢弃，订阅会在重连后重放
+    if (!connected_) {
+      continue;
+    }
+    auto ws = ws_;
+    auto generation = generation_;
+    try {
+      co_await ws->write(msg);
+    } catch (const boost::system::error_code& e) {
+      errors_->inc();
+      QLOG(ERROR, "binance {} Error in write_loop: code {} {}", name_, e.value(), e.what());
+      drop(generation);
+    } catch (const std::exception& e) {
+      errors_->inc();
+      QLOG(ERROR, "binance {} Error in write_loop: {}", name_, e.what());
+      drop(generation);
+    } catch (...) {
+      errors_->inc();
+      QLOG(ERROR, "binance {} Unknown error in write_loop", name_);
+      drop(generation);
+    }
+  }
+}
+
+}  // namespace market::binance
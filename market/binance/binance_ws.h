@@ -0,0 +1,106 @@
+#ifndef MARKET_BINANCE_BINANCE_WS_H_
+#define MARKET_BINANCE_BINANCE_WS_H_
+
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/asio/experimental/concurrent_channel.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include "data.hpp"
+#include "httpcpp/WebSocket.h"
+#include "utils/metrics.h"
+
+namespace market::binance {
+
+/**
+ * @brief Binance WebSocket连接
+ *
+ * 行情连接通过 SUBSCRIBE 请求订阅数据流；用户数据流的路径包含 listenKey，每次连接前重新获取。
+ * 读失败后按指数退避重连，重连成功后重放所有订阅，再调用 on_reconnect。
+ */
+class BinanceWs {
+ public:
+  /// 连接建立后的回调
+  typedef std::function<asio::awaitable<void>()> Hook;
+  /// 每次连接前获取路径
+  typedef std::function<asio::awaitable<std::string>()> PathProvider;
+
+  /**
+   * @param ctx 执行器
+   * @param channel_size 读写通道容量
+   * @param name 连接名称，用于日志和指标
+   * @param path 连接路径，返回路径的协程
+   */
+  BinanceWs(boost::asio::any_io_executor& ctx, size_t channel_size, std::string name, PathProvider path);
+  ~BinanceWs() {}
+
+  /**
+   * @brief 首次连接并启动读写和监督协程
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> connect();
+  asio::awaitable<WsMessage> read();
+
+  /// 重连并重放订阅后调用，首次连接不调用
+  void set_on_reconnect(Hook hook) { on_reconnect_ = std::move(hook); }
+
+  /// 当前是否已连接
+  bool connected() const { return connected_; }
+
+  /**
+   * @brief 订阅数据流并记录，重连后自动重放
+   * @param stream 数据流名称，如 btcusdt@aggTrade，相同名称只订阅一次
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> subscribe(const std::string& stream);
+
+ private:
+  /// 建立一条新连接
+  asio::awaitable<void> open();
+
+  /// 连接断开后退避重连，并重放订阅
+  asio::awaitable<void> supervise();
+
+  asio::awaitable<void> read_loop(std::shared_ptr<cpphttp::WebSocket> ws, uint64_t generation);
+  asio::awaitable<void> write_loop();
+
+  /// 发送一批数据流的订阅请求
+  asio::awaitable<void> send_subscribe(const std::vector<std::string>& streams);
+
+  /// 标记当前连接失效并唤醒监督协程
+  void drop(uint64_t generation);
+
+  std::string name_;
+  PathProvider path_;
+  std::shared_ptr<cpphttp::WebSocket> ws_;
+
+  asio::experimental::concurrent_channel<void(boost::system::error_code, WsMessage)> read_channel_;
+  asio::experimental::concurrent_channel<void(boost::system::error_code, std::string)> write_channel_;
+
+  /// 监督协程在此等待连接失效
+  asio::steady_timer wake_;
+
+  uint64_t generation_ = 0;
+  bool connected_ = false;
+  int64_t request_id_ = 0;
+
+  Hook on_reconnect_;
+
+  /// 按订阅顺序保存的数据流，用于重放
+  std::vector<std::string> streams_;
+  std::set<std::string> stream_set_;
+
+  Common::Counter* connects_ = nullptr;
+  Common::Counter* reconnects_ = nullptr;
+  Common::Counter* messages_ = nullptr;
+  Common::Counter* errors_ = nullptr;
+  Common::Gauge* connected_gauge_ = nullptr;
+};
+
+}  // namespace market::binance
+
+#endif  // MARKET_BINANCE_BINANCE_WS_H_
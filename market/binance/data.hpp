@@ -0,0 +1,441 @@
+#ifndef MARKET_BINANCE_DATA_H_
+#define MARKET_BINANCE_DATA_H_
+
+#include <utils/utils.h>
+
+#include <any>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/local_book.h"
+#include "config/config.h"
+#include "utils/fixed_point.hpp"
+
+namespace market::binance {
+
+class BinanceConfig : public Config::ConfigTree {
+ public:
+  BinanceConfig() : ConfigTree("binance"){};
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+
+    m_api_key = this->get<std::string>("api_key", "");
+    m_secret_key = this->get<std::string>("secret_key", "");
+    m_rest_url = this->get<std::string>("rest_url", "https://fapi.binance.com");
+    m_ws_url = this->get<std::string>("ws_url", "wss://fstream.binance.com");
+    m_recv_window_ms = this->get<uint32_t>("recv_window_ms", 5000);
+    m_ws_backoff_max_ms = this->get<uint32_t>("ws_backoff_max_ms", 30000);
+    m_listen_key_keepalive_s = this->get<uint32_t>("listen_key_keepalive_s", 1800);
+  }
+
+  std::string api_key() const { return m_api_key; }
+  std::string secret_key() const { return m_secret_key; }
+  /// REST 地址，可指向本地模拟服务
+  const std::string& rest_url() const { return m_rest_url; }
+  /// WebSocket 地址，可指向本地模拟服务
+  const std::string& ws_url() const { return m_ws_url; }
+  /// 签名请求的有效时间窗口
+  uint32_t recv_window_ms() const { return m_recv_window_ms; }
+  /// 重连退避上限
+  uint32_t ws_backoff_max_ms() const { return m_ws_backoff_max_ms; }
+  /// 用户数据流 listenKey 续期间隔，listenKey 60分钟不续期失效
+  uint32_t listen_key_keepalive_s() const { return m_listen_key_keepalive_s; }
+
+ private:
+  std::string m_api_key;
+  std::string m_secret_key;
+  std::string m_rest_url = "https://fapi.binance.com";
+  std::string m_ws_url = "wss://fstream.binance.com";
+  uint32_t m_recv_window_ms = 5000;
+  uint32_t m_ws_backoff_max_ms = 30000;
+  uint32_t m_listen_key_keepalive_s = 1800;
+};
+
+#define binance_config ::Common::SingletonPtr<::market::binance::BinanceConfig>::get_instance()
+
+struct AccountAsset {
+  std::string asset;
+  Common::Fixed walletBalance;
+  Common::Fixed marginBalance;
+};
+
+struct Account {
+  int64_t updateTime;
+  Common::Fixed totalMarginBalance;
+  std::vector<AccountAsset> assets;
+};
+
+struct PositionRisk {
+  std::string symbol;
+  std::string positionSide;  // BOTH 单向持仓，LONG/SHORT 双向持仓
+  Common::Fixed positionAmt;
+  Common::Fixed entryPrice;
+  Common::Fixed unRealizedProfit;
+  int64_t updateTime;
+};
+
+struct OrderDetail {
+  std::string symbol;
+  int64_t orderId;
+  std::string clientOrderId;
+  std::string side;    // BUY/SELL
+  std::string type;    // LIMIT/MARKET
+  std::string status;  // NEW/PARTIALLY_FILLED/FILLED/CANCELED/EXPIRED/REJECTED
+
+  Common::Fixed price;        // 委托价格
+  Common::Fixed origQty;      // 委托数量
+  Common::Fixed executedQty;  // 已成交数量
+  Common::Fixed avgPrice;     // 成交均价
+  int64_t updateTime;
+
+  // 最近一笔成交，只有用户数据流推送
+  int64_t tradeId = 0;
+  Common::Fixed lastPx;
+  Common::Fixed lastQty;
+  Common::Fixed commission;  // 手续费，正数为扣除
+  std::string commissionAsset;
+  bool maker = false;
+  int64_t tradeTime = 0;
+};
+
+/// 下单、撤单的返回，失败时 code 为负数
+struct OrderResponse {
+  int64_t code = 0;
+  std::string msg;
+  OrderDetail order;
+};
+
+struct SendOrderRequest {
+  std::string symbol;
+  std::string side;
+  std::string type;
+  std::string quantity;
+  std::string price;
+  std::string newClientOrderId;
+};
+
+struct ListenKey {
+  std::string listenKey;
+};
+
+/// 最优买卖价推送
+struct WsBookTicker {
+  int64_t updateId;
+  std::vector<base::BookLevel> bids;  // 1档
+  std::vector<base::BookLevel> asks;  // 1档
+  int64_t ts;
+};
+
+/// 有限档深度推送，每次都是全量
+struct WsDepth {
+  int64_t updateId;
+  std::vector<base::BookLevel> bids;
+  std::vector<base::BookLevel> asks;
+  int64_t ts;
+};
+
+/// 归集成交
+struct WsAggTrade {
+  int64_t aggId;
+  Common::Fixed px;
+  Common::Fixed qty;
+  bool buyerMaker;  // 买方是挂单方，即主动方为卖方
+  int64_t ts;
+};
+
+/// 24小时统计
+struct WsTicker {
+  Common::Fixed last;
+  Common::Fixed lastQty;
+  Common::Fixed volume;  // 24h成交量
+  Common::Fixed open;
+  Common::Fixed high;
+  Common::Fixed low;
+  int64_t ts;
+};
+
+/// 账户和持仓变化推送
+struct WsAccountUpdate {
+  std::vector<AccountAsset> balances;
+  std::vector<PositionRisk> positions;
+  int64_t ts;
+};
+
+struct WsMessage {
+  std::string event;  // 推送事件类型，订阅请求的返回为 response
+  std::string symbol;
+  int64_t id = 0;  // 订阅请求的返回对应的请求ID
+
+  // 数据
+  std::any data;
+
+  // 错误
+  int64_t code = 0;
+  std::string msg;
+
+  int64_t recv_ns = 0;  // 收到原始消息的时间（单调时钟纳秒）
+};
+
+/// 读取字符串字段，缺失时为空，数值字段直接在JSON缓冲区上解析
+inline std::string_view json_str(const jsoncpp::bj::object& jo, const char* key) {
+  auto v = jo.if_contains(key);
+  if (!v || !v->is_string()) {
+    return {};
+  }
+  auto& s = v->as_string();
+  return std::string_view(s.data(), s.size());
+}
+
+inline Common::Fixed json_fixed(const jsoncpp::bj::object& jo, const char* key) {
+  return Common::Fixed::from_string(json_str(jo, key));
+}
+
+inline int64_t json_int(const jsoncpp::bj::object& jo, const char* key) {
+  auto v = jo.if_contains(key);
+  return v && v->is_int64() ? v->as_int64() : 0;
+}
+
+inline bool json_bool(const jsoncpp::bj::object& jo, const char* key) {
+  auto v = jo.if_contains(key);
+  return v && v->is_bool() && v->as_bool();
+}
+
+/// REST 接口出错时返回 {"code": 负数, "msg": ...}
+inline void check_error(const jsoncpp::bj::value& jv) {
+  if (!jv.is_object()) {
+    return;
+  }
+  auto code = json_int(jv.as_object(), "code");
+  if (code < 0) {
+    throw std::runtime_error(fmt::format("binance error {}: {}", code, json_str(jv.as_object(), "msg")));
+  }
+}
+
+inline void parse_levels(const jsoncpp::bj::value& jv, std::vector<base::BookLevel>& levels) {
+  // [[价格, 数量], ...]
+  for (auto& level : jv.as_array()) {
+    auto& ja = level.as_array();
+    auto& px = ja.at(0).as_string();
+    auto& sz = ja.at(1).as_string();
+    levels.push_back({Common::Fixed::from_string(std::string_view(px.data(), px.size())),
+                      Common::Fixed::from_string(std::string_view(sz.data(), sz.size()))});
+  }
+}
+
+}  // namespace market::binance
+
+namespace jsoncpp {
+
+template <>
+struct transform<market::binance::AccountAsset> {
+  static void trans(const bj::value &jv, market::binance::AccountAsset &t) {
+    using namespace market::binance;
+    auto& jo = jv.as_object();
+    t.asset = json_str(jo, "asset");
+    t.walletBalance = json_fixed(jo, "walletBalance");
+    t.marginBalance = json_fixed(jo, "marginBalance");
+  }
+};
+
+template <>
+struct transform<market::binance::Account> {
+  static void trans(const bj::value &jv, market::binance::Account &t) {
+    using namespace market::binance;
+    check_error(jv);
+    auto& jo = jv.as_object();
+    t.updateTime = json_int(jo, "updateTime");
+    t.totalMarginBalance = json_fixed(jo, "totalMarginBalance");
+    transform<decltype(t.assets)>::trans(jo.at("assets"), t.assets);
+  }
+};
+
+template <>
+struct transform<market::binance::PositionRisk> {
+  static void trans(const bj::value &jv, market::binance::PositionRisk &t) {
+    using namespace market::binance;
+    auto& jo = jv.as_object();
+    t.symbol = json_str(jo, "symbol");
+    t.positionSide = json_str(jo, "positionSide");
+    t.positionAmt = json_fixed(jo, "positionAmt");
+    t.entryPrice = json_fixed(jo, "entryPrice");
+    t.unRealizedProfit = json_fixed(jo, "unRealizedProfit");
+    t.updateTime = json_int(jo, "updateTime");
+  }
+};
+
+template <>
+struct transform<std::vector<market::binance::PositionRisk>> {
+  static void trans(const bj::value &jv, std::vector<market::binance::PositionRisk> &t) {
+    market::binance::check_error(jv);
+    for (auto& item : jv.as_array()) {
+      transform<market::binance::PositionRisk>::trans(item, t.emplace_back());
+    }
+  }
+};
+
+template <>
+struct transform<market::binance::OrderDetail> {
+  static void trans(const bj::value &jv, market::binance::OrderDetail &t) {
+    using namespace market::binance;
+    auto& jo = jv.as_object();
+    t.symbol = json_str(jo, "symbol");
+    t.orderId = json_int(jo, "orderId");
+    t.clientOrderId = json_str(jo, "clientOrderId");
+    t.side = json_str(jo, "side");
+    t.type = json_str(jo, "type");
+    t.status = json_str(jo, "status");
+    t.price = json_fixed(jo, "price");
+    t.origQty = json_fixed(jo, "origQty");
+    t.executedQty = json_fixed(jo, "executedQty");
+    t.avgPrice = json_fixed(jo, "avgPrice");
+    t.updateTime = json_int(jo, "updateTime");
+  }
+};
+
+template <>
+struct transform<std::vector<market::binance::OrderDetail>> {
+  static void trans(const bj::value &jv, std::vector<market::binance::OrderDetail> &t) {
+    market::binance::check_error(jv);
+    for (auto& item : jv.as_array()) {
+      transform<market::binance::OrderDetail>::trans(item, t.emplace_back());
+    }
+  }
+};
+
+template <>
+struct transform<market::binance::OrderResponse> {
+  static void trans(const bj::value &jv, market::binance::OrderResponse &t) {
+    using namespace market::binance;
+    auto& jo = jv.as_object();
+    t.code = json_int(jo, "code");
+    if (t.code < 0) {
+      t.msg = json_str(jo, "msg");
+      return;
+    }
+    transform<OrderDetail>::trans(jv, t.order);
+  }
+};
+
+template <>
+struct transform<market::binance::ListenKey> {
+  static void trans(const bj::value &jv, market::binance::ListenKey &t) {
+    market::binance::check_error(jv);
+    t.listenKey = market::binance::json_str(jv.as_object(), "listenKey");
+  }
+};
+
+template <>
+struct transform<market::binance::WsMessage> {
+  static void trans(const bj::value &jv, market::binance::WsMessage &t) {
+    using namespace market::binance;
+    auto& jo = jv.as_object();
+
+    // 订阅请求的返回：{"result": null, "id": 1}，失败时带 error
+    if (!jo.contains("e")) {
+      t.event = "response";
+      t.id = json_int(jo, "id");
+      if (auto error = jo.if_contains("error"); error && error->is_object()) {
+        t.code = json_int(error->as_object(), "code");
+        t.msg = json_str(error->as_object(), "msg");
+      }
+      return;
+    }
+
+    t.event = json_str(jo, "e");
+    t.symbol = json_str(jo, "s");
+    if (t.event == "bookTicker") {
+      WsBookTicker data;
+      data.updateId = json_int(jo, "u");
+      data.bids.push_back({json_fixed(jo, "b"), json_fixed(jo, "B")});
+      data.asks.push_back({json_fixed(jo, "a"), json_fixed(jo, "A")});
+      data.ts = json_int(jo, "T");
+      t.data = data;
+    } else if (t.event == "depthUpdate") {
+      WsDepth data;
+      data.updateId = json_int(jo, "u");
+      parse_levels(jo.at("b"), data.bids);
+      parse_levels(jo.at("a"), data.asks);
+      data.ts = json_int(jo, "T");
+      t.data = data;
+    } else if (t.event == "aggTrade") {
+      WsAggTrade data;
+      data.aggId = json_int(jo, "a");
+      data.px = json_fixed(jo, "p");
+      data.qty = json_fixed(jo, "q");
+      data.buyerMaker = json_bool(jo, "m");
+      data.ts = json_int(jo, "T");
+      t.data = data;
+    } else if (t.event == "24hrTicker") {
+      WsTicker data;
+      data.last = json_fixed(jo, "c");
+      data.lastQty = json_fixed(jo, "Q");
+      data.volume = json_fixed(jo, "v");
+      data.open = json_fixed(jo, "o");
+      data.high = json_fixed(jo, "h");
+      data.low = json_fixed(jo, "l");
+      data.ts = json_int(jo, "E");
+      t.data = data;
+    } else if (t.event == "ORDER_TRADE_UPDATE") {
+      t.data = trans_order(jo.at("o").as_object(), json_int(jo, "T"));
+    } else if (t.event == "ACCOUNT_UPDATE") {
+      t.data = trans_account(jo.at("a").as_object(), json_int(jo, "T"));
+    }
+  }
+
+  static market::binance::OrderDetail trans_order(const bj::object &jo, int64_t ts) {
+    using namespace market::binance;
+    OrderDetail order;
+    order.symbol = json_str(jo, "s");
+    order.orderId = json_int(jo, "i");
+    order.clientOrderId = json_str(jo, "c");
+    order.side = json_str(jo, "S");
+    order.type = json_str(jo, "o");
+    order.status = json_str(jo, "X");
+    order.price = json_fixed(jo, "p");
+    order.origQty = json_fixed(jo, "q");
+    order.executedQty = json_fixed(jo, "z");
+    order.avgPrice = json_fixed(jo, "ap");
+    order.updateTime = ts;
+
+    // 本次推送为成交时带有成交明细
+    if (json_str(jo, "x") == "TRADE") {
+      order.tradeId = json_int(jo, "t");
+      order.lastPx = json_fixed(jo, "L");
+      order.lastQty = json_fixed(jo, "l");
+      order.commission = json_fixed(jo, "n");
+      order.commissionAsset = json_str(jo, "N");
+      order.maker = json_bool(jo, "m");
+      order.tradeTime = json_int(jo, "T");
+    }
+    return order;
+  }
+
+  static market::binance::WsAccountUpdate trans_account(const bj::object &jo, int64_t ts) {
+    using namespace market::binance;
+    WsAccountUpdate update;
+    update.ts = ts;
+    for (auto& item : jo.at("B").as_array()) {
+      auto& bo = item.as_object();
+      update.balances.push_back({std::string(json_str(bo, "a")), json_fixed(bo, "wb"), json_fixed(bo, "cw")});
+    }
+    for (auto& item : jo.at("P").as_array()) {
+      auto& po = item.as_object();
+      PositionRisk position;
+      position.symbol = json_str(po, "s");
+      position.positionSide = json_str(po, "ps");
+      position.positionAmt = json_fixed(po, "pa");
+      position.entryPrice = json_fixed(po, "ep");
+      position.unRealizedProfit = json_fixed(po, "up");
+      position.updateTime = ts;
+      update.positions.push_back(position);
+    }
+    return update;
+  }
+};
+
+}  // namespace jsoncpp
+
+#endif  // MARKET_BINANCE_DATA_H_
@@ -3,10 +3,14 @@
 
 #include <utils/utils.h>
 
+#include <boost/algorithm/string.hpp>
+#include <charconv>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "config/config.h"
+#include "utils/fixed_point.hpp"
 namespace market::okx {
 
 class OkxConfig : public Config::ConfigTree {
@@ -16,22 +20,60 @@ class OkxConfig : public Config::ConfigTree {
   void load(std::shared_ptr<Config::ptree> pt) override {
     m_ptree = pt;
 
-    m_api_key = this->get<std::string>("api_key");
-    m_secret_key = this->get<std::string>("secret_key");
-    m_passphrase = this->get<std::string>("passphrase");
-    m_sim = this->get<bool>("sim");
+    m_api_key = this->get<std::string>("api_key", "");
+    m_secret_key = this->get<std::string>("secret_key", "");
+    m_passphrase = this->get<std::string>("passphrase", "");
+    m_sim = this->get<bool>("sim", false);
+    m_ws_ping_interval_s = this->get<uint32_t>("ws_ping_interval_s", 20);
+    m_ws_backoff_max_ms = this->get<uint32_t>("ws_backoff_max_ms", 30000);
+    m_public_connections = std::max<uint32_t>(1, this->get<uint32_t>("public_connections", 1));
+    m_public_shard = this->get<std::string>("public_shard", "hash");
+    m_redundant_copies = std::max<uint32_t>(1, this->get<uint32_t>("redundant_copies", 2));
+    m_book_resync_timeout_ms = this->get<uint32_t>("book_resync_timeout_ms", 5000);
+
+    m_redundant_symbols.clear();
+    std::vector<std::string> symbols;
+    auto redundant = this->get<std::string>("redundant_symbols", "");
+    boost::split(symbols, redundant, boost::is_any_of(","));
+    for (auto& symbol : symbols) {
+      boost::trim(symbol);
+      if (!symbol.empty()) {
+        m_redundant_symbols.insert(symbol);
+      }
+    }
   }
 
   std::string api_key() const { return m_api_key; }
   std::string secret_key() const { return m_secret_key; }
   std::string passphrase() const { return m_passphrase; }
   bool sim() const { return m_sim; }
+  /// 无数据多久发送一次 ping，两倍时间仍无数据则重连
+  uint32_t ws_ping_interval_s() const { return m_ws_ping_interval_s; }
+  /// 重连退避上限
+  uint32_t ws_backoff_max_ms() const { return m_ws_backoff_max_ms; }
+  /// 公共连接数，订阅按交易对分散到各连接
+  uint32_t public_connections() const { return m_public_connections; }
+  /// 分片方式：hash 按交易对哈希，load 选订阅最少的连接
+  const std::string& public_shard() const { return m_public_shard; }
+  /// 需要多条连接冗余订阅的交易对
+  const std::set<std::string>& redundant_symbols() const { return m_redundant_symbols; }
+  /// 冗余订阅的连接数，不超过公共连接数
+  uint32_t redundant_copies() const { return m_redundant_copies; }
+  /// 订单簿重新订阅后等待快照的时间，超时仍无快照则再次重新订阅
+  uint32_t book_resync_timeout_ms() const { return m_book_resync_timeout_ms; }
 
  private:
   std::string m_api_key;
   std::string m_secret_key;
   std::string m_passphrase;
   bool m_sim;
+  uint32_t m_ws_ping_interval_s = 20;
+  uint32_t m_ws_backoff_max_ms = 30000;
+  uint32_t m_public_connections = 1;
+  std::string m_public_shard = "hash";
+  std::set<std::string> m_redundant_symbols;
+  uint32_t m_redundant_copies = 2;
+  uint32_t m_book_resync_timeout_ms = 5000;
 };
 
 #define okx_config ::Common::SingletonPtr<::market::okx::OkxConfig>::get_instance()
@@ -63,6 +105,7 @@ struct PositionDetail {
   uint64_t uTime;
   std::string instType;
   std::string posId;
+  std::string instId;
   std::string ccy;
   std::string posSide;
 
@@ -77,6 +120,8 @@ struct QueryOrderDetail {
   uint64_t uTime;
   std::string instId;
   std::string ordId;
+  std::string clOrdId;  // 客户端订单ID
+  std::string ordType;  // 订单类型
 
   dec_float px;         // 委托价格
   dec_float sz;         // 委托数量
@@ -84,6 +129,15 @@ struct QueryOrderDetail {
   dec_float accFillSz;  // 已成交数量
   dec_float avgPx;      // 平均成交价格
   std::string state;    // 订单状态
+
+  // 最近一笔成交，没有成交时为空字符串
+  std::string tradeId;     // 成交ID
+  std::string fillPx;      // 成交价格
+  std::string fillSz;      // 成交数量
+  std::string fillTime;    // 成交时间
+  std::string fillFee;     // 本次成交手续费，负数为扣除
+  std::string fillFeeCcy;  // 本次成交手续费币种
+  std::string execType;    // T 吃单，M 挂单
 };
 
 typedef Respone<std::vector<QueryOrderDetail>> QueryOrderRespone;
@@ -194,6 +248,8 @@ struct WsMessage {
   std::string msg;
 
   int connCount;
+
+  int64_t recv_ns = 0;  // 收到原始消息的时间（单调时钟纳秒）
 };
 
 struct WsTick {
@@ -218,12 +274,48 @@ struct WsTick {
   int64_t ts;
 };
 
+/// 订单簿档位，定点数解析，直接用于本地订单簿
 struct WsBookItem {
-  dec_float price;
-  dec_float size;
+  Common::Fixed price;
+  Common::Fixed size;
   int order_num;
 };
 
+/// 订单簿频道
+inline bool is_book_channel(std::string_view channel) {
+  return channel == "books" || channel == "books5" || channel == "bbo-tbt" || channel == "books50-l2-tbt" ||
+         channel == "books-l2-tbt";
+}
+
+/// 每次推送都是全量快照的订单簿频道
+inline bool is_snapshot_channel(std::string_view channel) { return channel == "books5" || channel == "bbo-tbt"; }
+
+/// 订单簿频道的档位数
+inline size_t book_channel_depth(std::string_view channel) {
+  if (channel == "bbo-tbt") {
+    return 1;
+  }
+  if (channel == "books5") {
+    return 5;
+  }
+  if (channel == "books50-l2-tbt") {
+    return 50;
+  }
+  return 400;
+}
+
+/// 逐笔成交，数值字段在JSON缓冲区上直接解析，不生成中间字符串
+struct WsTrade {
+  int64_t tradeId;
+  Common::Fixed px;
+  Common::Fixed sz;
+  bool buy;  ///< 主动成交方是否为买方
+  int64_t ts;
+};
+
+/// 逐笔成交频道，trades-all 在 business 连接上推送
+inline bool is_trade_channel(std::string_view channel) { return channel == "trades" || channel == "trades-all"; }
+
 struct WsBook {
   std::vector<WsBookItem> bids;
   std::vector<WsBookItem> asks;
@@ -241,10 +333,29 @@ namespace jsoncpp {
 template <>
 struct transform<market::okx::WsBookItem> {
   static void trans(const bj::value &jv, market::okx::WsBookItem &t) {
-    auto ja = jv.as_array();
-    t.price = dec_float(ja.at(0).as_string().c_str());
-    t.size = dec_float(ja.at(1).as_string().c_str());
-    t.order_num = std::stoll(ja.at(2).as_string().c_str());
+    // [价格, 数量, 已弃用字段, 订单数]
+    auto& ja = jv.as_array();
+    t.price = Common::Fixed::from_string(ja.at(0).as_string().c_str());
+    t.size = Common::Fixed::from_string(ja.at(1).as_string().c_str());
+    t.order_num = ja.size() > 3 ? std::stoi(ja.at(3).as_string().c_str()) : 0;
+  }
+};
+
+template <>
+struct transform<market::okx::WsTrade> {
+  static void trans(const bj::value &jv, market::okx::WsTrade &t) {
+    auto& jo = jv.as_object();
+    auto view = [&jo](const char* key) {
+      auto& s = jo.at(key).as_string();
+      return std::string_view(s.data(), s.size());
+    };
+    auto id = view("tradeId");
+    std::from_chars(id.data(), id.data() + id.size(), t.tradeId);
+    t.px = Common::Fixed::from_string(view("px"));
+    t.sz = Common::Fixed::from_string(view("sz"));
+    t.buy = view("side") == "buy";
+    auto ts = view("ts");
+    std::from_chars(ts.data(), ts.data() + ts.size(), t.ts);
   }
 };
 
@@ -287,12 +398,18 @@ struct transform<market::okx::WsMessage> {
       auto data = std::vector<market::okx::WsTick>();
       transform<decltype(data)>::trans(jo.at("data"), data);
       t.data = data;
-    } else if (t.arg.channel == "books") {
+    } else if (market::okx::is_book_channel(t.arg.channel)) {
       auto data = std::vector<market::okx::WsBook>();
       transform<decltype(data)>::trans(jo.at("data"), data);
       t.data = data;
-      
-      t.action = jo.at("action").as_string();
+
+      // books5 和 bbo-tbt 每次推送都是全量，没有 action 字段
+      auto action = jo.if_contains("action");
+      t.action = action ? std::string(action->as_string()) : std::string("snapshot");
+    } else if (market::okx::is_trade_channel(t.arg.channel)) {
+      auto data = std::vector<market::okx::WsTrade>();
+      transform<decltype(data)>::trans(jo.at("data"), data);
+      t.data = data;
     } else if (t.arg.channel == "account") {
       auto data = std::vector<market::okx::Account>();
       transform<decltype(data)>::trans(jo.at("data"), data);
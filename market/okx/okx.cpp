@@ -1,10 +1,18 @@
 #include "okx.h"
 
+#include <algorithm>
 #include <boost/asio/experimental/parallel_group.hpp>
+#include <set>
+
+#include "utils/async_log.h"
+#include "utils/latency.h"
 
 namespace market::okx {
 
-Okx::Okx(engine::EnginePtr engine) : base::Gateway(engine, "okx"), http_() {}
+Okx::Okx(engine::EnginePtr engine) : base::Gateway(engine, "okx"), http_() {
+  book_gaps_ = &metrics_registry.counter("qitrader_book_gaps_total", "Order book sequence gaps that forced a resnapshot",
+                                         "exchange=\"okx\"");
+}
 
 // 查询账户信息，通过HTTP API获取并转换为统一格式
 asio::awaitable<void> Okx::query_account(engine::QueryAccountDataPtr data) {
@@ -39,13 +47,14 @@ asio::awaitable<void> Okx::query_position(engine::QueryPositionDataPtr data) {
   // 调用HTTP API获取持仓数据
   auto positions = co_await http_.get_positions();
 
-  co_await deal_position(positions);
+  co_await deal_position(positions, true);
   co_return;
 }
 
-asio::awaitable<void> Okx::deal_position(const std::vector<PositionDetail>& positions) {
+asio::awaitable<void> Okx::deal_position(const std::vector<PositionDetail>& positions, bool snapshot) {
   auto position_data = std::make_shared<engine::PositionData>();
   position_data->exchange = name();
+  position_data->snapshot = snapshot;
 
   // 如果没有持仓，直接返回空数据
   if (positions.empty()) {
@@ -58,13 +67,18 @@ asio::awaitable<void> Okx::deal_position(const std::vector<PositionDetail>& posi
   // 遍历所有持仓，转换为统一格式
   for (auto& pos_item : positions) {
     auto item = std::make_shared<engine::PositionItem>();
-    item->symbol = pos_item.ccy;   // 交易对
-    item->volume = pos_item.pos;   // 持仓数量
-    item->price = pos_item.avgPx;  // 均价
-    item->pnl = pos_item.pnl;      // 盈亏
-
-    // 转换持仓方向：long转为BUY，short转为SELL
-    pos_item.posSide == "long" ? item->direction = engine::Direction::BUY : item->direction = engine::Direction::SELL;
+    item->symbol = pos_item.instId;  // 交易对
+    item->volume = pos_item.pos;     // 持仓数量
+    item->price = pos_item.avgPx;    // 均价
+    item->pnl = pos_item.pnl;        // 盈亏
+
+    // 转换持仓方向：long转为BUY，short转为SELL；单向持仓模式（net）按数量正负判断
+    if (pos_item.posSide == "net") {
+      item->direction = pos_item.pos < 0 ? engine::Direction::SELL : engine::Direction::BUY;
+      item->volume = abs(pos_item.pos);
+    } else {
+      item->direction = pos_item.posSide == "long" ? engine::Direction::BUY : engine::Direction::SELL;
+    }
 
     position_data->items.push_back(item);
   }
@@ -75,23 +89,35 @@ asio::awaitable<void> Okx::deal_position(const std::vector<PositionDetail>& posi
 
 // 查询订单信息，通过HTTP API获取并转换为统一格式
 asio::awaitable<void> Okx::query_order(engine::QueryOrderDataPtr data) {
+  auto orders_data = std::make_shared<engine::OrderData>();
+  orders_data->exchange = name();
+
+  // 指定了客户端订单ID时只查询这一笔，交易所没有该订单说明未成功提交
+  if (!data->client_order_id.empty()) {
+    auto order = co_await http_.get_order(data->symbol, data->client_order_id);
+    if (order) {
+      orders_data->items.push_back(to_order_item(*order));
+    } else {
+      auto item = std::make_shared<engine::OrderDataItem>();
+      item->symbol = data->symbol;
+      item->exchange = name();
+      item->client_order_id = data->client_order_id;
+      item->timestamp_ms = Common::get_current_time_s() * 1000;
+      item->status = engine::OrderStatus::REJECTED;
+      orders_data->items.push_back(item);
+    }
+    orders_data->symbol = data->symbol;
+    co_await on_order(orders_data);
+    co_return;
+  }
+
   // 调用HTTP API获取订单数据
   auto orders = co_await http_.get_pending_orders();
-
-  auto orders_data = std::make_shared<engine::OrderData>();
+  orders_data->snapshot = true;
 
   // 遍历所有订单，转换为统一格式
   for (auto& order : orders) {
-    auto order_item = std::make_shared<engine::OrderDataItem>();
-    order_item->order_id = order.ordId;                                                              // 订单ID
-    order_item->direction = order.side == "buy" ? engine::Direction::BUY : engine::Direction::SELL;  // 买卖方向
-    order_item->price = order.px;                                                                    // 订单价格
-    order_item->volume = order.sz;                                                                   // 订单数量
-    order_item->filled_volume = order.accFillSz;                                                     // 已成交数量
-    order_item->status =
-        order.state == "live" ? engine::OrderStatus::PENDING : engine::OrderStatus::PARTIAL_FILLED;  // 订单状态
-
-    orders_data->items.push_back(order_item);
+    orders_data->items.push_back(to_order_item(order));
   }
 
   co_await on_order(orders_data);
@@ -102,17 +128,23 @@ asio::awaitable<void> Okx::query_order(engine::QueryOrderDataPtr data) {
 asio::awaitable<void> Okx::run() {
   auto executor = co_await asio::this_coro::executor;
 
-  auto group = asio::experimental::make_parallel_group(asio::co_spawn(executor, watch_public(), asio::deferred),
-                                                       asio::co_spawn(executor, watch_private(), asio::deferred));
+  // 每条公共连接一个处理协程，互不阻塞
+  std::vector<decltype(asio::co_spawn(executor, watch_private(), asio::deferred))> watchers;
+  watchers.push_back(asio::co_spawn(executor, watch_private(), asio::deferred));
+  for (auto& ws : ws_public_) {
+    watchers.push_back(asio::co_spawn(executor, watch_public(ws), asio::deferred));
+  }
+  watchers.push_back(asio::co_spawn(executor, watch_public(ws_business_), asio::deferred));
+  auto group = asio::experimental::make_parallel_group(std::move(watchers));
 
   try {
     co_await group.async_wait(asio::experimental::wait_for_all(), asio::use_awaitable);
   } catch (boost::system::system_error& e) {
-    LOG(ERROR) << fmt::format("watch error: {}", e.what());
+    QLOG(ERROR, "watch error: {}", e.what());
   } catch (std::runtime_error& e) {
-    LOG(ERROR) << fmt::format("watch error: {}", e.what());
+    QLOG(ERROR, "watch error: {}", e.what());
   } catch (...) {
-    LOG(ERROR) << fmt::format("watch error: unknown error");
+    QLOG(ERROR, "watch error: unknown error");
   }
 
   co_return;
@@ -123,13 +155,13 @@ asio::awaitable<void> Okx::watch_private() {
     try {
       co_await ws_deal(ws_private_);
     } catch (boost::system::system_error& e) {
-      LOG(ERROR) << fmt::format("watch_private error: {}", e.what());
+      QLOG(ERROR, "watch_private error: {}", e.what());
     } catch (std::runtime_error& e) {
-      LOG(ERROR) << fmt::format("watch_private error: {}", e.what());
+      QLOG(ERROR, "watch_private error: {}", e.what());
     } catch (std::exception& e) {
-      LOG(ERROR) << fmt::format("watch_private error: {}", e.what());
+      QLOG(ERROR, "watch_private error: {}", e.what());
     } catch (...) {
-      LOG(ERROR) << fmt::format("watch_private error: unknown error");
+      QLOG(ERROR, "watch_private error: unknown error");
     }
   }
 
@@ -138,19 +170,19 @@ asio::awaitable<void> Okx::watch_private() {
 
 asio::awaitable<void> Okx::ws_deal(std::shared_ptr<OkxWs> ws) {
   // 从WebSocket读取消息
-  auto msg = co_await ws_private_->read();
+  auto msg = co_await ws->read();
 
   // 处理消息
   if (!msg.event.empty()) {
     if (msg.event == "error") {
-      LOG(ERROR) << fmt::format("ws error code: {}, message: {}", msg.code, msg.msg);
+      QLOG(ERROR, "ws error code: {}, message: {}", msg.code, msg.msg);
     } else if (msg.event == "channel-conn-count") {
-      LOG(INFO) << fmt::format("ws channel-conn-count: {}", msg.connCount);
+      QLOG(INFO, "ws channel-conn-count: {}", msg.connCount);
     } else if (msg.event == "subscribe") {
-      LOG(INFO) << fmt::format("ws subscribe: {}, channel: {}", msg.event, msg.arg.channel);
+      QLOG(INFO, "ws subscribe: {}, channel: {}", msg.event, msg.arg.channel);
     } else {
       // 处理事件消息（如订阅成功）
-      LOG(INFO) << fmt::format("ws event: {}", msg.event);
+      QLOG(INFO, "ws event: {}", msg.event);
     }
   }
 
@@ -158,100 +190,188 @@ asio::awaitable<void> Okx::ws_deal(std::shared_ptr<OkxWs> ws) {
     // 处理账户数据
     auto account = std::any_cast<std::vector<market::okx::Account>>(msg.data);
     if (account.empty()) {
-      LOG(INFO) << fmt::format("ws account empty");
+      QLOG(INFO, "ws account empty");
       co_return;
     }
     co_await deal_account(account[0]);
   } else if (msg.arg.channel == "positions") {
     // 处理持仓数据
-    co_await deal_position(std::any_cast<std::vector<PositionDetail>>(msg.data));
-  } else if (msg.arg.channel == "books") {
+    co_await deal_position(std::any_cast<std::vector<PositionDetail>>(msg.data), false);
+  } else if (is_book_channel(msg.arg.channel)) {
     // 处理订单簿数据
-    co_await deal_book(msg.arg.instId, std::any_cast<std::vector<WsBook>>(msg.data));
+    co_await deal_book(msg.arg.instId, msg.arg.channel, msg.action, std::any_cast<std::vector<WsBook>>(msg.data),
+                       msg.recv_ns, ws->index());
   } else if (msg.arg.channel == "tickers") {
     // 处理Tick数据
-    co_await deal_tick(msg.arg.instId, std::any_cast<std::vector<WsTick>>(msg.data));
+    co_await deal_tick(msg.arg.instId, std::any_cast<std::vector<WsTick>>(msg.data), msg.recv_ns, ws->index());
+  } else if (is_trade_channel(msg.arg.channel)) {
+    // 处理逐笔成交
+    co_await deal_trade(msg.arg.instId, msg.arg.channel, std::any_cast<std::vector<WsTrade>>(msg.data), msg.recv_ns,
+                        ws->index());
   } else if (msg.arg.channel == "orders") {
     // 处理订单数据
     co_await deal_order(std::any_cast<std::vector<QueryOrderDetail>>(msg.data));
   } else {
-    LOG(INFO) << fmt::format("unknown channel: {}", msg.arg.channel);
+    QLOG(INFO, "unknown channel: {}", msg.arg.channel);
   }
 }
 
-asio::awaitable<void> Okx::watch_public() {
+asio::awaitable<void> Okx::watch_public(std::shared_ptr<OkxWs> ws) {
   for (;;) {
     try {
-      co_await ws_deal(ws_public_);
+      co_await ws_deal(ws);
     } catch (boost::system::system_error& e) {
-      LOG(ERROR) << fmt::format("watch_public error: {}", e.what());
+      QLOG(ERROR, "watch_public error: {}", e.what());
     } catch (std::runtime_error& e) {
-      LOG(ERROR) << fmt::format("watch_public error: {}", e.what());
+      QLOG(ERROR, "watch_public error: {}", e.what());
     } catch (std::exception& e) {
-      LOG(ERROR) << fmt::format("watch_private error: {}", e.what());
+      QLOG(ERROR, "watch_private error: {}", e.what());
     } catch (...) {
-      LOG(ERROR) << fmt::format("watch_public error: unknown error");
+      QLOG(ERROR, "watch_public error: unknown error");
     }
   }
 
   co_return;
 }
 
-// 处理WebSocket接收到的订单簿数据，转换为统一格式并发送到引擎
-asio::awaitable<void> Okx::deal_book(const std::string& symbol, const std::vector<WsBook>& msg) {
-  auto book = std::make_shared<engine::Book>();
-  // 解析WebSocket消息中的订单簿数据
-  auto book_data = msg;
+// 处理WebSocket接收到的订单簿数据，维护本地订单簿并把前N档发送到引擎
+asio::awaitable<void> Okx::deal_book(const std::string& symbol, const std::string& channel, const std::string& action,
+                                     const std::vector<WsBook>& msg, int64_t recv_ns, size_t conn) {
+  // books5 和 bbo-tbt 每次都是全量，直接替换；其他频道快照之后是增量
+  bool full = is_snapshot_channel(channel) || action == "snapshot";
+  auto depth = book_channel_depth(channel);
+
+  for (auto& book_item : msg) {
+    bool first = true;
+    bool gap = false;
+    engine::BookPtr published;
+
+    markets_.apply([&](std::map<std::string, SingleMarket>& map) {
+      auto& market = map[symbol];
+      auto& state = market.books[channel];
+      auto prev_seq = state.seq;
+
+      // 冗余连接上的重复推送只转发先到的一份
+      first = accept_book(state, book_item, full);
+      if (!first) {
+        return;
+      }
+
+      if (full) {
+        state.book.snapshot(book_item.bids, book_item.asks);
+        state.valid = true;
+        state.resyncing = false;
+      } else {
+        // 增量必须接在上一条之后，否则本地订单簿已不可信
+        if (!state.valid || (prev_seq >= 0 && book_item.prevSeqId != prev_seq)) {
+          // 重新订阅后迟迟收不到快照（请求丢失或连接已断开）时再次重新订阅
+          auto now = engine::Engine::steady_now_ms();
+          gap = !state.resyncing || now - state.resync_ms >= okx_config->book_resync_timeout_ms();
+          state.valid = false;
+          state.resyncing = true;
+          if (gap) {
+            state.resync_ms = now;
+          }
+          return;
+        }
+        state.book.update(book_item.bids, book_item.asks);
+      }
+
+      auto item = std::make_shared<engine::Book>();
+      item->symbol = symbol;              // 交易对
+      item->exchange = name();            // 交易所
+      item->timestamp_ms = book_item.ts;  // 时间戳
+      item->recv_ns = recv_ns;            // 收到时间
+      state.book.fill(*item, depth);
+
+      // 保存最新的订单簿，供关联到Tick数据
+      market.last_book = item;
+      published = item;
+    });
 
-  // 遍历所有订单簿快照
-  for (auto& book_item : book_data) {
-    auto item = std::make_shared<engine::Book>();
-    item->symbol = symbol;              // 交易对
-    item->exchange = name();            // 交易所
-    item->timestamp_ms = book_item.ts;  // 时间戳
-
-    // 转换买盘数据
-    for (auto& bid : book_item.bids) {
-      auto bid_item = engine::BookItem();
-      bid_item.price = bid.price;  // 买价
-      bid_item.volume = bid.size;  // 买量
-      item->bids.push_back(bid_item);
+    count_feed(channel.c_str(), conn, first);
+    if (gap) {
+      book_gaps_->inc();
+      QLOG(WARNING, "book gap {} {}: resubscribe on conn {}", symbol, channel, conn);
+      co_await resubscribe_book(conn, symbol, channel);
     }
-
-    // 转换卖盘数据
-    for (auto& ask : book_item.asks) {
-      auto ask_item = engine::BookItem();
-      ask_item.price = ask.price;  // 卖价
-      ask_item.volume = ask.size;  // 卖量
-      item->asks.push_back(ask_item);
+    if (!published) {
+      continue;
     }
 
-    // 保存最新的订单簿，供关联到Tick数据
-    markets_.apply([item](std::map<std::string, SingleMarket> map) { map[item->symbol].last_book = item; });
     // 发送订单簿数据到引擎
-    co_await on_book(item);
+    latency_stats.record_since(Common::LatencyStage::kGatewayDeal, recv_ns);
+    co_await on_book(published);
   }
 
   co_return;
 }
 
+asio::awaitable<void> Okx::resubscribe_book(size_t conn, const std::string& symbol, const std::string& channel) {
+  // 取消后重新订阅，交易所会重新推送全量快照；不记录到重放列表
+  auto req = WsSubscibeRequest();
+  req.op = "unsubscribe";
+  req.args = {{channel, symbol}};
+  co_await ws_public_[conn]->write(req);
+  req.op = "subscribe";
+  co_await ws_public_[conn]->write(req);
+}
+
+// 处理WebSocket接收到的逐笔成交，按成交ID去重后发送到引擎
+asio::awaitable<void> Okx::deal_trade(const std::string& symbol, const std::string& channel,
+                                      const std::vector<WsTrade>& msg, int64_t recv_ns, size_t conn) {
+  for (auto& trade_item : msg) {
+    bool first = true;
+    markets_.apply([&](std::map<std::string, SingleMarket>& map) { first = accept_trade(map[symbol], trade_item); });
+    count_feed(channel.c_str(), conn, first);
+    if (!first) {
+      continue;
+    }
+
+    auto item = std::make_shared<engine::TradeData>();
+    item->symbol = symbol;                                // 交易对
+    item->exchange = name();                              // 交易所
+    item->timestamp_ms = trade_item.ts;                   // 成交时间
+    item->recv_ns = recv_ns;                              // 收到时间
+    item->trade_id = std::to_string(trade_item.tradeId);  // 成交ID
+    item->price = trade_item.px.to_dec();                 // 成交价
+    item->volume = trade_item.sz.to_dec();                // 成交量
+
+    // 主动成交方的方向
+    item->direction = trade_item.buy ? engine::Direction::BUY : engine::Direction::SELL;
+
+    latency_stats.record_since(Common::LatencyStage::kGatewayDeal, recv_ns);
+    co_await on_trade(item);
+  }
+}
+
 // 处理WebSocket接收到的Tick数据，转换为统一格式并发送到引擎
-asio::awaitable<void> Okx::deal_tick(const std::string& symbol, const std::vector<WsTick>& msg) {
+asio::awaitable<void> Okx::deal_tick(const std::string& symbol, const std::vector<WsTick>& msg, int64_t recv_ns,
+                                     size_t conn) {
   auto tick = std::make_shared<engine::TickData>();
   // 解析WebSocket消息中的Tick数据
   auto tick_data = msg;
 
   // 遍历所有Tick数据
   for (auto& tick_item : tick_data) {
+    bool first = true;
+    markets_.apply([&](std::map<std::string, SingleMarket>& map) { first = accept_tick(map[symbol], tick_item); });
+    count_feed("tickers", conn, first);
+    if (!first) {
+      continue;
+    }
+
     auto item = std::make_shared<engine::TickData>();
     item->symbol = symbol;              // 交易对
     item->exchange = name();            // 交易所
     item->timestamp_ms = tick_item.ts;  // 时间戳
+    item->recv_ns = recv_ns;            // 收到时间
 
     // 最新成交信息
     item->last_price = tick_item.last;                   // 最新价
     item->last_volume = tick_item.lastSz;                // 最新成交量
     item->turnover = tick_item.lastSz * tick_item.last;  // 成交额
+    item->volume_24h = tick_item.vol24h;                 // 24h成交量
 
     // 24小时统计数据
     item->last_close_price = tick_item.open24h;  // 昨收价（使用24h开盘价）
@@ -260,12 +380,13 @@ asio::awaitable<void> Okx::deal_tick(const std::string& symbol, const std::vecto
     item->low_price = tick_item.low24h;          // 24h最低价
 
     // 保存最新的Tick，供关联到订单簿数据
-    markets_.apply([item](std::map<std::string, SingleMarket> map) {
+    markets_.apply([item](std::map<std::string, SingleMarket>& map) {
       item->order_book = map[item->symbol].last_book;
       map[item->symbol].last_tick = item;
     });
 
     // 发送Tick数据到引擎
+    latency_stats.record_since(Common::LatencyStage::kGatewayDeal, recv_ns);
     co_await on_tick(item);
   }
 
@@ -277,21 +398,13 @@ asio::awaitable<void> Okx::deal_order(const std::vector<QueryOrderDetail>& msg)
     co_return;
   }
 
-  auto order = std::make_shared<engine::OrderData>();
-  // 解析HTTP API响应中的订单数据
-  auto order_data = msg;
   auto item = std::make_shared<engine::OrderData>();
-  item->symbol = order_data[0].instId;  // 交易对
-  item->exchange = name();           // 交易所
+  item->symbol = msg[0].instId;       // 交易对
+  item->exchange = name();            // 交易所
+  item->timestamp_ms = msg[0].uTime;  // 更新时间
   // 遍历所有订单数据
-  for (auto& order_item : order_data) {
-    auto order_data_item = std::make_shared<engine::OrderDataItem>();
-    order_data_item->order_id = order_item.ordId;
-    order_data_item->price = order_item.avgPx;
-    order_data_item->volume = order_item.sz;
-    order_data_item->direction = order_item.side == "buy" ? engine::Direction::BUY : engine::Direction::SELL;
-
-    item->items.push_back(order_data_item);
+  for (auto& order_item : msg) {
+    item->items.push_back(to_order_item(order_item));
   }
 
   // 发送订单数据到引擎
@@ -300,43 +413,138 @@ asio::awaitable<void> Okx::deal_order(const std::vector<QueryOrderDetail>& msg)
   co_return;
 }
 
+engine::OrderDataItemPtr Okx::to_order_item(const QueryOrderDetail& order) {
+  auto item = std::make_shared<engine::OrderDataItem>();
+  item->symbol = order.instId;            // 交易对
+  item->exchange = name();                // 交易所
+  item->timestamp_ms = order.uTime;       // 更新时间
+  item->order_id = order.ordId;           // 订单ID
+  item->client_order_id = order.clOrdId;  // 客户端订单ID
+  item->price = order.px;                 // 委托价格
+  item->volume = order.sz;                // 委托数量
+  item->filled_volume = order.accFillSz;  // 已成交数量
+  item->avg_price = order.avgPx;          // 成交均价
+
+  item->direction = order.side == "buy" ? engine::Direction::BUY : engine::Direction::SELL;
+  item->otype = order.ordType == "market" ? engine::OrderType::MARKET : engine::OrderType::LIMIT;
+
+  // 随订单推送的最近一笔成交，由订单管理关联到订单后以 kFill 发出
+  auto fill_size = Common::Fixed::from_string(order.fillSz);
+  if (!order.tradeId.empty() && fill_size.raw() > 0) {
+    auto fill = std::make_shared<engine::TradeData>();
+    fill->symbol = order.instId;
+    fill->exchange = name();
+    fill->timestamp_ms = order.fillTime.empty() ? order.uTime : std::stoll(order.fillTime);
+    fill->trade_id = order.tradeId;
+    fill->direction = item->direction;
+    fill->price = Common::Fixed::from_string(order.fillPx).to_dec();
+    fill->volume = fill_size.to_dec();
+    fill->fee = Common::Fixed::from_string(order.fillFee).to_dec();
+    fill->fee_currency = order.fillFeeCcy;
+    fill->maker = order.execType == "M";
+    item->fill = fill;
+  }
+
+  // 订单状态
+  if (order.state == "live") {
+    item->status = engine::OrderStatus::PENDING;
+  } else if (order.state == "partially_filled") {
+    item->status = engine::OrderStatus::PARTIAL_FILLED;
+  } else if (order.state == "filled") {
+    item->status = engine::OrderStatus::FILLED;
+  } else if (order.state == "canceled" || order.state == "mmp_canceled") {
+    item->status = engine::OrderStatus::CANCELLED;
+  } else {
+    QLOG(WARNING, "unknown order state: {}, ordId: {}", order.state, order.ordId);
+    item->status = engine::OrderStatus::PENDING;
+  }
+
+  return item;
+}
+
 // 订阅订单簿数据，通过WebSocket发送订阅请求
 asio::awaitable<void> Okx::subscribe_book(engine::SubscribeDataPtr data) {
   auto sub_req = WsSubscibeRequest();
   sub_req.op = "subscribe";                  // 订阅操作
-  sub_req.args = {{"books", data->symbol}};  // 订阅订单簿通道
+  // 按档位和是否逐笔选择频道：1档 bbo-tbt，5档 books5，逐笔 50/400 档 l2-tbt，其余 books
+  std::string channel = "books";
+  if (data->depth <= 1) {
+    channel = "bbo-tbt";
+  } else if (data->tick_by_tick) {
+    channel = data->depth <= 50 ? "books50-l2-tbt" : "books-l2-tbt";
+  } else if (data->depth <= 5) {
+    channel = "books5";
+  }
+  sub_req.args = {{channel, data->symbol}};  // 订阅订单簿通道
 
-  // 发送订阅请求到WebSocket
-  co_await ws_public_->write(sub_req);
+  // 发送订阅请求到WebSocket，重连后自动重放
+  for (auto& ws : public_ws(data->symbol)) {
+    if (channel.ends_with("-l2-tbt")) {
+      co_await ensure_public_login(ws);
+    }
+    co_await ws->subscribe(sub_req);
+  }
   co_return;
 }
 
+// 订阅逐笔成交，通过WebSocket发送订阅请求
+asio::awaitable<void> Okx::subscribe_trade(engine::SubscribeDataPtr data) {
+  auto sub_req = WsSubscibeRequest();
+  sub_req.op = "subscribe";
+
+  // trades-all 只在 business 连接上推送
+  if (data->tick_by_tick) {
+    sub_req.args = {{"trades-all", data->symbol}};
+    co_await ws_business_->subscribe(sub_req);
+    co_return;
+  }
+
+  sub_req.args = {{"trades", data->symbol}};
+  for (auto& ws : public_ws(data->symbol)) {
+    co_await ws->subscribe(sub_req);
+  }
+}
+
 // 订阅Tick数据，通过WebSocket发送订阅请求
 asio::awaitable<void> Okx::subscribe_tick(engine::SubscribeDataPtr data) {
   auto sub_req = WsSubscibeRequest();
   sub_req.op = "subscribe";                    // 订阅操作
   sub_req.args = {{"tickers", data->symbol}};  // 订阅Ticker通道
 
-  // 发送订阅请求到WebSocket
-  co_await ws_public_->write(sub_req);
+  // 发送订阅请求到WebSocket，重连后自动重放
+  for (auto& ws : public_ws(data->symbol)) {
+    co_await ws->subscribe(sub_req);
+  }
   co_return;
 }
 
 // 初始化市场网关，连接WebSocket
 asio::awaitable<void> Okx::market_init() {
   auto ctx = co_await asio::this_coro::executor;
-  ws_public_ = std::make_shared<OkxWs>(ctx, 100);
+  for (size_t i = 0; i < okx_config->public_connections(); ++i) {
+    auto ws = std::make_shared<OkxWs>(ctx, 100, "/ws/v5/public", i);
+    ws->set_on_reconnect([this, i]() { return resync_public(i); });
+    ws_public_.push_back(ws);
+  }
   ws_private_ = std::make_shared<OkxWs>(ctx, 100, "/ws/v5/private");
+  ws_business_ = std::make_shared<OkxWs>(ctx, 100, "/ws/v5/business");
+  ws_business_->set_on_reconnect(
+      [this]() { return on_message("okx business ws reconnected, trades during the gap are lost"); });
+
+  // 每次连接建立后先登录，重连后订阅会自动重放
+  ws_private_->set_on_open([this]() { return ws_login(ws_private_); });
+  ws_private_->set_on_reconnect([this]() { return resync_private(); });
 
   // 连接到OKX的WebSocket服务器
-  co_await ws_public_->connect();
-  LOG(INFO) << "ws public connected";
+  for (auto& ws : ws_public_) {
+    co_await ws->connect();
+  }
+  LOG(INFO) << fmt::format("ws public connected: {} connections", ws_public_.size());
 
-  co_await ws_private_->connect();
-  LOG(INFO) << "ws private connected";
+  co_await ws_business_->connect();
 
-  co_await ws_private_login();
-  LOG(INFO) << "ws private login";
+  co_await ws_private_->connect();
+  LOG(INFO) << "ws private connected and login";
 
   co_await ws_private_subscribe_account();
   LOG(INFO) << "ws private subscribe account";
@@ -358,17 +566,76 @@ asio::awaitable<void> Okx::send_orders(engine::OrderDataPtr order) {
     order_req.push_back(req);
   }
 
+  latency_stats.record_since(Common::LatencyStage::kTickToWire, order->recv_ns);
   auto rsp = co_await http_.send_orders(order_req);
 
+  // 提交失败的订单不会有WebSocket推送，直接回报拒绝
+  auto rejected = std::make_shared<engine::OrderData>();
+  rejected->exchange = name();
   for (auto& item : rsp) {
     if (item.sCode != 0) {
-      LOG(ERROR) << "send order failed, code: " << item.sCode << ", msg: " << item.sMsg;
+      QLOG(ERROR, "send order failed, code: {}, msg: {}", item.sCode, item.sMsg);
+
+      auto reject_item = std::make_shared<engine::OrderDataItem>();
+      reject_item->symbol = item.instId;
+      reject_item->exchange = name();
+      reject_item->timestamp_ms = item.ts;
+      reject_item->order_id = item.ordId;
+      reject_item->client_order_id = item.clOrdId;
+      reject_item->status = engine::OrderStatus::REJECTED;
+      rejected->items.push_back(reject_item);
     }
   }
 
+  if (!rejected->items.empty()) {
+    rejected->symbol = rejected->items[0]->symbol;
+    co_await on_order(rejected);
+  }
+
+  // 通知策略本次涉及的标的族剩余的下单额度
+  std::set<std::string> families;
+  for (auto& item : order->items) {
+    families.insert(RateLimiter::inst_family(item->symbol));
+  }
+  for (auto& family : families) {
+    auto budget = http_.order_budget(family);
+    auto limit = std::make_shared<engine::RateLimitData>();
+    limit->symbol = family;
+    limit->exchange = name();
+    limit->timestamp_ms = Common::get_current_time_s() * 1000;
+    limit->endpoint = OkxHttp::kBatchOrdersPath;
+    limit->remaining = budget.remaining;
+    limit->capacity = budget.capacity;
+    limit->queued = http_.queued_orders();
+    co_await on_rate_limit(limit);
+  }
+
   co_return;
 }
 
+asio::awaitable<void> Okx::cancel_order(engine::OrderDataPtr order) {
+  std::vector<CancelOrderRequest> requests;
+  for (auto& item : order->items) {
+    requests.push_back({item->symbol, item->order_id, item->client_order_id});
+  }
+
+  // 批量撤单与批量下单的每批上限相同
+  for (size_t i = 0; i < requests.size(); i += OkxHttp::kMaxBatchOrders) {
+    auto end = std::min(requests.size(), i + OkxHttp::kMaxBatchOrders);
+    std::vector<CancelOrderRequest> batch(requests.begin() + i, requests.begin() + end);
+    try {
+      auto rsp = co_await http_.cancel_orders(batch);
+      for (auto& item : rsp) {
+        if (item.sCode != 0) {
+          QLOG(ERROR, "cancel order failed, code: {}, msg: {}", item.sCode, item.sMsg);
+        }
+      }
+    } catch (const std::exception& e) {
+      QLOG(ERROR, "cancel order failed: {}", e.what());
+    }
+  }
+}
+
 SendOrderRequest Okx::to_send_order_request(engine::OrderDataItemPtr order) {
   bool is_spot = !order->symbol.contains("SWAP");
 
@@ -382,6 +649,7 @@ SendOrderRequest Okx::to_send_order_request(engine::OrderDataItemPtr order) {
 SendOrderRequest Okx::to_send_order_request_spot(engine::OrderDataItemPtr order) {
   auto req = SendOrderRequest();
   req.instId = order->symbol;
+  req.clOrdId = order->client_order_id;
   req.side = order->direction == engine::Direction::BUY ? "buy" : "sell";
 
   if (order->otype == engine::OrderType::MARKET) {
@@ -403,6 +671,7 @@ SendOrderRequest Okx::to_send_order_request_spot(engine::OrderDataItemPtr order)
 SendOrderRequest Okx::to_send_order_request_swap(engine::OrderDataItemPtr order) {
   auto req = SendOrderRequest();
   req.instId = order->symbol;
+  req.clOrdId = order->client_order_id;
   req.side = order->direction == engine::Direction::BUY ? "buy" : "sell";
   req.posSide = order->direction == engine::Direction::BUY ? "long" : "short";
 
@@ -420,7 +689,151 @@ SendOrderRequest Okx::to_send_order_request_swap(engine::OrderDataItemPtr order)
   return req;
 }
 
-asio::awaitable<void> Okx::ws_private_login() {
+bool Okx::accept_book(BookState& state, const WsBook& book, bool full) {
+  // 没有序号时无法判断，全部转发
+  if (book.seqId <= 0) {
+    return true;
+  }
+  // 本地订单簿失效时任何一条连接的快照都要接受：冗余连接仍在推送更大的序号，
+  // 按序号去重会把重新订阅得到的快照当成重复丢掉
+  if (full && !state.valid) {
+    state.seq = book.seqId;
+    return true;
+  }
+  // 交易所维护后序号重置，增量的 seqId 小于 prevSeqId；按序号去重会把之后的更新全部丢掉，
+  // 作为缺口处理：本地订单簿失效，由 deal_book 重新订阅获取新快照，其他连接的同一条推送按新序号去重
+  if (!full && book.prevSeqId >= 0 && book.seqId < book.prevSeqId) {
+    if (book.seqId == state.seq) {
+      return false;
+    }
+    state.seq = book.seqId;
+    state.valid = false;
+    return true;
+  }
+  if (book.seqId <= state.seq) {
+    return false;
+  }
+  state.seq = book.seqId;
+  return true;
+}
+
+bool Okx::accept_trade(SingleMarket& market, const WsTrade& trade) {
+  // 同一交易对成交ID递增，冗余连接和 trades/trades-all 重复订阅时只转发一次
+  if (trade.tradeId <= market.trade_id) {
+    return false;
+  }
+  market.trade_id = trade.tradeId;
+  return true;
+}
+
+bool Okx::accept_tick(SingleMarket& market, const WsTick& tick) {
+  if (market.tick_raw) {
+    auto& last = *market.tick_raw;
+    if (tick.ts < last.ts) {
+      return false;
+    }
+    // 同一毫秒内可能有多次推送，内容相同才视为重复
+    if (tick.ts == last.ts && tick.last == last.last && tick.lastSz == last.lastSz && tick.bidPx == last.bidPx &&
+        tick.bidSz == last.bidSz && tick.askPx == last.askPx && tick.askSz == last.askSz &&
+        tick.vol24h == last.vol24h) {
+      return false;
+    }
+  }
+  market.tick_raw = tick;
+  return true;
+}
+
+void Okx::count_feed(const char* channel, size_t conn, bool first) {
+  auto& counters = feed_counters_[{channel, conn}];
+  if (counters.first == nullptr) {
+    auto label = fmt::format("exchange=\"okx\",channel=\"{}\",conn=\"{}\"", channel, conn);
+    counters.first = &metrics_registry.counter("qitrader_feed_first_total", "Updates forwarded as first copy", label);
+    counters.second =
+        &metrics_registry.counter("qitrader_feed_duplicate_total", "Late duplicate updates dropped", label);
+  }
+  (first ? counters.first : counters.second)->inc();
+}
+
+std::vector<std::shared_ptr<OkxWs>> Okx::public_ws(const std::string& symbol) {
+  std::vector<std::shared_ptr<OkxWs>> result;
+  auto it = public_shards_.find(symbol);
+  if (it != public_shards_.end()) {
+    for (auto shard : it->second) {
+      result.push_back(ws_public_[shard]);
+    }
+    return result;
+  }
+
+  // 同一交易对的所有频道固定在同一组连接上，保证订单簿和Tick的先后顺序
+  size_t shard = 0;
+  if (okx_config->public_shard() == "load") {
+    for (size_t i = 1; i < ws_public_.size(); ++i) {
+      if (ws_public_[i]->subscription_count() < ws_public_[shard]->subscription_count()) {
+        shard = i;
+      }
+    }
+  } else {
+    shard = std::hash<std::string>{}(symbol) % ws_public_.size();
+  }
+
+  // 冗余交易对从首选连接起依次占用多条不同连接
+  size_t copies = 1;
+  if (okx_config->redundant_symbols().contains(symbol)) {
+    copies = std::min<size_t>(okx_config->redundant_copies(), ws_public_.size());
+  }
+  auto& shards = public_shards_[symbol];
+  for (size_t i = 0; i < copies; ++i) {
+    shards.push_back((shard + i) % ws_public_.size());
+    result.push_back(ws_public_[shards.back()]);
+  }
+  return result;
+}
+
+asio::awaitable<void> Okx::resync_public(size_t shard) {
+  // 重放的 books 订阅会先推送全量快照，该连接上之前的订单簿作废；
+  // 冗余交易对仍由其他连接推送，有效的订单簿保留去重状态，避免重连快照把序号拉回；
+  // 已失效的订单簿清除等待状态，由重放的快照恢复
+  markets_.apply([this, shard](std::map<std::string, SingleMarket>& map) {
+    for (auto& [symbol, market] : map) {
+      auto it = public_shards_.find(symbol);
+      if (it == public_shards_.end() || std::find(it->second.begin(), it->second.end(), shard) == it->second.end()) {
+        continue;
+      }
+      if (it->second.size() == 1) {
+        market.last_book = nullptr;
+        market.books.clear();
+        market.tick_raw.reset();
+        continue;
+      }
+      for (auto& [channel, state] : market.books) {
+        if (!state.valid) {
+          state.resyncing = false;
+        }
+      }
+    }
+  });
+  co_await on_message(fmt::format("okx public ws {} reconnected, subscriptions replayed", shard));
+}
+
+asio::awaitable<void> Okx::resync_private() {
+  co_await on_message("okx private ws reconnected, resync orders and positions");
+  // 断线期间的订单和持仓推送可能丢失，通过REST查询补齐
+  co_await query_order(std::make_shared<engine::QueryOrderData>());
+  co_await query_position(std::make_shared<engine::QueryPositionData>());
+  co_await query_account(std::make_shared<engine::QueryAccountData>());
+}
+
+asio::awaitable<void> Okx::ensure_public_login(std::shared_ptr<OkxWs> ws) {
+  auto index = ws->index();
+  if (!public_logins_.insert(index).second) {
+    co_return;
+  }
+  // 连接对象持有回调，按序号取连接以免循环引用
+  ws->set_on_open([this, index]() { return ws_login(ws_public_[index]); });
+  co_await ws_login(ws);
+}
+
+asio::awaitable<void> Okx::ws_login(std::shared_ptr<OkxWs> ws) {
   auto sub_req = WsLoginRequest();
   sub_req.op = "login";  // 登录操作
 
@@ -436,7 +849,7 @@ asio::awaitable<void> Okx::ws_private_login() {
 
   sub_req.args = {login_detail};
 
-  co_await ws_private_->write(sub_req);
+  co_await ws->write(sub_req);
 }
 
 asio::awaitable<void> Okx::ws_private_subscribe_account() {
@@ -444,7 +857,7 @@ asio::awaitable<void> Okx::ws_private_subscribe_account() {
   sub_req.op = "subscribe";  // 订阅操作
   sub_req.args = {{"account"}};
 
-  co_await ws_private_->write(sub_req);
+  co_await ws_private_->subscribe(sub_req);
 }
 
 asio::awaitable<void> Okx::ws_private_subscribe_position() {
@@ -452,7 +865,7 @@ asio::awaitable<void> Okx::ws_private_subscribe_position() {
   sub_req.op = "subscribe";  // 订阅操作
   sub_req.args = {{"positions", "SWAP"}};
 
-  co_await ws_private_->write(sub_req);
+  co_await ws_private_->subscribe(sub_req);
 }
 
 asio::awaitable<void> Okx::ws_private_subscribe_order() {
@@ -460,7 +873,7 @@ asio::awaitable<void> Okx::ws_private_subscribe_order() {
   sub_req.op = "subscribe";  // 订阅操作
   sub_req.args = {{"orders", "SWAP"}};
 
-  co_await ws_private_->write(sub_req);
+  co_await ws_private_->subscribe(sub_req);
 }
 
 };  // namespace market::okx
@@ -10,9 +10,15 @@
  * - 通过WebSocket接收实时行情数据
  */
 
+#include <map>
+#include <optional>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/gateway.h"
+#include "base/local_book.h"
 #include "config/config.h"
 #include "engine.h"
 #include "okx_http.h"
@@ -21,10 +27,26 @@
 
 namespace market::okx {
 
+/// 单个订单簿频道的本地状态
+struct BookState {
+  base::LocalBook book;    ///< 本地订单簿
+  int64_t seq = -1;        ///< 已转发的最大序号，多条连接的重复推送据此去重
+  bool valid = false;      ///< 已收到快照且增量连续
+  bool resyncing = false;  ///< 发现缺口后已重新订阅，等待新快照
+  int64_t resync_ms = 0;   ///< 最近一次重新订阅的时间
+};
+
 struct SingleMarket : public std::enable_shared_from_this<SingleMarket> {
   std::string symbol;
   engine::BookPtr last_book;      ///< 最近一次接收的订单簿数据
   engine::TickDataPtr last_tick;  ///< 最近一次接收的Tick数据
+
+  /// 按频道维护的本地订单簿，同一交易对可同时订阅不同档位
+  std::map<std::string, BookState> books;
+  /// 已转发的最新Tick原始数据，时间戳相同时比较内容去重
+  std::optional<WsTick> tick_raw;
+  /// 已转发的最大成交ID，同一交易对的成交ID递增
+  int64_t trade_id = -1;
 };
 
 /**
@@ -51,10 +73,11 @@ class Okx : public base::Gateway {
   asio::awaitable<void> run() override;
 
   /**
-   * @brief 监听公共WebSocket，处理公共数据
+   * @brief 监听一条公共WebSocket，处理公共数据
+   * @param ws 公共连接
    * @return asio::awaitable<void> 异步协程
    */
-  asio::awaitable<void> watch_public();
+  asio::awaitable<void> watch_public(std::shared_ptr<OkxWs> ws);
 
   /**
    * @brief 监听私有WebSocket，处理私有数据
@@ -71,11 +94,11 @@ class Okx : public base::Gateway {
   /// 取消订阅（当前未实现）
   void unsubscribe(const std::string& symbol) override{};
 
-  /// 发送订单（当前未实现）
+  /// 批量发送订单，提交失败的订单以 REJECTED 状态回报
   asio::awaitable<void> send_orders(engine::OrderDataPtr order) override;
 
-  /// 取消订单（当前未实现）
-  asio::awaitable<void> cancel_order(engine::OrderDataPtr order) override { co_return; };
+  /// 批量撤单，撤单结果通过订单频道推送，这里只记录失败
+  asio::awaitable<void> cancel_order(engine::OrderDataPtr order) override;
 
   /**
    * @brief 查询账户信息，通过HTTP API获取
@@ -112,29 +135,84 @@ class Okx : public base::Gateway {
    */
   asio::awaitable<void> subscribe_tick(engine::SubscribeDataPtr data) override;
 
+  /**
+   * @brief 订阅逐笔成交，合并推送的 trades 走公共连接，每笔推送的 trades-all 走 business 连接
+   * @param data 订阅请求数据
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> subscribe_trade(engine::SubscribeDataPtr data) override;
+
  private:
   /**
    * @brief 处理WebSocket接收到的订单簿数据
+   *
+   * 全量频道直接替换本地订单簿；增量频道按 prevSeqId 校验连续性，出现缺口或交易所重置序号时重新订阅以获取新快照。
+   * @param channel 订单簿频道
+   * @param action snapshot 或 update
    * @param msg WebSocket消息
+   * @param recv_ns 收到原始消息的时间，用于延迟统计
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> deal_book(const std::string& symbol, const std::string& channel, const std::string& action,
+                                  const std::vector<WsBook>& msg, int64_t recv_ns = 0, size_t conn = 0);
+
+  /**
+   * @brief 取消并重新订阅订单簿频道，交易所会推送新的全量快照
+   * @param conn 公共连接序号
    * @return asio::awaitable<void> 异步协程
    */
-  asio::awaitable<void> deal_book(const std::string& symbol, const std::vector<WsBook>& msg);
+  asio::awaitable<void> resubscribe_book(size_t conn, const std::string& symbol, const std::string& channel);
 
   /**
    * @brief 处理WebSocket接收到的Tick数据
    * @param msg WebSocket消息
+   * @param recv_ns 收到原始消息的时间，用于延迟统计
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> deal_tick(const std::string& symbol, const std::vector<WsTick>& msg, int64_t recv_ns = 0,
+                                  size_t conn = 0);
+
+  /**
+   * @brief 处理WebSocket接收到的逐笔成交
+   * @param channel trades 或 trades-all
+   * @param msg WebSocket消息
+   * @param recv_ns 收到原始消息的时间，用于延迟统计
    * @return asio::awaitable<void> 异步协程
    */
-  asio::awaitable<void> deal_tick(const std::string& symbol, const std::vector<WsTick>& msg);
+  asio::awaitable<void> deal_trade(const std::string& symbol, const std::string& channel,
+                                   const std::vector<WsTrade>& msg, int64_t recv_ns = 0, size_t conn = 0);
+
+  /**
+   * @brief 冗余推送仲裁，判断一条更新是否已由其他连接先送达
+   * @return bool 是否为首个副本，需要转发
+   */
+  bool accept_book(BookState& state, const WsBook& book, bool full);
+  bool accept_tick(SingleMarket& market, const WsTick& tick);
+  bool accept_trade(SingleMarket& market, const WsTrade& trade);
+
+  /// 记录仲裁结果
+  void count_feed(const char* channel, size_t conn, bool first);
 
   asio::awaitable<void> deal_account(const Account& msg);
-  asio::awaitable<void> deal_position(const std::vector<PositionDetail>& msg);
+  /// 转换持仓数据，snapshot 表示是否为全量查询的结果（REST 为全量，推送只含变化的持仓）
+  asio::awaitable<void> deal_position(const std::vector<PositionDetail>& msg, bool snapshot);
   asio::awaitable<void> deal_order(const std::vector<QueryOrderDetail>& msg);
+
+  /// 将OKX订单转换为统一格式
+  engine::OrderDataItemPtr to_order_item(const QueryOrderDetail& order);
+  /**
+   * @brief 登录WebSocket，私有连接和 l2-tbt 订单簿频道需要登录
+   * @param ws 要登录的连接
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> ws_login(std::shared_ptr<OkxWs> ws);
+
   /**
-   * @brief 登录私有WebSocket
+   * @brief 确保公共连接已登录，之后每次重连都会重新登录
+   * @param ws 公共连接
    * @return asio::awaitable<void> 异步协程
    */
-  asio::awaitable<void> ws_private_login();
+  asio::awaitable<void> ensure_public_login(std::shared_ptr<OkxWs> ws);
 
   asio::awaitable<void> ws_private_subscribe_account();
 
@@ -142,6 +220,26 @@ class Okx : public base::Gateway {
 
   asio::awaitable<void> ws_private_subscribe_order();
 
+  /**
+   * @brief 公共连接重连后的处理，清除该连接上的本地订单簿等待新快照
+   * @param shard 连接序号
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> resync_public(size_t shard);
+
+  /**
+   * @brief 交易对所在的公共连接，首次订阅时按配置分配
+   *
+   * 普通交易对一条连接；冗余交易对从首选连接起依次取 redundant_copies 条不同连接。
+   */
+  std::vector<std::shared_ptr<OkxWs>> public_ws(const std::string& symbol);
+
+  /**
+   * @brief 私有连接重连后通过REST补齐订单、持仓和账户
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> resync_private();
+
   asio::awaitable<void> ws_deal(std::shared_ptr<OkxWs> ws);
 
   SendOrderRequest to_send_order_request(engine::OrderDataItemPtr order);
@@ -151,8 +249,16 @@ class Okx : public base::Gateway {
   ConcurrentMap<std::string, SingleMarket> markets_;
 
   OkxHttp http_;  ///< HTTP客户端，用于查询操作
-  std::shared_ptr<OkxWs> ws_public_;      ///< WebSocket客户端，用于接收实时数据
+  std::vector<std::shared_ptr<OkxWs>> ws_public_;  ///< 公共WebSocket连接池，用于接收实时数据
+  std::unordered_map<std::string, std::vector<size_t>> public_shards_;  ///< 交易对到公共连接序号
+  std::set<size_t> public_logins_;  ///< 已登录的公共连接序号
+
+  /// 按频道和连接统计的首达与重复副本数
+  std::map<std::pair<std::string, size_t>, std::pair<Common::Counter*, Common::Counter*>> feed_counters_;
   std::shared_ptr<OkxWs> ws_private_;     ///< WebSocket客户端，用于接收私有数据
+  std::shared_ptr<OkxWs> ws_business_;    ///< business WebSocket，用于接收 trades-all
+
+  Common::Counter* book_gaps_ = nullptr;  ///< 订单簿序号缺口次数
 };
 
 }  // namespace market::okx
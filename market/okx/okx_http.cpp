@@ -4,15 +4,34 @@
 #include "httpcpp/request.h"
 #include "jsoncpp/jsoncpp.hpp"
 #include <glog/logging.h>
+#include <boost/asio/redirect_error.hpp>
+#include <chrono>
+#include "utils/latency.h"
+#include "utils/async_log.h"
 
 namespace market::okx {
 
+namespace {
+
+/// OKX限速错误码
+constexpr int kRateLimitCode = 50011;
+
+/// 被限速的批次最多重试次数
+constexpr int kMaxRateLimitRetries = 3;
+
+/// 查询的订单不存在
+constexpr int kOrderNotExistCode = 51603;
+
+}  // namespace
+
 OkxHttpRequest::OkxHttpRequest()
   : api_key(okx_config->api_key()), secret_key(okx_config->secret_key()), passphrase(okx_config->passphrase()), sim(okx_config->sim()) {}
 
 asio::awaitable<std::string> OkxHttpRequest::request(
-  const std::string& method, const std::string& request_path, const std::string& body){
+  const base::RestEndpoint& endpoint, const std::string& query, const std::string& body){
 
+  auto& method = endpoint.method;
+  auto request_path = query.empty() ? endpoint.path : endpoint.path + "?" + query;
   cpphttp::HttpRequest request(baseUrl_ + request_path, method, body);
   auto headers = get_headers(method, request_path, body);
   request.set_header(headers);
@@ -20,7 +39,9 @@ asio::awaitable<std::string> OkxHttpRequest::request(
     request.set_body("application/json", body);
   }
   
+  auto start_ns = Common::now_ns();
   auto resp = co_await request.request();
+  endpoint.latency->observe_since(start_ns);
 
   co_return resp;
 }
@@ -51,17 +72,18 @@ OkxHttp::OkxHttp()
 }
 
 asio::awaitable<Account> OkxHttp::get_account(){
-  auto resp = co_await request_->request("GET", "/api/v5/account/balance", "");
+  co_await limiter_.acquire("/api/v5/account/balance", "");
+  auto resp = co_await request_->request(balance_, "", "");
 
   auto account_rsp = jsoncpp::from_json<AccountRespone>(resp);
 
   if (account_rsp->code != 0) {
-    LOG(ERROR) << "get account failed, code: " << account_rsp->code << ", msg: " << account_rsp->msg;
+    QLOG(ERROR, "get account failed, code: {}, msg: {}", account_rsp->code, account_rsp->msg);
     throw std::runtime_error(fmt::format("get account failed, code: {}, msg: {}", account_rsp->code, account_rsp->msg));
   }
 
   if (account_rsp->data.size() == 0) {
-    LOG(ERROR) << "get account failed, no data returned";
+    QLOG(ERROR, "get account failed, no data returned");
     throw std::runtime_error("get account failed, no data returned");
   }
 
@@ -69,10 +91,11 @@ asio::awaitable<Account> OkxHttp::get_account(){
 }
 
 asio::awaitable<std::vector<PositionDetail>> OkxHttp::get_positions(){
-  auto resp = co_await request_->request("GET", "/api/v5/account/positions", "");
+  co_await limiter_.acquire("/api/v5/account/positions", "");
+  auto resp = co_await request_->request(positions_, "", "");
   auto position_rsp = jsoncpp::from_json<PositionRespone>(resp);
   if (position_rsp->code != 0) {
-    LOG(ERROR) << "get positions failed, code: " << position_rsp->code << ", msg: " << position_rsp->msg;
+    QLOG(ERROR, "get positions failed, code: {}, msg: {}", position_rsp->code, position_rsp->msg);
     throw std::runtime_error(fmt::format("get positions failed, code: {}, msg: {}", position_rsp->code, position_rsp->msg));
   }
 
@@ -80,36 +103,179 @@ asio::awaitable<std::vector<PositionDetail>> OkxHttp::get_positions(){
 }
 
 asio::awaitable<std::vector<QueryOrderDetail>> OkxHttp::get_pending_orders(){
-  auto resp = co_await request_->request("GET", "/api/v5/trade/orders-pending", "");
-  LOG(INFO) << "get orders response: " << resp;
+  co_await limiter_.acquire("/api/v5/trade/orders-pending", "");
+  auto resp = co_await request_->request(orders_pending_, "", "");
   auto order_rsp = jsoncpp::from_json<QueryOrderRespone>(resp);
   if (order_rsp->code != 0) {
-    LOG(ERROR) << "get orders failed, code: " << order_rsp->code << ", msg: " << order_rsp->msg;
+    QLOG(ERROR, "get orders failed, code: {}, msg: {}", order_rsp->code, order_rsp->msg);
     throw std::runtime_error(fmt::format("get orders failed, code: {}, msg: {}", order_rsp->code, order_rsp->msg));
   }
+  QLOG(INFO, "get orders: {} pending", order_rsp->data.size());
 
   co_return order_rsp->data;
 }
 
+asio::awaitable<std::optional<QueryOrderDetail>> OkxHttp::get_order(const std::string& inst_id,
+                                                                    const std::string& cl_ord_id) {
+  co_await limiter_.acquire("/api/v5/trade/order", inst_id);
+  auto query = fmt::format("instId={}&clOrdId={}", inst_id, cl_ord_id);
+  auto resp = co_await request_->request(order_, query, "");
+  auto order_rsp = jsoncpp::from_json<QueryOrderRespone>(resp);
+  if (order_rsp->code == kOrderNotExistCode) {
+    co_return std::nullopt;
+  }
+  if (order_rsp->code != 0) {
+    QLOG(ERROR, "get order {} failed, code: {}, msg: {}", cl_ord_id, order_rsp->code, order_rsp->msg);
+    throw std::runtime_error(fmt::format("get order failed, code: {}, msg: {}", order_rsp->code, order_rsp->msg));
+  }
+  if (order_rsp->data.empty()) {
+    co_return std::nullopt;
+  }
+  co_return order_rsp->data[0];
+}
+
 asio::awaitable<std::vector<SendOrderRspDetail>> OkxHttp::send_orders(const std::vector<SendOrderRequest>& request){
-  LOG(INFO) << "send orders: " << jsoncpp::to_json(request);
-  auto resp = co_await request_->request(
-    "POST", "/api/v5/trade/batch-orders", jsoncpp::to_json(request));
-  auto order_rsp = jsoncpp::from_json<SendOrderRespone>(resp);
-  if (order_rsp->code != 0 && order_rsp->code != 1 && order_rsp->code != 2) {
-    LOG(ERROR) << "send order failed, code: " << order_rsp->code << ", msg: " << order_rsp->msg;
-    throw std::runtime_error(fmt::format("send order failed, code: {}, msg: {}", order_rsp->code, order_rsp->msg));
+  if (request.empty()) {
+    co_return std::vector<SendOrderRspDetail>();
   }
 
-  co_return order_rsp->data;
+  auto executor = co_await asio::this_coro::executor;
+  auto waiter = std::make_shared<OrderWaiter>(executor);
+  waiter->results.resize(request.size());
+  waiter->pending = request.size();
+  for (size_t i = 0; i < request.size(); ++i) {
+    order_queue_.push_back({request[i], waiter, i});
+  }
+
+  if (!order_loop_running_) {
+    order_loop_running_ = true;
+    asio::co_spawn(executor, order_loop(), asio::detached);
+  }
+
+  // 等待队列协程完成本次所有订单
+  waiter->done.expires_at(asio::steady_timer::time_point::max());
+  boost::system::error_code ec;
+  co_await waiter->done.async_wait(asio::redirect_error(asio::use_awaitable, ec));
+
+  if (waiter->error) {
+    std::rethrow_exception(waiter->error);
+  }
+  co_return waiter->results;
+}
+
+asio::awaitable<void> OkxHttp::order_loop() {
+  while (!order_queue_.empty()) {
+    // 取出一批，等待令牌期间新到的订单留在队列中，进入下一批
+    std::vector<QueuedOrder> batch;
+    while (!order_queue_.empty() && batch.size() < kMaxBatchOrders) {
+      batch.push_back(std::move(order_queue_.front()));
+      order_queue_.pop_front();
+    }
+
+    // 按标的族取令牌
+    std::map<std::string, double> costs;
+    for (auto& order : batch) {
+      costs[RateLimiter::inst_family(order.request.instId)] += 1;
+    }
+    for (auto& [family, cost] : costs) {
+      co_await limiter_.acquire(kBatchOrdersPath, family, cost);
+    }
+
+    std::vector<SendOrderRequest> requests;
+    for (auto& order : batch) {
+      requests.push_back(order.request);
+    }
+
+    try {
+      auto body = jsoncpp::to_json(requests);
+      QLOG(INFO, "send orders: {}", body);
+      auto start_ns = Common::now_ns();
+      auto resp = co_await request_->request(batch_orders_, "", body);
+      latency_stats.record_since(Common::LatencyStage::kOrderRtt, start_ns);
+      auto order_rsp = jsoncpp::from_json<SendOrderRespone>(resp);
+
+      // 被限速：清空令牌，整批放回队首重试
+      if (order_rsp->code == kRateLimitCode) {
+        QLOG(WARNING, "send order rate limited: {}", order_rsp->msg);
+        for (auto& [family, cost] : costs) {
+          limiter_.penalize(kBatchOrdersPath, family);
+        }
+        for (auto it = batch.rbegin(); it != batch.rend(); ++it) {
+          if (++it->retries > kMaxRateLimitRetries) {
+            complete(*it, nullptr,
+                     std::make_exception_ptr(std::runtime_error(fmt::format("send order rate limited: {}", order_rsp->msg))));
+            continue;
+          }
+          order_queue_.push_front(std::move(*it));
+        }
+        continue;
+      }
+
+      if (order_rsp->code != 0 && order_rsp->code != 1 && order_rsp->code != 2) {
+        QLOG(ERROR, "send order failed, code: {}, msg: {}", order_rsp->code, order_rsp->msg);
+        throw std::runtime_error(fmt::format("send order failed, code: {}, msg: {}", order_rsp->code, order_rsp->msg));
+      }
+
+      // 返回结果与请求顺序一致，数量不一致时按客户端订单ID匹配
+      auto& data = order_rsp->data;
+      for (size_t i = 0; i < batch.size(); ++i) {
+        const SendOrderRspDetail* rsp = nullptr;
+        if (data.size() == batch.size()) {
+          rsp = &data[i];
+        } else {
+          for (auto& item : data) {
+            if (!item.clOrdId.empty() && item.clOrdId == batch[i].request.clOrdId) {
+              rsp = &item;
+              break;
+            }
+          }
+        }
+        complete(batch[i], rsp, nullptr);
+      }
+    } catch (...) {
+      auto error = std::current_exception();
+      for (auto& order : batch) {
+        complete(order, nullptr, error);
+      }
+    }
+  }
+
+  order_loop_running_ = false;
+}
+
+void OkxHttp::complete(QueuedOrder& order, const SendOrderRspDetail* rsp, std::exception_ptr error) {
+  auto& waiter = *order.waiter;
+  if (rsp) {
+    waiter.results[order.index] = *rsp;
+  } else {
+    // 没有对应结果的订单按失败处理
+    auto& result = waiter.results[order.index];
+    result.instId = order.request.instId;
+    result.clOrdId = order.request.clOrdId;
+    result.sCode = -1;
+    result.sMsg = "no response";
+  }
+  if (error && !waiter.error) {
+    waiter.error = error;
+  }
+  if (--waiter.pending == 0) {
+    waiter.done.cancel();
+  }
 }
 
 asio::awaitable<std::vector<CancelOrderRspDetail>> OkxHttp::cancel_orders(const std::vector<CancelOrderRequest>& request) {
-  auto resp = co_await request_->request(
-    "POST", "/api/v5/trade/cancel-batch-orders", jsoncpp::to_json(request));
+  std::map<std::string, double> costs;
+  for (auto& item : request) {
+    costs[RateLimiter::inst_family(item.instId)] += 1;
+  }
+  for (auto& [family, cost] : costs) {
+    co_await limiter_.acquire("/api/v5/trade/cancel-batch-orders", family, cost);
+  }
+
+  auto resp = co_await request_->request(cancel_batch_orders_, "", jsoncpp::to_json(request));
   auto order_rsp = jsoncpp::from_json<CancelOrderRespone>(resp);
   if (order_rsp->code != 0) {
-    LOG(ERROR) << "cancel order failed, code: " << order_rsp->code << ", msg: " << order_rsp->msg;
+    QLOG(ERROR, "cancel order failed, code: {}, msg: {}", order_rsp->code, order_rsp->msg);
     throw std::runtime_error(fmt::format("cancel order failed, code: {}, msg: {}", order_rsp->code, order_rsp->msg));
   }
 
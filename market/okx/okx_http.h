@@ -1,11 +1,17 @@
 #ifndef MARKET_OKX_OKX_HTTP_H_
 #define MARKET_OKX_OKX_HTTP_H_
 
+#include <boost/asio/steady_timer.hpp>
+#include <deque>
+#include <exception>
 #include <memory>
+#include <optional>
 #include <string>
 #include "utils/utils.h"
 #include <map>
+#include "base/rest_endpoint.h"
 #include "data.hpp"
+#include "rate_limiter.h"
 
 namespace market::okx {
 
@@ -13,8 +19,15 @@ class OkxHttpRequest {
  public:
   OkxHttpRequest();
 
-  asio::awaitable<std::string> request(const std::string& method, const std::string& request_path,
-                      const std::string& body);
+  /**
+   * @brief 发送签名请求
+   * @param endpoint 接口
+   * @param query 查询参数，不含 '?'
+   * @param body 请求体
+   * @return asio::awaitable<std::string> 响应内容
+   */
+  asio::awaitable<std::string> request(const base::RestEndpoint& endpoint, const std::string& query,
+                                       const std::string& body);
  private:
   std::map<std::string, std::string> get_headers(const std::string& method, const std::string& request_path,
                       const std::string& body);
@@ -27,6 +40,12 @@ class OkxHttpRequest {
 
 typedef std::shared_ptr<OkxHttpRequest> OkxHttpRequestPtr;
 
+/**
+ * @brief OKX REST客户端
+ *
+ * 所有请求先经过限速调度。下单请求进入队列，由单独的协程按标的族取令牌，
+ * 把排队中的订单合并为每批最多20笔的批量下单，结果按原请求拆分返回。
+ */
 class OkxHttp {
  public:
   OkxHttp();
@@ -35,11 +54,61 @@ class OkxHttp {
   asio::awaitable<Account> get_account();
   asio::awaitable<std::vector<PositionDetail>> get_positions();
   asio::awaitable<std::vector<QueryOrderDetail>> get_pending_orders();
+
+  /**
+   * @brief 按客户端订单ID查询单笔订单，包括已完成的订单
+   * @return asio::awaitable<std::optional<QueryOrderDetail>> 订单不存在时为空
+   */
+  asio::awaitable<std::optional<QueryOrderDetail>> get_order(const std::string& inst_id, const std::string& cl_ord_id);
   asio::awaitable<std::vector<SendOrderRspDetail>> send_orders(const std::vector<SendOrderRequest>& request);
   asio::awaitable<std::vector<CancelOrderRspDetail>> cancel_orders(const std::vector<CancelOrderRequest>& request);
+
+  /// 下单接口在某标的族上的剩余额度
+  RateBudget order_budget(const std::string& family) { return limiter_.budget(kBatchOrdersPath, family); }
+
+  /// 排队等待发送的订单数
+  size_t queued_orders() const { return order_queue_.size(); }
+
+  static constexpr const char* kBatchOrdersPath = "/api/v5/trade/batch-orders";
+  static constexpr size_t kMaxBatchOrders = 20;  ///< 批量下单每批最大订单数
+
  private:
+  /// 一次 send_orders 调用，等待队列协程填充结果
+  struct OrderWaiter {
+    OrderWaiter(asio::any_io_executor executor) : done(executor) {}
+
+    std::vector<SendOrderRspDetail> results;
+    size_t pending = 0;
+    std::exception_ptr error;
+    asio::steady_timer done;  ///< 全部完成时取消，唤醒调用方
+  };
+
+  /// 队列中的一笔订单
+  struct QueuedOrder {
+    SendOrderRequest request;
+    std::shared_ptr<OrderWaiter> waiter;
+    size_t index;  ///< 在原请求中的位置
+    int retries = 0;
+  };
+
+  /// 下单队列协程，队列为空时退出
+  asio::awaitable<void> order_loop();
+
+  /// 完成一笔订单，所属调用全部完成时唤醒
+  static void complete(QueuedOrder& order, const SendOrderRspDetail* rsp, std::exception_ptr error);
+
   OkxHttpRequestPtr request_;
-  
+  RateLimiter limiter_;
+
+  base::RestEndpoint balance_{"okx", "GET", "/api/v5/account/balance"};
+  base::RestEndpoint positions_{"okx", "GET", "/api/v5/account/positions"};
+  base::RestEndpoint orders_pending_{"okx", "GET", "/api/v5/trade/orders-pending"};
+  base::RestEndpoint order_{"okx", "GET", "/api/v5/trade/order"};
+  base::RestEndpoint batch_orders_{"okx", "POST", kBatchOrdersPath};
+  base::RestEndpoint cancel_batch_orders_{"okx", "POST", "/api/v5/trade/cancel-batch-orders"};
+
+  std::deque<QueuedOrder> order_queue_;
+  bool order_loop_running_ = false;
 };
 
 }  // namespace market::okx
@@ -2,51 +2,173 @@
 
 #include <glog/logging.h>
 
+#include <boost/asio/redirect_error.hpp>
+#include <chrono>
+
 #include "data.hpp"
+#include "utils/async_log.h"
+#include "utils/latency.h"
 #include "utils/utils.h"
 
 namespace market::okx {
 
+namespace {
+
+/// 重连退避初始值
+constexpr int64_t kBackoffMinMs = 500;
+
+int64_t steady_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
 // 初始化WebSocket客户端，连接到OKX的WebSocket服务器
 OkxWs::OkxWs(boost::asio::any_io_executor& ctx, size_t channel_size)
-    : write_channel_(ctx, channel_size), read_channel_(ctx, channel_size) {
+    : read_channel_(ctx, channel_size), write_channel_(ctx, channel_size), wake_(ctx) {
   if (okx_config->sim()) {
     base_url_ = "wss://wspap.okx.com:8443";
   }
-  ws_ = std::make_unique<cpphttp::WebSocket>(base_url_ + uri_);
+  init_metrics(0);
 }
 
-OkxWs::OkxWs(boost::asio::any_io_executor& ctx, size_t channel_size, std::string uri)
-    : write_channel_(ctx, channel_size), read_channel_(ctx, channel_size) {
+OkxWs::OkxWs(boost::asio::any_io_executor& ctx, size_t channel_size, std::string uri, size_t index)
+    : read_channel_(ctx, channel_size), write_channel_(ctx, channel_size), wake_(ctx) {
   uri_ = uri;
+  index_ = index;
   if (okx_config->sim()) {
     base_url_ = "wss://wspap.okx.com:8443";
   }
-  ws_ = std::make_unique<cpphttp::WebSocket>(base_url_ + uri_);
+  init_metrics(index);
 }
 
 OkxWs::~OkxWs() {}
 
+void OkxWs::init_metrics(size_t index) {
+  auto label = fmt::format("exchange=\"okx\",uri=\"{}\",conn=\"{}\"", uri_, index);
+  connects_ = &metrics_registry.counter("qitrader_ws_connects_total", "WebSocket connects including reconnects", label);
+  reconnects_ = &metrics_registry.counter("qitrader_ws_reconnects_total", "WebSocket reconnect attempts", label);
+  messages_ = &metrics_registry.counter("qitrader_ws_messages_total", "WebSocket messages received", label);
+  bytes_ = &metrics_registry.counter("qitrader_ws_bytes_total", "WebSocket payload bytes received", label);
+  errors_ = &metrics_registry.counter("qitrader_ws_errors_total", "WebSocket read and write errors", label);
+  connected_gauge_ = &metrics_registry.gauge("qitrader_ws_connected", "WebSocket connection is up", label);
+}
+
 // 连接到WebSocket服务器
 asio::awaitable<void> OkxWs::connect() {
   auto ctx = co_await asio::this_coro::executor;
 
-  if (okx_config->sim()) {
-    ws_->add_header("x-simulated-trading", "1");
+  // 首次连接失败同样交给监督协程重试
+  try {
+    co_await open();
+  } catch (const std::exception& e) {
+    errors_->inc();
+    QLOG(ERROR, "{} connect failed: {}", uri_, e.what());
   }
 
-  ws_->add_header("User-Agent", "qitrader");
-
-  co_await ws_->connect();
-
-  co_spawn(
-      ctx, [this] { return read_loop(); }, asio::detached);
   co_spawn(
       ctx, [this] { return write_loop(); }, asio::detached);
+  co_spawn(
+      ctx, [this] { return keepalive_loop(); }, asio::detached);
+  co_spawn(
+      ctx, [this] { return supervise(); }, asio::detached);
 
   co_return;
 }
 
+asio::awaitable<void> OkxWs::open() {
+  auto ctx = co_await asio::this_coro::executor;
+
+  auto ws = std::make_shared<cpphttp::WebSocket>(base_url_ + uri_);
+  if (okx_config->sim()) {
+    ws->add_header("x-simulated-trading", "1");
+  }
+  ws->add_header("User-Agent", "qitrader");
+
+  co_await ws->connect();
+
+  ws_ = ws;
+  ++generation_;
+  connected_ = true;
+  last_recv_ms_ = steady_ms();
+  connects_->inc();
+  connected_gauge_->set(1);
+
+  co_spawn(ctx, read_loop(ws, generation_), asio::detached);
+
+  if (on_open_) {
+    co_await on_open_();
+  }
+}
+
+void OkxWs::drop(uint64_t generation) {
+  if (generation != generation_ || !connected_) {
+    return;
+  }
+  connected_ = false;
+  connected_gauge_->set(0);
+
+  // 关闭旧连接：心跳超时时读协程还阻塞在 read 上，关闭后读出错退出，释放套接字和协程
+  if (auto ws = std::move(ws_)) {
+    try {
+      ws->close();
+    } catch (const std::exception& e) {
+      QLOG(WARNING, "{} close error: {}", uri_, e.what());
+    }
+  }
+  wake_.cancel();
+}
+
+asio::awaitable<void> OkxWs::supervise() {
+  auto ctx = co_await asio::this_coro::executor;
+  asio::steady_timer backoff_timer(ctx);
+
+  while (true) {
+    // 等待连接失效
+    if (connected_) {
+      boost::system::error_code ec;
+      wake_.expires_at(asio::steady_timer::time_point::max());
+      co_await wake_.async_wait(asio::redirect_error(asio::use_awaitable, ec));
+      continue;
+    }
+
+    // 指数退避重连
+    int64_t backoff_ms = kBackoffMinMs;
+    while (!connected_) {
+      reconnects_->inc();
+      QLOG(WARNING, "{} disconnected, reconnect in {}ms", uri_, backoff_ms);
+      backoff_timer.expires_after(std::chrono::milliseconds(backoff_ms));
+      co_await backoff_timer.async_wait(asio::use_awaitable);
+      backoff_ms = std::min<int64_t>(backoff_ms * 2, okx_config->ws_backoff_max_ms());
+
+      try {
+        co_await open();
+      } catch (const std::exception& e) {
+        errors_->inc();
+        QLOG(ERROR, "{} reconnect failed: {}", uri_, e.what());
+      } catch (...) {
+        errors_->inc();
+        QLOG(ERROR, "{} reconnect failed: unknown error", uri_);
+      }
+    }
+
+    // 登录已在 open 中完成，按原顺序重放订阅
+    for (auto& sub : subscriptions_) {
+      co_await write_channel_.async_send(boost::system::error_code{}, sub, asio::use_awaitable);
+    }
+    QLOG(INFO, "{} reconnected, replayed {} subscriptions", uri_, subscriptions_.size());
+
+    if (on_reconnect_) {
+      try {
+        co_await on_reconnect_();
+      } catch (const std::exception& e) {
+        QLOG(ERROR, "{} resync after reconnect failed: {}", uri_, e.what());
+      }
+    }
+  }
+}
+
 // 从WebSocket读取消息并解析为WsMessage结构
 asio::awaitable<market::okx::WsMessage> OkxWs::read() {
   // 读取原始JSON数据
@@ -54,33 +176,103 @@ asio::awaitable<market::okx::WsMessage> OkxWs::read() {
   co_return rsp;
 }
 
-asio::awaitable<void> OkxWs::read_loop() {
+asio::awaitable<void> OkxWs::read_loop(std::shared_ptr<cpphttp::WebSocket> ws, uint64_t generation) {
   while (true) {
+    std::string rsp;
+    // 读失败说明连接已断开，交给监督协程重连
     try {
-      auto rsp = co_await ws_->read();
-      auto msg = jsoncpp::from_json<market::okx::WsMessage>(rsp);
-      co_await read_channel_.async_send(boost::system::error_code{}, *msg, asio::use_awaitable);
+      rsp = co_await ws->read();
     } catch (const boost::system::error_code& e) {
-      LOG(ERROR) << fmt::format("{} Error in read_loop: code {} {}", uri_, e.value(), e.what());
+      errors_->inc();
+      QLOG(ERROR, "{} Error in read_loop: code {} {}", uri_, e.value(), e.what());
+      drop(generation);
+      co_return;
     } catch (const std::exception& e) {
-      LOG(ERROR) << fmt::format("{} Error in read_loop: {}", uri_, e.what());
+      errors_->inc();
+      QLOG(ERROR, "{} Error in read_loop: {}", uri_, e.what());
+      drop(generation);
+      co_return;
     } catch (...) {
-      LOG(ERROR) << fmt::format("{} Unknown error in read_loop", uri_);
+      errors_->inc();
+      QLOG(ERROR, "{} Unknown error in read_loop", uri_);
+      drop(generation);
+      co_return;
+    }
+
+    // 心跳超时后已被新连接取代，丢弃旧连接上迟到的数据
+    if (generation != generation_) {
+      co_return;
+    }
+    last_recv_ms_ = steady_ms();
+    bytes_->inc(rsp.size());
+    if (rsp == "pong") {
+      continue;
+    }
+
+    try {
+      auto recv_ns = Common::now_ns();
+      auto msg = jsoncpp::from_json<market::okx::WsMessage>(rsp);
+      msg->recv_ns = recv_ns;
+      messages_->inc();
+      latency_stats.record_since(Common::LatencyStage::kWsParse, recv_ns);
+      co_await read_channel_.async_send(boost::system::error_code{}, *msg, asio::use_awaitable);
+    } catch (const std::exception& e) {
+      errors_->inc();
+      QLOG(ERROR, "{} Error parsing message: {}", uri_, e.what());
     }
   }
 }
 
 asio::awaitable<void> OkxWs::write_loop() {
   while (true) {
+    auto msg = co_await write_channel_.async_receive();
+    // 断线期间的消息丢弃，订阅会在重连后重放
+    if (!connected_) {
+      QLOG(WARNING, "{} not connected, drop message: {}", uri_, msg);
+      continue;
+    }
+    auto ws = ws_;
+    auto generation = generation_;
     try {
-      auto msg = co_await write_channel_.async_receive();
-      co_await ws_->write(msg);
+      co_await ws->write(msg);
     } catch (const boost::system::error_code& e) {
-      LOG(ERROR) << fmt::format("{} Error in write_loop: code {} {}", uri_, e.value(), e.what());
+      errors_->inc();
+      QLOG(ERROR, "{} Error in write_loop: code {} {}", uri_, e.value(), e.what());
+      drop(generation);
     } catch (const std::exception& e) {
-      LOG(ERROR) << fmt::format("{} Error in write_loop: {}", uri_, e.what());
+      errors_->inc();
+      QLOG(ERROR, "{} Error in write_loop: {}", uri_, e.what());
+      drop(generation);
     } catch (...) {
-      LOG(ERROR) << fmt::format("{} Unknown error in write_loop", uri_);
+      errors_->inc();
+      QLOG(ERROR, "{} Unknown error in write_loop", uri_);
+      drop(generation);
+    }
+  }
+}
+
+asio::awaitable<void> OkxWs::keepalive_loop() {
+  auto ctx = co_await asio::this_coro::executor;
+  asio::steady_timer timer(ctx);
+  int64_t last_ping_ms = 0;
+
+  while (true) {
+    timer.expires_after(std::chrono::seconds(1));
+    co_await timer.async_wait(asio::use_awaitable);
+    if (!connected_) {
+      continue;
+    }
+
+    // OKX 30秒无数据会断开连接，空闲时发送 ping，服务端回复 pong
+    int64_t interval_ms = okx_config->ws_ping_interval_s() * 1000;
+    auto now = steady_ms();
+    auto idle_ms = now - last_recv_ms_;
+    if (idle_ms >= 2 * interval_ms) {
+      QLOG(WARNING, "{} no data for {}ms, reconnect", uri_, idle_ms);
+      drop(generation_);
+    } else if (idle_ms >= interval_ms && now - last_ping_ms >= interval_ms) {
+      last_ping_ms = now;
+      co_await write_channel_.async_send(boost::system::error_code{}, std::string("ping"), asio::use_awaitable);
     }
   }
 }
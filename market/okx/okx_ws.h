@@ -5,37 +5,131 @@
 #include <vector>
 
 #include "data.hpp"
+#include <functional>
 #include <memory>
+#include <set>
 #include "httpcpp/WebSocket.h"
+#include "utils/metrics.h"
 #include <glog/logging.h>
 #include <boost/asio/experimental/concurrent_channel.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 namespace market::okx {
 
+/**
+ * @brief OKX WebSocket连接
+ *
+ * 连接由监督协程维护：读失败或心跳超时后按指数退避重连，
+ * 重连成功后先调用 on_open（私有连接在此登录），再按原顺序重放所有订阅，
+ * 最后调用 on_reconnect 让网关补齐断线期间的状态。
+ */
 class OkxWs {
  public:
+  /// 连接建立后的回调
+  typedef std::function<asio::awaitable<void>()> Hook;
+
   OkxWs(boost::asio::any_io_executor& ctx, size_t channel_size);
-  OkxWs(boost::asio::any_io_executor& ctx, size_t channel_size, std::string uri);
+  /**
+   * @param uri 连接路径
+   * @param index 同一路径多条连接时的序号，用于区分指标
+   */
+  OkxWs(boost::asio::any_io_executor& ctx, size_t channel_size, std::string uri, size_t index = 0);
   ~OkxWs();
+
+  /**
+   * @brief 首次连接并启动读写、心跳和监督协程
+   * @return asio::awaitable<void> 异步协程
+   */
   asio::awaitable<void> connect();
   asio::awaitable<market::okx::WsMessage> read();
 
+  /// 每次连接建立后、重放订阅前调用，需在 connect 之前设置
+  void set_on_open(Hook hook) { on_open_ = std::move(hook); }
+
+  /// 重连并重放订阅后调用，首次连接不调用
+  void set_on_reconnect(Hook hook) { on_reconnect_ = std::move(hook); }
+
+  /// 当前是否已连接
+  bool connected() const { return connected_; }
+
+  /// 已记录的订阅数
+  size_t subscription_count() const { return subscriptions_.size(); }
+
+  /// 同一路径多条连接时的序号
+  size_t index() const { return index_; }
+
   template <typename T>
   asio::awaitable<void> write(T&& message) {
     auto msg_str = jsoncpp::to_json(message);
     co_await write_channel_.async_send(boost::system::error_code{}, msg_str, asio::use_awaitable);
   }
 
+  /**
+   * @brief 发送订阅请求并记录，重连后自动重放
+   * @param message 订阅请求，相同内容只记录一次
+   * @return asio::awaitable<void> 异步协程
+   */
+  template <typename T>
+  asio::awaitable<void> subscribe(T&& message) {
+    auto msg_str = jsoncpp::to_json(message);
+    if (subscription_set_.insert(msg_str).second) {
+      subscriptions_.push_back(msg_str);
+    }
+    co_await write_channel_.async_send(boost::system::error_code{}, msg_str, asio::use_awaitable);
+  }
+
  private:
-  asio::awaitable<void> read_loop();
+  /// 建立一条新连接
+  asio::awaitable<void> open();
+
+  /// 连接断开后退避重连，并重放登录和订阅
+  asio::awaitable<void> supervise();
+
+  /**
+   * @brief 读取一条连接上的消息
+   * @param ws 连接，协程持有以保证对象存活
+   * @param generation 连接代数，已被新连接取代时丢弃数据并退出
+   */
+  asio::awaitable<void> read_loop(std::shared_ptr<cpphttp::WebSocket> ws, uint64_t generation);
   asio::awaitable<void> write_loop();
 
-  std::unique_ptr<cpphttp::WebSocket> ws_;
+  /// 无数据时发送 ping，超时未收到任何数据判定连接失效
+  asio::awaitable<void> keepalive_loop();
+
+  /// 标记当前连接失效并唤醒监督协程
+  void drop(uint64_t generation);
+
+  /// 注册本连接的指标，标签为 uri 和连接序号
+  void init_metrics(size_t index);
+
+  std::shared_ptr<cpphttp::WebSocket> ws_;
   std::string uri_ = "/ws/v5/public";
   std::string base_url_ = "wss://ws.okx.com:8443";
 
   asio::experimental::concurrent_channel<void(boost::system::error_code, market::okx::WsMessage)> read_channel_;
   asio::experimental::concurrent_channel<void(boost::system::error_code, std::string)> write_channel_;
+
+  /// 监督协程在此等待连接失效
+  asio::steady_timer wake_;
+
+  size_t index_ = 0;
+  uint64_t generation_ = 0;
+  bool connected_ = false;
+  int64_t last_recv_ms_ = 0;
+
+  Hook on_open_;
+  Hook on_reconnect_;
+
+  /// 按订阅顺序保存的请求，用于重放
+  std::vector<std::string> subscriptions_;
+  std::set<std::string> subscription_set_;
+
+  Common::Counter* connects_ = nullptr;
+  Common::Counter* reconnects_ = nullptr;
+  Common::Counter* messages_ = nullptr;
+  Common::Counter* bytes_ = nullptr;
+  Common::Counter* errors_ = nullptr;
+  Common::Gauge* connected_gauge_ = nullptr;
 };
 
 std::string get_sign(
@@ -0,0 +1,98 @@
+#include "rate_limiter.h"
+
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <cmath>
+
+#include "engine.h"
+#include "utils/async_log.h"
+
+namespace market::okx {
+
+TokenBucket::TokenBucket(double capacity, int64_t window_ms)
+    : capacity_(capacity), rate_per_ms_(capacity / window_ms), tokens_(capacity) {}
+
+void TokenBucket::refill(int64_t now_ms) {
+  if (last_ms_ == 0) {
+    last_ms_ = now_ms;
+  }
+  if (now_ms > last_ms_) {
+    tokens_ = std::min(capacity_, tokens_ + (now_ms - last_ms_) * rate_per_ms_);
+    last_ms_ = now_ms;
+  }
+}
+
+int64_t TokenBucket::reserve(double cost, int64_t now_ms) {
+  refill(now_ms);
+  tokens_ -= cost;
+  if (tokens_ >= 0) {
+    return 0;
+  }
+  return static_cast<int64_t>(std::ceil(-tokens_ / rate_per_ms_));
+}
+
+double TokenBucket::remaining(int64_t now_ms) {
+  refill(now_ms);
+  return tokens_;
+}
+
+void TokenBucket::drain(int64_t now_ms) {
+  refill(now_ms);
+  tokens_ = std::min(tokens_, 0.0);
+}
+
+RateLimiter::RateLimiter() {
+  // 窗口均为2秒
+  rules_["/api/v5/account/balance"] = {10, 2000, false};
+  rules_["/api/v5/account/positions"] = {10, 2000, false};
+  rules_["/api/v5/trade/orders-pending"] = {60, 2000, false};
+  rules_["/api/v5/trade/order"] = {60, 2000, true};
+  rules_["/api/v5/trade/batch-orders"] = {300, 2000, true};
+  rules_["/api/v5/trade/cancel-batch-orders"] = {300, 2000, true};
+}
+
+TokenBucket& RateLimiter::bucket(const std::string& endpoint, const std::string& family) {
+  auto rule_it = rules_.find(endpoint);
+  // 未配置规则的接口按每2秒20次处理
+  Rule rule = rule_it == rules_.end() ? Rule{20, 2000, false} : rule_it->second;
+
+  auto key = rule.per_family ? endpoint + "|" + family : endpoint;
+  auto it = buckets_.find(key);
+  if (it == buckets_.end()) {
+    it = buckets_.emplace(key, TokenBucket(rule.capacity, rule.window_ms)).first;
+  }
+  return it->second;
+}
+
+asio::awaitable<void> RateLimiter::acquire(const std::string& endpoint, const std::string& family, double cost) {
+  auto wait_ms = bucket(endpoint, family).reserve(cost, engine::Engine::steady_now_ms());
+  if (wait_ms <= 0) {
+    co_return;
+  }
+
+  QLOG(INFO, "rate limit {} {}: queued {}ms", endpoint, family, wait_ms);
+  asio::steady_timer timer(co_await asio::this_coro::executor);
+  timer.expires_after(std::chrono::milliseconds(wait_ms));
+  co_await timer.async_wait(asio::use_awaitable);
+}
+
+RateBudget RateLimiter::budget(const std::string& endpoint, const std::string& family) {
+  auto& b = bucket(endpoint, family);
+  return {b.remaining(engine::Engine::steady_now_ms()), b.capacity()};
+}
+
+void RateLimiter::penalize(const std::string& endpoint, const std::string& family) {
+  bucket(endpoint, family).drain(engine::Engine::steady_now_ms());
+}
+
+std::string RateLimiter::inst_family(const std::string& inst_id) {
+  // 现货 BTC-USDT，永续 BTC-USDT-SWAP，交割 BTC-USDT-250328，期权 BTC-USD-250328-100000-C
+  auto first = inst_id.find('-');
+  if (first == std::string::npos) {
+    return inst_id;
+  }
+  auto second = inst_id.find('-', first + 1);
+  return second == std::string::npos ? inst_id : inst_id.substr(0, second);
+}
+
+}  // namespace market::okx
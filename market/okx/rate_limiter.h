@@ -0,0 +1,109 @@
+#ifndef MARKET_OKX_RATE_LIMITER_H_
+#define MARKET_OKX_RATE_LIMITER_H_
+
+/**
+ * @file rate_limiter.h
+ * @brief OKX REST接口限速
+ *
+ * 按 接口 + 标的族 维护令牌桶，超出限速的请求排队等待，而不是发出后被交易所以 50011 拒绝。
+ */
+
+#include <string>
+#include <unordered_map>
+
+#include "utils/utils.h"
+
+namespace market::okx {
+
+/**
+ * @brief 令牌桶
+ *
+ * 采用预占模式：请求到来时直接扣除令牌，令牌可以为负，
+ * 返回值为令牌恢复到非负所需的等待时间，因此排队天然先进先出。
+ */
+class TokenBucket {
+ public:
+  /**
+   * @param capacity 窗口内允许的请求数
+   * @param window_ms 窗口长度（毫秒）
+   */
+  TokenBucket(double capacity, int64_t window_ms);
+
+  /**
+   * @brief 预占令牌
+   * @param cost 消耗的令牌数
+   * @param now_ms 当前时间（毫秒，单调时钟）
+   * @return int64_t 需要等待的毫秒数，0表示立即可用
+   */
+  int64_t reserve(double cost, int64_t now_ms);
+
+  /// 当前剩余令牌，排队中时为负
+  double remaining(int64_t now_ms);
+
+  /// 被交易所限速后清空令牌，等待一个完整窗口
+  void drain(int64_t now_ms);
+
+  double capacity() const { return capacity_; }
+
+ private:
+  void refill(int64_t now_ms);
+
+  double capacity_;
+  double rate_per_ms_;
+  double tokens_;
+  int64_t last_ms_ = 0;
+};
+
+/**
+ * @brief 某个限速桶的剩余额度
+ */
+struct RateBudget {
+  double remaining = 0;  ///< 剩余请求数，负数表示已有请求排队
+  double capacity = 0;   ///< 窗口容量
+};
+
+/**
+ * @brief OKX限速调度
+ *
+ * 规则来自OKX文档，按用户ID计的接口所有标的共享一个桶，
+ * 下单/撤单按标的计，这里用标的族（去掉 -SWAP 等后缀）作为key。
+ */
+class RateLimiter {
+ public:
+  RateLimiter();
+
+  /**
+   * @brief 获取令牌，不足时挂起等待
+   * @param endpoint 接口路径
+   * @param family 标的族，按用户限速的接口传空
+   * @param cost 消耗的令牌数（批量下单为订单数）
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> acquire(const std::string& endpoint, const std::string& family, double cost = 1);
+
+  /// 查询剩余额度
+  RateBudget budget(const std::string& endpoint, const std::string& family);
+
+  /// 收到限速错误后清空对应的桶
+  void penalize(const std::string& endpoint, const std::string& family);
+
+  /// 标的族，如 BTC-USDT-SWAP -> BTC-USDT
+  static std::string inst_family(const std::string& inst_id);
+
+ private:
+  /// 限速规则
+  struct Rule {
+    double capacity;
+    int64_t window_ms;
+    bool per_family;  ///< 是否按标的族分桶
+  };
+
+  TokenBucket& bucket(const std::string& endpoint, const std::string& family);
+
+  std::unordered_map<std::string, Rule> rules_;          ///< key: 接口路径
+  std::unordered_map<std::string, TokenBucket> buckets_;  ///< key: 接口路径|标的族
+};
+
+}  // namespace market::okx
+
+#endif  // MARKET_OKX_RATE_LIMITER_H_
@@ -0,0 +1,319 @@
+#include "algo_engine.h"
+
+#include "base/gateway_registry.h"
+#include "order/order_manager.h"
+#include "utils/async_log.h"
+
+namespace service::algo {
+
+using Common::Fixed;
+
+namespace {
+
+bool is_finished(engine::OrderStatus status) {
+  return status == engine::OrderStatus::FILLED || status == engine::OrderStatus::CANCELLED ||
+         status == engine::OrderStatus::REJECTED;
+}
+
+}  // namespace
+
+AlgoEngine::AlgoEngine(engine::EnginePtr engine) : engine_(engine) {}
+
+AlgoEngine::~AlgoEngine() {}
+
+asio::awaitable<void> AlgoEngine::init() {
+  engine_->register_callback<engine::AlgoOrderData>(engine::EventType::kAlgoOrder,
+    std::bind(&AlgoEngine::start, shared_from_this(), std::placeholders::_1));
+
+  engine_->register_callback<engine::AlgoOrderData>(engine::EventType::kCancelAlgo,
+    std::bind(&AlgoEngine::stop, shared_from_this(), std::placeholders::_1));
+
+  engine_->register_callback<engine::Book>(engine::EventType::kBook,
+    std::bind(&AlgoEngine::recv_book, shared_from_this(), std::placeholders::_1));
+
+  engine_->register_callback<engine::TradeData>(engine::EventType::kTrade,
+    std::bind(&AlgoEngine::recv_trade, shared_from_this(), std::placeholders::_1));
+
+  engine_->register_callback<engine::OrderData>(engine::EventType::kOrder,
+    std::bind(&AlgoEngine::recv_order, shared_from_this(), std::placeholders::_1));
+  co_return;
+}
+
+asio::awaitable<void> AlgoEngine::run() {
+  executor_ = co_await asio::this_coro::executor;
+  co_return;
+}
+
+const AlgoState* AlgoEngine::find(const std::string& algo_id) const {
+  auto it = algos_.find(algo_id);
+  return it == algos_.end() ? nullptr : it->second.get();
+}
+
+asio::awaitable<void> AlgoEngine::start(engine::AlgoOrderDataPtr order) {
+  auto state = std::make_unique<AlgoState>();
+  auto& request = state->order;
+  request = *order;
+  if (request.algo_id.empty()) {
+    request.algo_id = order::OrderManager::next_client_order_id();
+  }
+  if (request.exchange.empty()) {
+    request.exchange = gateway_config->default_venue();
+  }
+  if (request.interval_ms <= 0) {
+    request.interval_ms = algo_config->interval_ms();
+  }
+  state->volume = Fixed::from_dec(request.volume);
+  state->algo = Algo::create(request, engine::Engine::steady_now_ms());
+
+  auto algo_id = request.algo_id;
+  if (!state->algo || state->volume.raw() <= 0 || algos_.contains(algo_id)) {
+    QLOG(ERROR, "algo order rejected: {}", algo_id);
+    co_await publish(*state, engine::OrderStatus::REJECTED);
+    co_return;
+  }
+
+  // 第一次定时器立即触发，之后每个间隔触发一次
+  state->timer = engine_->schedule_timer(0, std::bind(&AlgoEngine::on_timer, shared_from_this(), algo_id));
+  auto& ref = *state;
+  algos_[algo_id] = std::move(state);
+  QLOG(INFO, "algo {} started: {} {}", algo_id, ref.order.symbol, ref.volume.str());
+  co_await publish(ref, engine::OrderStatus::PENDING);
+}
+
+asio::awaitable<void> AlgoEngine::stop(engine::AlgoOrderDataPtr order) {
+  auto it = algos_.find(order->algo_id);
+  if (it == algos_.end()) {
+    co_return;
+  }
+  it->second->stopping = true;
+  co_await work(order->algo_id);
+}
+
+asio::awaitable<void> AlgoEngine::recv_book(engine::BookPtr book) {
+  books_[book_key(book->exchange, book->symbol)] = book;
+  co_return;
+}
+
+asio::awaitable<void> AlgoEngine::recv_trade(engine::TradeDataPtr trade) {
+  for (auto& [algo_id, state] : algos_) {
+    if (state->order.symbol == trade->symbol && state->order.exchange == trade->exchange) {
+      state->algo->on_trade(*trade);
+    }
+  }
+  co_return;
+}
+
+void AlgoEngine::on_timer(const std::string& algo_id) {
+  auto it = algos_.find(algo_id);
+  if (it == algos_.end()) {
+    return;
+  }
+  auto& state = *it->second;
+  state.timer = engine_->schedule_timer(state.order.interval_ms,
+                                        std::bind(&AlgoEngine::on_timer, shared_from_this(), algo_id));
+  if (executor_) {
+    asio::co_spawn(executor_, std::bind(&AlgoEngine::work, shared_from_this(), algo_id), asio::detached);
+  }
+}
+
+Fixed AlgoEngine::peg_price(const AlgoState& state) const {
+  auto it = books_.find(book_key(state.order.exchange, state.order.symbol));
+  if (it == books_.end()) {
+    return Fixed();
+  }
+
+  bool buy = state.order.direction == engine::Direction::BUY;
+  auto& side = buy ? it->second->bids : it->second->asks;
+  if (side.empty()) {
+    return Fixed();
+  }
+  auto peg = Fixed::from_dec(side.front().price);
+  auto limit = Fixed::from_dec(state.order.price);
+  if (!limit.is_zero()) {
+    peg = buy ? std::min(peg, limit) : std::max(peg, limit);
+  }
+  return peg;
+}
+
+Fixed AlgoEngine::working_volume(const AlgoState& state) const {
+  auto volume = std::min(state.algo->released(engine::Engine::steady_now_ms()), state.volume) - state.filled;
+  auto display = Fixed::from_dec(state.order.display_volume);
+  if (!display.is_zero()) {
+    volume = std::min(volume, display);
+  }
+  return volume;
+}
+
+asio::awaitable<void> AlgoEngine::work(std::string algo_id) {
+  auto it = algos_.find(algo_id);
+  if (it == algos_.end()) {
+    co_return;
+  }
+  auto& state = *it->second;
+
+  // 有工作中的子单：等待确认，偏离盘口、停止或释放进度超过子单剩余数量时撤单，撤单回报到达后再重挂
+  if (!state.child_id.empty()) {
+    if (state.cancelling || state.child_status == engine::OrderStatus::SUBMITTING) {
+      co_return;
+    }
+    auto peg = peg_price(state);
+    // 冰山单的子单成交完才补充下一笔，不因部分成交撤单重挂
+    bool behind = state.order.algo != engine::AlgoType::ICEBERG &&
+                  working_volume(state) > state.child_volume - state.child_filled;
+    if (state.stopping || behind || (!peg.is_zero() && peg != state.child_price)) {
+      state.cancelling = true;
+      auto item = std::make_shared<engine::OrderDataItem>();
+      item->symbol = state.order.symbol;
+      item->exchange = state.order.exchange;
+      item->client_order_id = state.child_id;
+      item->order_id = state.child_order_id;
+      auto cancel = std::make_shared<engine::OrderData>();
+      cancel->symbol = item->symbol;
+      cancel->exchange = item->exchange;
+      cancel->items.push_back(item);
+      co_await engine_->on_event(engine::EventType::kCancelOrder, cancel);
+    }
+    co_return;
+  }
+
+  if (state.stopping) {
+    co_await finish(algo_id, engine::OrderStatus::CANCELLED);
+    co_return;
+  }
+
+  auto peg = peg_price(state);
+  if (peg.is_zero()) {
+    co_return;
+  }
+  auto volume = working_volume(state);
+  if (volume.raw() <= 0) {
+    co_return;
+  }
+
+  auto item = std::make_shared<engine::OrderDataItem>();
+  item->symbol = state.order.symbol;
+  item->exchange = state.order.exchange;
+  item->client_order_id = order::OrderManager::next_client_order_id();
+  item->direction = state.order.direction;
+  item->price = peg.to_dec();
+  item->volume = volume.to_dec();
+  item->otype = engine::OrderType::LIMIT;
+
+  state.child_id = item->client_order_id;
+  state.child_order_id.clear();
+  state.child_price = peg;
+  state.child_volume = volume;
+  state.child_filled = Fixed();
+  state.child_avg = Fixed();
+  state.child_status = engine::OrderStatus::SUBMITTING;
+  state.cancelling = false;
+  ++state.child_orders;
+  children_[state.child_id] = algo_id;
+
+  auto child = std::make_shared<engine::OrderData>();
+  child->symbol = item->symbol;
+  child->exchange = item->exchange;
+  child->items.push_back(item);
+  co_await engine_->on_event(engine::EventType::kSendOrder, child);
+}
+
+bool AlgoEngine::apply(AlgoState& state, const engine::OrderDataItem& item) {
+  if (!item.order_id.empty()) {
+    state.child_order_id = item.order_id;
+  }
+
+  bool changed = false;
+  auto filled = Fixed::from_dec(item.filled_volume);
+  if (filled > state.child_filled) {
+    // 本次成交金额 = 累计成交额的增量
+    auto avg = Fixed::from_dec(item.avg_price);
+    state.turnover += avg * filled - state.child_avg * state.child_filled;
+    state.filled += filled - state.child_filled;
+    state.child_filled = filled;
+    state.child_avg = avg;
+    changed = true;
+  }
+
+  if (item.status != engine::OrderStatus::SUBMITTING) {
+    state.child_status = item.status;
+  }
+  if (is_finished(state.child_status)) {
+    state.rejects = state.child_status == engine::OrderStatus::REJECTED ? state.rejects + 1 : 0;
+    children_.erase(state.child_id);
+    state.child_id.clear();
+    state.cancelling = false;
+  }
+  return changed;
+}
+
+asio::awaitable<void> AlgoEngine::recv_order(engine::OrderDataPtr order) {
+  for (auto& item : order->items) {
+    auto child_it = children_.find(item->client_order_id);
+    if (child_it == children_.end()) {
+      continue;
+    }
+    auto algo_id = child_it->second;
+    auto it = algos_.find(algo_id);
+    if (it == algos_.end() || it->second->child_id != item->client_order_id) {
+      children_.erase(child_it);
+      continue;
+    }
+
+    auto& state = *it->second;
+    bool changed = apply(state, *item);
+    bool repost = state.child_id.empty() && state.rejects == 0;
+
+    if (state.filled >= state.volume) {
+      co_await finish(algo_id, engine::OrderStatus::FILLED);
+      continue;
+    }
+    if (state.rejects >= algo_config->max_rejects()) {
+      QLOG(ERROR, "algo {} stopped after {} rejected child orders", algo_id, state.rejects);
+      co_await finish(algo_id,
+                      state.filled.is_zero() ? engine::OrderStatus::REJECTED : engine::OrderStatus::CANCELLED);
+      continue;
+    }
+    if (changed) {
+      co_await publish(state, engine::OrderStatus::PARTIAL_FILLED);
+    }
+    // 子单结束（撤单完成或成交完）后立即按当前盘口重挂，被拒绝的等下一次定时器
+    if (repost) {
+      co_await work(algo_id);
+    }
+  }
+}
+
+asio::awaitable<void> AlgoEngine::publish(const AlgoState& state, engine::OrderStatus status) {
+  auto data = std::make_shared<engine::AlgoStatusData>();
+  data->symbol = state.order.symbol;
+  data->exchange = state.order.exchange;
+  data->timestamp_ms = Common::get_current_time_s() * 1000;
+  data->algo_id = state.order.algo_id;
+  data->algo = state.order.algo;
+  data->direction = state.order.direction;
+  data->volume = state.volume.to_dec();
+  data->filled_volume = state.filled.to_dec();
+  data->avg_price = state.filled.is_zero() ? Fixed().to_dec() : (state.turnover / state.filled).to_dec();
+  data->child_orders = state.child_orders;
+  data->status = status;
+  co_await engine_->on_event(engine::EventType::kAlgoStatus, data);
+}
+
+asio::awaitable<void> AlgoEngine::finish(const std::string& algo_id, engine::OrderStatus status) {
+  auto it = algos_.find(algo_id);
+  if (it == algos_.end()) {
+    co_return;
+  }
+  auto state = std::move(it->second);
+  algos_.erase(it);
+  if (state->timer != engine::TimerWheel::kInvalidTimer) {
+    engine_->cancel_timer(state->timer);
+  }
+  if (!state->child_id.empty()) {
+    children_.erase(state->child_id);
+  }
+  QLOG(INFO, "algo {} finished: filled {} / {}", algo_id, state->filled.str(), state->volume.str());
+  co_await publish(*state, status);
+}
+
+}  // namespace service::algo
@@ -0,0 +1,159 @@
+#ifndef __SERVICE_ALGO_ALGO_ENGINE_H__
+#define __SERVICE_ALGO_ALGO_ENGINE_H__
+
+/**
+ * @file algo_engine.h
+ * @brief 算法执行组件
+ *
+ * 策略以 kAlgoOrder 发出 TWAP、VWAP 或冰山单，组件为每个算法单在引擎时间轮上设置定时器，
+ * 每个间隔按算法的释放进度挂出一笔被动子单：买单挂买一、卖单挂卖一，不超过限价。
+ * 盘口移动或新释放的数量超过子单剩余数量后撤单，撤单回报到达后按新的盘口和数量重挂，不主动吃单。
+ * 成交量或状态变化时发出 kAlgoStatus，kCancelAlgo 撤掉工作中的子单并停止算法单。
+ *
+ * 算法单的交易对需要由策略订阅订单簿，VWAP 还需要订阅逐笔成交。
+ */
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "algos.h"
+#include "config/config.h"
+#include "engine.h"
+#include "utils/fixed_point.hpp"
+
+namespace service::algo {
+
+class AlgoConfig : public Config::ConfigTree {
+ public:
+  AlgoConfig() : ConfigTree("algo") {}
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+    m_enable = this->get<bool>("enable", false);
+    m_interval_ms = this->get<int64_t>("interval_ms", 1000);
+    m_max_rejects = this->get<uint32_t>("max_rejects", 3);
+  }
+
+  bool enable() const { return m_enable; }
+
+  /// 算法单未指定间隔时的默认值
+  int64_t interval_ms() const { return m_interval_ms; }
+
+  /// 子单连续被拒绝的次数达到该值时停止算法单
+  uint32_t max_rejects() const { return m_max_rejects; }
+
+ private:
+  bool m_enable = false;
+  int64_t m_interval_ms = 1000;
+  uint32_t m_max_rejects = 3;
+};
+
+#define algo_config ::Common::SingletonPtr<::service::algo::AlgoConfig>::get_instance()
+
+/**
+ * @brief 执行中的算法单
+ */
+struct AlgoState {
+  engine::AlgoOrderData order;  ///< 请求，algo_id、exchange 和 interval_ms 已补全
+  std::unique_ptr<Algo> algo;
+
+  Common::Fixed volume;    ///< 总数量
+  Common::Fixed filled;    ///< 已成交数量
+  Common::Fixed turnover;  ///< 已成交金额
+  size_t child_orders = 0;
+  uint32_t rejects = 0;  ///< 子单连续被拒绝次数
+
+  std::string child_id;        ///< 工作中子单的客户端订单ID，空表示没有
+  std::string child_order_id;  ///< 工作中子单的交易所订单ID
+  Common::Fixed child_price;   ///< 工作中子单的价格
+  Common::Fixed child_volume;  ///< 工作中子单的委托数量
+  Common::Fixed child_filled;  ///< 工作中子单的已成交数量
+  Common::Fixed child_avg;     ///< 工作中子单的成交均价
+  engine::OrderStatus child_status = engine::OrderStatus::SUBMITTING;
+  bool cancelling = false;  ///< 已对工作中子单发出撤单
+
+  bool stopping = false;  ///< 收到停止请求，子单撤完后结束
+  engine::TimerWheel::TimerId timer = engine::TimerWheel::kInvalidTimer;
+};
+
+/**
+ * @brief 算法执行组件
+ *
+ * 每个算法单同一时间最多一笔工作中的子单。只在引擎执行器上访问，非线程安全。
+ */
+class AlgoEngine : public std::enable_shared_from_this<AlgoEngine>, public engine::Component {
+ public:
+  AlgoEngine(engine::EnginePtr engine);
+  ~AlgoEngine();
+
+  /**
+   * @brief 注册算法单请求、订单簿、成交和订单回报回调
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> init() override;
+
+  /**
+   * @brief 记录执行器，用于定时器回调
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> run() override;
+
+  /// 按算法单ID查询执行中的算法单，不存在返回nullptr
+  const AlgoState* find(const std::string& algo_id) const;
+
+ private:
+  /// 处理策略的算法单请求
+  asio::awaitable<void> start(engine::AlgoOrderDataPtr order);
+
+  /// 处理停止请求
+  asio::awaitable<void> stop(engine::AlgoOrderDataPtr order);
+
+  asio::awaitable<void> recv_book(engine::BookPtr book);
+  asio::awaitable<void> recv_trade(engine::TradeDataPtr trade);
+  asio::awaitable<void> recv_order(engine::OrderDataPtr order);
+
+  /// 定时器到期，设置下一次定时器并推进算法单
+  void on_timer(const std::string& algo_id);
+
+  /**
+   * @brief 推进算法单：子单偏离盘口或数量落后于释放进度时撤单，没有子单时按释放进度挂出新子单
+   * @param algo_id 算法单ID
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> work(std::string algo_id);
+
+  /**
+   * @brief 应用一条子单回报，子单结束时清除工作中子单
+   * @return bool 成交量是否增加
+   */
+  bool apply(AlgoState& state, const engine::OrderDataItem& item);
+
+  /// 己方最优价，限价以内；没有盘口时返回0
+  Common::Fixed peg_price(const AlgoState& state) const;
+
+  /// 按释放进度应当挂单的数量：已释放未成交的部分，不超过显示数量
+  Common::Fixed working_volume(const AlgoState& state) const;
+
+  /// 发出算法单状态
+  asio::awaitable<void> publish(const AlgoState& state, engine::OrderStatus status);
+
+  /// 算法单结束，发出最终状态并移除
+  asio::awaitable<void> finish(const std::string& algo_id, engine::OrderStatus status);
+
+  /// 订单簿索引的key
+  static std::string book_key(const std::string& exchange, const std::string& symbol) {
+    return exchange + "|" + symbol;
+  }
+
+  engine::EnginePtr engine_;
+  asio::any_io_executor executor_;
+
+  std::unordered_map<std::string, std::unique_ptr<AlgoState>> algos_;  ///< key: 算法单ID
+  std::unordered_map<std::string, std::string> children_;             ///< 子单客户端订单ID -> 算法单ID
+  std::unordered_map<std::string, engine::BookPtr> books_;             ///< 最新订单簿，key: 交易所|交易对
+};
+
+}  // namespace service::algo
+
+#endif  // __SERVICE_ALGO_ALGO_ENGINE_H__
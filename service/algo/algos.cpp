@@ -0,0 +1,59 @@
+#include "algos.h"
+
+#include <algorithm>
+
+namespace service::algo {
+
+using Common::Fixed;
+
+Algo::Algo(const engine::AlgoOrderData& order, int64_t start_ms)
+    : volume_(Fixed::from_dec(order.volume)), start_ms_(start_ms), duration_ms_(order.duration_ms) {}
+
+std::unique_ptr<Algo> Algo::create(const engine::AlgoOrderData& order, int64_t start_ms) {
+  switch (order.algo) {
+    case engine::AlgoType::TWAP:
+      if (order.duration_ms <= 0 || order.interval_ms <= 0) {
+        return nullptr;
+      }
+      return std::make_unique<TwapAlgo>(order, start_ms, order.interval_ms);
+    case engine::AlgoType::VWAP:
+      if (Fixed::from_dec(order.participation).raw() <= 0) {
+        return nullptr;
+      }
+      return std::make_unique<VwapAlgo>(order, start_ms);
+    case engine::AlgoType::ICEBERG:
+      if (Fixed::from_dec(order.display_volume).raw() <= 0) {
+        return nullptr;
+      }
+      return std::make_unique<IcebergAlgo>(order, start_ms);
+  }
+  return nullptr;
+}
+
+TwapAlgo::TwapAlgo(const engine::AlgoOrderData& order, int64_t start_ms, int64_t interval_ms)
+    : Algo(order, start_ms),
+      slices_(std::max<int64_t>(1, order.duration_ms / interval_ms)),
+      interval_ms_(interval_ms) {}
+
+Fixed TwapAlgo::released(int64_t now_ms) const {
+  if (expired(now_ms)) {
+    return volume_;
+  }
+  // 开始时即释放第一片
+  auto slice = std::min(slices_, (now_ms - start_ms_) / interval_ms_ + 1);
+  return volume_ * Fixed::from_int(slice) / Fixed::from_int(slices_);
+}
+
+VwapAlgo::VwapAlgo(const engine::AlgoOrderData& order, int64_t start_ms)
+    : Algo(order, start_ms), participation_(Fixed::from_dec(order.participation)) {}
+
+Fixed VwapAlgo::released(int64_t now_ms) const {
+  if (expired(now_ms)) {
+    return volume_;
+  }
+  return std::min(volume_, market_volume_ * participation_);
+}
+
+void VwapAlgo::on_trade(const engine::TradeData& trade) { market_volume_ += Fixed::from_dec(trade.volume); }
+
+}  // namespace service::algo
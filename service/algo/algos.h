@@ -0,0 +1,95 @@
+#ifndef __SERVICE_ALGO_ALGOS_H__
+#define __SERVICE_ALGO_ALGOS_H__
+
+/**
+ * @file algos.h
+ * @brief 执行算法的释放进度
+ *
+ * 每种算法只决定截至某一时刻累计可以释放多少数量，挂单、跟随盘口和撤单重挂由算法执行组件统一处理，
+ * 新增算法只需实现 released。
+ */
+
+#include <memory>
+
+#include "object.h"
+#include "utils/fixed_point.hpp"
+
+namespace service::algo {
+
+class Algo {
+ public:
+  /**
+   * @param order 算法单请求
+   * @param start_ms 开始时间（单调时钟毫秒）
+   */
+  Algo(const engine::AlgoOrderData& order, int64_t start_ms);
+  virtual ~Algo() = default;
+
+  /**
+   * @brief 截至 now_ms 累计可以释放的数量，不超过总数量
+   * @param now_ms 当前时间（单调时钟毫秒）
+   */
+  virtual Common::Fixed released(int64_t now_ms) const = 0;
+
+  /// 市场逐笔成交，默认忽略
+  virtual void on_trade(const engine::TradeData& trade) {}
+
+  /**
+   * @brief 按类型创建算法，参数不合法时返回nullptr
+   * @param order 算法单请求
+   * @param start_ms 开始时间（单调时钟毫秒）
+   */
+  static std::unique_ptr<Algo> create(const engine::AlgoOrderData& order, int64_t start_ms);
+
+ protected:
+  /// 是否已过执行时长
+  bool expired(int64_t now_ms) const { return duration_ms_ > 0 && now_ms >= start_ms_ + duration_ms_; }
+
+  Common::Fixed volume_;  ///< 总数量
+  int64_t start_ms_;      ///< 开始时间
+  int64_t duration_ms_;   ///< 执行时长，0 表示不限
+};
+
+/**
+ * @brief TWAP：把执行时长按间隔分成若干片，每到一片释放等量的数量
+ */
+class TwapAlgo : public Algo {
+ public:
+  TwapAlgo(const engine::AlgoOrderData& order, int64_t start_ms, int64_t interval_ms);
+
+  Common::Fixed released(int64_t now_ms) const override;
+
+ private:
+  int64_t slices_;  ///< 分片数
+  int64_t interval_ms_;
+};
+
+/**
+ * @brief VWAP：按开始以来市场实际成交量的固定比例释放，成交集中的时段执行得多，
+ * 执行均价贴近同期市场成交均价；设置了执行时长时到期释放全部剩余数量
+ */
+class VwapAlgo : public Algo {
+ public:
+  VwapAlgo(const engine::AlgoOrderData& order, int64_t start_ms);
+
+  Common::Fixed released(int64_t now_ms) const override;
+  void on_trade(const engine::TradeData& trade) override;
+
+ private:
+  Common::Fixed participation_;  ///< 跟随比例
+  Common::Fixed market_volume_;  ///< 开始以来的市场成交量
+};
+
+/**
+ * @brief 冰山单：一开始释放全部数量，由子单的显示数量限制每次挂出的部分
+ */
+class IcebergAlgo : public Algo {
+ public:
+  using Algo::Algo;
+
+  Common::Fixed released(int64_t now_ms) const override { return volume_; }
+};
+
+}  // namespace service::algo
+
+#endif  // __SERVICE_ALGO_ALGOS_H__
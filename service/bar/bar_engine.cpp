@@ -0,0 +1,293 @@
+#include "bar_engine.h"
+
+#include <chrono>
+#include <filesystem>
+
+#include "store/recorder.h"
+#include "store/tick_store.h"
+
+namespace service::bar {
+
+using Common::Fixed;
+
+namespace {
+
+int64_t now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+BarEngine::BarEngine(engine::EnginePtr engine) : engine_(engine), ready_(bar_config->backfill_s() <= 0) {
+  for (auto interval : bar_config->intervals()) {
+    if (intervals_.size() >= kMaxIntervals) {
+      LOG(ERROR) << fmt::format("too many bar intervals, ignore {}s", interval);
+      continue;
+    }
+    intervals_.push_back(interval * 1000);
+  }
+}
+
+BarEngine::~BarEngine() {}
+
+asio::awaitable<void> BarEngine::init() {
+  engine_->register_callback<engine::TickData>(engine::EventType::kTick,
+    std::bind(&BarEngine::recv_tick, shared_from_this(), std::placeholders::_1));
+
+  engine_->register_callback<engine::TradeData>(engine::EventType::kTrade,
+    std::bind(&BarEngine::recv_trade, shared_from_this(), std::placeholders::_1));
+  co_return;
+}
+
+asio::awaitable<void> BarEngine::run() {
+  executor_ = co_await asio::this_coro::executor;
+  if (ready_) {
+    co_return;
+  }
+
+  co_await backfill_all();
+
+  // 处理回补期间到达的实时数据，处理过程中新到达的继续追加到 pending_
+  while (!pending_.empty()) {
+    std::vector<Pending> pending;
+    pending.swap(pending_);
+    std::vector<engine::BarDataPtr> closed;
+    for (auto& data : pending) {
+      std::visit([&](auto& ptr) { apply(*ptr, closed); }, data);
+    }
+    co_await emit(closed);
+  }
+  ready_ = true;
+}
+
+asio::awaitable<void> BarEngine::recv_tick(engine::TickDataPtr tick) {
+  if (!ready_) {
+    pending_.push_back(tick);
+    co_return;
+  }
+  std::vector<engine::BarDataPtr> closed;
+  apply(*tick, closed);
+  co_await emit(closed);
+}
+
+asio::awaitable<void> BarEngine::recv_trade(engine::TradeDataPtr trade) {
+  if (!ready_) {
+    pending_.push_back(trade);
+    co_return;
+  }
+  std::vector<engine::BarDataPtr> closed;
+  apply(*trade, closed);
+  co_await emit(closed);
+}
+
+void BarEngine::apply(const engine::TickData& tick, std::vector<engine::BarDataPtr>& closed) {
+  auto& sb = get_bars(tick.exchange, tick.symbol);
+  auto volume = tick_volume(sb, Fixed::from_dec(tick.last_volume), Fixed::from_dec(tick.volume_24h));
+
+  // 有逐笔成交时以成交为准，避免重复计量
+  if (sb.has_trade) {
+    return;
+  }
+  update(sb, tick.timestamp_ms, Fixed::from_dec(tick.last_price), volume, closed);
+}
+
+void BarEngine::apply(const engine::TradeData& trade, std::vector<engine::BarDataPtr>& closed) {
+  auto& sb = get_bars(trade.exchange, trade.symbol);
+  sb.has_trade = true;
+  update(sb, trade.timestamp_ms, Fixed::from_dec(trade.price), Fixed::from_dec(trade.volume), closed);
+}
+
+Fixed BarEngine::tick_volume(SymbolBars& sb, Fixed last_volume, Fixed volume_24h) {
+  // 成交与滚出窗口的旧成交同时发生、24小时成交量没有增加时会少计一笔，有逐笔成交时以成交为准
+  if (!volume_24h.is_zero()) {
+    if (sb.volume_24h.is_zero() || volume_24h <= sb.volume_24h) {
+      last_volume = Fixed();
+    }
+    sb.volume_24h = volume_24h;
+  }
+  return last_volume;
+}
+
+SymbolBars& BarEngine::get_bars(const std::string& exchange, const std::string& symbol) {
+  auto key = fmt::format("{}/{}", exchange, symbol);
+  auto it = symbols_.find(key);
+  if (it == symbols_.end()) {
+    it = symbols_.emplace(key, SymbolBars()).first;
+    it->second.exchange = exchange;
+    it->second.symbol = symbol;
+  }
+  return it->second;
+}
+
+void BarEngine::update(SymbolBars& sb, int64_t ts, Fixed price, Fixed volume,
+                       std::vector<engine::BarDataPtr>& closed, bool history) {
+  for (size_t i = 0; i < intervals_.size(); ++i) {
+    auto& st = sb.bars[i];
+    int64_t start = ts - ts % intervals_[i];
+
+    if (st.active && start == st.start_ms) {
+      // 当前K线内，更新高低收量
+      st.high = std::max(st.high, price);
+      st.low = std::min(st.low, price);
+      st.close = price;
+      st.volume += volume;
+      continue;
+    }
+
+    if (st.active && start > st.start_ms) {
+      // 越过结束时间，先收盘
+      closed.push_back(make_bar(sb, i, history));
+      st.active = false;
+      st.last_start_ms = st.start_ms;
+    }
+
+    // 已收盘K线的迟到数据直接丢弃
+    if (start <= st.last_start_ms || (st.active && start < st.start_ms)) {
+      continue;
+    }
+
+    st.start_ms = start;
+    st.active = true;
+    st.open = st.high = st.low = st.close = price;
+    st.volume = volume;
+    if (!history) {
+      schedule_close(sb, i);
+    }
+  }
+}
+
+engine::BarDataPtr BarEngine::make_bar(const SymbolBars& sb, size_t index, bool history) const {
+  auto& st = sb.bars[index];
+  auto bar = std::make_shared<engine::BarData>();
+  bar->symbol = sb.symbol;
+  bar->exchange = sb.exchange;
+  bar->timestamp_ms = st.start_ms;
+  bar->interval = intervals_[index] / 1000;
+  bar->open_price = st.open.to_dec();
+  bar->high_price = st.high.to_dec();
+  bar->low_price = st.low.to_dec();
+  bar->close_price = st.close.to_dec();
+  bar->volume = st.volume.to_dec();
+  bar->history = history;
+  return bar;
+}
+
+void BarEngine::schedule_close(SymbolBars& sb, size_t index) {
+  auto& st = sb.bars[index];
+  int64_t delay_ms = st.start_ms + intervals_[index] + bar_config->close_delay_ms() - now_ms();
+
+  // 上一根K线的定时器未触发时直接改期，已触发或已取消时重新添加
+  if (st.close_timer != engine::TimerWheel::kInvalidTimer && engine_->reschedule_timer(st.close_timer, delay_ms)) {
+    return;
+  }
+  // 交易对状态保存在 unordered_map 中，节点地址不会变化
+  st.close_timer = engine_->schedule_timer(
+      delay_ms, std::bind(&BarEngine::on_close_timer, shared_from_this(), &sb, index));
+}
+
+void BarEngine::on_close_timer(SymbolBars* sb, size_t index) {
+  auto& st = sb->bars[index];
+  st.close_timer = engine::TimerWheel::kInvalidTimer;
+  // 定时器随开新K线改期，触发时对应的总是当前K线；已被新数据收盘则跳过
+  if (!st.active) {
+    return;
+  }
+  closing_.push_back(make_bar(*sb, index));
+  st.active = false;
+  st.last_start_ms = st.start_ms;
+
+  // 定时器回调是同步的，由单独的协程按顺序发出
+  if (!flushing_ && executor_) {
+    flushing_ = true;
+    asio::co_spawn(executor_, std::bind(&BarEngine::flush_closing, shared_from_this()), asio::detached);
+  }
+}
+
+asio::awaitable<void> BarEngine::flush_closing() {
+  while (!closing_.empty()) {
+    std::vector<engine::BarDataPtr> bars;
+    bars.swap(closing_);
+    co_await emit(bars);
+  }
+  flushing_ = false;
+}
+
+asio::awaitable<void> BarEngine::emit(const std::vector<engine::BarDataPtr>& bars) {
+  for (auto& bar : bars) {
+    co_await engine_->on_event(engine::EventType::kBar, bar);
+  }
+}
+
+asio::awaitable<void> BarEngine::backfill_all() {
+  // 存储目录结构为 {root}/{exchange}/{symbol}/
+  std::filesystem::path root(store_config->path());
+  std::vector<std::pair<std::string, std::string>> series;
+  std::error_code ec;
+  for (auto& exchange : std::filesystem::directory_iterator(root, ec)) {
+    if (!exchange.is_directory()) {
+      continue;
+    }
+    for (auto& symbol : std::filesystem::directory_iterator(exchange.path(), ec)) {
+      if (symbol.is_directory()) {
+        series.emplace_back(exchange.path().filename().string(), symbol.path().filename().string());
+      }
+    }
+  }
+
+  auto to_ms = now_ms();
+  for (auto& [exchange, symbol] : series) {
+    co_await backfill(exchange, symbol, to_ms - bar_config->backfill_s() * 1000, to_ms - 1);
+  }
+}
+
+asio::awaitable<void> BarEngine::backfill(const std::string& exchange, const std::string& symbol, int64_t from_ms,
+                                          int64_t to_ms) {
+  auto root = store_config->path();
+  std::vector<engine::BarDataPtr> bars;
+
+  try {
+    // 优先使用Tick数据合成所有周期，使用独立的状态，不影响实时合成
+    SymbolBars sb;
+    sb.exchange = exchange;
+    sb.symbol = symbol;
+
+    store::TickReader reader(root, exchange, symbol, from_ms, to_ms);
+    store::TickBatch batch;
+    size_t ticks = 0;
+    while (reader.next(batch)) {
+      // 与实时合成相同，只计入包含新成交的Tick；旧文件没有24小时成交量列
+      auto& cols = batch.raw().columns;
+      bool has_volume_24h = cols.size() > 8;
+      for (size_t i = 0; i < batch.size(); ++i) {
+        auto volume = tick_volume(sb, Fixed::from_raw(cols[2][i]),
+                                  has_volume_24h ? Fixed::from_raw(cols[8][i]) : Fixed());
+        update(sb, cols[0][i], Fixed::from_raw(cols[1][i]), volume, bars, true);
+      }
+      ticks += batch.size();
+    }
+
+    // 没有Tick数据时读取已落盘的K线
+    if (ticks == 0) {
+      for (auto interval : intervals_) {
+        store::BarReader bar_reader(root, exchange, symbol, from_ms, to_ms, interval / 1000);
+        store::BarBatch bar_batch;
+        while (bar_reader.next(bar_batch)) {
+          for (auto& item : bar_batch) {
+            auto bar = std::make_shared<engine::BarData>(item);
+            bar->history = true;
+            bars.push_back(bar);
+          }
+        }
+      }
+    }
+  } catch (std::runtime_error& e) {
+    LOG(ERROR) << fmt::format("bar backfill {} {} error: {}", exchange, symbol, e.what());
+  }
+
+  std::stable_sort(bars.begin(), bars.end(), [](auto& a, auto& b) { return a->timestamp_ms < b->timestamp_ms; });
+  LOG(INFO) << fmt::format("bar backfill {} {}: {} bars", exchange, symbol, bars.size());
+  co_await emit(bars);
+}
+
+}  // namespace service::bar
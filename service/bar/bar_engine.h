@@ -0,0 +1,202 @@
+#ifndef __SERVICE_BAR_BAR_ENGINE_H__
+#define __SERVICE_BAR_BAR_ENGINE_H__
+
+/**
+ * @file bar_engine.h
+ * @brief 实时多周期K线合成组件
+ *
+ * 从 kTick/kTrade 事件合成各周期K线，收盘时发出 kBar 事件，
+ * 策略不再需要各自聚合Tick。
+ *
+ * 开启回补时，run() 先从历史存储回补所有已落盘交易对的K线，回补期间到达的实时数据暂存，
+ * 回补的K线全部发出后再按到达顺序处理，实时K线不会早于历史K线发出。
+ */
+
+#include <array>
+#include <boost/algorithm/string.hpp>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "config/config.h"
+#include "engine.h"
+#include "utils/fixed_point.hpp"
+
+namespace service::bar {
+
+class BarConfig : public Config::ConfigTree {
+ public:
+  BarConfig() : ConfigTree("bar") {}
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+    m_enable = this->get<bool>("enable", false);
+    m_close_delay_ms = this->get<int64_t>("close_delay_ms", 100);
+    m_backfill_s = this->get<int64_t>("backfill_s", 0);
+
+    // 周期列表，单位秒，如 "1,60,300,3600"
+    m_intervals.clear();
+    std::vector<std::string> items;
+    auto intervals = this->get<std::string>("intervals", "1,60,300,3600");
+    boost::split(items, intervals, boost::is_any_of(","));
+    for (auto& item : items) {
+      boost::trim(item);
+      if (!item.empty()) {
+        m_intervals.push_back(std::stoll(item));
+      }
+    }
+  }
+
+  bool enable() const { return m_enable; }
+  const std::vector<int64_t>& intervals() const { return m_intervals; }
+  int64_t close_delay_ms() const { return m_close_delay_ms; }
+  int64_t backfill_s() const { return m_backfill_s; }
+
+ private:
+  bool m_enable = false;
+  std::vector<int64_t> m_intervals;
+  int64_t m_close_delay_ms = 100;
+  int64_t m_backfill_s = 0;
+};
+
+#define bar_config ::Common::SingletonPtr<::service::bar::BarConfig>::get_instance()
+
+/// 支持的最大周期数
+constexpr size_t kMaxIntervals = 8;
+
+/**
+ * @brief 单个周期正在合成中的K线，使用定点数保存
+ */
+struct BarState {
+  int64_t start_ms = 0;  ///< 开始时间
+  bool active = false;   ///< 是否有数据
+
+  int64_t last_start_ms = std::numeric_limits<int64_t>::min();  ///< 最近一根已收盘K线的开始时间
+
+  Common::Fixed open;
+  Common::Fixed high;
+  Common::Fixed low;
+  Common::Fixed close;
+  Common::Fixed volume;
+
+  engine::TimerWheel::TimerId close_timer = engine::TimerWheel::kInvalidTimer;  ///< 墙钟收盘定时器
+};
+
+/**
+ * @brief 单个交易对所有周期的合成状态
+ */
+struct SymbolBars {
+  std::string symbol;
+  std::string exchange;
+  bool has_trade = false;  ///< 收到过逐笔成交后，以成交为准，忽略Tick
+  Common::Fixed volume_24h;  ///< 上一个Tick的24小时成交量，用于判断Tick是否包含新成交
+  std::array<BarState, kMaxIntervals> bars;
+};
+
+/**
+ * @brief K线合成引擎
+ *
+ * 每个Tick/成交只更新各周期的当前K线，O(1)完成。
+ * 收盘由两种方式触发：
+ * - 事件时间：新数据的时间越过当前K线结束时间
+ * - 墙钟时间：引擎定时器在K线结束时间 + close_delay_ms 后收盘，
+ *   保证不活跃的交易对也能按时收到K线。每个周期复用同一个定时器，开新K线时只修改到期时间
+ */
+class BarEngine : public std::enable_shared_from_this<BarEngine>, public engine::Component {
+ public:
+  BarEngine(engine::EnginePtr engine);
+  ~BarEngine();
+
+  /**
+   * @brief 注册Tick和成交事件回调
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> init() override;
+
+  /**
+   * @brief 记录执行器，回补历史K线后开始处理实时数据
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> run() override;
+
+  /// 处理Tick数据
+  asio::awaitable<void> recv_tick(engine::TickDataPtr tick);
+
+  /// 处理逐笔成交数据
+  asio::awaitable<void> recv_trade(engine::TradeDataPtr trade);
+
+  /**
+   * @brief 从历史存储回补K线，以 history=true 的 kBar 事件发出
+   * @param exchange 交易所
+   * @param symbol 交易对
+   * @param from_ms 开始时间
+   * @param to_ms 结束时间
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> backfill(const std::string& exchange, const std::string& symbol, int64_t from_ms,
+                                 int64_t to_ms);
+
+ private:
+  /// 回补期间暂存的实时数据
+  typedef std::variant<engine::TickDataPtr, engine::TradeDataPtr> Pending;
+
+  /// 获取交易对状态，首次出现时创建
+  SymbolBars& get_bars(const std::string& exchange, const std::string& symbol);
+
+  /// 用一条Tick更新K线，收盘的K线追加到 closed
+  void apply(const engine::TickData& tick, std::vector<engine::BarDataPtr>& closed);
+
+  /// 用一笔成交更新K线，收盘的K线追加到 closed
+  void apply(const engine::TradeData& trade, std::vector<engine::BarDataPtr>& closed);
+
+  /**
+   * @brief Tick计入K线的成交量，实时合成与回补共用
+   *
+   * 交易所在只有盘口变化时也会推送Tick，最新成交量保持不变，只有24小时成交量增加时才计入；
+   * 没有24小时成交量时按最新成交量计入
+   */
+  static Common::Fixed tick_volume(SymbolBars& sb, Common::Fixed last_volume, Common::Fixed volume_24h);
+
+  /// 回补存储中所有交易对最近 backfill_s 秒的K线
+  asio::awaitable<void> backfill_all();
+
+  /**
+   * @brief 更新所有周期，收盘的K线追加到 closed
+   * @param history 是否为回补数据，回补数据不进入时间轮
+   */
+  void update(SymbolBars& sb, int64_t ts, Common::Fixed price, Common::Fixed volume,
+              std::vector<engine::BarDataPtr>& closed, bool history = false);
+
+  /// 将当前K线转换为事件数据
+  engine::BarDataPtr make_bar(const SymbolBars& sb, size_t index, bool history = false) const;
+
+  /// 设置当前K线的墙钟收盘定时器
+  void schedule_close(SymbolBars& sb, size_t index);
+
+  /// 定时器到期收盘
+  void on_close_timer(SymbolBars* sb, size_t index);
+
+  /// 发出定时器收盘的K线
+  asio::awaitable<void> flush_closing();
+
+  /// 按顺序发出K线事件
+  asio::awaitable<void> emit(const std::vector<engine::BarDataPtr>& bars);
+
+  engine::EnginePtr engine_;
+  std::vector<int64_t> intervals_;  ///< 周期（毫秒）
+
+  std::unordered_map<std::string, SymbolBars> symbols_;  ///< key: exchange/symbol
+
+  asio::any_io_executor executor_;            ///< 引擎执行器
+  std::vector<engine::BarDataPtr> closing_;   ///< 定时器收盘、等待发出的K线
+  bool flushing_ = false;                     ///< 是否已有发出协程在运行
+
+  bool ready_ = true;              ///< 回补完成，实时数据直接处理
+  std::vector<Pending> pending_;  ///< 回补完成前到达的实时数据
+};
+
+}  // namespace service::bar
+
+#endif  // __SERVICE_BAR_BAR_ENGINE_H__
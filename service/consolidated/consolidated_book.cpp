@@ -0,0 +1,165 @@
+#include "consolidated_book.h"
+
+#include <algorithm>
+
+namespace service::consolidated {
+
+using Common::Fixed;
+
+namespace {
+
+/// 合并一侧的盘口，用于判断是否需要发出 kConsolidatedQuote
+struct Top {
+  Fixed price;
+  Fixed total;
+  uint32_t venue = 0;
+  bool valid = false;
+
+  bool operator==(const Top&) const = default;
+};
+
+Top top_of(const ConsolidatedLevel* level) {
+  if (level == nullptr) {
+    return Top();
+  }
+  return Top{level->price, level->total, level->top_venue(), true};
+}
+
+}  // namespace
+
+uint32_t ConsolidatedLevel::top_venue() const {
+  auto it = std::max_element(venues.begin(), venues.end(),
+                             [](const VenueSize& a, const VenueSize& b) { return a.size < b.size; });
+  return it == venues.end() ? 0 : it->venue;
+}
+
+ConsolidatedBook::ConsolidatedBook(engine::EnginePtr engine) : engine_(engine) {}
+
+ConsolidatedBook::~ConsolidatedBook() {}
+
+asio::awaitable<void> ConsolidatedBook::init() {
+  engine_->register_callback<engine::Book>(engine::EventType::kBook,
+    std::bind(&ConsolidatedBook::recv_book, shared_from_this(), std::placeholders::_1));
+  co_return;
+}
+
+asio::awaitable<void> ConsolidatedBook::run() { co_return; }
+
+const ConsolidatedLadder* ConsolidatedBook::ladder(const std::string& symbol) const {
+  auto it = ladders_.find(symbol);
+  return it == ladders_.end() ? nullptr : &it->second;
+}
+
+uint32_t ConsolidatedBook::venue_id(const std::string& exchange) {
+  auto it = std::find(venues_.begin(), venues_.end(), exchange);
+  if (it != venues_.end()) {
+    return static_cast<uint32_t>(it - venues_.begin());
+  }
+  venues_.push_back(exchange);
+  return static_cast<uint32_t>(venues_.size() - 1);
+}
+
+template <typename Side>
+void ConsolidatedBook::set_level(Side& side, uint32_t venue, Fixed price, Fixed size) {
+  auto it = side.find(price);
+  if (it == side.end()) {
+    if (size.is_zero()) {
+      return;
+    }
+    it = side.emplace(price, ConsolidatedLevel{price, Fixed(), {}}).first;
+  }
+
+  auto& level = it->second;
+  auto entry = std::find_if(level.venues.begin(), level.venues.end(),
+                            [venue](const VenueSize& v) { return v.venue == venue; });
+  if (entry == level.venues.end()) {
+    if (!size.is_zero()) {
+      level.venues.push_back({venue, size});
+      level.total += size;
+    }
+  } else if (size.is_zero()) {
+    level.total -= entry->size;
+    level.venues.erase(entry);
+  } else {
+    level.total += size - entry->size;
+    entry->size = size;
+  }
+
+  if (level.venues.empty()) {
+    side.erase(it);
+  }
+}
+
+template <typename Side>
+void ConsolidatedBook::apply_side(Side& side, uint32_t venue, std::vector<ConsolidatedLadder::VenueLevel>& previous,
+                                  const std::vector<engine::BookItem>& items) {
+  std::vector<ConsolidatedLadder::VenueLevel> current;
+  current.reserve(items.size());
+  for (auto& item : items) {
+    auto size = Fixed::from_dec(item.volume);
+    if (!size.is_zero()) {
+      current.push_back({Fixed::from_dec(item.price), size});
+    }
+  }
+
+  // 两侧都按优先级排序，同时遍历新旧档位，只处理新增、删除和数量变化的档位
+  auto before = side.key_comp();
+  size_t i = 0, j = 0;
+  while (i < previous.size() || j < current.size()) {
+    if (j == current.size() || (i < previous.size() && before(previous[i].price, current[j].price))) {
+      set_level(side, venue, previous[i].price, Fixed());
+      ++i;
+    } else if (i == previous.size() || before(current[j].price, previous[i].price)) {
+      set_level(side, venue, current[j].price, current[j].size);
+      ++j;
+    } else {
+      if (previous[i].size != current[j].size) {
+        set_level(side, venue, current[j].price, current[j].size);
+      }
+      ++i;
+      ++j;
+    }
+  }
+
+  previous.swap(current);
+}
+
+asio::awaitable<void> ConsolidatedBook::recv_book(engine::BookPtr book) {
+  auto venue = venue_id(book->exchange);
+  auto symbol = consolidated_config->canonical(book->exchange, book->symbol);
+  auto& ladder = ladders_[symbol];
+  if (ladder.venues_.size() <= venue) {
+    ladder.venues_.resize(venue + 1);
+  }
+
+  auto bid_before = top_of(ladder.best_bid());
+  auto ask_before = top_of(ladder.best_ask());
+
+  auto& previous = ladder.venues_[venue];
+  apply_side(ladder.bids_, venue, previous.bids, book->bids);
+  apply_side(ladder.asks_, venue, previous.asks, book->asks);
+
+  auto bid = top_of(ladder.best_bid());
+  auto ask = top_of(ladder.best_ask());
+  if (bid == bid_before && ask == ask_before) {
+    co_return;
+  }
+
+  auto quote = std::make_shared<engine::ConsolidatedQuote>();
+  quote->symbol = symbol;
+  quote->timestamp_ms = book->timestamp_ms;
+  quote->recv_ns = book->recv_ns;
+  if (bid.valid) {
+    quote->bid_price = bid.price.to_dec();
+    quote->bid_volume = bid.total.to_dec();
+    quote->bid_exchange = venues_[bid.venue];
+  }
+  if (ask.valid) {
+    quote->ask_price = ask.price.to_dec();
+    quote->ask_volume = ask.total.to_dec();
+    quote->ask_exchange = venues_[ask.venue];
+  }
+  co_await engine_->on_event(engine::EventType::kConsolidatedQuote, quote);
+}
+
+}  // namespace service::consolidated
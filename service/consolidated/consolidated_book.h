@@ -0,0 +1,199 @@
+#ifndef __SERVICE_CONSOLIDATED_CONSOLIDATED_BOOK_H__
+#define __SERVICE_CONSOLIDATED_CONSOLIDATED_BOOK_H__
+
+/**
+ * @file consolidated_book.h
+ * @brief 跨交易所合并订单簿
+ *
+ * 为每个交易所保存上一次收到的订单簿，新的订单簿到达时与之逐档比较，
+ * 只把变化的档位应用到合并后的价格阶梯，每个变化档位 O(log n)，不重建整个订单簿。
+ * 合并阶梯的每一档记录各交易所的数量，最优买卖价 O(1) 读取，供跨所套利和智能路由使用。
+ * 合并买一价或卖一价变化时发出 kConsolidatedQuote。
+ */
+
+#include <boost/algorithm/string.hpp>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "config/config.h"
+#include "engine.h"
+#include "utils/fixed_point.hpp"
+
+namespace service::consolidated {
+
+class ConsolidatedConfig : public Config::ConfigTree {
+ public:
+  ConsolidatedConfig() : ConfigTree("consolidated") {}
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+    m_enable = this->get<bool>("enable", false);
+
+    // 交易对别名，格式 "交易所:交易对=统一名称,..."，如 "binance:BTCUSDT=BTC-USDT-SWAP"，
+    // 未配置的交易对直接使用原名称
+    m_aliases.clear();
+    m_venue_symbols.clear();
+    std::vector<std::string> items;
+    auto aliases = this->get<std::string>("aliases", "");
+    boost::split(items, aliases, boost::is_any_of(","));
+    for (auto& item : items) {
+      std::vector<std::string> fields;
+      boost::split(fields, item, boost::is_any_of("="));
+      if (fields.size() == 2) {
+        auto key = boost::trim_copy(fields[0]);
+        auto canonical = boost::trim_copy(fields[1]);
+        auto pos = key.find(':');
+        if (pos != std::string::npos) {
+          m_aliases[key] = canonical;
+          m_venue_symbols[key.substr(0, pos + 1) + canonical] = key.substr(pos + 1);
+        }
+      }
+    }
+  }
+
+  bool enable() const { return m_enable; }
+
+  /// 交易所的交易对对应的统一名称
+  std::string canonical(const std::string& exchange, const std::string& symbol) const {
+    auto it = m_aliases.find(exchange + ":" + symbol);
+    return it == m_aliases.end() ? symbol : it->second;
+  }
+
+  /// 统一名称在交易所的交易对，canonical 的反向映射
+  std::string venue_symbol(const std::string& exchange, const std::string& canonical) const {
+    auto it = m_venue_symbols.find(exchange + ":" + canonical);
+    return it == m_venue_symbols.end() ? canonical : it->second;
+  }
+
+ private:
+  bool m_enable = false;
+  std::unordered_map<std::string, std::string> m_aliases;        ///< key: 交易所:交易对
+  std::unordered_map<std::string, std::string> m_venue_symbols;  ///< key: 交易所:统一名称
+};
+
+#define consolidated_config ::Common::SingletonPtr<::service::consolidated::ConsolidatedConfig>::get_instance()
+
+/**
+ * @brief 合并档位上一个交易所的数量
+ */
+struct VenueSize {
+  uint32_t venue;      ///< 交易所编号，见 ConsolidatedBook::venue_name
+  Common::Fixed size;  ///< 数量
+};
+
+/**
+ * @brief 合并阶梯的一档
+ */
+struct ConsolidatedLevel {
+  Common::Fixed price;
+  Common::Fixed total;            ///< 各交易所数量之和
+  std::vector<VenueSize> venues;  ///< 各交易所数量，通常只有一两个
+
+  /// 数量最大的交易所
+  uint32_t top_venue() const;
+};
+
+/**
+ * @brief 一个交易对的合并价格阶梯
+ */
+class ConsolidatedLadder {
+ public:
+  typedef std::map<Common::Fixed, ConsolidatedLevel, std::greater<>> BidSide;
+  typedef std::map<Common::Fixed, ConsolidatedLevel, std::less<>> AskSide;
+
+  /// 合并买一，为空时返回nullptr
+  const ConsolidatedLevel* best_bid() const { return bids_.empty() ? nullptr : &bids_.begin()->second; }
+
+  /// 合并卖一，为空时返回nullptr
+  const ConsolidatedLevel* best_ask() const { return asks_.empty() ? nullptr : &asks_.begin()->second; }
+
+  /// 买盘，价格从高到低
+  const BidSide& bids() const { return bids_; }
+
+  /// 卖盘，价格从低到高
+  const AskSide& asks() const { return asks_; }
+
+ private:
+  friend class ConsolidatedBook;
+
+  /// 交易所上一次的订单簿档位
+  struct VenueLevel {
+    Common::Fixed price;
+    Common::Fixed size;
+  };
+
+  /// 一个交易所上一次的订单簿，用于与新的订单簿逐档比较
+  struct VenueBook {
+    std::vector<VenueLevel> bids;  ///< 价格从高到低
+    std::vector<VenueLevel> asks;  ///< 价格从低到高
+  };
+
+  BidSide bids_;
+  AskSide asks_;
+  std::vector<VenueBook> venues_;  ///< 下标为交易所编号
+};
+
+/**
+ * @brief 合并订单簿组件
+ *
+ * 只在引擎执行器上访问，非线程安全。
+ */
+class ConsolidatedBook : public std::enable_shared_from_this<ConsolidatedBook>, public engine::Component {
+ public:
+  ConsolidatedBook(engine::EnginePtr engine);
+  ~ConsolidatedBook();
+
+  /**
+   * @brief 注册订单簿回调
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> init() override;
+
+  /**
+   * @brief 无后台任务
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> run() override;
+
+  /**
+   * @brief 查询合并价格阶梯
+   * @param symbol 统一后的交易对名称
+   * @return 没有记录返回nullptr
+   */
+  const ConsolidatedLadder* ladder(const std::string& symbol) const;
+
+  /// 交易所编号对应的名称
+  const std::string& venue_name(uint32_t venue) const { return venues_[venue]; }
+
+ private:
+  /// 处理一个交易所的订单簿
+  asio::awaitable<void> recv_book(engine::BookPtr book);
+
+  /// 交易所名称对应的编号，首次出现时分配
+  uint32_t venue_id(const std::string& exchange);
+
+  /**
+   * @brief 把一个交易所一侧的新档位与上一次比较，只应用变化的档位
+   * @param side 合并阶梯的一侧
+   * @param previous 该交易所上一次的档位，比较后替换为新档位
+   * @param items 新档位
+   */
+  template <typename Side>
+  static void apply_side(Side& side, uint32_t venue, std::vector<ConsolidatedLadder::VenueLevel>& previous,
+                         const std::vector<engine::BookItem>& items);
+
+  /// 设置一个交易所在某价格上的数量，数量为0表示删除
+  template <typename Side>
+  static void set_level(Side& side, uint32_t venue, Common::Fixed price, Common::Fixed size);
+
+  engine::EnginePtr engine_;
+  std::unordered_map<std::string, ConsolidatedLadder> ladders_;  ///< key: 统一后的交易对
+  std::vector<std::string> venues_;                              ///< 下标为交易所编号
+};
+
+}  // namespace service::consolidated
+
+#endif  // __SERVICE_CONSOLIDATED_CONSOLIDATED_BOOK_H__
@@ -0,0 +1,31 @@
+#include "latency_monitor.h"
+
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+
+#include "utils/latency.h"
+
+namespace service::monitor {
+
+LatencyMonitor::LatencyMonitor(engine::EnginePtr engine) : engine_(engine) {}
+
+LatencyMonitor::~LatencyMonitor() {}
+
+asio::awaitable<void> LatencyMonitor::init() { co_return; }
+
+asio::awaitable<void> LatencyMonitor::run() {
+  auto executor = co_await asio::this_coro::executor;
+  asio::steady_timer timer(executor);
+
+  while (true) {
+    timer.expires_after(std::chrono::seconds(latency_config->dump_interval_s()));
+    co_await timer.async_wait(asio::use_awaitable);
+
+    auto report = latency_stats.dump();
+    if (!report.empty()) {
+      LOG(INFO) << "latency:\n" << report;
+    }
+  }
+}
+
+}  // namespace service::monitor
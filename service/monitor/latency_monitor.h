@@ -0,0 +1,62 @@
+#ifndef __SERVICE_MONITOR_LATENCY_MONITOR_H__
+#define __SERVICE_MONITOR_LATENCY_MONITOR_H__
+
+/**
+ * @file latency_monitor.h
+ * @brief 延迟统计输出组件
+ *
+ * 定期把各阶段的延迟直方图（p50/p99/p99.9/max）写入日志并清零。
+ */
+
+#include "config/config.h"
+#include "engine.h"
+
+namespace service::monitor {
+
+class LatencyConfig : public Config::ConfigTree {
+ public:
+  LatencyConfig() : ConfigTree("latency") {}
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+    m_enable = this->get<bool>("enable", false);
+    m_dump_interval_s = this->get<uint32_t>("dump_interval_s", 60);
+  }
+
+  bool enable() const { return m_enable; }
+  uint32_t dump_interval_s() const { return m_dump_interval_s; }
+
+ private:
+  bool m_enable = false;
+  uint32_t m_dump_interval_s = 60;
+};
+
+#define latency_config ::Common::SingletonPtr<::service::monitor::LatencyConfig>::get_instance()
+
+/**
+ * @brief 延迟统计输出
+ */
+class LatencyMonitor : public std::enable_shared_from_this<LatencyMonitor>, public engine::Component {
+ public:
+  LatencyMonitor(engine::EnginePtr engine);
+  ~LatencyMonitor();
+
+  /**
+   * @brief 无需注册回调
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> init() override;
+
+  /**
+   * @brief 定期输出延迟统计
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> run() override;
+
+ private:
+  engine::EnginePtr engine_;
+};
+
+}  // namespace service::monitor
+
+#endif  // __SERVICE_MONITOR_LATENCY_MONITOR_H__
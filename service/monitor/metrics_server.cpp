@@ -0,0 +1,68 @@
+#include "metrics_server.h"
+
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/write.hpp>
+
+#include "utils/metrics.h"
+
+namespace service::monitor {
+
+namespace {
+
+/// 请求头最大长度，超出直接断开
+constexpr size_t kMaxRequestSize = 8192;
+
+std::string response(const char* status, const char* content_type, const std::string& body) {
+  return fmt::format("HTTP/1.1 {}\r\nContent-Type: {}\r\nContent-Length: {}\r\nConnection: close\r\n\r\n{}", status,
+                     content_type, body.size(), body);
+}
+
+}  // namespace
+
+MetricsServer::MetricsServer(engine::EnginePtr engine) : engine_(engine) {}
+
+MetricsServer::~MetricsServer() {}
+
+asio::awaitable<void> MetricsServer::init() { co_return; }
+
+asio::awaitable<void> MetricsServer::run() {
+  auto executor = co_await asio::this_coro::executor;
+  asio::ip::tcp::endpoint endpoint(asio::ip::make_address(metrics_config->address()), metrics_config->port());
+  asio::ip::tcp::acceptor acceptor(executor, endpoint);
+  LOG(INFO) << fmt::format("metrics listening on {}:{}", metrics_config->address(), metrics_config->port());
+
+  while (true) {
+    boost::system::error_code ec;
+    auto socket = co_await acceptor.async_accept(asio::redirect_error(asio::use_awaitable, ec));
+    if (ec) {
+      LOG(WARNING) << fmt::format("metrics accept error: {}", ec.message());
+      continue;
+    }
+    asio::co_spawn(executor, serve(std::move(socket)), asio::detached);
+  }
+}
+
+asio::awaitable<void> MetricsServer::serve(asio::ip::tcp::socket socket) {
+  boost::system::error_code ec;
+  std::string buffer;
+  co_await asio::async_read_until(socket, asio::dynamic_buffer(buffer, kMaxRequestSize), "\r\n\r\n",
+                                  asio::redirect_error(asio::use_awaitable, ec));
+  if (ec) {
+    co_return;
+  }
+
+  // 只看请求行：GET /metrics HTTP/1.1
+  auto line = buffer.substr(0, buffer.find("\r\n"));
+  std::string reply;
+  if (line.starts_with("GET /metrics ") || line.starts_with("GET /metrics?")) {
+    reply = response("200 OK", "text/plain; version=0.0.4", metrics_registry.expose());
+  } else {
+    reply = response("404 Not Found", "text/plain", "not found\n");
+  }
+
+  co_await asio::async_write(socket, asio::buffer(reply), asio::redirect_error(asio::use_awaitable, ec));
+  socket.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+}
+
+}  // namespace service::monitor
@@ -0,0 +1,76 @@
+#ifndef __SERVICE_MONITOR_METRICS_SERVER_H__
+#define __SERVICE_MONITOR_METRICS_SERVER_H__
+
+/**
+ * @file metrics_server.h
+ * @brief 指标HTTP输出组件
+ *
+ * 在引擎的 io_context 上监听一个端口，响应 GET /metrics，
+ * 以 Prometheus 文本格式返回指标注册表的内容。
+ * 抓取只读取原子计数，不进入事件通道，也不影响回调。
+ */
+
+#include <boost/asio/ip/tcp.hpp>
+
+#include "config/config.h"
+#include "engine.h"
+
+namespace service::monitor {
+
+class MetricsConfig : public Config::ConfigTree {
+ public:
+  MetricsConfig() : ConfigTree("metrics") {}
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+    m_enable = this->get<bool>("enable", false);
+    m_address = this->get<std::string>("address", "127.0.0.1");
+    m_port = this->get<uint16_t>("port", 9464);
+  }
+
+  bool enable() const { return m_enable; }
+  const std::string& address() const { return m_address; }
+  uint16_t port() const { return m_port; }
+
+ private:
+  bool m_enable = false;
+  std::string m_address = "127.0.0.1";
+  uint16_t m_port = 9464;
+};
+
+#define metrics_config ::Common::SingletonPtr<::service::monitor::MetricsConfig>::get_instance()
+
+/**
+ * @brief 指标HTTP输出
+ */
+class MetricsServer : public std::enable_shared_from_this<MetricsServer>, public engine::Component {
+ public:
+  MetricsServer(engine::EnginePtr engine);
+  ~MetricsServer();
+
+  /**
+   * @brief 无需注册回调
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> init() override;
+
+  /**
+   * @brief 监听端口并处理抓取请求
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> run() override;
+
+ private:
+  /**
+   * @brief 处理一个连接，响应一次请求后关闭
+   * @param socket 已建立的连接
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> serve(asio::ip::tcp::socket socket);
+
+  engine::EnginePtr engine_;
+};
+
+}  // namespace service::monitor
+
+#endif  // __SERVICE_MONITOR_METRICS_SERVER_H__
@@ -0,0 +1,366 @@
+#include "order_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <unordered_set>
+
+#include "utils/async_log.h"
+#include "utils/fixed_point.hpp"
+#include "utils/latency.h"
+
+namespace service::order {
+
+namespace {
+
+/// 状态先后顺序，终态之间不区分
+int status_rank(engine::OrderStatus status) {
+  switch (status) {
+    case engine::OrderStatus::SUBMITTING:
+      return 0;
+    case engine::OrderStatus::PENDING:
+      return 1;
+    case engine::OrderStatus::PARTIAL_FILLED:
+      return 2;
+    default:
+      return 3;
+  }
+}
+
+bool is_finished(engine::OrderStatus status) { return status_rank(status) == 3; }
+
+/// 索引使用的key
+std::string order_key(const engine::OrderDataItem& item) {
+  return item.client_order_id.empty() ? item.order_id : item.client_order_id;
+}
+
+size_t side_index(engine::Direction direction) { return direction == engine::Direction::BUY ? 0 : 1; }
+
+}  // namespace
+
+OrderManager::OrderManager(engine::EnginePtr engine, std::shared_ptr<risk::RiskGate> risk)
+    : engine_(engine), risk_(risk) {}
+
+OrderManager::~OrderManager() {}
+
+asio::awaitable<void> OrderManager::init() {
+  engine_->register_callback<engine::OrderData>(engine::EventType::kSendOrder,
+    std::bind(&OrderManager::send_orders, shared_from_this(), std::placeholders::_1));
+
+  engine_->register_callback<engine::OrderData>(engine::EventType::kOrder,
+    std::bind(&OrderManager::recv_order, shared_from_this(), std::placeholders::_1));
+  co_return;
+}
+
+asio::awaitable<void> OrderManager::run() {
+  executor_ = co_await asio::this_coro::executor;
+  co_return;
+}
+
+std::string OrderManager::next_client_order_id() {
+  static const uint64_t session =
+      std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  static std::atomic<uint64_t> sequence{0};
+  return fmt::format("qi{:x}{:08x}", session, sequence.fetch_add(1, std::memory_order_relaxed) + 1);
+}
+
+OrderEntryPtr OrderManager::find(const std::string& client_order_id) const {
+  auto it = orders_.find(client_order_id);
+  return it == orders_.end() ? nullptr : it->second;
+}
+
+OrderEntryPtr OrderManager::find_by_order_id(const std::string& order_id) const {
+  auto it = order_ids_.find(order_id);
+  return it == order_ids_.end() ? nullptr : find(it->second);
+}
+
+const OrderIndex& OrderManager::open_orders(const std::string& symbol, engine::Direction direction) const {
+  static const OrderIndex empty;
+  auto it = sides_.find(symbol);
+  return it == sides_.end() ? empty : it->second[side_index(direction)];
+}
+
+asio::awaitable<void> OrderManager::send_orders(engine::OrderDataPtr order) {
+  latency_stats.record_since(Common::LatencyStage::kTickToOrder, order->recv_ns);
+
+  auto submit = std::make_shared<engine::OrderData>(*order);
+  auto rejected = std::make_shared<engine::OrderData>();
+  submit->items.clear();
+
+  for (auto& item : order->items) {
+    // 复制一份，补充客户端订单ID后再提交，不修改策略持有的数据
+    auto copy = std::make_shared<engine::OrderDataItem>(*item);
+    if (copy->client_order_id.empty()) {
+      copy->client_order_id = next_client_order_id();
+    }
+    copy->order_id.clear();
+    copy->filled_volume = 0;
+    copy->avg_price = 0;
+    copy->status = engine::OrderStatus::SUBMITTING;
+    copy->timestamp_ms = 0;
+
+    // 重复的客户端订单ID直接拒绝，不发往交易所
+    if (orders_.contains(copy->client_order_id)) {
+      QLOG(ERROR, "duplicate client order id: {}", copy->client_order_id);
+      copy->status = engine::OrderStatus::REJECTED;
+      rejected->items.push_back(copy);
+      continue;
+    }
+
+    // 下单前风控
+    if (risk_) {
+      auto& sides = sides_[copy->symbol];
+      auto reason = risk_->check(*copy, orders_.size(), sides[0].size() + sides[1].size());
+      if (reason != risk::RiskReason::kPass) {
+        copy->status = engine::OrderStatus::REJECTED;
+        rejected->items.push_back(copy);
+        co_await risk_->reject(copy, reason);
+        continue;
+      }
+    }
+
+    auto entry = std::make_shared<OrderEntry>();
+    entry->item = *copy;
+    auto key = copy->client_order_id;
+    entry->ack_timer = engine_->schedule_timer(order_config->ack_timeout_ms(),
+                                               std::bind(&OrderManager::on_ack_timeout, shared_from_this(), key));
+    orders_[key] = entry;
+    sides_[copy->symbol][side_index(copy->direction)][key] = entry;
+
+    submit->items.push_back(copy);
+  }
+
+  if (!submit->items.empty()) {
+    co_await engine_->on_event(engine::EventType::kSubmitOrder, submit);
+  }
+  if (!rejected->items.empty()) {
+    rejected->symbol = rejected->items[0]->symbol;
+    rejected->exchange = rejected->items[0]->exchange;
+    co_await engine_->on_event(engine::EventType::kOrder, rejected);
+  }
+}
+
+asio::awaitable<void> OrderManager::recv_order(engine::OrderDataPtr order) {
+  std::vector<engine::TradeDataPtr> fills;
+  for (auto& item : order->items) {
+    apply(*item, fills);
+  }
+  std::vector<OrderEntryPtr> absent;
+  if (order->snapshot) {
+    absent = absent_from(*order);
+  }
+
+  for (auto& fill : fills) {
+    co_await engine_->on_event(engine::EventType::kFill, fill);
+  }
+  for (auto& entry : absent) {
+    co_await query(*entry);
+  }
+}
+
+std::vector<OrderEntryPtr> OrderManager::absent_from(const engine::OrderData& snapshot) {
+  std::unordered_set<std::string> listed;
+  for (auto& item : snapshot.items) {
+    listed.insert(item->client_order_id);
+    listed.insert(item->order_id);
+  }
+
+  std::vector<OrderEntryPtr> absent;
+  std::vector<std::string> untracked;
+  for (auto& [key, entry] : orders_) {
+    auto& item = entry->item;
+    if (item.exchange != snapshot.exchange || entry->ack_timer != engine::TimerWheel::kInvalidTimer) {
+      continue;
+    }
+    if ((!item.client_order_id.empty() && listed.contains(item.client_order_id)) ||
+        (!item.order_id.empty() && listed.contains(item.order_id))) {
+      continue;
+    }
+    if (item.client_order_id.empty()) {
+      untracked.push_back(key);
+    } else {
+      absent.push_back(entry);
+    }
+  }
+
+  for (auto& key : untracked) {
+    QLOG(WARNING, "external order {} no longer pending, stop tracking", key);
+    finish(key);
+  }
+  return absent;
+}
+
+void OrderManager::apply(const engine::OrderDataItem& update, std::vector<engine::TradeDataPtr>& fills) {
+  // 优先按客户端订单ID匹配，其次按交易所订单ID
+  auto key = update.client_order_id;
+  auto it = key.empty() ? orders_.end() : orders_.find(key);
+  if (it == orders_.end() && !update.order_id.empty()) {
+    auto id_it = order_ids_.find(update.order_id);
+    if (id_it != order_ids_.end()) {
+      key = id_it->second;
+      it = orders_.find(key);
+    }
+  }
+
+  if (it == orders_.end()) {
+    // 未登记的订单（其他客户端下单、重启前的挂单）：未完成的纳入管理，已完成的忽略
+    if (is_finished(update.status) || update.status == engine::OrderStatus::SUBMITTING) {
+      return;
+    }
+    key = order_key(update);
+    if (key.empty()) {
+      return;
+    }
+    auto entry = std::make_shared<OrderEntry>();
+    entry->item = update;
+    orders_[key] = entry;
+    sides_[update.symbol][side_index(update.direction)][key] = entry;
+    if (!update.order_id.empty()) {
+      order_ids_[update.order_id] = key;
+    }
+    return;
+  }
+
+  auto& entry = *it->second;
+  if (!can_transit(entry.item, update)) {
+    return;
+  }
+
+  // 收到交易所回报，取消确认超时
+  if (entry.ack_timer != engine::TimerWheel::kInvalidTimer) {
+    engine_->cancel_timer(entry.ack_timer);
+    entry.ack_timer = engine::TimerWheel::kInvalidTimer;
+  }
+
+  if (entry.item.exchange.empty()) {
+    entry.item.exchange = update.exchange;
+  }
+  if (!update.order_id.empty() && entry.item.order_id.empty()) {
+    entry.item.order_id = update.order_id;
+    order_ids_[update.order_id] = key;
+  }
+  entry.item.status = update.status;
+  entry.item.timestamp_ms = update.timestamp_ms;
+  if (update.filled_volume > entry.item.filled_volume) {
+    fills.push_back(make_fill(entry.item, update));
+    entry.item.filled_volume = update.filled_volume;
+    entry.item.avg_price = update.avg_price;
+  }
+
+  if (is_finished(update.status)) {
+    finish(key);
+  }
+}
+
+engine::TradeDataPtr OrderManager::make_fill(const engine::OrderDataItem& before,
+                                             const engine::OrderDataItem& update) {
+  using Common::Fixed;
+  auto old_filled = Fixed::from_dec(before.filled_volume);
+  auto new_filled = Fixed::from_dec(update.filled_volume);
+  auto new_avg = Fixed::from_dec(update.avg_price);
+  auto volume = new_filled - old_filled;
+
+  std::shared_ptr<engine::TradeData> fill;
+  if (update.fill && Fixed::from_dec(update.fill->volume) == volume) {
+    // 交易所的成交明细，带有成交ID、手续费和挂单/吃单标记
+    fill = std::make_shared<engine::TradeData>(*update.fill);
+  } else {
+    // 本次成交价 = 成交额增量 / 成交量增量，均价缺失时退化为最新均价
+    auto price = (new_avg * new_filled - Fixed::from_dec(before.avg_price) * old_filled) / volume;
+    if (price.raw() <= 0) {
+      price = new_avg;
+    }
+
+    fill = std::make_shared<engine::TradeData>();
+    fill->timestamp_ms = update.timestamp_ms;
+    fill->trade_id = fmt::format("{}-{}", update.order_id, new_filled.str());
+    fill->price = price.to_dec();
+    fill->volume = volume.to_dec();
+  }
+  fill->symbol = before.symbol;
+  fill->exchange = update.exchange.empty() ? before.exchange : update.exchange;
+  fill->direction = before.direction;
+
+  auto order = std::make_shared<engine::OrderData>();
+  order->symbol = before.symbol;
+  order->exchange = fill->exchange;
+  order->timestamp_ms = update.timestamp_ms;
+  auto item = std::make_shared<engine::OrderDataItem>(before);
+  item->order_id = update.order_id.empty() ? before.order_id : update.order_id;
+  item->status = update.status;
+  item->filled_volume = update.filled_volume;
+  item->avg_price = update.avg_price;
+  item->fill = nullptr;
+  order->items.push_back(item);
+  fill->order = order;
+  return fill;
+}
+
+bool OrderManager::can_transit(const engine::OrderDataItem& from, const engine::OrderDataItem& to) {
+  if (is_finished(from.status)) {
+    return false;
+  }
+  if (status_rank(to.status) < status_rank(from.status)) {
+    return false;
+  }
+  if (to.filled_volume < from.filled_volume) {
+    return false;
+  }
+  if (from.timestamp_ms > 0 && to.timestamp_ms > 0 && to.timestamp_ms < from.timestamp_ms) {
+    return false;
+  }
+  return true;
+}
+
+void OrderManager::finish(const std::string& key) {
+  auto it = orders_.find(key);
+  if (it == orders_.end()) {
+    return;
+  }
+
+  auto& item = it->second->item;
+  if (it->second->ack_timer != engine::TimerWheel::kInvalidTimer) {
+    engine_->cancel_timer(it->second->ack_timer);
+  }
+  if (!item.order_id.empty()) {
+    order_ids_.erase(item.order_id);
+  }
+  auto side_it = sides_.find(item.symbol);
+  if (side_it != sides_.end()) {
+    side_it->second[side_index(item.direction)].erase(key);
+  }
+  orders_.erase(it);
+}
+
+void OrderManager::on_ack_timeout(const std::string& key) {
+  auto it = orders_.find(key);
+  if (it == orders_.end()) {
+    return;
+  }
+  it->second->ack_timer = engine::TimerWheel::kInvalidTimer;
+  if (it->second->item.status != engine::OrderStatus::SUBMITTING || !executor_) {
+    return;
+  }
+  asio::co_spawn(executor_, std::bind(&OrderManager::reconcile, shared_from_this(), key), asio::detached);
+}
+
+asio::awaitable<void> OrderManager::reconcile(std::string key) {
+  auto msg = fmt::format("order ack timeout: {}", key);
+  QLOG(WARNING, "{}", msg);
+  co_await engine_->on_event(engine::EventType::kMessage, std::make_shared<engine::MessageData>(msg));
+
+  // 已成交、已撤销或被拒绝的订单不在挂单列表中，按客户端订单ID单独查询
+  auto it = orders_.find(key);
+  if (it != orders_.end()) {
+    co_await query(*it->second);
+  }
+}
+
+asio::awaitable<void> OrderManager::query(const OrderEntry& entry) {
+  auto request = std::make_shared<engine::QueryOrderData>();
+  request->exchange = entry.item.exchange;
+  request->symbol = entry.item.symbol;
+  request->client_order_id = entry.item.client_order_id;
+  co_await engine_->on_event(engine::EventType::kQueryOrder, request);
+}
+
+}  // namespace service::order
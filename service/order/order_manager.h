@@ -0,0 +1,168 @@
+#ifndef __SERVICE_ORDER_ORDER_MANAGER_H__
+#define __SERVICE_ORDER_ORDER_MANAGER_H__
+
+/**
+ * @file order_manager.h
+ * @brief 订单管理组件
+ *
+ * 策略发出的 kSendOrder 先经过订单管理：分配客户端订单ID、登记为 SUBMITTING，
+ * 再以 kSubmitOrder 转发给网关。网关回报的 kOrder 按状态机更新内存中的订单状态。
+ */
+
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "config/config.h"
+#include "engine.h"
+#include "risk/risk_gate.h"
+
+namespace service::order {
+
+class OrderConfig : public Config::ConfigTree {
+ public:
+  OrderConfig() : ConfigTree("order") {}
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+    m_ack_timeout_ms = this->get<int64_t>("ack_timeout_ms", 5000);
+  }
+
+  int64_t ack_timeout_ms() const { return m_ack_timeout_ms; }
+
+ private:
+  int64_t m_ack_timeout_ms = 5000;
+};
+
+#define order_config ::Common::SingletonPtr<::service::order::OrderConfig>::get_instance()
+
+/**
+ * @brief 订单管理中的一笔订单
+ */
+struct OrderEntry {
+  engine::OrderDataItem item;  ///< 最新状态
+
+  engine::TimerWheel::TimerId ack_timer = engine::TimerWheel::kInvalidTimer;  ///< 等待交易所确认的定时器
+};
+
+typedef std::shared_ptr<const OrderEntry> OrderEntryPtr;
+
+/// 未完成订单索引，key: 客户端订单ID（外部订单没有时使用交易所订单ID）
+typedef std::unordered_map<std::string, std::shared_ptr<OrderEntry>> OrderIndex;
+
+/**
+ * @brief 订单管理
+ *
+ * - 只保存未完成订单，订单进入 FILLED/CANCELLED/REJECTED 后从索引中移除
+ * - 按客户端订单ID、交易所订单ID、交易对+方向 三种方式O(1)查询
+ * - 状态只能向前推进，乱序到达的旧回报（时间更早或已成交数量更少）被丢弃
+ * - 提交后 ack_timeout_ms 内没有收到交易所回报时，发出告警并按客户端订单ID查询该订单对账，
+ *   交易所没有该订单时以 REJECTED 结束
+ * - 收到全量挂单快照时，本交易所已确认但不在快照中的订单（断线期间成交或撤销）逐笔查询最终状态
+ * - 设置了风控时，每笔订单在转发前同步检查，被拒绝的订单以 REJECTED 回报
+ * - 已成交数量增加时发出 kFill：网关附带的成交明细覆盖全部增量时直接使用，
+ *   否则（如断线后查询补齐）按累计成交量和均价的差值合成一笔
+ *
+ * 只在引擎执行器上访问，非线程安全。
+ */
+class OrderManager : public std::enable_shared_from_this<OrderManager>, public engine::Component {
+ public:
+  /**
+   * @brief 构造函数
+   * @param engine 引擎指针
+   * @param risk 下单前风控，为空时不检查
+   */
+  OrderManager(engine::EnginePtr engine, std::shared_ptr<risk::RiskGate> risk = nullptr);
+  ~OrderManager();
+
+  /**
+   * @brief 注册下单请求和订单回报回调
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> init() override;
+
+  /**
+   * @brief 记录执行器，用于超时处理
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> run() override;
+
+  /**
+   * @brief 生成客户端订单ID，进程内唯一，可在多线程中调用
+   *
+   * 格式为 "qi" + 启动时间 + 序号（十六进制），满足OKX clOrdId 字母数字、不超过32位的要求。
+   * 策略需要在发单前知道订单ID时可以自行调用并填入 client_order_id。
+   *
+   * @return std::string 客户端订单ID
+   */
+  static std::string next_client_order_id();
+
+  /// 按客户端订单ID查询未完成订单，不存在返回nullptr
+  OrderEntryPtr find(const std::string& client_order_id) const;
+
+  /// 按交易所订单ID查询未完成订单，不存在返回nullptr
+  OrderEntryPtr find_by_order_id(const std::string& order_id) const;
+
+  /// 指定交易对和方向的未完成订单
+  const OrderIndex& open_orders(const std::string& symbol, engine::Direction direction) const;
+
+  /// 未完成订单总数
+  size_t open_count() const { return orders_.size(); }
+
+ private:
+  /// 处理策略的下单请求
+  asio::awaitable<void> send_orders(engine::OrderDataPtr order);
+
+  /// 处理网关的订单回报
+  asio::awaitable<void> recv_order(engine::OrderDataPtr order);
+
+  /**
+   * @brief 应用一条订单回报
+   * @param update 订单回报
+   * @param fills 新增成交追加到这里
+   */
+  void apply(const engine::OrderDataItem& update, std::vector<engine::TradeDataPtr>& fills);
+
+  /// 根据回报生成成交：优先使用网关附带的成交明细，否则按累计成交量的变化合成
+  static engine::TradeDataPtr make_fill(const engine::OrderDataItem& before, const engine::OrderDataItem& update);
+
+  /// 状态是否可以从 from 推进到 to
+  static bool can_transit(const engine::OrderDataItem& from, const engine::OrderDataItem& to);
+
+  /// 订单进入终态，从所有索引中移除
+  void finish(const std::string& key);
+
+  /// 订单等待确认超时
+  void on_ack_timeout(const std::string& key);
+
+  /// 超时后告警并查询该订单对账
+  asio::awaitable<void> reconcile(std::string key);
+
+  /// 按客户端订单ID查询单笔订单，回报经 kOrder 回到 apply
+  asio::awaitable<void> query(const OrderEntry& entry);
+
+  /**
+   * @brief 找出不在挂单快照中的已确认订单
+   *
+   * 仍在等待确认的订单由确认超时处理，不在这里查询，避免把刚提交、尚未到达交易所的订单误判为不存在。
+   * 没有客户端订单ID的外部订单无法单独查询，直接移出管理。
+   *
+   * @param snapshot 全量挂单快照
+   * @return std::vector<OrderEntryPtr> 需要查询最终状态的订单
+   */
+  std::vector<OrderEntryPtr> absent_from(const engine::OrderData& snapshot);
+
+  engine::EnginePtr engine_;
+  std::shared_ptr<risk::RiskGate> risk_;
+  asio::any_io_executor executor_;
+
+  OrderIndex orders_;                                                 ///< 所有未完成订单
+  std::unordered_map<std::string, std::string> order_ids_;            ///< 交易所订单ID -> key
+  std::unordered_map<std::string, std::array<OrderIndex, 2>> sides_;  ///< 交易对 -> [买, 卖]
+};
+
+}  // namespace service::order
+
+#endif  // __SERVICE_ORDER_ORDER_MANAGER_H__
@@ -0,0 +1,158 @@
+#include "position_keeper.h"
+
+namespace service::position {
+
+using Common::Fixed;
+
+PositionKeeper::PositionKeeper(engine::EnginePtr engine) : engine_(engine) {}
+
+PositionKeeper::~PositionKeeper() {}
+
+asio::awaitable<void> PositionKeeper::init() {
+  engine_->register_callback<engine::TradeData>(engine::EventType::kFill,
+    std::bind(&PositionKeeper::recv_fill, shared_from_this(), std::placeholders::_1));
+
+  engine_->register_callback<engine::TickData>(engine::EventType::kTick,
+    std::bind(&PositionKeeper::recv_tick, shared_from_this(), std::placeholders::_1));
+
+  engine_->register_callback<engine::PositionData>(engine::EventType::kPosition,
+    std::bind(&PositionKeeper::recv_position, shared_from_this(), std::placeholders::_1));
+  co_return;
+}
+
+asio::awaitable<void> PositionKeeper::run() { co_return; }
+
+const PositionState* PositionKeeper::position(const std::string& symbol) const {
+  auto it = positions_.find(symbol);
+  return it == positions_.end() ? nullptr : &it->second;
+}
+
+Fixed PositionKeeper::total_pnl() const {
+  Fixed total;
+  for (auto& [symbol, state] : positions_) {
+    total += state.realized + state.unrealized;
+  }
+  return total;
+}
+
+PositionState& PositionKeeper::get(const std::string& symbol, const std::string& exchange) {
+  auto it = positions_.find(symbol);
+  if (it == positions_.end()) {
+    it = positions_.emplace(symbol, PositionState()).first;
+    auto& state = it->second;
+    state.symbol = symbol;
+    state.exchange = exchange;
+    auto& multipliers = position_config->multipliers();
+    auto mul_it = multipliers.find(symbol);
+    if (mul_it != multipliers.end()) {
+      state.multiplier = mul_it->second;
+    }
+  }
+  return it->second;
+}
+
+void PositionKeeper::mark_to_market(PositionState& state) {
+  if (state.mark.is_zero()) {
+    return;
+  }
+  state.unrealized = (state.mark - state.avg_cost) * state.net * state.multiplier;
+  state.exposure = state.mark * state.net * state.multiplier;
+}
+
+asio::awaitable<void> PositionKeeper::recv_fill(engine::TradeDataPtr fill) {
+  auto& state = get(fill->symbol, fill->exchange);
+  auto price = Fixed::from_dec(fill->price);
+  auto volume = Fixed::from_dec(fill->volume);
+  auto qty = fill->direction == engine::Direction::BUY ? volume : -volume;
+
+  if (state.net.is_zero() || (state.net.raw() > 0) == (qty.raw() > 0)) {
+    // 开仓或加仓，按数量加权更新均价
+    auto held = state.net.abs();
+    state.avg_cost = (state.avg_cost * held + price * volume) / (held + volume);
+    state.net += qty;
+  } else {
+    // 减仓，平掉的部分计入已实现盈亏
+    auto closed = std::min(volume, state.net.abs());
+    auto pnl = (price - state.avg_cost) * closed * state.multiplier;
+    state.realized += state.net.raw() > 0 ? pnl : -pnl;
+    state.net += qty;
+    if (state.net.is_zero()) {
+      state.avg_cost = Fixed();
+    } else if ((state.net.raw() > 0) == (qty.raw() > 0)) {
+      // 反手，剩余部分以成交价开仓
+      state.avg_cost = price;
+    }
+  }
+
+  if (state.mark.is_zero()) {
+    state.mark = price;
+  }
+  state.update_ms = fill->timestamp_ms;
+  mark_to_market(state);
+  co_return;
+}
+
+asio::awaitable<void> PositionKeeper::recv_tick(engine::TickDataPtr tick) {
+  auto it = positions_.find(tick->symbol);
+  if (it == positions_.end()) {
+    co_return;
+  }
+  it->second.mark = Fixed::from_dec(tick->last_price);
+  mark_to_market(it->second);
+  co_return;
+}
+
+asio::awaitable<void> PositionKeeper::recv_position(engine::PositionDataPtr position) {
+  // 推送只包含变化的持仓（双向持仓时可能只有一条腿），无法得出净持仓，只用全量快照对账
+  if (!position->snapshot) {
+    co_return;
+  }
+
+  // 双向持仓时同一交易对有多空两条，合并为净持仓；成本带符号，空头腿抵减多头腿
+  struct Snapshot {
+    Fixed net;
+    Fixed cost;  ///< 均价 × 带符号数量之和，用于合并均价
+  };
+  std::unordered_map<std::string, Snapshot> snapshots;
+  for (auto& item : position->items) {
+    auto volume = Fixed::from_dec(item->volume);
+    auto qty = item->direction == engine::Direction::BUY ? volume : -volume;
+    auto& snap = snapshots[item->symbol];
+    snap.net += qty;
+    snap.cost += Fixed::from_dec(item->price) * qty;
+  }
+
+  // 快照中没有的交易对在交易所已无持仓
+  for (auto& [symbol, state] : positions_) {
+    if (state.exchange == position->exchange && !state.net.is_zero()) {
+      snapshots.try_emplace(symbol);
+    }
+  }
+
+  auto tolerance = position_config->drift_tolerance();
+  for (auto& [symbol, snap] : snapshots) {
+    auto& state = get(symbol, position->exchange);
+    auto drift = (state.net - snap.net).abs();
+
+    if (state.synced && drift > tolerance) {
+      auto msg = fmt::format("position drift {} {}: local {} exchange {}", position->exchange, symbol,
+                             state.net.str(), snap.net.str());
+      LOG(WARNING) << msg;
+      co_await engine_->on_event(engine::EventType::kMessage, std::make_shared<engine::MessageData>(msg));
+    }
+
+    // 以交易所为准
+    if (!state.synced || drift > tolerance) {
+      state.net = snap.net;
+      state.avg_cost = snap.net.is_zero() ? Fixed() : snap.cost / snap.net;
+      if (snap.net.is_zero()) {
+        state.unrealized = Fixed();
+        state.exposure = Fixed();
+      }
+      mark_to_market(state);
+    }
+    state.synced = true;
+  }
+}
+
+}  // namespace service::position
@@ -0,0 +1,136 @@
+#ifndef __SERVICE_POSITION_POSITION_KEEPER_H__
+#define __SERVICE_POSITION_POSITION_KEEPER_H__
+
+/**
+ * @file position_keeper.h
+ * @brief 本地持仓与盈亏
+ *
+ * 根据本账户成交（kFill）和最新价（kTick）实时维护每个交易对的持仓、均价、
+ * 已实现/未实现盈亏和敞口，不必等待交易所推送持仓。
+ * 收到交易所全量持仓快照（kPosition）时对账，偏差超过阈值时通过 kMessage 告警并以快照为准；
+ * 快照中没有的交易对视为已平仓。只含变化持仓的推送不参与对账。
+ */
+
+#include <boost/algorithm/string.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "config/config.h"
+#include "engine.h"
+#include "utils/fixed_point.hpp"
+
+namespace service::position {
+
+class PositionConfig : public Config::ConfigTree {
+ public:
+  PositionConfig() : ConfigTree("position") {}
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+    m_enable = this->get<bool>("enable", false);
+    m_drift_tolerance = Common::Fixed::from_string(this->get<std::string>("drift_tolerance", "0"));
+
+    // 合约面值，格式 "交易对:面值,..."，如 "BTC-USDT-SWAP:0.01"，未配置的为1
+    m_multipliers.clear();
+    std::vector<std::string> items;
+    auto multipliers = this->get<std::string>("multipliers", "");
+    boost::split(items, multipliers, boost::is_any_of(","));
+    for (auto& item : items) {
+      std::vector<std::string> fields;
+      boost::split(fields, item, boost::is_any_of(":"));
+      if (fields.size() == 2) {
+        m_multipliers[boost::trim_copy(fields[0])] = Common::Fixed::from_string(boost::trim_copy(fields[1]));
+      }
+    }
+  }
+
+  bool enable() const { return m_enable; }
+  Common::Fixed drift_tolerance() const { return m_drift_tolerance; }
+  const std::unordered_map<std::string, Common::Fixed>& multipliers() const { return m_multipliers; }
+
+ private:
+  bool m_enable = false;
+  Common::Fixed m_drift_tolerance;
+  std::unordered_map<std::string, Common::Fixed> m_multipliers;
+};
+
+#define position_config ::Common::SingletonPtr<::service::position::PositionConfig>::get_instance()
+
+/**
+ * @brief 单个交易对的持仓状态
+ *
+ * 数量带符号，多头为正、空头为负；金额 = 价格 × 数量 × 合约面值。
+ */
+struct PositionState {
+  std::string symbol;
+  std::string exchange;
+
+  Common::Fixed multiplier = Common::Fixed::from_int(1);  ///< 合约面值
+
+  Common::Fixed net;         ///< 净持仓
+  Common::Fixed avg_cost;    ///< 持仓均价
+  Common::Fixed realized;    ///< 已实现盈亏
+  Common::Fixed unrealized;  ///< 未实现盈亏
+  Common::Fixed mark;        ///< 最新价
+  Common::Fixed exposure;    ///< 敞口，净持仓按最新价计的名义金额（带符号）
+
+  int64_t update_ms = 0;  ///< 最近一次更新时间
+  bool synced = false;    ///< 是否已与交易所快照对齐，首次快照直接采用不告警
+};
+
+/**
+ * @brief 持仓与盈亏组件
+ *
+ * 成交和价格更新都是O(1)：只修改对应交易对的状态，不遍历历史成交。
+ * 只在引擎执行器上访问，非线程安全。
+ */
+class PositionKeeper : public std::enable_shared_from_this<PositionKeeper>, public engine::Component {
+ public:
+  PositionKeeper(engine::EnginePtr engine);
+  ~PositionKeeper();
+
+  /**
+   * @brief 注册成交、Tick和持仓回调
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> init() override;
+
+  /**
+   * @brief 无后台任务
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> run() override;
+
+  /// 查询持仓，没有记录返回nullptr
+  const PositionState* position(const std::string& symbol) const;
+
+  /// 所有交易对的持仓
+  const std::unordered_map<std::string, PositionState>& positions() const { return positions_; }
+
+  /// 所有交易对的已实现和未实现盈亏之和
+  Common::Fixed total_pnl() const;
+
+ private:
+  /// 处理本账户成交
+  asio::awaitable<void> recv_fill(engine::TradeDataPtr fill);
+
+  /// 按最新价重新计算未实现盈亏
+  asio::awaitable<void> recv_tick(engine::TickDataPtr tick);
+
+  /// 与交易所持仓快照对账
+  asio::awaitable<void> recv_position(engine::PositionDataPtr position);
+
+  /// 获取交易对状态，首次出现时创建
+  PositionState& get(const std::string& symbol, const std::string& exchange);
+
+  /// 更新按最新价计算的字段
+  static void mark_to_market(PositionState& state);
+
+  engine::EnginePtr engine_;
+  std::unordered_map<std::string, PositionState> positions_;  ///< key: 交易对
+};
+
+}  // namespace service::position
+
+#endif  // __SERVICE_POSITION_POSITION_KEEPER_H__
@@ -0,0 +1,175 @@
+#include "risk_gate.h"
+
+#include <chrono>
+
+#include "utils/async_log.h"
+
+namespace service::risk {
+
+using Common::Fixed;
+
+RiskGate::RiskGate(engine::EnginePtr engine)
+    : engine_(engine),
+      price_band_bps_(risk_config->price_band_bps()),
+      max_open_orders_(risk_config->max_open_orders()),
+      max_symbol_open_orders_(risk_config->max_symbol_open_orders()),
+      max_orders_per_second_(risk_config->max_orders_per_second()) {
+  default_.limit = risk_config->default_limit();
+  for (auto& [symbol, limit] : risk_config->symbol_limits()) {
+    auto risk = std::make_unique<SymbolRisk>();
+    risk->limit = limit;
+    symbols_.emplace(symbol, std::move(risk));
+  }
+}
+
+RiskGate::~RiskGate() {}
+
+asio::awaitable<void> RiskGate::init() {
+  engine_->register_callback<engine::TickData>(engine::EventType::kTick,
+    std::bind(&RiskGate::recv_tick, shared_from_this(), std::placeholders::_1));
+  co_return;
+}
+
+asio::awaitable<void> RiskGate::run() { co_return; }
+
+asio::awaitable<void> RiskGate::recv_tick(engine::TickDataPtr tick) {
+  set_reference(tick->symbol, Fixed::from_dec(tick->last_price));
+  co_return;
+}
+
+void RiskGate::set_reference(const std::string& symbol, Fixed price) {
+  get_symbol(symbol).ref_price.store(price.raw(), std::memory_order_relaxed);
+}
+
+RiskGate::SymbolRisk& RiskGate::get_symbol(const std::string& symbol) {
+  auto it = symbols_.find(symbol);
+  if (it == symbols_.end()) {
+    auto risk = std::make_unique<SymbolRisk>();
+    risk->limit = risk_config->default_limit();
+    it = symbols_.emplace(symbol, std::move(risk)).first;
+  }
+  return *it->second;
+}
+
+const RiskGate::SymbolRisk& RiskGate::find_symbol(const std::string& symbol) const {
+  auto it = symbols_.find(symbol);
+  return it == symbols_.end() ? default_ : *it->second;
+}
+
+RiskReason RiskGate::check(const engine::OrderDataItem& item, size_t open_orders, size_t symbol_open_orders) {
+  // dec_float 只在这里转换一次
+  auto price = item.otype == engine::OrderType::LIMIT ? Fixed::from_dec(item.price) : Fixed();
+  return check(item.symbol, item.otype, Fixed::from_dec(item.volume), price, open_orders, symbol_open_orders);
+}
+
+RiskReason RiskGate::check(const std::string& symbol, engine::OrderType otype, Fixed volume, Fixed price,
+                           size_t open_orders, size_t symbol_open_orders) {
+  auto result = [this](RiskReason reason) {
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    return reason;
+  };
+
+  auto& risk = find_symbol(symbol);
+  auto& limit = risk.limit;
+
+  // 单笔数量
+  if (volume.raw() <= 0) {
+    return result(RiskReason::kInvalid);
+  }
+  if (!limit.max_volume.is_zero() && volume > limit.max_volume) {
+    return result(RiskReason::kVolume);
+  }
+
+  // 市价单使用参考价估算名义金额
+  auto ref = Fixed::from_raw(risk.ref_price.load(std::memory_order_relaxed));
+  bool limit_order = otype == engine::OrderType::LIMIT;
+  if (limit_order) {
+    if (price.raw() <= 0) {
+      return result(RiskReason::kInvalid);
+    }
+  } else {
+    price = ref;
+  }
+
+  // 没有参考价时无法估算市价单金额、无法判断限价偏离，拒绝而不是放行
+  if (ref.is_zero() && ((!limit_order && !limit.max_notional.is_zero()) || (limit_order && price_band_bps_ > 0))) {
+    return result(RiskReason::kNoReference);
+  }
+
+  if (!limit.max_notional.is_zero() && price * volume > limit.max_notional) {
+    return result(RiskReason::kNotional);
+  }
+
+  // 限价偏离参考价：|price - ref| / ref > band_bps / 10000
+  if (price_band_bps_ > 0 && limit_order) {
+    auto diff = static_cast<__int128>((price - ref).abs().raw()) * 10000;
+    if (diff > static_cast<__int128>(ref.raw()) * price_band_bps_) {
+      return result(RiskReason::kPriceBand);
+    }
+  }
+
+  // 挂单数量
+  if (max_open_orders_ > 0 && static_cast<int64_t>(open_orders) >= max_open_orders_) {
+    return result(RiskReason::kOpenOrders);
+  }
+  if (max_symbol_open_orders_ > 0 && static_cast<int64_t>(symbol_open_orders) >= max_symbol_open_orders_) {
+    return result(RiskReason::kSymbolOpenOrders);
+  }
+
+  // 下单频率，按秒分窗，最后检查，只有通过的订单计数
+  if (max_orders_per_second_ > 0) {
+    int64_t now_s = engine::Engine::steady_now_ms() / 1000;
+    int64_t window = window_s_.load(std::memory_order_relaxed);
+    if (window != now_s && window_s_.compare_exchange_strong(window, now_s, std::memory_order_relaxed)) {
+      window_count_.store(0, std::memory_order_relaxed);
+    }
+    if (window_count_.fetch_add(1, std::memory_order_relaxed) >= max_orders_per_second_) {
+      window_count_.fetch_sub(1, std::memory_order_relaxed);
+      return result(RiskReason::kRate);
+    }
+  }
+
+  passed_.fetch_add(1, std::memory_order_relaxed);
+  return RiskReason::kPass;
+}
+
+asio::awaitable<void> RiskGate::reject(engine::OrderDataItemPtr item, RiskReason reason) {
+  auto data = std::make_shared<engine::RiskRejectData>();
+  data->symbol = item->symbol;
+  data->exchange = item->exchange;
+  data->timestamp_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+          .count();
+  data->order = item;
+  data->code = static_cast<int>(reason);
+  data->reason = reason_text(reason);
+
+  QLOG(WARNING, "risk reject {} {}: {}", item->symbol, item->client_order_id, data->reason);
+  co_await engine_->on_event(engine::EventType::kRiskReject, data);
+}
+
+const char* RiskGate::reason_text(RiskReason reason) {
+  switch (reason) {
+    case RiskReason::kPass:
+      return "pass";
+    case RiskReason::kVolume:
+      return "order volume exceeds limit";
+    case RiskReason::kNotional:
+      return "order notional exceeds limit";
+    case RiskReason::kPriceBand:
+      return "price outside band";
+    case RiskReason::kOpenOrders:
+      return "too many open orders";
+    case RiskReason::kSymbolOpenOrders:
+      return "too many open orders on symbol";
+    case RiskReason::kRate:
+      return "order rate exceeds limit";
+    case RiskReason::kInvalid:
+      return "invalid price or volume";
+    case RiskReason::kNoReference:
+      return "no reference price";
+  }
+  return "unknown";
+}
+
+}  // namespace service::risk
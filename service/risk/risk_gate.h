@@ -0,0 +1,204 @@
+#ifndef __SERVICE_RISK_RISK_GATE_H__
+#define __SERVICE_RISK_RISK_GATE_H__
+
+/**
+ * @file risk_gate.h
+ * @brief 下单前风控
+ *
+ * 由订单管理在转发 kSubmitOrder 之前同步调用，检查单笔数量、名义金额、价格偏离、
+ * 挂单数量和下单频率，拒绝时发出 kRiskReject 事件。
+ */
+
+#include <atomic>
+#include <boost/algorithm/string.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "config/config.h"
+#include "engine.h"
+#include "utils/fixed_point.hpp"
+
+namespace service::risk {
+
+/**
+ * @brief 单个交易对的限额
+ */
+struct SymbolLimit {
+  Common::Fixed max_volume;    ///< 单笔最大数量，0表示不限制
+  Common::Fixed max_notional;  ///< 单笔最大名义金额，0表示不限制
+};
+
+class RiskConfig : public Config::ConfigTree {
+ public:
+  RiskConfig() : ConfigTree("risk") {}
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+    m_enable = this->get<bool>("enable", false);
+    m_default_limit.max_volume = Common::Fixed::from_string(this->get<std::string>("max_order_volume", "0"));
+    m_default_limit.max_notional = Common::Fixed::from_string(this->get<std::string>("max_order_notional", "0"));
+    m_price_band_bps = this->get<int64_t>("price_band_bps", 0);
+    m_max_open_orders = this->get<int64_t>("max_open_orders", 0);
+    m_max_symbol_open_orders = this->get<int64_t>("max_symbol_open_orders", 0);
+    m_max_orders_per_second = this->get<int64_t>("max_orders_per_second", 0);
+
+    // 交易对单独限额，格式 "交易对:最大数量:最大名义金额,..."，如 "BTC-USDT-SWAP:1:100000"
+    m_symbol_limits.clear();
+    std::vector<std::string> items;
+    auto limits = this->get<std::string>("symbol_limits", "");
+    boost::split(items, limits, boost::is_any_of(","));
+    for (auto& item : items) {
+      boost::trim(item);
+      std::vector<std::string> fields;
+      boost::split(fields, item, boost::is_any_of(":"));
+      if (fields.size() != 3) {
+        continue;
+      }
+      SymbolLimit limit;
+      limit.max_volume = Common::Fixed::from_string(boost::trim_copy(fields[1]));
+      limit.max_notional = Common::Fixed::from_string(boost::trim_copy(fields[2]));
+      m_symbol_limits[boost::trim_copy(fields[0])] = limit;
+    }
+  }
+
+  bool enable() const { return m_enable; }
+  const SymbolLimit& default_limit() const { return m_default_limit; }
+  const std::unordered_map<std::string, SymbolLimit>& symbol_limits() const { return m_symbol_limits; }
+  int64_t price_band_bps() const { return m_price_band_bps; }
+  int64_t max_open_orders() const { return m_max_open_orders; }
+  int64_t max_symbol_open_orders() const { return m_max_symbol_open_orders; }
+  int64_t max_orders_per_second() const { return m_max_orders_per_second; }
+
+ private:
+  bool m_enable = false;
+  SymbolLimit m_default_limit;
+  std::unordered_map<std::string, SymbolLimit> m_symbol_limits;
+  int64_t m_price_band_bps = 0;
+  int64_t m_max_open_orders = 0;
+  int64_t m_max_symbol_open_orders = 0;
+  int64_t m_max_orders_per_second = 0;
+};
+
+#define risk_config ::Common::SingletonPtr<::service::risk::RiskConfig>::get_instance()
+
+/**
+ * @brief 拒绝原因
+ */
+enum class RiskReason {
+  kPass = 0,          ///< 通过
+  kVolume,            ///< 超过单笔最大数量
+  kNotional,          ///< 超过单笔最大名义金额
+  kPriceBand,         ///< 限价偏离参考价过大
+  kOpenOrders,        ///< 账户挂单数超限
+  kSymbolOpenOrders,  ///< 交易对挂单数超限
+  kRate,              ///< 下单频率超限
+  kInvalid,           ///< 数量或价格非法
+  kNoReference,       ///< 需要参考价的检查已开启，但还没有该交易对的行情
+};
+
+/**
+ * @brief 下单前风控
+ *
+ * 所有阈值在启动时转换为定点数。订单的数量和价格是 dec_float，在入口处各转换一次定点数，
+ * 之后的检查只有整数比较；下单路径只查找交易对，不插入、不分配内存。
+ * 参考价取自最新Tick，保存在原子变量中；没有参考价时，依赖参考价的检查（市价单名义金额、
+ * 限价偏离）直接拒绝。频率计数按秒分窗，使用原子计数器。
+ */
+class RiskGate : public std::enable_shared_from_this<RiskGate>, public engine::Component {
+ public:
+  RiskGate(engine::EnginePtr engine);
+  ~RiskGate();
+
+  /**
+   * @brief 注册Tick回调，维护参考价
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> init() override;
+
+  /**
+   * @brief 无后台任务
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> run() override;
+
+  /**
+   * @brief 检查一笔订单，通过时计入频率计数
+   * @param item 订单
+   * @param open_orders 账户当前挂单数
+   * @param symbol_open_orders 该交易对当前挂单数
+   * @return RiskReason 检查结果
+   */
+  RiskReason check(const engine::OrderDataItem& item, size_t open_orders, size_t symbol_open_orders);
+
+  /**
+   * @brief 检查一笔已转换为定点数的订单，通过时计入频率计数
+   * @param symbol 交易对
+   * @param otype 订单类型
+   * @param volume 数量
+   * @param price 限价，市价单忽略
+   * @param open_orders 账户当前挂单数
+   * @param symbol_open_orders 该交易对当前挂单数
+   * @return RiskReason 检查结果
+   */
+  RiskReason check(const std::string& symbol, engine::OrderType otype, Common::Fixed volume, Common::Fixed price,
+                   size_t open_orders, size_t symbol_open_orders);
+
+  /**
+   * @brief 更新参考价，交易对首次出现时按默认限额创建
+   * @param symbol 交易对
+   * @param price 参考价
+   */
+  void set_reference(const std::string& symbol, Common::Fixed price);
+
+  /**
+   * @brief 发出风控拒单事件
+   * @param item 被拒绝的订单
+   * @param reason 拒绝原因
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> reject(engine::OrderDataItemPtr item, RiskReason reason);
+
+  /// 拒绝原因说明
+  static const char* reason_text(RiskReason reason);
+
+  /// 累计通过/拒绝的订单数
+  uint64_t passed() const { return passed_.load(std::memory_order_relaxed); }
+  uint64_t rejected() const { return rejected_.load(std::memory_order_relaxed); }
+
+ private:
+  /// 单个交易对的风控状态
+  struct SymbolRisk {
+    SymbolLimit limit;
+    std::atomic<int64_t> ref_price{0};  ///< 参考价（定点数原始值），0表示还没有行情
+  };
+
+  /// 更新参考价
+  asio::awaitable<void> recv_tick(engine::TickDataPtr tick);
+
+  /// 获取交易对状态，首次出现时按配置创建，只在行情路径调用
+  SymbolRisk& get_symbol(const std::string& symbol);
+
+  /// 查找交易对状态，不存在时返回默认限额、没有参考价的状态
+  const SymbolRisk& find_symbol(const std::string& symbol) const;
+
+  engine::EnginePtr engine_;
+
+  std::unordered_map<std::string, std::unique_ptr<SymbolRisk>> symbols_;
+  SymbolRisk default_;  ///< 没有配置、也没有行情的交易对
+
+  int64_t price_band_bps_;
+  int64_t max_open_orders_;
+  int64_t max_symbol_open_orders_;
+  int64_t max_orders_per_second_;
+
+  std::atomic<int64_t> window_s_{0};      ///< 当前频率窗口（秒）
+  std::atomic<int64_t> window_count_{0};  ///< 当前窗口内通过的订单数
+  std::atomic<uint64_t> passed_{0};
+  std::atomic<uint64_t> rejected_{0};
+};
+
+}  // namespace service::risk
+
+#endif  // __SERVICE_RISK_RISK_GATE_H__
@@ -0,0 +1,285 @@
+#include "smart_router.h"
+
+#include <algorithm>
+#include <boost/asio/experimental/parallel_group.hpp>
+
+#include "base/gateway_registry.h"
+#include "order/order_manager.h"
+#include "utils/async_log.h"
+#include "utils/latency.h"
+
+namespace service::router {
+
+using Common::Fixed;
+
+namespace {
+
+/// 下单延迟滑动平均的权重
+constexpr double kLatencyAlpha = 0.2;
+
+bool is_finished(engine::OrderStatus status) {
+  return status == engine::OrderStatus::FILLED || status == engine::OrderStatus::CANCELLED ||
+         status == engine::OrderStatus::REJECTED;
+}
+
+/// 一个交易所在一个价格上的可成交数量
+struct Candidate {
+  uint32_t venue;
+  Fixed price;
+  Fixed size;
+  double cost;  ///< 计入手续费和延迟后的价格
+};
+
+}  // namespace
+
+SmartRouter::SmartRouter(engine::EnginePtr engine, std::shared_ptr<consolidated::ConsolidatedBook> book)
+    : engine_(engine), book_(book) {}
+
+SmartRouter::~SmartRouter() {}
+
+asio::awaitable<void> SmartRouter::init() {
+  engine_->register_callback<engine::OrderData>(engine::EventType::kRouteOrder,
+    std::bind(&SmartRouter::route_orders, shared_from_this(), std::placeholders::_1));
+
+  engine_->register_callback<engine::OrderData>(engine::EventType::kOrder,
+    std::bind(&SmartRouter::recv_order, shared_from_this(), std::placeholders::_1));
+  co_return;
+}
+
+asio::awaitable<void> SmartRouter::run() { co_return; }
+
+const ParentOrder* SmartRouter::find(const std::string& parent_id) const {
+  auto it = parents_.find(parent_id);
+  return it == parents_.end() ? nullptr : &it->second;
+}
+
+double SmartRouter::latency_ms(const std::string& exchange) const {
+  auto it = latencies_.find(exchange);
+  return it == latencies_.end() ? router_config->latency_ms(exchange) : it->second;
+}
+
+asio::awaitable<void> SmartRouter::route_orders(engine::OrderDataPtr order) {
+  for (auto& item : order->items) {
+    co_await route(*item);
+  }
+}
+
+template <typename Side>
+std::vector<SmartRouter::Allocation> SmartRouter::sweep(const Side& side, const engine::OrderDataItem& parent,
+                                                        bool buy) const {
+  auto limit = Fixed::from_dec(parent.price);
+  bool has_limit = parent.otype == engine::OrderType::LIMIT;
+
+  // 收集限价以内若干档上每个交易所的数量，按折算价格排序
+  std::vector<Candidate> candidates;
+  uint32_t levels = 0;
+  for (auto& [price, level] : side) {
+    if (levels++ >= router_config->max_levels()) {
+      break;
+    }
+    if (has_limit && (buy ? price > limit : price < limit)) {
+      break;
+    }
+    for (auto& venue : level.venues) {
+      auto& exchange = book_->venue_name(venue.venue);
+      auto penalty = router_config->fee(exchange) + latency_ms(exchange) * router_config->latency_bps_per_ms() / 10000;
+      auto cost = price.to_double() * (buy ? 1 + penalty : 1 - penalty);
+      candidates.push_back({venue.venue, price, venue.size, cost});
+    }
+  }
+  std::stable_sort(candidates.begin(), candidates.end(), [buy](const Candidate& a, const Candidate& b) {
+    return buy ? a.cost < b.cost : a.cost > b.cost;
+  });
+
+  // 从优到劣分配，同一交易所的数量合并为一笔子单，价格取扫到的最差价格
+  std::vector<Allocation> allocations;
+  auto remaining = Fixed::from_dec(parent.volume);
+  for (auto& candidate : candidates) {
+    if (remaining.is_zero()) {
+      break;
+    }
+    auto take = std::min(remaining, candidate.size);
+    remaining -= take;
+
+    auto& exchange = book_->venue_name(candidate.venue);
+    auto it = std::find_if(allocations.begin(), allocations.end(),
+                           [&exchange](const Allocation& a) { return a.exchange == exchange; });
+    if (it == allocations.end()) {
+      allocations.push_back({exchange, candidate.price, take});
+    } else {
+      it->price = buy ? std::max(it->price, candidate.price) : std::min(it->price, candidate.price);
+      it->volume += take;
+    }
+  }
+
+  // 可见挂单不足时，剩余数量放到折算价格最优的交易所，限价单按母单价格挂出
+  if (!remaining.is_zero()) {
+    if (allocations.empty()) {
+      allocations.push_back({gateway_config->default_venue(), limit, remaining});
+    } else {
+      // 第一项是最先分配的，即折算价格最优的交易所
+      allocations.front().volume += remaining;
+    }
+    if (has_limit) {
+      allocations.front().price = limit;
+    }
+  }
+  return allocations;
+}
+
+std::vector<SmartRouter::Allocation> SmartRouter::plan(const engine::OrderDataItem& parent) const {
+  auto ladder = book_->ladder(parent.symbol);
+  if (ladder == nullptr) {
+    return {{gateway_config->default_venue(), Fixed::from_dec(parent.price), Fixed::from_dec(parent.volume)}};
+  }
+  return parent.direction == engine::Direction::BUY ? sweep(ladder->asks(), parent, true)
+                                                    : sweep(ladder->bids(), parent, false);
+}
+
+asio::awaitable<void> SmartRouter::route(const engine::OrderDataItem& parent) {
+  ParentOrder entry;
+  entry.item = parent;
+  if (entry.item.client_order_id.empty()) {
+    entry.item.client_order_id = order::OrderManager::next_client_order_id();
+  }
+  entry.item.exchange.clear();
+  entry.item.filled_volume = 0;
+  entry.item.avg_price = 0;
+  entry.item.status = engine::OrderStatus::SUBMITTING;
+  auto parent_id = entry.item.client_order_id;
+
+  if (parents_.contains(parent_id) || Fixed::from_dec(parent.volume).raw() <= 0) {
+    QLOG(ERROR, "route order rejected: {}", parent_id);
+    entry.item.status = engine::OrderStatus::REJECTED;
+    auto rejected = std::make_shared<engine::OrderData>();
+    rejected->symbol = parent.symbol;
+    rejected->items.push_back(std::make_shared<engine::OrderDataItem>(entry.item));
+    co_await engine_->on_event(engine::EventType::kParentOrder, rejected);
+    co_return;
+  }
+
+  // 每个交易所一笔子单，先登记再发出，回报可能在发送返回前到达
+  std::vector<engine::OrderDataPtr> sends;
+  for (auto& allocation : plan(parent)) {
+    auto item = std::make_shared<engine::OrderDataItem>(parent);
+    item->client_order_id = order::OrderManager::next_client_order_id();
+    item->symbol = consolidated_config->venue_symbol(allocation.exchange, parent.symbol);
+    item->exchange = allocation.exchange;
+    item->price = allocation.price.to_dec();
+    item->volume = allocation.volume.to_dec();
+
+    auto child = std::make_shared<engine::OrderData>();
+    child->symbol = item->symbol;
+    child->exchange = item->exchange;
+    child->recv_ns = parent.recv_ns;
+    child->items.push_back(item);
+    sends.push_back(child);
+
+    ChildOrder state;
+    state.parent = parent_id;
+    state.exchange = allocation.exchange;
+    state.volume = allocation.volume;
+    state.sent_ns = Common::now_ns();
+    children_[item->client_order_id] = state;
+    entry.children.push_back(item->client_order_id);
+
+    QLOG(INFO, "route {} -> {} {} {}@{}", parent_id, allocation.exchange, item->client_order_id,
+         allocation.volume.str(), allocation.price.str());
+  }
+  parents_[parent_id] = std::move(entry);
+
+  // 各交易所的子单并发发出，互不等待
+  auto executor = co_await asio::this_coro::executor;
+  std::vector<decltype(asio::co_spawn(executor, std::declval<asio::awaitable<void>>(), asio::deferred))> ops;
+  for (auto& child : sends) {
+    ops.push_back(asio::co_spawn(executor, engine_->on_event(engine::EventType::kSendOrder, child), asio::deferred));
+  }
+  auto group = asio::experimental::make_parallel_group(std::move(ops));
+  co_await group.async_wait(asio::experimental::wait_for_all(), asio::use_awaitable);
+}
+
+void SmartRouter::aggregate(ParentOrder& parent, const std::unordered_map<std::string, ChildOrder>& children) {
+  Fixed filled, turnover;
+  bool all_finished = true, all_rejected = true, any_acked = false;
+  for (auto& id : parent.children) {
+    auto& child = children.at(id);
+    filled += child.filled;
+    turnover += child.avg_price * child.filled;
+    all_finished = all_finished && is_finished(child.status);
+    all_rejected = all_rejected && child.status == engine::OrderStatus::REJECTED;
+    any_acked = any_acked || child.status != engine::OrderStatus::SUBMITTING;
+  }
+
+  auto& item = parent.item;
+  item.filled_volume = filled.to_dec();
+  item.avg_price = filled.is_zero() ? Fixed().to_dec() : (turnover / filled).to_dec();
+  if (all_finished) {
+    if (filled == Fixed::from_dec(item.volume)) {
+      item.status = engine::OrderStatus::FILLED;
+    } else if (filled.is_zero() && all_rejected) {
+      item.status = engine::OrderStatus::REJECTED;
+    } else {
+      item.status = engine::OrderStatus::CANCELLED;
+    }
+  } else if (!filled.is_zero()) {
+    item.status = engine::OrderStatus::PARTIAL_FILLED;
+  } else if (any_acked) {
+    item.status = engine::OrderStatus::PENDING;
+  }
+}
+
+asio::awaitable<void> SmartRouter::recv_order(engine::OrderDataPtr order) {
+  std::vector<std::string> changed;
+  for (auto& item : order->items) {
+    auto it = children_.find(item->client_order_id);
+    if (it == children_.end()) {
+      continue;
+    }
+    auto& child = it->second;
+    auto filled = Fixed::from_dec(item->filled_volume);
+    // 终态之后和成交量回退的乱序回报丢弃
+    if (is_finished(child.status) || filled < child.filled) {
+      continue;
+    }
+
+    // 首次回报时更新该交易所的下单延迟估计
+    if (child.status == engine::OrderStatus::SUBMITTING && item->status != engine::OrderStatus::SUBMITTING &&
+        item->status != engine::OrderStatus::REJECTED) {
+      auto elapsed_ms = static_cast<double>(Common::now_ns() - child.sent_ns) / 1e6;
+      auto& latency = latencies_.try_emplace(child.exchange, router_config->latency_ms(child.exchange)).first->second;
+      latency += kLatencyAlpha * (elapsed_ms - latency);
+    }
+
+    child.status = item->status;
+    child.filled = filled;
+    child.avg_price = Fixed::from_dec(item->avg_price);
+    if (std::find(changed.begin(), changed.end(), child.parent) == changed.end()) {
+      changed.push_back(child.parent);
+    }
+  }
+
+  for (auto& parent_id : changed) {
+    auto parent_it = parents_.find(parent_id);
+    if (parent_it == parents_.end()) {
+      continue;
+    }
+    auto& parent = parent_it->second;
+    aggregate(parent, children_);
+
+    auto data = std::make_shared<engine::OrderData>();
+    data->symbol = parent.item.symbol;
+    data->timestamp_ms = order->timestamp_ms;
+    data->items.push_back(std::make_shared<engine::OrderDataItem>(parent.item));
+
+    // 母单完成后不再跟踪
+    if (is_finished(parent.item.status)) {
+      for (auto& id : parent.children) {
+        children_.erase(id);
+      }
+      parents_.erase(parent_it);
+    }
+    co_await engine_->on_event(engine::EventType::kParentOrder, data);
+  }
+}
+
+}  // namespace service::router
@@ -0,0 +1,180 @@
+#ifndef __SERVICE_ROUTER_SMART_ROUTER_H__
+#define __SERVICE_ROUTER_SMART_ROUTER_H__
+
+/**
+ * @file smart_router.h
+ * @brief 智能订单路由
+ *
+ * 策略以 kRouteOrder 发出母单，路由按合并订单簿逐档扫过各交易所的挂单，
+ * 按手续费和下单延迟折算后的价格从优到劣分配数量，每个交易所合成一笔子单，
+ * 并发经订单管理发往各交易所网关。子单回报汇总为母单状态，以 kParentOrder 发出。
+ */
+
+#include <boost/algorithm/string.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "config/config.h"
+#include "consolidated/consolidated_book.h"
+#include "engine.h"
+#include "utils/fixed_point.hpp"
+
+namespace service::router {
+
+class RouterConfig : public Config::ConfigTree {
+ public:
+  RouterConfig() : ConfigTree("router") {}
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+    m_enable = this->get<bool>("enable", false);
+    m_max_levels = this->get<uint32_t>("max_levels", 20);
+    m_latency_bps_per_ms = this->get<double>("latency_bps_per_ms", 0.1);
+
+    // 吃单费率和初始下单延迟，格式 "交易所:数值,..."，如 "okx:0.0005,binance:0.0004"
+    m_fees = parse(this->get<std::string>("fees", ""));
+    m_latencies = parse(this->get<std::string>("latency_ms", ""));
+  }
+
+  bool enable() const { return m_enable; }
+
+  /// 每次路由最多扫过的合并档位数
+  uint32_t max_levels() const { return m_max_levels; }
+
+  /// 每毫秒下单延迟折算的价格成本（基点），延迟越高越容易错过挂单
+  double latency_bps_per_ms() const { return m_latency_bps_per_ms; }
+
+  /// 交易所的吃单费率，未配置为0
+  double fee(const std::string& exchange) const { return value(m_fees, exchange); }
+
+  /// 交易所的初始下单延迟估计（毫秒），运行后按子单确认时间更新，未配置为0
+  double latency_ms(const std::string& exchange) const { return value(m_latencies, exchange); }
+
+ private:
+  static std::unordered_map<std::string, double> parse(const std::string& text) {
+    std::unordered_map<std::string, double> result;
+    std::vector<std::string> items;
+    boost::split(items, text, boost::is_any_of(","));
+    for (auto& item : items) {
+      std::vector<std::string> fields;
+      boost::split(fields, item, boost::is_any_of(":"));
+      if (fields.size() == 2) {
+        result[boost::trim_copy(fields[0])] = std::stod(boost::trim_copy(fields[1]));
+      }
+    }
+    return result;
+  }
+
+  static double value(const std::unordered_map<std::string, double>& values, const std::string& exchange) {
+    auto it = values.find(exchange);
+    return it == values.end() ? 0 : it->second;
+  }
+
+  bool m_enable = false;
+  uint32_t m_max_levels = 20;
+  double m_latency_bps_per_ms = 0.1;
+  std::unordered_map<std::string, double> m_fees;
+  std::unordered_map<std::string, double> m_latencies;
+};
+
+#define router_config ::Common::SingletonPtr<::service::router::RouterConfig>::get_instance()
+
+/**
+ * @brief 发往一个交易所的子单
+ */
+struct ChildOrder {
+  std::string parent;       ///< 母单ID
+  std::string exchange;     ///< 交易所
+  Common::Fixed volume;     ///< 子单数量
+  Common::Fixed filled;     ///< 已成交数量
+  Common::Fixed avg_price;  ///< 成交均价
+  engine::OrderStatus status = engine::OrderStatus::SUBMITTING;
+  int64_t sent_ns = 0;  ///< 发出时间（单调时钟纳秒），用于估计交易所的下单延迟
+};
+
+/**
+ * @brief 母单
+ */
+struct ParentOrder {
+  engine::OrderDataItem item;         ///< 汇总后的状态，client_order_id 为母单ID
+  std::vector<std::string> children;  ///< 子单的客户端订单ID
+};
+
+/**
+ * @brief 智能订单路由组件
+ *
+ * 依赖合并订单簿，交易对使用合并订单簿的统一名称，子单按别名换回各交易所的交易对。
+ * 只在引擎执行器上访问，非线程安全。
+ */
+class SmartRouter : public std::enable_shared_from_this<SmartRouter>, public engine::Component {
+ public:
+  /**
+   * @brief 构造函数
+   * @param engine 引擎指针
+   * @param book 合并订单簿
+   */
+  SmartRouter(engine::EnginePtr engine, std::shared_ptr<consolidated::ConsolidatedBook> book);
+  ~SmartRouter();
+
+  /**
+   * @brief 注册母单请求和订单回报回调
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> init() override;
+
+  /**
+   * @brief 无后台任务
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> run() override;
+
+  /// 按母单ID查询未完成母单，不存在返回nullptr
+  const ParentOrder* find(const std::string& parent_id) const;
+
+  /// 交易所当前的下单延迟估计（毫秒）
+  double latency_ms(const std::string& exchange) const;
+
+ private:
+  /// 一个交易所分到的数量
+  struct Allocation {
+    std::string exchange;
+    Common::Fixed price;   ///< 扫到的最差价格
+    Common::Fixed volume;  ///< 数量
+  };
+
+  /// 处理策略的母单请求
+  asio::awaitable<void> route_orders(engine::OrderDataPtr order);
+
+  /// 拆分一笔母单并并发发出子单
+  asio::awaitable<void> route(const engine::OrderDataItem& parent);
+
+  /**
+   * @brief 按合并订单簿分配母单数量
+   * @param parent 母单
+   * @return std::vector<Allocation> 每个交易所一项
+   */
+  std::vector<Allocation> plan(const engine::OrderDataItem& parent) const;
+
+  /// 扫过合并订单簿的一侧，buy 为真时价格越低越优
+  template <typename Side>
+  std::vector<Allocation> sweep(const Side& side, const engine::OrderDataItem& parent, bool buy) const;
+
+  /// 处理子单回报
+  asio::awaitable<void> recv_order(engine::OrderDataPtr order);
+
+  /// 按子单状态重新汇总母单
+  static void aggregate(ParentOrder& parent, const std::unordered_map<std::string, ChildOrder>& children);
+
+  engine::EnginePtr engine_;
+  std::shared_ptr<consolidated::ConsolidatedBook> book_;
+
+  std::unordered_map<std::string, ParentOrder> parents_;  ///< 未完成母单，key: 母单ID
+  std::unordered_map<std::string, ChildOrder> children_;  ///< 未完成母单的子单，key: 客户端订单ID
+  std::unordered_map<std::string, double> latencies_;     ///< 交易所下单延迟的滑动平均（毫秒）
+};
+
+}  // namespace service::router
+
+#endif  // __SERVICE_ROUTER_SMART_ROUTER_H__
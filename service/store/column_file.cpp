@@ -0,0 +1,465 @@
+#include "column_file.h"
+
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#ifdef BOOST_ASIO_HAS_FILE
+#include <boost/asio/random_access_file.hpp>
+#include <boost/asio/write_at.hpp>
+#endif
+
+#include "utils/async_log.h"
+
+namespace service::store {
+
+namespace {
+
+constexpr uint32_t kFileMagic = 0x53434951;   // "QICS"
+constexpr uint32_t kBlockMagic = 0x4b4c4251;  // "QBLK"
+constexpr uint32_t kIndexMagic = 0x58444951;  // "QIDX"
+constexpr uint16_t kVersion = 1;
+
+constexpr size_t kFileHeaderSize = 24;
+constexpr size_t kBlockHeaderSize = 32;
+constexpr size_t kIndexEntrySize = 32;
+constexpr size_t kTrailerSize = 16;
+
+template <typename T>
+void put(std::vector<uint8_t>& buf, T v) {
+  auto pos = buf.size();
+  buf.resize(pos + sizeof(T));
+  std::memcpy(buf.data() + pos, &v, sizeof(T));
+}
+
+template <typename T>
+T get(const uint8_t* p) {
+  T v;
+  std::memcpy(&v, p, sizeof(T));
+  return v;
+}
+
+inline uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+
+inline int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+inline void put_varint(std::vector<uint8_t>& buf, uint64_t v) {
+  while (v >= 0x80) {
+    buf.push_back(static_cast<uint8_t>(v) | 0x80);
+    v >>= 7;
+  }
+  buf.push_back(static_cast<uint8_t>(v));
+}
+
+inline const uint8_t* get_varint(const uint8_t* p, const uint8_t* end, uint64_t& v) {
+  v = 0;
+  for (int shift = 0; p < end && shift < 64; shift += 7) {
+    uint8_t b = *p++;
+    v |= static_cast<uint64_t>(b & 0x7f) << shift;
+    if ((b & 0x80) == 0) {
+      return p;
+    }
+  }
+  throw std::runtime_error("corrupted varint");
+}
+
+}  // namespace
+
+// ==================== ColumnWriter ====================
+
+#ifdef BOOST_ASIO_HAS_FILE
+struct ColumnWriter::AsyncFile {
+  AsyncFile(const boost::asio::any_io_executor& executor, const std::string& path)
+      : file(executor), path(path) {}
+
+  boost::asio::random_access_file file;
+  std::string path;
+  size_t pending = 0;         ///< 未完成的块写入
+  bool failed = false;        ///< 有块写入失败或被取消，不再写索引
+  bool closing = false;       ///< 已调用 close()，index 待写入
+  uint64_t index_offset = 0;  ///< 索引的写入位置
+  std::vector<uint8_t> index;
+};
+#endif
+
+ColumnWriter::ColumnWriter(const std::string& path, uint16_t columns, int64_t interval, uint32_t block_rows,
+                           boost::asio::any_io_executor executor)
+    : path_(path), ncols_(columns), interval_(interval), block_rows_(block_rows), pending_(columns) {
+  for (auto& col : pending_) {
+    col.reserve(block_rows_);
+  }
+
+  std::filesystem::create_directories(std::filesystem::path(path_).parent_path());
+
+  // 文件已存在时续写：读取已有块索引，截掉旧的尾部索引
+  bool resume = std::filesystem::exists(path_) && std::filesystem::file_size(path_) >= kFileHeaderSize;
+  if (resume) {
+    uint16_t ncols = 0;
+    int64_t file_interval = 0;
+    {
+      std::ifstream in(path_, std::ios::binary);
+      std::tie(index_, offset_) = ColumnReader::load_index(in, ncols, file_interval);
+    }
+    if (file_interval != interval_) {
+      throw std::runtime_error(fmt::format("column file {} schema mismatch", path_));
+    }
+    if (ncols != ncols_) {
+      // 列数变化（升级后Tick增加了列）时不能续写，旧文件改名保留，重新开始
+      auto moved = fmt::format("{}.{}cols", path_, ncols);
+      QLOG(WARNING, "column file {} has {} columns, expected {}, moved to {}", path_, ncols, ncols_, moved);
+      std::filesystem::rename(path_, moved);
+      index_.clear();
+      offset_ = 0;
+      resume = false;
+    } else {
+      std::filesystem::resize_file(path_, offset_);
+    }
+  }
+
+#ifdef BOOST_ASIO_HAS_FILE
+  if (executor) {
+    auto flags = boost::asio::file_base::write_only | boost::asio::file_base::create;
+    if (!resume) {
+      flags = flags | boost::asio::file_base::truncate;
+    }
+    boost::system::error_code ec;
+    file_ = std::make_shared<AsyncFile>(executor, path_);
+    file_->file.open(path_, flags, ec);
+    if (ec) {
+      throw std::runtime_error(fmt::format("open column file {} failed: {}", path_, ec.message()));
+    }
+  }
+  bool async = file_ != nullptr;
+#else
+  bool async = false;
+#endif
+
+  if (!async) {
+    if (resume) {
+      out_.open(path_, std::ios::binary | std::ios::in | std::ios::out);
+      out_.seekp(static_cast<std::streamoff>(offset_));
+    } else {
+      out_.open(path_, std::ios::binary | std::ios::trunc);
+    }
+    if (!out_) {
+      throw std::runtime_error(fmt::format("open column file {} failed", path_));
+    }
+  }
+
+  if (!resume) {
+    buffer_.clear();
+    put<uint32_t>(buffer_, kFileMagic);
+    put<uint16_t>(buffer_, kVersion);
+    put<uint16_t>(buffer_, ncols_);
+    put<int64_t>(buffer_, interval_);
+    put<uint64_t>(buffer_, 0);
+    write_sync();
+  }
+}
+
+ColumnWriter::~ColumnWriter() {
+  try {
+    close();
+  } catch (...) {
+  }
+}
+
+void ColumnWriter::append(const int64_t* row) {
+  for (uint16_t i = 0; i < ncols_; ++i) {
+    pending_[i].push_back(row[i]);
+  }
+  if (pending_[0].size() >= block_rows_) {
+    flush();
+  }
+}
+
+void ColumnWriter::flush() {
+  auto rows = pending_[0].size();
+  if (rows == 0 || closed_) {
+    return;
+  }
+
+  int64_t min_ts = pending_[0][0];
+  int64_t max_ts = pending_[0][0];
+  for (auto ts : pending_[0]) {
+    min_ts = std::min(min_ts, ts);
+    max_ts = std::max(max_ts, ts);
+  }
+
+  // 预留块头位置，先编码负载
+  buffer_.clear();
+  buffer_.resize(kBlockHeaderSize);
+  for (auto& col : pending_) {
+    int64_t prev = 0;
+    for (auto v : col) {
+      put_varint(buffer_, zigzag(v - prev));
+      prev = v;
+    }
+    col.clear();
+  }
+
+  uint32_t payload = static_cast<uint32_t>(buffer_.size() - kBlockHeaderSize);
+  uint8_t* h = buffer_.data();
+  std::memcpy(h, &kBlockMagic, 4);
+  uint32_t rows32 = static_cast<uint32_t>(rows);
+  std::memcpy(h + 4, &rows32, 4);
+  std::memcpy(h + 8, &min_ts, 8);
+  std::memcpy(h + 16, &max_ts, 8);
+  std::memcpy(h + 24, &payload, 4);
+  std::memset(h + 28, 0, 4);
+
+  uint64_t offset = offset_;
+  write_block();
+  index_.push_back({offset, rows32, min_ts, max_ts});
+}
+
+void ColumnWriter::close() {
+  if (closed_) {
+    return;
+  }
+  flush();
+
+  buffer_.clear();
+  for (auto& idx : index_) {
+    put<uint64_t>(buffer_, idx.offset);
+    put<uint32_t>(buffer_, idx.rows);
+    put<uint32_t>(buffer_, 0);
+    put<int64_t>(buffer_, idx.min_ts);
+    put<int64_t>(buffer_, idx.max_ts);
+  }
+  put<uint64_t>(buffer_, index_.size());
+  put<uint32_t>(buffer_, kIndexMagic);
+  put<uint32_t>(buffer_, 0);
+  closed_ = true;
+
+#ifdef BOOST_ASIO_HAS_FILE
+  if (file_) {
+    // 索引不能先于它指向的数据块落盘，由最后一次块写入的完成回调写入
+    file_->index = std::move(buffer_);
+    file_->index_offset = offset_;
+    file_->closing = true;
+    if (file_->pending == 0) {
+      finish_async(*file_);
+    }
+    file_.reset();
+    return;
+  }
+#endif
+  write_sync();
+  out_.close();
+}
+
+#ifdef BOOST_ASIO_HAS_FILE
+void ColumnWriter::finish_async(AsyncFile& state) {
+  if (state.failed) {
+    QLOG(ERROR, "column file {} closed without index after write failures", state.path);
+  } else {
+    boost::system::error_code ec;
+    boost::asio::write_at(state.file, state.index_offset, boost::asio::buffer(state.index), ec);
+    if (ec) {
+      QLOG(ERROR, "write column file {} index failed: {}", state.path, ec.message());
+    }
+  }
+  boost::system::error_code ec;
+  state.file.close(ec);
+}
+#endif
+
+void ColumnWriter::write_sync() {
+#ifdef BOOST_ASIO_HAS_FILE
+  if (file_) {
+    boost::asio::write_at(file_->file, offset_, boost::asio::buffer(buffer_));
+    offset_ += buffer_.size();
+    return;
+  }
+#endif
+  out_.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size());
+  offset_ += buffer_.size();
+}
+
+void ColumnWriter::write_block() {
+#ifdef BOOST_ASIO_HAS_FILE
+  if (file_) {
+    // 缓冲区交给写操作，完成前不能复用
+    auto block = std::make_shared<std::vector<uint8_t>>(std::move(buffer_));
+    buffer_ = std::vector<uint8_t>();
+    ++file_->pending;
+    boost::asio::async_write_at(file_->file, offset_, boost::asio::buffer(*block),
+                                [state = file_, block](boost::system::error_code ec, size_t) {
+                                  if (ec) {
+                                    QLOG(ERROR, "write column file {} failed: {}", state->path, ec.message());
+                                    state->failed = true;
+                                  }
+                                  if (--state->pending == 0 && state->closing) {
+                                    finish_async(*state);
+                                  }
+                                });
+    offset_ += block->size();
+    return;
+  }
+#endif
+  write_sync();
+  out_.flush();
+}
+
+// ==================== ColumnReader ====================
+
+ColumnReader::ColumnReader(const std::string& path) : in_(path, std::ios::binary) {
+  if (!in_) {
+    throw std::runtime_error(fmt::format("open column file {} failed", path));
+  }
+  index_ = load_index(in_, ncols_, interval_).first;
+}
+
+std::pair<std::vector<BlockIndex>, uint64_t> ColumnReader::load_index(std::ifstream& in, uint16_t& ncols,
+                                                                      int64_t& interval) {
+  in.seekg(0, std::ios::end);
+  uint64_t size = static_cast<uint64_t>(in.tellg());
+  if (size < kFileHeaderSize) {
+    throw std::runtime_error("column file too small");
+  }
+
+  uint8_t header[kFileHeaderSize];
+  in.seekg(0);
+  in.read(reinterpret_cast<char*>(header), kFileHeaderSize);
+  if (get<uint32_t>(header) != kFileMagic) {
+    throw std::runtime_error("bad column file magic");
+  }
+  ncols = get<uint16_t>(header + 6);
+  interval = get<int64_t>(header + 8);
+
+  std::vector<BlockIndex> index;
+
+  // 优先使用文件尾部的块索引
+  if (size >= kFileHeaderSize + kTrailerSize) {
+    uint8_t trailer[kTrailerSize];
+    in.seekg(size - kTrailerSize);
+    in.read(reinterpret_cast<char*>(trailer), kTrailerSize);
+    uint64_t count = get<uint64_t>(trailer);
+    if (get<uint32_t>(trailer + 8) == kIndexMagic && count * kIndexEntrySize + kTrailerSize <= size - kFileHeaderSize) {
+      uint64_t index_begin = size - kTrailerSize - count * kIndexEntrySize;
+      std::vector<uint8_t> buf(count * kIndexEntrySize);
+      in.seekg(index_begin);
+      in.read(reinterpret_cast<char*>(buf.data()), buf.size());
+      index.reserve(count);
+      for (uint64_t i = 0; i < count; ++i) {
+        const uint8_t* p = buf.data() + i * kIndexEntrySize;
+        index.push_back({get<uint64_t>(p), get<uint32_t>(p + 8), get<int64_t>(p + 16), get<int64_t>(p + 24)});
+      }
+
+      // 索引可能先于数据块落盘（异步写入未完成时进程退出），逐块核对块头，不一致时扫描重建
+      uint8_t bh[kBlockHeaderSize];
+      bool intact = true;
+      for (auto& idx : index) {
+        if (idx.offset < kFileHeaderSize || idx.offset + kBlockHeaderSize > index_begin) {
+          intact = false;
+          break;
+        }
+        in.seekg(idx.offset);
+        in.read(reinterpret_cast<char*>(bh), kBlockHeaderSize);
+        if (!in || get<uint32_t>(bh) != kBlockMagic || get<uint32_t>(bh + 4) != idx.rows ||
+            idx.offset + kBlockHeaderSize + get<uint32_t>(bh + 24) > index_begin) {
+          intact = false;
+          break;
+        }
+      }
+      if (intact) {
+        return {index, index_begin};
+      }
+      QLOG(WARNING, "column file index does not match its blocks, scanning block headers");
+      in.clear();
+      index.clear();
+    }
+  }
+
+  // 没有尾部索引，顺序扫描块头重建，遇到不完整的块即停止
+  uint64_t offset = kFileHeaderSize;
+  uint8_t bh[kBlockHeaderSize];
+  while (offset + kBlockHeaderSize <= size) {
+    in.seekg(offset);
+    in.read(reinterpret_cast<char*>(bh), kBlockHeaderSize);
+    if (get<uint32_t>(bh) != kBlockMagic) {
+      break;
+    }
+    uint64_t end = offset + kBlockHeaderSize + get<uint32_t>(bh + 24);
+    if (end > size) {
+      break;
+    }
+    index.push_back({offset, get<uint32_t>(bh + 4), get<int64_t>(bh + 8), get<int64_t>(bh + 16)});
+    offset = end;
+  }
+  in.clear();
+  return {index, offset};
+}
+
+void ColumnReader::seek(int64_t from_ms, int64_t to_ms) {
+  from_ms_ = from_ms;
+  to_ms_ = to_ms;
+  cursor_ = 0;
+}
+
+bool ColumnReader::next(ColumnBatch& batch) {
+  batch.rows = 0;
+  if (batch.columns.size() != ncols_) {
+    batch.columns.resize(ncols_);
+  }
+
+  while (cursor_ < index_.size()) {
+    const auto& idx = index_[cursor_++];
+    // 按块的时间范围剪枝
+    if (idx.max_ts < from_ms_ || idx.min_ts > to_ms_) {
+      continue;
+    }
+
+    uint8_t bh[kBlockHeaderSize];
+    in_.seekg(idx.offset);
+    in_.read(reinterpret_cast<char*>(bh), kBlockHeaderSize);
+    uint32_t payload = get<uint32_t>(bh + 24);
+    buffer_.resize(payload);
+    in_.read(reinterpret_cast<char*>(buffer_.data()), payload);
+    if (!in_) {
+      throw std::runtime_error("read column block failed");
+    }
+
+    const uint8_t* p = buffer_.data();
+    const uint8_t* end = p + payload;
+    for (auto& col : batch.columns) {
+      col.resize(idx.rows);
+      int64_t prev = 0;
+      for (uint32_t r = 0; r < idx.rows; ++r) {
+        uint64_t v;
+        p = get_varint(p, end, v);
+        prev += unzigzag(v);
+        col[r] = prev;
+      }
+    }
+
+    // 块完全在范围内时不需要逐行过滤
+    if (idx.min_ts >= from_ms_ && idx.max_ts <= to_ms_) {
+      batch.rows = idx.rows;
+    } else {
+      size_t out = 0;
+      auto& ts = batch.columns[0];
+      for (uint32_t r = 0; r < idx.rows; ++r) {
+        if (ts[r] < from_ms_ || ts[r] > to_ms_) {
+          continue;
+        }
+        if (out != r) {
+          for (auto& col : batch.columns) {
+            col[out] = col[r];
+          }
+        }
+        ++out;
+      }
+      batch.rows = out;
+    }
+
+    if (batch.rows > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace service::store
@@ -0,0 +1,172 @@
+#ifndef __SERVICE_STORE_COLUMN_FILE_H__
+#define __SERVICE_STORE_COLUMN_FILE_H__
+
+/**
+ * @file column_file.h
+ * @brief 按块组织的列式文件
+ *
+ * 文件格式：
+ * - 文件头：魔数、版本、列数、K线周期
+ * - 数据块：块头（行数、最小/最大时间戳、负载长度）+ 各列数据
+ *   每列先写首个值，之后写与前一行的差值，差值经zigzag后用varint编码
+ * - 块索引：每个块的偏移、行数、最小/最大时间戳，写在文件末尾
+ *
+ * 第0列固定为毫秒时间戳，其它列由上层（Tick/Bar）定义，均为定点数原始值。
+ * 文件尾部索引缺失时（进程异常退出），读取方会顺序扫描块头重建索引。
+ */
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/any_io_executor.hpp>
+
+namespace service::store {
+
+/// 数据块索引项
+struct BlockIndex {
+  uint64_t offset;  ///< 块头在文件中的偏移
+  uint32_t rows;    ///< 块内行数
+  int64_t min_ts;   ///< 块内最小时间戳（毫秒）
+  int64_t max_ts;   ///< 块内最大时间戳（毫秒）
+};
+
+/**
+ * @brief 列式数据批次，按列保存，重复使用避免逐行分配
+ */
+struct ColumnBatch {
+  size_t rows = 0;                            ///< 有效行数
+  std::vector<std::vector<int64_t>> columns;  ///< 各列数据
+};
+
+/**
+ * @brief 列式文件写入器
+ *
+ * 行数据先缓存在内存列中，攒满一个块后压缩写入文件；
+ * close() 时写入块索引。打开已存在的文件时会续写。
+ *
+ * 传入执行器且 asio 支持文件操作（BOOST_ASIO_HAS_FILE，Linux 下由 io_uring 实现）时，
+ * 数据块以 async_write_at 提交后立即返回，不在事件循环中等待磁盘写入；文件头同步写入。
+ * close() 时仍有未完成的块写入则推迟写索引，最后一次写完成后再同步写入并关闭文件；
+ * 有块写入失败或被取消（io_context 停止）时不写索引，读取方扫描块头恢复。
+ * 没有使用 io_uring 注册缓冲区：每个数据块的缓冲区交给写操作后不再复用，大小也不固定，
+ * 需要先改为固定大小的缓冲池才能注册。
+ */
+class ColumnWriter {
+ public:
+  /**
+   * @brief 构造函数
+   * @param path 文件路径
+   * @param columns 列数（含时间戳列）
+   * @param interval K线周期（秒），Tick数据为0
+   * @param block_rows 每块最大行数
+   * @param executor 非空时数据块异步写入，为空时使用 std::ofstream 同步写入
+   */
+  ColumnWriter(const std::string& path, uint16_t columns, int64_t interval, uint32_t block_rows = 4096,
+               boost::asio::any_io_executor executor = {});
+  ~ColumnWriter();
+
+  ColumnWriter(const ColumnWriter&) = delete;
+  ColumnWriter& operator=(const ColumnWriter&) = delete;
+
+  /**
+   * @brief 追加一行
+   * @param row 长度为列数的数组，row[0]为时间戳
+   */
+  void append(const int64_t* row);
+
+  /// 将缓存的行写成一个数据块
+  void flush();
+
+  /// 写入剩余数据和块索引并关闭文件
+  void close();
+
+  const std::string& path() const { return path_; }
+
+ private:
+  /// 同步写出 buffer_，写入位置前移
+  void write_sync();
+
+  /// 写出 buffer_ 中编码好的数据块，异步写入时交出缓冲区
+  void write_block();
+
+#ifdef BOOST_ASIO_HAS_FILE
+  /// 异步写入的文件及未完成写操作的状态，由写操作的完成回调共同持有
+  struct AsyncFile;
+
+  /// 块写入全部完成后写入索引并关闭文件
+  static void finish_async(AsyncFile& state);
+#endif
+
+  std::string path_;
+  uint16_t ncols_;
+  int64_t interval_;
+  uint32_t block_rows_;
+  bool closed_ = false;
+  uint64_t offset_ = 0;  ///< 下一次写入的偏移
+
+  std::ofstream out_;
+#ifdef BOOST_ASIO_HAS_FILE
+  std::shared_ptr<AsyncFile> file_;  ///< 异步写入时使用
+#endif
+  std::vector<std::vector<int64_t>> pending_;  ///< 待写入的列缓存
+  std::vector<uint8_t> buffer_;                ///< 编码缓冲区，重复使用
+  std::vector<BlockIndex> index_;              ///< 已写入块的索引
+};
+
+/**
+ * @brief 列式文件读取器
+ *
+ * 根据块索引跳过不在时间范围内的数据块，只解码命中的块。
+ */
+class ColumnReader {
+ public:
+  /**
+   * @brief 打开文件并加载块索引
+   * @param path 文件路径
+   * @throws std::runtime_error 文件不存在或格式错误
+   */
+  explicit ColumnReader(const std::string& path);
+
+  uint16_t columns() const { return ncols_; }
+  int64_t interval() const { return interval_; }
+  const std::vector<BlockIndex>& index() const { return index_; }
+
+  /**
+   * @brief 设置扫描的时间范围 [from_ms, to_ms]
+   */
+  void seek(int64_t from_ms, int64_t to_ms);
+
+  /**
+   * @brief 读取下一个命中的数据块
+   * @param batch 输出批次，容量会被复用
+   * @return bool 是否还有数据
+   */
+  bool next(ColumnBatch& batch);
+
+  /**
+   * @brief 读取文件的块索引
+   * 先读取文件尾部索引，缺失时扫描块头重建
+   * @return 块索引和最后一个完整块的结束偏移
+   */
+  static std::pair<std::vector<BlockIndex>, uint64_t> load_index(std::ifstream& in, uint16_t& ncols,
+                                                                 int64_t& interval);
+
+ private:
+  std::ifstream in_;
+  uint16_t ncols_ = 0;
+  int64_t interval_ = 0;
+  std::vector<BlockIndex> index_;
+
+  int64_t from_ms_ = 0;
+  int64_t to_ms_ = 0;
+  size_t cursor_ = 0;  ///< 下一个待检查的块
+
+  std::vector<uint8_t> buffer_;  ///< 块负载缓冲区，重复使用
+};
+
+}  // namespace service::store
+
+#endif  // __SERVICE_STORE_COLUMN_FILE_H__
@@ -0,0 +1,85 @@
+#include "recorder.h"
+
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+
+#include "utils/async_log.h"
+
+namespace service::store {
+
+Recorder::Recorder(engine::EnginePtr engine)
+    : engine_(engine), root_(store_config->path()), block_rows_(store_config->block_rows()) {}
+
+Recorder::~Recorder() {
+  for (auto& [key, writer] : tick_writers_) {
+    writer->close();
+  }
+  for (auto& [key, writer] : bar_writers_) {
+    writer->close();
+  }
+}
+
+asio::awaitable<void> Recorder::init() {
+  engine_->register_callback<engine::TickData>(engine::EventType::kTick,
+    std::bind(&Recorder::recv_tick, shared_from_this(), std::placeholders::_1));
+
+  engine_->register_callback<engine::BarData>(engine::EventType::kBar,
+    std::bind(&Recorder::recv_bar, shared_from_this(), std::placeholders::_1));
+
+  if (store_config->async_io()) {
+#ifdef BOOST_ASIO_HAS_FILE
+    executor_ = co_await asio::this_coro::executor;
+#else
+    QLOG(WARNING, "store async_io needs BOOST_ASIO_HAS_FILE, fall back to synchronous writes");
+#endif
+  }
+  co_return;
+}
+
+asio::awaitable<void> Recorder::run() {
+  auto executor = co_await asio::this_coro::executor;
+  asio::steady_timer timer(executor);
+
+  // 定期把未满的块写入磁盘
+  while (true) {
+    timer.expires_after(std::chrono::seconds(store_config->flush_interval_s()));
+    co_await timer.async_wait(asio::use_awaitable);
+    for (auto& [key, writer] : tick_writers_) {
+      writer->flush();
+    }
+    for (auto& [key, writer] : bar_writers_) {
+      writer->flush();
+    }
+  }
+}
+
+asio::awaitable<void> Recorder::recv_tick(engine::TickDataPtr tick) {
+  auto key = fmt::format("{}/{}", tick->exchange, tick->symbol);
+  auto it = tick_writers_.find(key);
+  if (it == tick_writers_.end()) {
+    it = tick_writers_
+             .emplace(key, std::make_unique<TickWriter>(root_, tick->exchange, tick->symbol, 0, block_rows_, executor_))
+             .first;
+  }
+  it->second->append(*tick);
+  co_return;
+}
+
+asio::awaitable<void> Recorder::recv_bar(engine::BarDataPtr bar) {
+  if (bar->history) {
+    co_return;
+  }
+
+  auto key = fmt::format("{}/{}/{}", bar->exchange, bar->symbol, bar->interval);
+  auto it = bar_writers_.find(key);
+  if (it == bar_writers_.end()) {
+    it = bar_writers_
+             .emplace(key, std::make_unique<BarWriter>(root_, bar->exchange, bar->symbol, bar->interval, block_rows_,
+                                                       executor_))
+             .first;
+  }
+  it->second->append(*bar);
+  co_return;
+}
+
+}  // namespace service::store
@@ -0,0 +1,93 @@
+#ifndef __SERVICE_STORE_RECORDER_H__
+#define __SERVICE_STORE_RECORDER_H__
+
+/**
+ * @file recorder.h
+ * @brief 行情落盘组件
+ *
+ * 订阅引擎中的Tick和K线事件，写入列式存储，供研究和回测使用。
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "config/config.h"
+#include "engine.h"
+#include "tick_store.h"
+
+namespace service::store {
+
+class StoreConfig : public Config::ConfigTree {
+ public:
+  StoreConfig() : ConfigTree("store") {}
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+    m_enable = this->get<bool>("enable", false);
+    m_path = this->get<std::string>("path", "data");
+    m_block_rows = this->get<uint32_t>("block_rows", 4096);
+    m_flush_interval_s = this->get<uint32_t>("flush_interval_s", 5);
+    m_async_io = this->get<bool>("async_io", false);
+  }
+
+  bool enable() const { return m_enable; }
+  std::string path() const { return m_path; }
+  uint32_t block_rows() const { return m_block_rows; }
+  uint32_t flush_interval_s() const { return m_flush_interval_s; }
+
+  /// 数据块经 asio 文件（io_uring）异步写入，需要编译时支持 BOOST_ASIO_HAS_FILE
+  bool async_io() const { return m_async_io; }
+
+ private:
+  bool m_enable = false;
+  std::string m_path;
+  uint32_t m_block_rows = 4096;
+  uint32_t m_flush_interval_s = 5;
+  bool m_async_io = false;
+};
+
+#define store_config ::Common::SingletonPtr<::service::store::StoreConfig>::get_instance()
+
+/**
+ * @brief 行情记录组件
+ *
+ * 每个 交易所+交易对 维护一个写入器，定期把未满的数据块刷到磁盘，
+ * 进程异常退出时最多丢失一个刷新周期的数据。
+ */
+class Recorder : public std::enable_shared_from_this<Recorder>, public engine::Component {
+ public:
+  Recorder(engine::EnginePtr engine);
+  ~Recorder();
+
+  /**
+   * @brief 注册Tick和K线事件回调
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> init() override;
+
+  /**
+   * @brief 定期刷新写入器
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> run() override;
+
+  /// 记录一条Tick数据
+  asio::awaitable<void> recv_tick(engine::TickDataPtr tick);
+
+  /// 记录一根实时K线，回补的历史K线不重复写入
+  asio::awaitable<void> recv_bar(engine::BarDataPtr bar);
+
+ private:
+  engine::EnginePtr engine_;
+  std::string root_;
+  uint32_t block_rows_;
+  asio::any_io_executor executor_;  ///< 异步写入时传给写入器，同步写入时为空
+
+  std::map<std::string, std::unique_ptr<TickWriter>> tick_writers_;  ///< key: exchange/symbol
+  std::map<std::string, std::unique_ptr<BarWriter>> bar_writers_;    ///< key: exchange/symbol/interval
+};
+
+}  // namespace service::store
+
+#endif  // __SERVICE_STORE_RECORDER_H__
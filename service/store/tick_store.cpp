@@ -0,0 +1,73 @@
+#include "tick_store.h"
+
+#include <ctime>
+
+#include "utils/fixed_point.hpp"
+
+namespace service::store {
+
+using Common::Fixed;
+
+namespace {
+
+inline int64_t to_raw(const dec_float& v) { return Fixed::from_dec(v).raw(); }
+
+inline dec_float from_raw(int64_t v) { return Fixed::from_raw(v).to_dec(); }
+
+}  // namespace
+
+std::string series_path(const std::string& root, const std::string& exchange, const std::string& symbol, int64_t day,
+                        const std::string& suffix) {
+  std::time_t t = static_cast<std::time_t>(day * (kDayMs / 1000));
+  std::tm tm;
+  gmtime_r(&t, &tm);
+  char date[sizeof "20250101"];
+  strftime(date, sizeof date, "%Y%m%d", &tm);
+  return fmt::format("{}/{}/{}/{}.{}", root, exchange, symbol, date, suffix);
+}
+
+void TickCodec::encode(const Data& data, int64_t* row) {
+  row[0] = data.timestamp_ms;
+  row[1] = to_raw(data.last_price);
+  row[2] = to_raw(data.last_volume);
+  row[3] = to_raw(data.turnover);
+  row[4] = to_raw(data.open_price);
+  row[5] = to_raw(data.high_price);
+  row[6] = to_raw(data.low_price);
+  row[7] = to_raw(data.last_close_price);
+  row[8] = to_raw(data.volume_24h);
+}
+
+void TickCodec::decode(const ColumnBatch& batch, size_t i, Data& data) {
+  auto& c = batch.columns;
+  data.timestamp_ms = c[0][i];
+  data.last_price = from_raw(c[1][i]);
+  data.last_volume = from_raw(c[2][i]);
+  data.turnover = from_raw(c[3][i]);
+  data.open_price = from_raw(c[4][i]);
+  data.high_price = from_raw(c[5][i]);
+  data.low_price = from_raw(c[6][i]);
+  data.last_close_price = from_raw(c[7][i]);
+  data.volume_24h = c.size() > 8 ? from_raw(c[8][i]) : dec_float();
+}
+
+void BarCodec::encode(const Data& data, int64_t* row) {
+  row[0] = data.timestamp_ms;
+  row[1] = to_raw(data.open_price);
+  row[2] = to_raw(data.high_price);
+  row[3] = to_raw(data.low_price);
+  row[4] = to_raw(data.close_price);
+  row[5] = to_raw(data.volume);
+}
+
+void BarCodec::decode(const ColumnBatch& batch, size_t i, Data& data) {
+  auto& c = batch.columns;
+  data.timestamp_ms = c[0][i];
+  data.open_price = from_raw(c[1][i]);
+  data.high_price = from_raw(c[2][i]);
+  data.low_price = from_raw(c[3][i]);
+  data.close_price = from_raw(c[4][i]);
+  data.volume = from_raw(c[5][i]);
+}
+
+}  // namespace service::store
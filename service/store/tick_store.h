@@ -0,0 +1,235 @@
+#ifndef __SERVICE_STORE_TICK_STORE_H__
+#define __SERVICE_STORE_TICK_STORE_H__
+
+/**
+ * @file tick_store.h
+ * @brief 历史Tick/K线列式存储
+ *
+ * 按 交易所/交易对/日期 分文件保存：
+ *   {root}/{exchange}/{symbol}/{YYYYMMDD}.tick
+ *   {root}/{exchange}/{symbol}/{YYYYMMDD}.bar{interval}
+ * 价格、数量以定点数原始值入库，经差分+varint压缩。
+ * 读取接口按批次返回 TickData/BarData，批次对象可重复使用，不做逐行分配。
+ */
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "column_file.h"
+#include "object.h"
+
+namespace service::store {
+
+/// 一天的毫秒数
+constexpr int64_t kDayMs = 86400000;
+
+/**
+ * @brief 生成某天数据文件的路径
+ * @param root 存储根目录
+ * @param exchange 交易所
+ * @param symbol 交易对
+ * @param day 自1970-01-01起的天数（UTC）
+ * @param suffix 文件后缀，如"tick"、"bar60"
+ */
+std::string series_path(const std::string& root, const std::string& exchange, const std::string& symbol, int64_t day,
+                        const std::string& suffix);
+
+/// Tick数据编解码：时间戳、最新价、最新量、成交额、开、高、低、昨收、24小时成交量
+/// 24小时成交量用于区分包含新成交的Tick和只有盘口变化的Tick，旧的8列文件读出为0
+struct TickCodec {
+  using Data = engine::TickData;
+  static constexpr uint16_t kColumns = 9;
+
+  static std::string suffix(int64_t interval) { return "tick"; }
+  static void prepare(Data& data, int64_t interval) {}
+  static void encode(const Data& data, int64_t* row);
+  static void decode(const ColumnBatch& batch, size_t i, Data& data);
+};
+
+/// K线数据编解码：时间戳、开、高、低、收、成交量
+struct BarCodec {
+  using Data = engine::BarData;
+  static constexpr uint16_t kColumns = 6;
+
+  static std::string suffix(int64_t interval) { return fmt::format("bar{}", interval); }
+  static void prepare(Data& data, int64_t interval) { data.interval = interval; }
+  static void encode(const Data& data, int64_t* row);
+  static void decode(const ColumnBatch& batch, size_t i, Data& data);
+};
+
+/**
+ * @brief 读取批次
+ *
+ * rows_ 只增不减，读取下一批时原地覆盖，避免逐行分配。
+ * 需要更高性能的研究代码可以直接使用 raw() 访问定点数列。
+ */
+template <typename Data>
+class DataBatch {
+ public:
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const Data& operator[](size_t i) const { return rows_[i]; }
+  typename std::vector<Data>::const_iterator begin() const { return rows_.begin(); }
+  typename std::vector<Data>::const_iterator end() const { return rows_.begin() + size_; }
+
+  /// 原始列数据（定点数原始值，第0列为时间戳）
+  const ColumnBatch& raw() const { return columns_; }
+
+ private:
+  template <typename>
+  friend class SeriesReader;
+
+  std::vector<Data> rows_;
+  size_t size_ = 0;
+  ColumnBatch columns_;
+};
+
+typedef DataBatch<engine::TickData> TickBatch;
+typedef DataBatch<engine::BarData> BarBatch;
+
+/**
+ * @brief 单个交易对的时间序列写入器，按UTC日期自动切换文件
+ */
+template <typename Codec>
+class SeriesWriter {
+ public:
+  /// executor 非空时数据块异步写入，见 ColumnWriter
+  SeriesWriter(const std::string& root, const std::string& exchange, const std::string& symbol, int64_t interval = 0,
+               uint32_t block_rows = 4096, boost::asio::any_io_executor executor = {})
+      : root_(root),
+        exchange_(exchange),
+        symbol_(symbol),
+        interval_(interval),
+        block_rows_(block_rows),
+        executor_(executor) {}
+
+  /// 追加一条数据，跨天时关闭旧文件并打开新文件
+  void append(const typename Codec::Data& data) {
+    int64_t day = data.timestamp_ms / kDayMs;
+    if (!writer_ || day != day_) {
+      if (writer_) {
+        writer_->close();
+      }
+      day_ = day;
+      writer_ = std::make_unique<ColumnWriter>(
+          series_path(root_, exchange_, symbol_, day_, Codec::suffix(interval_)), Codec::kColumns, interval_,
+          block_rows_, executor_);
+    }
+    Codec::encode(data, row_);
+    writer_->append(row_);
+  }
+
+  /// 将缓存数据写成数据块
+  void flush() {
+    if (writer_) {
+      writer_->flush();
+    }
+  }
+
+  /// 关闭当前文件，写入块索引
+  void close() {
+    if (writer_) {
+      writer_->close();
+      writer_.reset();
+    }
+  }
+
+ private:
+  std::string root_;
+  std::string exchange_;
+  std::string symbol_;
+  int64_t interval_;
+  uint32_t block_rows_;
+  boost::asio::any_io_executor executor_;
+
+  int64_t day_ = -1;
+  int64_t row_[Codec::kColumns];
+  std::unique_ptr<ColumnWriter> writer_;
+};
+
+/**
+ * @brief 单个交易对的时间序列读取器，跨天顺序扫描 [from_ms, to_ms]
+ */
+template <typename Codec>
+class SeriesReader {
+ public:
+  SeriesReader(const std::string& root, const std::string& exchange, const std::string& symbol, int64_t from_ms,
+               int64_t to_ms, int64_t interval = 0)
+      : root_(root),
+        exchange_(exchange),
+        symbol_(symbol),
+        interval_(interval),
+        from_ms_(from_ms),
+        to_ms_(to_ms),
+        day_(from_ms / kDayMs) {}
+
+  /**
+   * @brief 读取下一批数据
+   * @param batch 输出批次，会被原地覆盖
+   * @return bool 是否读到数据，false表示范围内数据已读完
+   */
+  bool next(DataBatch<typename Codec::Data>& batch) {
+    batch.size_ = 0;
+    while (true) {
+      if (!reader_ && !open_next()) {
+        return false;
+      }
+      if (!reader_->next(batch.columns_)) {
+        reader_.reset();
+        continue;
+      }
+
+      auto rows = batch.columns_.rows;
+      if (batch.rows_.size() < rows) {
+        batch.rows_.resize(rows);
+      }
+      for (size_t i = 0; i < rows; ++i) {
+        auto& item = batch.rows_[i];
+        if (item.symbol != symbol_) {
+          item.symbol = symbol_;
+          item.exchange = exchange_;
+          Codec::prepare(item, interval_);
+        }
+        Codec::decode(batch.columns_, i, item);
+      }
+      batch.size_ = rows;
+      return true;
+    }
+  }
+
+ private:
+  /// 打开下一个存在的日文件
+  bool open_next() {
+    for (; day_ <= to_ms_ / kDayMs; ++day_) {
+      auto path = series_path(root_, exchange_, symbol_, day_, Codec::suffix(interval_));
+      if (!std::filesystem::exists(path)) {
+        continue;
+      }
+      reader_ = std::make_unique<ColumnReader>(path);
+      reader_->seek(from_ms_, to_ms_);
+      ++day_;
+      return true;
+    }
+    return false;
+  }
+
+  std::string root_;
+  std::string exchange_;
+  std::string symbol_;
+  int64_t interval_;
+  int64_t from_ms_;
+  int64_t to_ms_;
+  int64_t day_;
+  std::unique_ptr<ColumnReader> reader_;
+};
+
+typedef SeriesWriter<TickCodec> TickWriter;
+typedef SeriesWriter<BarCodec> BarWriter;
+typedef SeriesReader<TickCodec> TickReader;
+typedef SeriesReader<BarCodec> BarReader;
+
+}  // namespace service::store
+
+#endif  // __SERVICE_STORE_TICK_STORE_H__
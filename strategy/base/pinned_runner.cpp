@@ -0,0 +1,155 @@
+#include "pinned_runner.h"
+
+#include "strategy.h"
+#include "utils/async_log.h"
+#include "utils/latency.h"
+
+namespace strategy::base {
+
+PinnedRunner::PinnedRunner(engine::EnginePtr engine, std::shared_ptr<Strategy> strategy, int cpu, size_t queue_size)
+    : engine_(engine),
+      strategy_(strategy),
+      cpu_(cpu),
+      work_(asio::make_work_guard(ctx_)),
+      timers_(engine::Engine::steady_now_ms()),
+      inbound_(queue_size),
+      outbound_(queue_size) {
+  strategy_->_pinned = this;
+  inbound_full_ = &metrics_registry.counter("qitrader_pinned_queue_full_total",
+                                            "Pinned strategy queue full events by direction", "queue=\"inbound\"");
+  outbound_full_ = &metrics_registry.counter("qitrader_pinned_queue_full_total",
+                                             "Pinned strategy queue full events by direction", "queue=\"outbound\"");
+  metrics_registry.gauge_fn("qitrader_pinned_inbound_depth", "Events waiting for the pinned strategy thread",
+                            [this] { return double(inbound_.size()); });
+  inbound_backlog_gauge_ = &metrics_registry.gauge("qitrader_pinned_inbound_backlog",
+                                                   "Events buffered on the engine thread while the inbound queue is full");
+}
+
+PinnedRunner::~PinnedRunner() {
+  running_ = false;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+asio::awaitable<void> PinnedRunner::init() {
+  // 唤醒通道在引擎执行器上接收，需要在策略初始化发出请求前创建
+  wake_ = std::make_unique<asio::experimental::concurrent_channel<void(boost::system::error_code)>>(
+      co_await asio::this_coro::executor, 1);
+  co_await strategy_->init();
+
+  running_ = true;
+  thread_ = std::thread(&PinnedRunner::loop, this);
+  QLOG(INFO, "pinned strategy thread started, cpu {}, queue {}", cpu_, inbound_.capacity());
+}
+
+asio::awaitable<void> PinnedRunner::run() {
+  asio::co_spawn(ctx_, [strategy = strategy_]() -> asio::awaitable<void> {
+    try {
+      co_await strategy->run();
+    } catch (std::exception& e) {
+      QLOG(ERROR, "pinned strategy run error: {}", e.what());
+    } catch (...) {
+      QLOG(ERROR, "pinned strategy run error: unknown error");
+    }
+  }, asio::detached);
+
+  // 先取走唤醒再取队列，策略线程在取完之后写入的请求会重新唤醒
+  Outbound outbound;
+  while (true) {
+    co_await wake_->async_receive(asio::use_awaitable);
+    while (outbound_.try_pop(outbound)) {
+      co_await engine_->on_event(outbound.type, std::move(outbound.data));
+    }
+  }
+}
+
+asio::awaitable<void> PinnedRunner::deliver(std::shared_ptr<const engine::BaseData> data, Dispatch dispatch) {
+  Inbound inbound{std::move(data), dispatch, Common::now_ns()};
+  // 已有积压时排在积压之后，保证策略按引擎分发的顺序收到事件
+  if (inbound_backlog_.empty() && inbound_.try_push(std::move(inbound))) {
+    co_return;
+  }
+  inbound_backlog_.push_back(std::move(inbound));
+  inbound_backlog_gauge_->set(double(inbound_backlog_.size()));
+  if (inbound_backlog_.size() == 1) {
+    asio::co_spawn(co_await asio::this_coro::executor, flush_inbound(shared_from_this()), asio::detached);
+  }
+}
+
+asio::awaitable<void> PinnedRunner::flush_inbound(std::shared_ptr<PinnedRunner> self) {
+  // 唯一的写入方，按积压顺序写入；队列满时让出引擎执行器，不阻塞网关和其他组件
+  auto& backlog = self->inbound_backlog_;
+  while (!backlog.empty()) {
+    if (!self->inbound_.try_push(std::move(backlog.front()))) {
+      self->inbound_full_->inc();
+      co_await asio::post(co_await asio::this_coro::executor, asio::use_awaitable);
+      continue;
+    }
+    backlog.pop_front();
+    self->inbound_backlog_gauge_->set(double(backlog.size()));
+  }
+}
+
+asio::awaitable<void> PinnedRunner::emit(engine::EventType type, std::shared_ptr<const engine::BaseData> data) {
+  Outbound outbound{type, std::move(data)};
+  // 与 deliver 相同，策略先后发出的下单和撤单请求按顺序交给引擎
+  if (!outbound_backlog_.empty() || !outbound_.try_push(std::move(outbound))) {
+    outbound_backlog_.push_back(std::move(outbound));
+    if (outbound_backlog_.size() == 1) {
+      asio::co_spawn(ctx_, flush_outbound(), asio::detached);
+    }
+    co_return;
+  }
+  // 已有未处理的唤醒时写入失败，引擎线程处理那次唤醒时会取到本条
+  wake_->try_send(boost::system::error_code());
+}
+
+asio::awaitable<void> PinnedRunner::flush_outbound() {
+  while (!outbound_backlog_.empty()) {
+    if (!outbound_.try_push(std::move(outbound_backlog_.front()))) {
+      outbound_full_->inc();
+      co_await asio::post(ctx_, asio::use_awaitable);
+      continue;
+    }
+    outbound_backlog_.pop_front();
+    wake_->try_send(boost::system::error_code());
+  }
+}
+
+void PinnedRunner::loop() {
+  if (cpu_ >= 0 && !Common::pin_current_thread(cpu_)) {
+    QLOG(WARNING, "failed to pin strategy thread to cpu {}", cpu_);
+  }
+
+  Inbound inbound;
+  while (running_.load(std::memory_order_relaxed)) {
+    bool idle = true;
+    while (inbound_.try_pop(inbound)) {
+      latency_stats.record_since(Common::LatencyStage::kStrategyQueue, inbound.enqueue_ns);
+      asio::co_spawn(ctx_, invoke(strategy_, std::move(inbound)), asio::detached);
+      idle = false;
+    }
+    if (timers_.advance(engine::Engine::steady_now_ms()) > 0) {
+      idle = false;
+    }
+    if (ctx_.poll() > 0) {
+      idle = false;
+    }
+    if (idle) {
+      Common::cpu_relax();
+    }
+  }
+}
+
+asio::awaitable<void> PinnedRunner::invoke(std::shared_ptr<Strategy> strategy, Inbound inbound) {
+  try {
+    co_await inbound.dispatch(*strategy, std::move(inbound.data));
+  } catch (std::exception& e) {
+    QLOG(ERROR, "pinned strategy callback error: {}", e.what());
+  } catch (...) {
+    QLOG(ERROR, "pinned strategy callback error: unknown error");
+  }
+}
+
+}  // namespace strategy::base
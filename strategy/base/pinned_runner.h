@@ -0,0 +1,165 @@
+#ifndef __STRATEGY_BASE_PINNED_RUNNER_H__
+#define __STRATEGY_BASE_PINNED_RUNNER_H__
+
+/**
+ * @file pinned_runner.h
+ * @brief 在独立线程上运行策略
+ *
+ * 默认策略与网关的TLS、JSON解析和日志共用引擎所在的 io_context，信号计算的延迟会受到IO抖动影响。
+ * 开启后策略运行在一个绑核、忙轮询的独立线程上：
+ * - 引擎线程把策略订阅的事件写入输入队列，策略线程取出后在自己的 io_context 上执行回调
+ * - 策略发出的下单、订阅等请求写入输出队列，由引擎线程取出后发给引擎
+ * - 两个方向都是单生产者单消费者的无锁环形队列
+ * - 队列满时写入方把元素按顺序放入本线程的积压缓冲，由一个协程依次写入队列，事件和请求不会乱序
+ * - 策略的定时器使用策略线程自己的时间轮，不访问引擎的时间轮
+ */
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <thread>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/experimental/concurrent_channel.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include "config/config.h"
+#include "engine.h"
+#include "utils/metrics.h"
+#include "utils/spsc_queue.hpp"
+
+namespace strategy::base {
+
+class Strategy;
+
+class PinnedConfig : public Config::ConfigTree {
+ public:
+  PinnedConfig() : ConfigTree("pinned") {}
+
+  void load(std::shared_ptr<Config::ptree> pt) override {
+    m_ptree = pt;
+    m_enable = this->get<bool>("enable", false);
+    m_cpu = this->get<int>("cpu", -1);
+    m_queue_size = this->get<size_t>("queue_size", 4096);
+  }
+
+  bool enable() const { return m_enable; }
+
+  /// 策略线程绑定的CPU核，-1 表示不绑定
+  int cpu() const { return m_cpu; }
+
+  /// 输入、输出队列的容量
+  size_t queue_size() const { return m_queue_size; }
+
+ private:
+  bool m_enable = false;
+  int m_cpu = -1;
+  size_t m_queue_size = 4096;
+};
+
+#define pinned_config ::Common::SingletonPtr<::strategy::base::PinnedConfig>::get_instance()
+
+/**
+ * @brief 策略线程运行器
+ *
+ * 作为组件代替策略注册到引擎：init 时初始化策略并启动策略线程，run 时把策略的 run 交给策略线程执行。
+ */
+class PinnedRunner : public std::enable_shared_from_this<PinnedRunner>, public engine::Component {
+ public:
+  /// 在策略线程上调用策略回调，由 Strategy 按事件类型生成
+  typedef asio::awaitable<void> (*Dispatch)(Strategy& strategy, std::shared_ptr<const engine::BaseData> data);
+
+  /**
+   * @param engine 引擎指针
+   * @param strategy 在独立线程上运行的策略
+   * @param cpu 绑定的CPU核，-1 表示不绑定
+   * @param queue_size 输入、输出队列的容量
+   */
+  PinnedRunner(engine::EnginePtr engine, std::shared_ptr<Strategy> strategy, int cpu, size_t queue_size);
+  ~PinnedRunner();
+
+  /**
+   * @brief 初始化策略并启动策略线程
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> init() override;
+
+  /**
+   * @brief 在策略线程上启动策略的 run，并持续把输出队列中的请求发给引擎
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> run() override;
+
+  /**
+   * @brief 把事件交给策略线程，在引擎线程调用；队列满或已有积压时放入积压缓冲，不等待
+   * @param data 事件数据
+   * @param dispatch 策略回调
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> deliver(std::shared_ptr<const engine::BaseData> data, Dispatch dispatch);
+
+  /**
+   * @brief 把请求交给引擎，在策略线程调用；队列满或已有积压时放入积压缓冲，不等待
+   * @param type 事件类型
+   * @param data 事件数据
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> emit(engine::EventType type, std::shared_ptr<const engine::BaseData> data);
+
+  /// 策略线程的时间轮，只能在策略线程访问
+  engine::TimerWheel& timers() { return timers_; }
+
+ private:
+  /// 输入队列元素
+  struct Inbound {
+    std::shared_ptr<const engine::BaseData> data;
+    Dispatch dispatch = nullptr;
+    int64_t enqueue_ns = 0;
+  };
+
+  /// 输出队列元素
+  struct Outbound {
+    engine::EventType type = engine::EventType::kQuit;
+    std::shared_ptr<const engine::BaseData> data;
+  };
+
+  /// 策略线程主循环
+  void loop();
+
+  /// 执行一个策略回调，异常记录后丢弃，不影响策略线程
+  static asio::awaitable<void> invoke(std::shared_ptr<Strategy> strategy, Inbound inbound);
+
+  /// 在引擎执行器上把输入积压依次写入输入队列，队列满时让出执行器后重试
+  static asio::awaitable<void> flush_inbound(std::shared_ptr<PinnedRunner> self);
+
+  /// 在策略线程上把输出积压依次写入输出队列，队列满时让出执行器后重试
+  asio::awaitable<void> flush_outbound();
+
+  engine::EnginePtr engine_;
+  std::shared_ptr<Strategy> strategy_;
+  int cpu_;
+
+  asio::io_context ctx_;  ///< 策略线程的执行器
+  asio::executor_work_guard<asio::io_context::executor_type> work_;
+  engine::TimerWheel timers_;
+
+  Common::SpscQueue<Inbound> inbound_;    ///< 引擎线程 -> 策略线程
+  Common::SpscQueue<Outbound> outbound_;  ///< 策略线程 -> 引擎线程
+
+  std::deque<Inbound> inbound_backlog_;    ///< 输入队列满时的积压，只在引擎线程访问
+  std::deque<Outbound> outbound_backlog_;  ///< 输出队列满时的积压，只在策略线程访问
+
+  /// 输出队列有新请求时唤醒引擎线程，容量为1，已有未处理的唤醒时不再写入
+  std::unique_ptr<asio::experimental::concurrent_channel<void(boost::system::error_code)>> wake_;
+
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+
+  Common::Counter* inbound_full_ = nullptr;
+  Common::Counter* outbound_full_ = nullptr;
+  Common::Gauge* inbound_backlog_gauge_ = nullptr;
+};
+
+}  // namespace strategy::base
+
+#endif  // __STRATEGY_BASE_PINNED_RUNNER_H__
@@ -1,5 +1,7 @@
 #include "strategy.h"
 
+#include "pinned_runner.h"
+
 namespace strategy::base {
 
 Strategy::Strategy(engine::EnginePtr engine) : _engine(engine) {
@@ -7,60 +9,146 @@ Strategy::Strategy(engine::EnginePtr engine) : _engine(engine) {
 
 Strategy::~Strategy() {}
 
+template <typename EventDataType, asio::awaitable<void> (Strategy::*Handler)(std::shared_ptr<const EventDataType>)>
+void Strategy::listen(engine::EventType type) {
+  _engine->register_callback<EventDataType>(type,
+    [self = shared_from_this()](std::shared_ptr<const EventDataType> data) -> asio::awaitable<void> {
+      if (self->_pinned) {
+        return self->_pinned->deliver(std::move(data), &Strategy::dispatch<EventDataType, Handler>);
+      }
+      return ((*self).*Handler)(std::move(data));
+    });
+}
+
+template <typename EventDataType, asio::awaitable<void> (Strategy::*Handler)(std::shared_ptr<const EventDataType>)>
+asio::awaitable<void> Strategy::dispatch(Strategy& strategy, std::shared_ptr<const engine::BaseData> data) {
+  return (strategy.*Handler)(std::static_pointer_cast<const EventDataType>(std::move(data)));
+}
+
 // 初始化策略，注册各类事件的回调函数
 asio::awaitable<void> Strategy::init() {
   // 注册账户数据事件回调
-  _engine->register_callback<engine::AccountData>(engine::EventType::kAccount,
-    std::bind(&Strategy::recv_account, shared_from_this(), std::placeholders::_1));
+  listen<engine::AccountData, &Strategy::recv_account>(engine::EventType::kAccount);
 
   // 注册持仓数据事件回调
-  _engine->register_callback<engine::PositionData>(engine::EventType::kPosition,
-    std::bind(&Strategy::recv_position, shared_from_this(), std::placeholders::_1));
+  listen<engine::PositionData, &Strategy::recv_position>(engine::EventType::kPosition);
 
   // 注册订单簿数据事件回调
-  _engine->register_callback<engine::Book>(engine::EventType::kBook,
-    std::bind(&Strategy::recv_book, shared_from_this(), std::placeholders::_1));
+  listen<engine::Book, &Strategy::recv_book>(engine::EventType::kBook);
 
   // 注册Tick数据事件回调
-  _engine->register_callback<engine::TickData>(engine::EventType::kTick,
-    std::bind(&Strategy::recv_tick, shared_from_this(), std::placeholders::_1));
+  listen<engine::TickData, &Strategy::recv_tick>(engine::EventType::kTick);
   
+  // 注册K线收盘事件回调
+  listen<engine::BarData, &Strategy::recv_bar>(engine::EventType::kBar);
+
   // 注册订单数据事件回调
-  _engine->register_callback<engine::OrderData>(engine::EventType::kOrder,
-    std::bind(&Strategy::recv_order, shared_from_this(), std::placeholders::_1));
+  listen<engine::OrderData, &Strategy::recv_order>(engine::EventType::kOrder);
+
+  // 注册市场逐笔成交事件回调
+  listen<engine::TradeData, &Strategy::recv_trade>(engine::EventType::kTrade);
+
+  // 注册本账户成交事件回调
+  listen<engine::TradeData, &Strategy::recv_fill>(engine::EventType::kFill);
+
+  // 注册接口限速额度事件回调
+  listen<engine::RateLimitData, &Strategy::recv_rate_limit>(engine::EventType::kRateLimit);
+
+  // 注册跨交易所合并最优买卖价事件回调
+  listen<engine::ConsolidatedQuote, &Strategy::recv_consolidated_quote>(engine::EventType::kConsolidatedQuote);
+
+  // 注册母单状态事件回调
+  listen<engine::OrderData, &Strategy::recv_parent_order>(engine::EventType::kParentOrder);
+
+  // 注册算法单状态事件回调
+  listen<engine::AlgoStatusData, &Strategy::recv_algo_status>(engine::EventType::kAlgoStatus);
   
   co_return;
 }
 
 asio::awaitable<void> Strategy::on_message(engine::MessageDataPtr msg) {
-  return _engine->on_event(engine::EventType::kMessage, msg);
+  return emit(engine::EventType::kMessage, msg);
 }
 
 asio::awaitable<void> Strategy::on_request_account() {
-  return _engine->on_event(engine::EventType::kQueryAccount, std::make_shared<engine::QueryAccountData>());
+  return emit(engine::EventType::kQueryAccount, std::make_shared<engine::QueryAccountData>());
 }
 
 asio::awaitable<void> Strategy::on_request_position() {
-  return _engine->on_event(engine::EventType::kQueryPosition, std::make_shared<engine::QueryPositionData>());
+  return emit(engine::EventType::kQueryPosition, std::make_shared<engine::QueryPositionData>());
 }
 
 // 订阅指定交易对的订单簿数据
-asio::awaitable<void> Strategy::on_subscribe_book(const std::string& symbol) {
+asio::awaitable<void> Strategy::on_subscribe_book(const std::string& symbol, uint32_t depth, bool tick_by_tick) {
   auto book = std::make_shared<engine::SubscribeData>();
   book->symbol = symbol;
-  return _engine->on_event(engine::EventType::kSubscribeBook, book);
+  book->depth = depth;
+  book->tick_by_tick = tick_by_tick;
+  return emit(engine::EventType::kSubscribeBook, book);
 }
 
 // 订阅指定交易对的Tick数据
 asio::awaitable<void> Strategy::on_subscribe_tick(const std::string& symbol) {
   auto tick = std::make_shared<engine::SubscribeData>();
   tick->symbol = symbol;
-  return _engine->on_event(engine::EventType::kSubscribeTick, tick);
+  return emit(engine::EventType::kSubscribeTick, tick);
+}
+
+// 订阅指定交易对的逐笔成交
+asio::awaitable<void> Strategy::on_subscribe_trade(const std::string& symbol, bool all) {
+  auto trade = std::make_shared<engine::SubscribeData>();
+  trade->symbol = symbol;
+  trade->tick_by_tick = all;
+  return emit(engine::EventType::kSubscribeTrade, trade);
 }
 
 // 发送订单
 asio::awaitable<void> Strategy::on_send_order(engine::OrderDataPtr order) {
-  return _engine->on_event(engine::EventType::kSendOrder, order);
+  return emit(engine::EventType::kSendOrder, order);
+}
+
+// 发送母单，由智能路由拆分
+asio::awaitable<void> Strategy::on_route_order(engine::OrderDataPtr order) {
+  return emit(engine::EventType::kRouteOrder, order);
+}
+
+// 撤销订单
+asio::awaitable<void> Strategy::on_cancel_order(engine::OrderDataPtr order) {
+  return emit(engine::EventType::kCancelOrder, order);
+}
+
+// 发送算法单
+asio::awaitable<void> Strategy::on_algo_order(engine::AlgoOrderDataPtr order) {
+  return emit(engine::EventType::kAlgoOrder, order);
+}
+
+// 停止算法单
+asio::awaitable<void> Strategy::on_cancel_algo(const std::string& algo_id) {
+  auto order = std::make_shared<engine::AlgoOrderData>();
+  order->algo_id = algo_id;
+  return emit(engine::EventType::kCancelAlgo, order);
+}
+
+engine::TimerWheel::TimerId Strategy::add_timer(int64_t delay_ms, engine::TimerWheel::Callback callback) {
+  if (_pinned) {
+    return _pinned->timers().schedule(delay_ms, std::move(callback));
+  }
+  return _engine->schedule_timer(delay_ms, std::move(callback));
+}
+
+bool Strategy::cancel_timer(engine::TimerWheel::TimerId id) {
+  if (_pinned) {
+    return _pinned->timers().cancel(id);
+  }
+  return _engine->cancel_timer(id);
+}
+
+// 独立线程运行时经输出队列交给引擎线程
+asio::awaitable<void> Strategy::emit(engine::EventType type, std::shared_ptr<const engine::BaseData> data) {
+  if (_pinned) {
+    return _pinned->emit(type, std::move(data));
+  }
+  return _engine->on_event(type, std::move(data));
 }
 
 
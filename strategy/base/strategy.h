@@ -16,6 +16,8 @@
 namespace strategy {
 namespace base {
 
+class PinnedRunner;
+
 /**
  * @brief 策略基类
  * 
@@ -59,9 +61,11 @@ public:
   /**
    * @brief 订阅订单簿数据
    * @param symbol 交易对符号
+   * @param depth 每侧需要的档位数，1 表示只要最优买卖价
+   * @param tick_by_tick 是否需要逐笔推送
    * @return asio::awaitable<void> 异步协程
    */
-  asio::awaitable<void> on_subscribe_book(const std::string& symbol);
+  asio::awaitable<void> on_subscribe_book(const std::string& symbol, uint32_t depth = 400, bool tick_by_tick = false);
   
   /**
    * @brief 订阅Tick数据
@@ -70,13 +74,74 @@ public:
    */
   asio::awaitable<void> on_subscribe_tick(const std::string& symbol);
 
+  /**
+   * @brief 订阅市场逐笔成交
+   * @param symbol 交易对符号
+   * @param all 是否需要每一笔成交，否则同一主动单的成交可能合并推送
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> on_subscribe_trade(const std::string& symbol, bool all = false);
+
   /**
    * @brief 发送订单
+   *
+   * 由行情触发的订单把 order->recv_ns 设为触发行情的 recv_ns，即可统计 tick-to-trade 延迟。
+   *
    * @param order 订单数据
    * @return asio::awaitable<void> 异步协程
    */
   asio::awaitable<void> on_send_order(engine::OrderDataPtr order);
 
+  /**
+   * @brief 发送母单，由智能路由按合并订单簿拆分到各交易所
+   *
+   * 需要开启合并订单簿和智能路由。交易对使用合并订单簿的统一名称，exchange 不需要填写，
+   * 汇总后的母单状态通过 recv_parent_order 回报。
+   *
+   * @param order 母单数据，每一项是一笔母单
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> on_route_order(engine::OrderDataPtr order);
+
+  /**
+   * @brief 撤销订单，撤单结果通过 recv_order 回报
+   * @param order 订单数据，每一项需要 client_order_id 或 order_id
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> on_cancel_order(engine::OrderDataPtr order);
+
+  /**
+   * @brief 发送算法单（TWAP、VWAP、冰山单），需要开启算法执行组件
+   *
+   * 进度和完成通过 recv_algo_status 回报。策略需要订阅该交易对的订单簿，VWAP 还需要订阅逐笔成交。
+   *
+   * @param order 算法单请求
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> on_algo_order(engine::AlgoOrderDataPtr order);
+
+  /**
+   * @brief 停止算法单，撤掉工作中的子单后以 CANCELLED 回报
+   * @param algo_id 算法单ID
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> on_cancel_algo(const std::string& algo_id);
+
+  /**
+   * @brief 添加定时器，回调在引擎执行器上触发；在独立线程运行时由策略线程的时间轮触发
+   * @param delay_ms 延迟（毫秒）
+   * @param callback 到期回调
+   * @return engine::TimerWheel::TimerId 定时器ID
+   */
+  engine::TimerWheel::TimerId add_timer(int64_t delay_ms, engine::TimerWheel::Callback callback);
+
+  /**
+   * @brief 取消定时器
+   * @param id 定时器ID
+   * @return bool 定时器是否存在
+   */
+  bool cancel_timer(engine::TimerWheel::TimerId id);
+
   /**
    * @brief 接收账户数据回调（纯虚函数，子类必须实现）
    * @param account 账户数据
@@ -105,6 +170,13 @@ public:
    */
   virtual asio::awaitable<void> recv_tick(engine::TickDataPtr ticker) = 0;
 
+  /**
+   * @brief 接收K线收盘回调，默认忽略
+   * @param bar K线数据，history为true表示启动时回补的历史K线
+   * @return asio::awaitable<void> 异步协程
+   */
+  virtual asio::awaitable<void> recv_bar(engine::BarDataPtr bar) { co_return; }
+
   /**
    * @brief 接收订单数据回调（纯虚函数，子类必须实现）
    * @param order 订单数据
@@ -112,8 +184,83 @@ public:
    */
   virtual asio::awaitable<void> recv_order(engine::OrderDataPtr order) = 0;
 
+  /**
+   * @brief 接收市场逐笔成交回调，默认忽略
+   * @param trade 成交数据，direction 为主动成交方的方向
+   * @return asio::awaitable<void> 异步协程
+   */
+  virtual asio::awaitable<void> recv_trade(engine::TradeDataPtr trade) { co_return; }
+
+  /**
+   * @brief 接收本账户成交回调，默认忽略
+   * @param fill 成交数据，order 为所属订单
+   * @return asio::awaitable<void> 异步协程
+   */
+  virtual asio::awaitable<void> recv_fill(engine::TradeDataPtr fill) { co_return; }
+
+  /**
+   * @brief 接收交易所接口剩余额度，默认忽略
+   *
+   * 网关在每批下单后发出，策略可据此在额度紧张时降低报单频率。
+   *
+   * @param limit 限速额度
+   * @return asio::awaitable<void> 异步协程
+   */
+  virtual asio::awaitable<void> recv_rate_limit(engine::RateLimitDataPtr limit) { co_return; }
+
+  /**
+   * @brief 接收跨交易所合并最优买卖价，默认忽略
+   *
+   * 仅在开启合并订单簿时发出，合并买一价或卖一价变化时推送。
+   *
+   * @param quote 合并最优买卖价
+   * @return asio::awaitable<void> 异步协程
+   */
+  virtual asio::awaitable<void> recv_consolidated_quote(engine::ConsolidatedQuotePtr quote) { co_return; }
+
+  /**
+   * @brief 接收母单状态回调，默认忽略
+   *
+   * 任一子单回报改变母单的成交量或状态时推送，成交均价为各子单按数量加权。
+   *
+   * @param order 母单数据，client_order_id 为母单ID
+   * @return asio::awaitable<void> 异步协程
+   */
+  virtual asio::awaitable<void> recv_parent_order(engine::OrderDataPtr order) { co_return; }
+
+  /**
+   * @brief 接收算法单状态回调，默认忽略
+   * @param status 算法单状态，FILLED/CANCELLED/REJECTED 表示算法单结束
+   * @return asio::awaitable<void> 异步协程
+   */
+  virtual asio::awaitable<void> recv_algo_status(engine::AlgoStatusDataPtr status) { co_return; }
+
 private:
-  engine::EnginePtr _engine;  ///< 引擎指针
+  friend class PinnedRunner;
+
+  /**
+   * @brief 注册事件回调，在独立线程运行时把事件转交策略线程
+   * @tparam EventDataType 事件数据类型
+   * @tparam Handler 处理该事件的成员函数
+   * @param type 事件类型
+   */
+  template <typename EventDataType, asio::awaitable<void> (Strategy::*Handler)(std::shared_ptr<const EventDataType>)>
+  void listen(engine::EventType type);
+
+  /// 在策略线程上调用 Handler，供 PinnedRunner 分发
+  template <typename EventDataType, asio::awaitable<void> (Strategy::*Handler)(std::shared_ptr<const EventDataType>)>
+  static asio::awaitable<void> dispatch(Strategy& strategy, std::shared_ptr<const engine::BaseData> data);
+
+  /**
+   * @brief 向引擎发出请求
+   * @param type 事件类型
+   * @param data 事件数据
+   * @return asio::awaitable<void> 异步协程
+   */
+  asio::awaitable<void> emit(engine::EventType type, std::shared_ptr<const engine::BaseData> data);
+
+  engine::EnginePtr _engine;         ///< 引擎指针
+  PinnedRunner* _pinned = nullptr;  ///< 在独立线程运行时的运行器，由 PinnedRunner 设置
 };
 
 }  // namespace base
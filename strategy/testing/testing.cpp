@@ -1,11 +1,8 @@
 #include "testing.h"
 
-#include <boost/asio/steady_timer.hpp>
-#include <chrono>
+#include "utils/async_log.h"
 #include "utils/utils.h"
 
-using namespace std::chrono_literals;
-
 namespace strategy::testing {
 
 Testing::Testing(engine::EnginePtr engine) : base::Strategy(engine) {}
@@ -15,7 +12,7 @@ Testing::~Testing() {}
 // 策略启动后执行的主逻辑
 asio::awaitable<void> Testing::run() {
   auto executor = co_await asio::this_coro::executor;
-  LOG(INFO) << fmt::format("run");
+  QLOG(INFO, "run");
 
   // 查询账户信息
   co_await on_request_account();
@@ -29,10 +26,14 @@ asio::awaitable<void> Testing::run() {
   // // 订阅BTC-USDT-SWAP的Tick数据
   // co_await on_subscribe_tick("BTC-USDT-SWAP");
 
-  boost::asio::steady_timer timer(executor);
-  timer.expires_after(1s);
-  co_await timer.async_wait(asio::use_awaitable);
-  
+  // 1秒后下一笔测试单，定时器由时间轮统一管理
+  add_timer(1000, [self = std::static_pointer_cast<Testing>(shared_from_this()), executor]() {
+    asio::co_spawn(executor, self->send_test_order(), asio::detached);
+  });
+  co_return;
+}
+
+asio::awaitable<void> Testing::send_test_order() {
   auto order = std::make_shared<engine::OrderData>();
   auto order_item = std::make_shared<engine::OrderDataItem>();
   order_item->symbol = "BTC-USDT-SWAP";
@@ -41,38 +42,47 @@ asio::awaitable<void> Testing::run() {
   order_item->volume = dec_float("0.01");
   order->items.push_back(order_item);
   co_await on_send_order(order);
-  co_return;
 }
 
 asio::awaitable<void> Testing::recv_account(engine::AccountDataPtr account) {
-  LOG(INFO) << fmt::format("recv_account: {}", account->balance.str());
+  QLOG(INFO, "recv_account: {}", account->balance.str());
   co_return;
 }
 
 // 接收持仓数据并打印详细信息
 asio::awaitable<void> Testing::recv_position(engine::PositionDataPtr position) {
-  LOG(INFO) << fmt::format("recv_position: {}", position->items.size());
+  QLOG(INFO, "recv_position: {}", position->items.size());
   // 遍历所有持仓，打印交易对、数量、价格和方向
   for (auto& item : position->items) {
-    LOG(INFO) << fmt::format("position: {}, {} {} {}", item->symbol, item->volume.str(), item->price.str(), int(item->direction));
+    QLOG(INFO, "position: {}, {} {} {}", item->symbol, item->volume.str(), item->price.str(), int(item->direction));
   }
   co_return;
 }
 
 // 接收订单簿数据并打印买卖盘信息
 asio::awaitable<void> Testing::recv_book(engine::BookPtr order) {
-  LOG(INFO) << fmt::format("recv_book {}: ask {} bid {}", order->symbol, order->asks.size(), order->bids.size());
+  QLOG(INFO, "recv_book {}: ask {} bid {}", order->symbol, order->asks.size(), order->bids.size());
 
   co_return;
 }
 
 asio::awaitable<void> Testing::recv_tick(engine::TickDataPtr ticker) {
-  LOG(INFO) << fmt::format("recv_tick: {}", ticker->symbol);
+  QLOG(INFO, "recv_tick: {}", ticker->symbol);
+  co_return;
+}
+
+asio::awaitable<void> Testing::recv_bar(engine::BarDataPtr bar) {
+  // 不同交易对、不同周期的K线各自计算
+  auto key = fmt::format("{}/{}/{}", bar->exchange, bar->symbol, bar->interval);
+  auto ema = close_emas_.try_emplace(key, 20).first->second.update(bar->close_price);
+  QLOG(INFO, "recv_bar {} {}s: o {} h {} l {} c {} v {} ema20 {:.4f}", bar->symbol, bar->interval,
+       bar->open_price.str(), bar->high_price.str(), bar->low_price.str(), bar->close_price.str(), bar->volume.str(),
+       ema);
   co_return;
 }
 
 asio::awaitable<void> Testing::recv_order(engine::OrderDataPtr order) {
-  LOG(INFO) << fmt::format("recv_order: {}", order->items.size());
+  QLOG(INFO, "recv_order: {}", order->items.size());
   co_return;
 }
 
@@ -13,7 +13,9 @@
  */
 
 #include <string>
+#include <unordered_map>
 #include "base/strategy.h"
+#include "indicator/indicator.hpp"
 
 namespace strategy {
 namespace testing {
@@ -52,8 +54,18 @@ public:
   /// 接收并打印Tick数据
   asio::awaitable<void> recv_tick(engine::TickDataPtr ticker) override;
 
+  /// 接收并打印K线数据
+  asio::awaitable<void> recv_bar(engine::BarDataPtr bar) override;
+
   /// 接收并打印订单数据
   asio::awaitable<void> recv_order(engine::OrderDataPtr order) override;
+
+private:
+  /// 发送一笔市价测试单
+  asio::awaitable<void> send_test_order();
+
+  /// K线收盘价EMA，key: 交易所/交易对/周期
+  std::unordered_map<std::string, Common::indicator::Ema> close_emas_;
 };
 
 }  // namespace testing
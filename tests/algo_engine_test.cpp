@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include "algo/algo_engine.h"
+#include "engine_probe.hpp"
+
+using Common::Fixed;
+using engine::EventType;
+using engine::OrderStatus;
+using service::algo::AlgoEngine;
+using testing_support::Probe;
+
+namespace {
+
+std::shared_ptr<engine::Book> book(int bid, int ask) {
+  auto data = std::make_shared<engine::Book>();
+  data->symbol = "BTC-USDT-SWAP";
+  data->exchange = "okx";
+  engine::BookItem level;
+  level.price = bid;
+  level.volume = 10;
+  data->bids.push_back(level);
+  level.price = ask;
+  data->asks.push_back(level);
+  return data;
+}
+
+std::shared_ptr<engine::AlgoOrderData> algo_order(engine::AlgoType algo, int volume) {
+  auto order = std::make_shared<engine::AlgoOrderData>();
+  order->symbol = "BTC-USDT-SWAP";
+  order->exchange = "okx";
+  order->algo_id = "a1";
+  order->algo = algo;
+  order->direction = engine::Direction::BUY;
+  order->volume = volume;
+  return order;
+}
+
+std::shared_ptr<engine::OrderData> report(const engine::OrderDataItem& child, OrderStatus status, int filled = 0) {
+  auto order = std::make_shared<engine::OrderData>();
+  order->exchange = "okx";
+  auto item = std::make_shared<engine::OrderDataItem>(child);
+  item->order_id = "ex-" + child.client_order_id;
+  item->status = status;
+  item->filled_volume = filled;
+  item->avg_price = filled > 0 ? child.price : 0;
+  order->items.push_back(item);
+  return order;
+}
+
+// 场景在协程中执行，只能使用 EXPECT_*，ASSERT_* 含有 return
+class AlgoEngineTest : public ::testing::Test {
+ protected:
+  void run(Probe::Scenario scenario) {
+    engine_ = std::make_shared<engine::Engine>(ctx_);
+    algo_ = std::make_shared<AlgoEngine>(engine_);
+    probe_ = std::make_shared<Probe>(engine_, std::vector{EventType::kSendOrder, EventType::kCancelOrder},
+                                     std::move(scenario));
+    engine_->register_component(algo_);
+    engine_->register_component(probe_);
+    ASSERT_TRUE(testing_support::run_engine(ctx_, engine_));
+    if (probe_->error()) {
+      std::rethrow_exception(probe_->error());
+    }
+  }
+
+  /// 第 n 笔子单
+  std::shared_ptr<const engine::OrderDataItem> child(Probe& probe, size_t n) {
+    auto sent = probe.events<engine::OrderData>(EventType::kSendOrder);
+    return n < sent.size() && !sent[n]->items.empty() ? sent[n]->items[0] : nullptr;
+  }
+
+  asio::io_context ctx_;
+  engine::EnginePtr engine_;
+  std::shared_ptr<AlgoEngine> algo_;
+  std::shared_ptr<Probe> probe_;
+};
+
+}  // namespace
+
+TEST_F(AlgoEngineTest, TwapTopsUpRestingChildWhenScheduleAdvances) {
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    co_await probe.emit(EventType::kBook, book(100, 101));
+    auto order = algo_order(engine::AlgoType::TWAP, 4);
+    order->duration_ms = 800;
+    order->interval_ms = 200;
+    co_await probe.emit(EventType::kAlgoOrder, order);
+    co_await probe.sleep(20);
+
+    // 第一片挂在买一
+    auto first = child(probe, 0);
+    EXPECT_NE(first, nullptr);
+    if (!first) {
+      co_return;
+    }
+    EXPECT_EQ(Fixed::from_dec(first->volume), Fixed::from_int(1));
+    EXPECT_EQ(Fixed::from_dec(first->price), Fixed::from_int(100));
+    co_await probe.emit(EventType::kOrder, report(*first, OrderStatus::PENDING));
+
+    // 盘口不变，第二片释放后子单数量落后于进度，撤单后按累计未成交数量重挂
+    co_await probe.sleep(250);
+    auto cancels = probe.events<engine::OrderData>(EventType::kCancelOrder);
+    EXPECT_EQ(cancels.size(), 1u);
+    if (cancels.empty()) {
+      co_return;
+    }
+    EXPECT_EQ(cancels[0]->items[0]->client_order_id, first->client_order_id);
+
+    co_await probe.emit(EventType::kOrder, report(*first, OrderStatus::CANCELLED));
+    co_await probe.sleep(10);
+    auto second = child(probe, 1);
+    EXPECT_NE(second, nullptr);
+    if (second) {
+      EXPECT_EQ(Fixed::from_dec(second->volume), Fixed::from_int(2));
+      EXPECT_EQ(Fixed::from_dec(second->price), Fixed::from_int(100));
+    }
+  });
+}
+
+TEST_F(AlgoEngineTest, IcebergDoesNotRefillPartiallyFilledClip) {
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    co_await probe.emit(EventType::kBook, book(100, 101));
+    auto order = algo_order(engine::AlgoType::ICEBERG, 10);
+    order->display_volume = 2;
+    order->interval_ms = 50;
+    co_await probe.emit(EventType::kAlgoOrder, order);
+    co_await probe.sleep(20);
+
+    auto first = child(probe, 0);
+    EXPECT_NE(first, nullptr);
+    if (!first) {
+      co_return;
+    }
+    EXPECT_EQ(Fixed::from_dec(first->volume), Fixed::from_int(2));
+    co_await probe.emit(EventType::kOrder, report(*first, OrderStatus::PARTIAL_FILLED, 1));
+
+    // 显示数量部分成交后保持排队位置，成交完才挂下一笔
+    co_await probe.sleep(150);
+    EXPECT_TRUE(probe.events<engine::OrderData>(EventType::kCancelOrder).empty());
+    EXPECT_EQ(probe.events<engine::OrderData>(EventType::kSendOrder).size(), 1u);
+  });
+}
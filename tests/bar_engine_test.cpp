@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+
+#include "bar/bar_engine.h"
+#include "engine_probe.hpp"
+#include "store/recorder.h"
+#include "store/tick_store.h"
+
+using Common::Fixed;
+using engine::EventType;
+using service::bar::BarEngine;
+using testing_support::Probe;
+
+namespace {
+
+constexpr const char* kExchange = "okx";
+constexpr const char* kSymbol = "BTC-USDT-SWAP";
+
+std::shared_ptr<engine::TickData> tick(int64_t ts, int price, int last_volume, int volume_24h) {
+  auto data = std::make_shared<engine::TickData>();
+  data->exchange = kExchange;
+  data->symbol = kSymbol;
+  data->timestamp_ms = ts;
+  data->last_price = price;
+  data->last_volume = last_volume;
+  data->volume_24h = volume_24h;
+  return data;
+}
+
+/// 指定开始时间的K线
+std::shared_ptr<const engine::BarData> find_bar(const std::vector<std::shared_ptr<const engine::BarData>>& bars,
+                                                int64_t start_ms, bool history) {
+  for (auto& bar : bars) {
+    if (bar->timestamp_ms == start_ms && bar->history == history) {
+      return bar;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+// 同一组Tick实时合成与从存储回补得到的K线成交量一致，只有盘口变化的Tick不重复计量
+TEST(BarEngineTest, BackfilledBarMatchesLiveBar) {
+  auto root = (std::filesystem::temp_directory_path() / "qitrader_bar_test").string();
+  std::filesystem::remove_all(root);
+
+  auto pt = std::make_shared<Config::ptree>();
+  pt->put("store.path", root);
+  pt->put("bar.intervals", "1");
+  // 墙钟收盘延后，只由下一秒的Tick按事件时间收盘
+  pt->put("bar.close_delay_ms", 60000);
+  store_config->load(pt);
+  bar_config->load(pt);
+
+  auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::system_clock::now().time_since_epoch())
+                 .count();
+  int64_t start = now - now % 1000 - 2000;
+  std::vector<std::shared_ptr<engine::TickData>> ticks = {
+      tick(start + 100, 100, 1, 1000),  // 首个Tick无法判断是否包含新成交
+      tick(start + 200, 101, 2, 1002),
+      tick(start + 300, 101, 2, 1002),  // 只有盘口变化
+      tick(start + 400, 102, 3, 1005),
+      tick(start + 500, 102, 3, 1005),  // 只有盘口变化
+      tick(start + 1100, 103, 1, 1006),
+  };
+  {
+    service::store::TickWriter writer(root, kExchange, kSymbol);
+    for (auto& data : ticks) {
+      writer.append(*data);
+    }
+  }
+
+  asio::io_context ctx;
+  auto engine = std::make_shared<engine::Engine>(ctx);
+  auto bars = std::make_shared<BarEngine>(engine);
+  auto probe = std::make_shared<Probe>(engine, std::vector{EventType::kBar}, [&](Probe& probe) -> asio::awaitable<void> {
+    for (auto& data : ticks) {
+      co_await probe.emit(EventType::kTick, data);
+    }
+    co_await bars->backfill(kExchange, kSymbol, start, start + 1999);
+    co_await probe.sleep(50);
+  });
+  engine->register_component(bars);
+  engine->register_component(probe);
+  ASSERT_TRUE(testing_support::run_engine(ctx, engine));
+  if (probe->error()) {
+    std::rethrow_exception(probe->error());
+  }
+
+  auto events = probe->events<engine::BarData>(EventType::kBar);
+  auto live = find_bar(events, start, false);
+  auto history = find_bar(events, start, true);
+  ASSERT_NE(live, nullptr);
+  ASSERT_NE(history, nullptr);
+  EXPECT_EQ(Fixed::from_dec(live->volume), Fixed::from_int(5));
+  EXPECT_EQ(Fixed::from_dec(history->volume), Fixed::from_dec(live->volume));
+  EXPECT_EQ(Fixed::from_dec(history->open_price), Fixed::from_dec(live->open_price));
+  EXPECT_EQ(Fixed::from_dec(history->high_price), Fixed::from_dec(live->high_price));
+  EXPECT_EQ(Fixed::from_dec(history->close_price), Fixed::from_dec(live->close_price));
+
+  std::filesystem::remove_all(root);
+}
@@ -0,0 +1,123 @@
+#ifndef __TESTS_BINANCE_MOCK_HPP__
+#define __TESTS_BINANCE_MOCK_HPP__
+
+/**
+ * @file binance_mock.hpp
+ * @brief Binance 网关测试用的本地模拟
+ *
+ * REST 请求不经网络，按 "方法 路径" 返回预置的响应并记录查询参数；
+ * WebSocket 推送以交易所原始 JSON 给出，解析后直接交给 Binance::dispatch。
+ */
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "binance/binance.h"
+#include "jsoncpp/jsoncpp.hpp"
+
+namespace testing_support {
+
+class MockBinanceHttp : public market::binance::BinanceHttp {
+ public:
+  /// 设置接口的响应，key 形如 "GET /fapi/v1/order"
+  void respond(const std::string& key, std::string body) { responses_[key] = std::move(body); }
+
+  /// 接口收到的查询参数，按请求顺序
+  const std::vector<std::string>& queries(const std::string& key) const {
+    static const std::vector<std::string> empty;
+    auto it = queries_.find(key);
+    return it == queries_.end() ? empty : it->second;
+  }
+
+ protected:
+  asio::awaitable<std::string> request(const market::base::RestEndpoint& endpoint, std::string query,
+                                       bool sign) override {
+    auto key = endpoint.method + " " + endpoint.path;
+    queries_[key].push_back(query);
+    auto it = responses_.find(key);
+    if (it == responses_.end()) {
+      throw std::runtime_error("no canned response for " + key);
+    }
+    co_return it->second;
+  }
+
+ private:
+  std::map<std::string, std::string> responses_;
+  std::map<std::string, std::vector<std::string>> queries_;
+};
+
+/// 解析一条 WebSocket 推送
+inline market::binance::WsMessage ws_message(const std::string& json) {
+  return *jsoncpp::from_json<market::binance::WsMessage>(json);
+}
+
+namespace binance_payload {
+
+/// 5档深度推送
+inline const char* kDepth5 = R"({
+  "e": "depthUpdate", "E": 1700000000100, "T": 1700000000090, "s": "BTCUSDT", "U": 390, "u": 400, "pu": 389,
+  "b": [["37000.10", "1.500"], ["37000.00", "2.000"]],
+  "a": [["37000.20", "0.700"], ["37000.30", "1.200"]]
+})";
+
+/// 比 kDepth5 更早的深度推送，乱序到达时应丢弃
+inline const char* kDepth5Stale = R"({
+  "e": "depthUpdate", "E": 1700000000050, "T": 1700000000040, "s": "BTCUSDT", "U": 380, "u": 389, "pu": 379,
+  "b": [["36999.00", "9.000"]],
+  "a": [["37001.00", "9.000"]]
+})";
+
+/// 部分成交的订单推送，带成交明细
+inline const char* kOrderTrade = R"({
+  "e": "ORDER_TRADE_UPDATE", "E": 1700000000200, "T": 1700000000199,
+  "o": {
+    "s": "BTCUSDT", "c": "c1", "S": "BUY", "o": "LIMIT", "f": "GTC", "q": "2.000", "p": "37000.00",
+    "ap": "37000.00", "x": "TRADE", "X": "PARTIALLY_FILLED", "i": 8886774, "l": "0.500", "z": "0.500",
+    "L": "37000.00", "N": "USDT", "n": "3.70000000", "T": 1700000000199, "t": 51234, "m": true, "ps": "BOTH"
+  }
+})";
+
+/// 账户变化推送，只包含变化的币种和持仓
+inline const char* kAccountUpdate = R"({
+  "e": "ACCOUNT_UPDATE", "E": 1700000000300, "T": 1700000000299,
+  "a": {
+    "m": "ORDER",
+    "B": [{"a": "USDT", "wb": "1000.00", "cw": "1000.00", "bc": "0"}],
+    "P": [{"s": "BTCUSDT", "pa": "-0.500", "ep": "37000.00", "cr": "0", "up": "-1.25", "mt": "cross", "iw": "0",
+           "ps": "BOTH"}]
+  }
+})";
+
+/// GET /fapi/v2/account
+inline const char* kAccount = R"({
+  "totalMarginBalance": "1001.50", "updateTime": 1700000000400,
+  "assets": [{"asset": "USDT", "walletBalance": "1000.00", "marginBalance": "1001.50"}]
+})";
+
+/// GET /fapi/v2/positionRisk，接口返回所有交易对，包括没有持仓的
+inline const char* kPositionRisk = R"([
+  {"symbol": "BTCUSDT", "positionSide": "LONG", "positionAmt": "0.300", "entryPrice": "36500.0",
+   "unRealizedProfit": "150.0", "updateTime": 1700000000500},
+  {"symbol": "BTCUSDT", "positionSide": "SHORT", "positionAmt": "-0.100", "entryPrice": "37200.0",
+   "unRealizedProfit": "20.0", "updateTime": 1700000000500},
+  {"symbol": "ETHUSDT", "positionSide": "BOTH", "positionAmt": "0.000", "entryPrice": "0.0",
+   "unRealizedProfit": "0.0", "updateTime": 0}
+])";
+
+/// GET /fapi/v1/order，订单不存在
+inline const char* kOrderNotExist = R"({"code": -2013, "msg": "Order does not exist."})";
+
+/// GET /fapi/v1/order，已撤销的订单
+inline const char* kOrderCancelled = R"({
+  "symbol": "BTCUSDT", "orderId": 8886775, "clientOrderId": "c2", "side": "SELL", "type": "LIMIT",
+  "status": "CANCELED", "price": "38000.00", "origQty": "1.000", "executedQty": "0.000", "avgPrice": "0.00",
+  "updateTime": 1700000000600
+})";
+
+}  // namespace binance_payload
+
+}  // namespace testing_support
+
+#endif  // __TESTS_BINANCE_MOCK_HPP__
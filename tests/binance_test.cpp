@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include "binance_mock.hpp"
+#include "engine_probe.hpp"
+
+using Common::Fixed;
+using engine::EventType;
+using engine::OrderStatus;
+using market::binance::Binance;
+using testing_support::MockBinanceHttp;
+using testing_support::Probe;
+using testing_support::ws_message;
+namespace payload = testing_support::binance_payload;
+
+namespace {
+
+Fixed fixed(const char* s) { return Fixed::from_string(s); }
+
+Fixed fixed(const dec_float& v) { return Fixed::from_dec(v); }
+
+// 场景在协程中执行，只能使用 EXPECT_*，ASSERT_* 含有 return
+class BinanceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    binance_config->load(std::make_shared<Config::ptree>());
+    http_ = std::make_shared<MockBinanceHttp>();
+  }
+
+  void run(Probe::Scenario scenario) {
+    engine_ = std::make_shared<engine::Engine>(ctx_);
+    gateway_ = std::make_shared<Binance>(engine_, http_);
+    probe_ = std::make_shared<Probe>(
+        engine_, std::vector{EventType::kBook, EventType::kOrder, EventType::kPosition, EventType::kAccount},
+        std::move(scenario));
+    engine_->register_component(probe_);
+    ASSERT_TRUE(testing_support::run_engine(ctx_, engine_));
+    if (probe_->error()) {
+      std::rethrow_exception(probe_->error());
+    }
+  }
+
+  asio::io_context ctx_;
+  engine::EnginePtr engine_;
+  std::shared_ptr<MockBinanceHttp> http_;
+  std::shared_ptr<Binance> gateway_;
+  std::shared_ptr<Probe> probe_;
+};
+
+}  // namespace
+
+TEST_F(BinanceTest, DepthUpdateReplacesBookAndDropsStale) {
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    auto depth = ws_message(payload::kDepth5);
+    auto stale = ws_message(payload::kDepth5Stale);
+    co_await gateway_->dispatch(depth);
+    co_await gateway_->dispatch(stale);
+    co_await probe.sleep(10);
+
+    // 乱序到达的旧推送不转发
+    auto books = probe.events<engine::Book>(EventType::kBook);
+    EXPECT_EQ(books.size(), 1u);
+    if (books.empty()) {
+      co_return;
+    }
+    auto& book = *books[0];
+    EXPECT_EQ(book.symbol, "BTCUSDT");
+    EXPECT_EQ(book.exchange, "binance");
+    EXPECT_EQ(book.timestamp_ms, 1700000000090);
+    EXPECT_EQ(book.bids.size(), 2u);
+    EXPECT_EQ(book.asks.size(), 2u);
+    if (book.bids.size() == 2 && book.asks.size() == 2) {
+      EXPECT_EQ(fixed(book.bids[0].price), fixed("37000.10"));
+      EXPECT_EQ(fixed(book.bids[1].volume), fixed("2"));
+      EXPECT_EQ(fixed(book.asks[0].price), fixed("37000.20"));
+      EXPECT_EQ(fixed(book.asks[1].volume), fixed("1.2"));
+    }
+  });
+}
+
+TEST_F(BinanceTest, OrderTradeUpdateCarriesFill) {
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    auto msg = ws_message(payload::kOrderTrade);
+    co_await gateway_->dispatch(msg);
+    co_await probe.sleep(10);
+
+    auto orders = probe.events<engine::OrderData>(EventType::kOrder);
+    EXPECT_EQ(orders.size(), 1u);
+    if (orders.empty() || orders[0]->items.empty()) {
+      co_return;
+    }
+    auto& item = *orders[0]->items[0];
+    EXPECT_EQ(item.client_order_id, "c1");
+    EXPECT_EQ(item.order_id, "8886774");
+    EXPECT_EQ(item.status, OrderStatus::PARTIAL_FILLED);
+    EXPECT_EQ(item.direction, engine::Direction::BUY);
+    EXPECT_EQ(item.otype, engine::OrderType::LIMIT);
+    EXPECT_EQ(fixed(item.volume), fixed("2"));
+    EXPECT_EQ(fixed(item.filled_volume), fixed("0.5"));
+
+    // 成交明细随订单发出，手续费按扣除记为负数
+    EXPECT_NE(item.fill, nullptr);
+    if (item.fill) {
+      EXPECT_EQ(item.fill->trade_id, "51234");
+      EXPECT_EQ(fixed(item.fill->volume), fixed("0.5"));
+      EXPECT_EQ(fixed(item.fill->fee), fixed("-3.7"));
+      EXPECT_EQ(item.fill->fee_currency, "USDT");
+      EXPECT_TRUE(item.fill->maker);
+    }
+  });
+}
+
+TEST_F(BinanceTest, AccountUpdateIsPartialAndRefreshesBalance) {
+  http_->respond("GET /fapi/v2/account", payload::kAccount);
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    auto msg = ws_message(payload::kAccountUpdate);
+    co_await gateway_->dispatch(msg);
+    co_await probe.sleep(10);
+
+    // 推送只含变化的持仓，不能当作全量快照
+    auto positions = probe.events<engine::PositionData>(EventType::kPosition);
+    EXPECT_EQ(positions.size(), 1u);
+    if (!positions.empty()) {
+      EXPECT_FALSE(positions[0]->snapshot);
+      EXPECT_EQ(positions[0]->items.size(), 1u);
+      if (!positions[0]->items.empty()) {
+        auto& item = *positions[0]->items[0];
+        EXPECT_EQ(item.direction, engine::Direction::SELL);
+        EXPECT_EQ(fixed(item.volume), fixed("0.5"));
+        EXPECT_EQ(fixed(item.pnl), fixed("-1.25"));
+      }
+    }
+
+    // 币种余额变化后通过REST补齐账户总权益
+    EXPECT_EQ(http_->queries("GET /fapi/v2/account").size(), 1u);
+    auto accounts = probe.events<engine::AccountData>(EventType::kAccount);
+    EXPECT_EQ(accounts.size(), 1u);
+    if (!accounts.empty()) {
+      EXPECT_EQ(fixed(accounts[0]->balance), fixed("1001.5"));
+    }
+  });
+}
+
+TEST_F(BinanceTest, QueryPositionIsSnapshotOfOpenLegs) {
+  http_->respond("GET /fapi/v2/positionRisk", payload::kPositionRisk);
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    co_await gateway_->query_position(std::make_shared<engine::QueryPositionData>());
+    co_await probe.sleep(10);
+
+    auto positions = probe.events<engine::PositionData>(EventType::kPosition);
+    EXPECT_EQ(positions.size(), 1u);
+    if (positions.empty()) {
+      co_return;
+    }
+    EXPECT_TRUE(positions[0]->snapshot);
+
+    // 没有持仓的交易对不发出，双向持仓按 positionSide 判断方向
+    auto& items = positions[0]->items;
+    EXPECT_EQ(items.size(), 2u);
+    if (items.size() == 2) {
+      EXPECT_EQ(items[0]->direction, engine::Direction::BUY);
+      EXPECT_EQ(fixed(items[0]->volume), fixed("0.3"));
+      EXPECT_EQ(fixed(items[0]->price), fixed("36500"));
+      EXPECT_EQ(items[1]->direction, engine::Direction::SELL);
+      EXPECT_EQ(fixed(items[1]->volume), fixed("0.1"));
+    }
+  });
+}
+
+TEST_F(BinanceTest, QueryOrderByClientOrderId) {
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    auto query = std::make_shared<engine::QueryOrderData>();
+    query->symbol = "BTCUSDT";
+    query->exchange = "binance";
+
+    // 交易所没有该订单，说明下单未成功提交
+    http_->respond("GET /fapi/v1/order", payload::kOrderNotExist);
+    query->client_order_id = "c1";
+    co_await gateway_->query_order(query);
+
+    // 已完成的订单同样能查到
+    http_->respond("GET /fapi/v1/order", payload::kOrderCancelled);
+    query->client_order_id = "c2";
+    co_await gateway_->query_order(query);
+    co_await probe.sleep(10);
+
+    auto& queries = http_->queries("GET /fapi/v1/order");
+    EXPECT_EQ(queries.size(), 2u);
+    if (queries.size() == 2) {
+      EXPECT_EQ(queries[0], "symbol=BTCUSDT&origClientOrderId=c1");
+    }
+
+    auto orders = probe.events<engine::OrderData>(EventType::kOrder);
+    EXPECT_EQ(orders.size(), 2u);
+    if (orders.size() != 2) {
+      co_return;
+    }
+    EXPECT_FALSE(orders[0]->snapshot);
+    EXPECT_EQ(orders[0]->items[0]->client_order_id, "c1");
+    EXPECT_EQ(orders[0]->items[0]->status, OrderStatus::REJECTED);
+    EXPECT_EQ(orders[1]->items[0]->client_order_id, "c2");
+    EXPECT_EQ(orders[1]->items[0]->status, OrderStatus::CANCELLED);
+    EXPECT_EQ(orders[1]->items[0]->direction, engine::Direction::SELL);
+  });
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "store/column_file.h"
+
+using service::store::ColumnBatch;
+using service::store::ColumnReader;
+using service::store::ColumnWriter;
+
+namespace {
+
+constexpr uint16_t kColumns = 3;
+
+class ColumnFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() / "qitrader_column_test";
+    std::filesystem::remove_all(dir_);
+    path_ = (dir_ / "series.col").string();
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  /// 第i行：时间戳每行加10，第1列上下波动，第2列单调递减并穿过0
+  static std::vector<int64_t> row(int64_t i) {
+    return {1000 + i * 10, (i % 3 == 0 ? 500 : -700) + i, 50 - i * 1000003};
+  }
+
+  void write(int64_t rows, uint32_t block_rows) {
+    ColumnWriter writer(path_, kColumns, 0, block_rows);
+    for (int64_t i = 0; i < rows; ++i) {
+      writer.append(row(i).data());
+    }
+  }
+
+  /// 读出 [from_ms, to_ms] 内所有行
+  std::vector<std::vector<int64_t>> read(int64_t from_ms, int64_t to_ms) {
+    ColumnReader reader(path_);
+    reader.seek(from_ms, to_ms);
+    ColumnBatch batch;
+    std::vector<std::vector<int64_t>> rows;
+    while (reader.next(batch)) {
+      for (size_t r = 0; r < batch.rows; ++r) {
+        std::vector<int64_t> values;
+        for (auto& col : batch.columns) {
+          values.push_back(col[r]);
+        }
+        rows.push_back(values);
+      }
+    }
+    return rows;
+  }
+
+  std::filesystem::path dir_;
+  std::string path_;
+};
+
+}  // namespace
+
+TEST_F(ColumnFileTest, MultiBlockRoundTrip) {
+  write(10, 4);
+
+  ColumnReader reader(path_);
+  EXPECT_EQ(reader.columns(), kColumns);
+  ASSERT_EQ(reader.index().size(), 3u);
+  EXPECT_EQ(reader.index()[0].rows, 4u);
+  EXPECT_EQ(reader.index()[2].rows, 2u);
+  EXPECT_EQ(reader.index()[1].min_ts, 1040);
+  EXPECT_EQ(reader.index()[1].max_ts, 1070);
+
+  auto rows = read(0, INT64_MAX);
+  ASSERT_EQ(rows.size(), 10u);
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(rows[i], row(i));
+  }
+}
+
+TEST_F(ColumnFileTest, RangeStartsMidBlock) {
+  write(12, 4);
+
+  // 1030 在第一块中间，1085 在第三块中间
+  auto rows = read(1030, 1085);
+  ASSERT_EQ(rows.size(), 6u);
+  for (int64_t i = 0; i < 6; ++i) {
+    EXPECT_EQ(rows[i], row(i + 3));
+  }
+
+  EXPECT_TRUE(read(2000, 3000).empty());
+}
+
+TEST_F(ColumnFileTest, NegativeDeltas) {
+  {
+    ColumnWriter writer(path_, kColumns, 0, 8);
+    std::vector<std::vector<int64_t>> values = {
+        {1000, 0, INT64_MAX / 2}, {1001, -1, -(INT64_MAX / 2)}, {1002, -300000, 1}, {999, 300000, -1}};
+    for (auto& v : values) {
+      writer.append(v.data());
+    }
+  }
+
+  auto rows = read(0, INT64_MAX);
+  ASSERT_EQ(rows.size(), 4u);
+  EXPECT_EQ(rows[1], (std::vector<int64_t>{1001, -1, -(INT64_MAX / 2)}));
+  EXPECT_EQ(rows[2], (std::vector<int64_t>{1002, -300000, 1}));
+  // 时间戳回退也按块内最小时间戳建索引
+  EXPECT_EQ(rows[3], (std::vector<int64_t>{999, 300000, -1}));
+  ColumnReader reader(path_);
+  ASSERT_EQ(reader.index().size(), 1u);
+  EXPECT_EQ(reader.index()[0].min_ts, 999);
+  EXPECT_EQ(reader.index()[0].max_ts, 1002);
+}
+
+// 进程异常退出时没有尾部索引，最后一块可能只写了一半：扫描块头恢复完整的块
+TEST_F(ColumnFileTest, RecoversTruncatedTailByHeaderScan) {
+  write(10, 4);
+  uint64_t last_block = 0;
+  {
+    ColumnReader reader(path_);
+    ASSERT_EQ(reader.index().size(), 3u);
+    last_block = reader.index()[2].offset;
+  }
+  std::filesystem::resize_file(path_, last_block + 10);
+
+  ColumnReader reader(path_);
+  ASSERT_EQ(reader.index().size(), 2u);
+  auto rows = read(0, INT64_MAX);
+  ASSERT_EQ(rows.size(), 8u);
+  EXPECT_EQ(rows[7], row(7));
+
+  // 续写时从最后一个完整块之后开始
+  {
+    ColumnWriter writer(path_, kColumns, 0, 4);
+    for (int64_t i = 8; i < 10; ++i) {
+      writer.append(row(i).data());
+    }
+  }
+  rows = read(0, INT64_MAX);
+  ASSERT_EQ(rows.size(), 10u);
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(rows[i], row(i));
+  }
+}
+
+// 异步写入时索引可能先于数据块落盘：索引指向的块头无效时不信任索引，扫描块头恢复之前的块
+TEST_F(ColumnFileTest, IndexPointingAtUnwrittenBlockFallsBackToScan) {
+  write(10, 4);
+  uint64_t second_block = 0;
+  {
+    ColumnReader reader(path_);
+    ASSERT_EQ(reader.index().size(), 3u);
+    second_block = reader.index()[1].offset;
+  }
+  // 第二块未落盘，文件中留下空洞
+  {
+    std::fstream file(path_, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(static_cast<std::streamoff>(second_block));
+    std::vector<char> zeros(16, 0);
+    file.write(zeros.data(), zeros.size());
+  }
+
+  ColumnReader reader(path_);
+  ASSERT_EQ(reader.index().size(), 1u);
+  auto rows = read(0, INT64_MAX);
+  ASSERT_EQ(rows.size(), 4u);
+  EXPECT_EQ(rows[3], row(3));
+}
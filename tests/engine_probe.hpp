@@ -0,0 +1,100 @@
+#ifndef __TESTS_ENGINE_PROBE_HPP__
+#define __TESTS_ENGINE_PROBE_HPP__
+
+/**
+ * @file engine_probe.hpp
+ * @brief 组件测试用的引擎探针
+ *
+ * 探针作为组件注册到引擎，记录指定类型的事件，并在 run 中执行测试场景。
+ * 场景结束后停止 io_context，run_engine 返回。
+ */
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <boost/asio/steady_timer.hpp>
+
+#include "engine.h"
+
+namespace testing_support {
+
+class Probe : public std::enable_shared_from_this<Probe>, public engine::Component {
+ public:
+  typedef std::function<asio::awaitable<void>(Probe&)> Scenario;
+
+  Probe(engine::EnginePtr engine, std::vector<engine::EventType> watch, Scenario scenario)
+      : engine_(engine), watch_(std::move(watch)), scenario_(std::move(scenario)) {}
+
+  asio::awaitable<void> init() override {
+    for (auto type : watch_) {
+      engine_->register_callback<engine::BaseData>(
+          type, [self = shared_from_this(), type](std::shared_ptr<const engine::BaseData> data) -> asio::awaitable<void> {
+            self->events_[type].push_back(data);
+            co_return;
+          });
+    }
+    co_return;
+  }
+
+  asio::awaitable<void> run() override {
+    try {
+      co_await scenario_(*this);
+    } catch (...) {
+      error_ = std::current_exception();
+    }
+    static_cast<asio::io_context&>((co_await asio::this_coro::executor).context()).stop();
+  }
+
+  /// 发送事件
+  asio::awaitable<void> emit(engine::EventType type, std::shared_ptr<const engine::BaseData> data) {
+    co_await engine_->on_event(type, std::move(data));
+  }
+
+  /// 等待一段时间，让引擎分发完已发出的事件
+  asio::awaitable<void> sleep(int64_t ms) {
+    asio::steady_timer timer(co_await asio::this_coro::executor);
+    timer.expires_after(std::chrono::milliseconds(ms));
+    co_await timer.async_wait(asio::use_awaitable);
+  }
+
+  /// 收到的指定类型事件
+  template <typename T>
+  std::vector<std::shared_ptr<const T>> events(engine::EventType type) const {
+    std::vector<std::shared_ptr<const T>> result;
+    auto it = events_.find(type);
+    if (it != events_.end()) {
+      for (auto& data : it->second) {
+        result.push_back(std::dynamic_pointer_cast<const T>(data));
+      }
+    }
+    return result;
+  }
+
+  void clear() { events_.clear(); }
+
+  std::exception_ptr error() const { return error_; }
+
+ private:
+  engine::EnginePtr engine_;
+  std::vector<engine::EventType> watch_;
+  Scenario scenario_;
+  std::map<engine::EventType, std::vector<std::shared_ptr<const engine::BaseData>>> events_;
+  std::exception_ptr error_;
+};
+
+/**
+ * @brief 运行引擎直到探针的场景结束，最长 timeout_ms
+ * @return bool 场景是否在超时前结束
+ */
+inline bool run_engine(asio::io_context& ctx, engine::EnginePtr engine, int64_t timeout_ms = 5000) {
+  asio::co_spawn(ctx, engine->run(), asio::detached);
+  ctx.run_for(std::chrono::milliseconds(timeout_ms));
+  return ctx.stopped();
+}
+
+}  // namespace testing_support
+
+#endif  // __TESTS_ENGINE_PROBE_HPP__
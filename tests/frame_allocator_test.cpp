@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "engine_probe.hpp"
+#include "utils/frame_allocator.h"
+#include "utils/metrics.h"
+
+using Common::FramePool;
+using engine::EventType;
+using testing_support::Probe;
+
+namespace {
+
+uint64_t heap_allocs() {
+  return metrics_registry
+      .counter("qitrader_frame_pool_heap_allocs_total", "Frame pool allocations served by the heap")
+      .value();
+}
+
+/// 线程退出时在 FreeLists 之后析构，释放它持有的块并再分配一次
+struct LateFree {
+  void* block = nullptr;
+  size_t size = 0;
+
+  ~LateFree() {
+    if (block) {
+      FramePool::deallocate(block, size);
+      FramePool::deallocate(FramePool::allocate(size), size);
+    }
+  }
+};
+
+}  // namespace
+
+TEST(FramePoolTest, FreedBlocksAreReused) {
+  constexpr size_t kSizes[] = {40, 150, 1000};
+  void* blocks[std::size(kSizes)];
+  for (size_t i = 0; i < std::size(kSizes); ++i) {
+    blocks[i] = FramePool::allocate(kSizes[i]);
+  }
+  for (size_t i = 0; i < std::size(kSizes); ++i) {
+    FramePool::deallocate(blocks[i], kSizes[i]);
+  }
+
+  // 同级别的请求全部由空闲链表满足
+  auto before = heap_allocs();
+  for (int round = 0; round < 1000; ++round) {
+    for (size_t i = 0; i < std::size(kSizes); ++i) {
+      blocks[i] = FramePool::allocate(kSizes[i]);
+    }
+    for (size_t i = 0; i < std::size(kSizes); ++i) {
+      FramePool::deallocate(blocks[i], kSizes[i]);
+    }
+  }
+  EXPECT_EQ(heap_allocs(), before);
+}
+
+TEST(FramePoolTest, OversizedGoesToHeap) {
+  auto before = heap_allocs();
+  auto p = FramePool::allocate(FramePool::kGranularity * FramePool::kClasses + 1);
+  FramePool::deallocate(p, FramePool::kGranularity * FramePool::kClasses + 1);
+  EXPECT_EQ(heap_allocs(), before + 1);
+}
+
+// 线程本地对象析构顺序与构造相反：先构造的 LateFree 在 FreeLists 之后析构，
+// 此时的分配和释放直接使用全局堆，块不能挂到已析构的空闲链表上（LSan 下会报告泄漏）
+TEST(FramePoolTest, FreeAfterThreadListsDestroyed) {
+  std::thread([] {
+    thread_local LateFree late;
+    late.size = 100;
+    late.block = FramePool::allocate(late.size);
+    auto cached = FramePool::allocate(100);
+    FramePool::deallocate(cached, 100);
+  }).join();
+  SUCCEED();
+}
+
+// 稳态下分发事件不再从全局堆分配 Event 和回调协程的完成处理器
+TEST(FramePoolTest, EngineDispatchIsHeapFreeAfterWarmup) {
+  constexpr int kEvents = 2000;
+  asio::io_context ctx;
+  auto engine = std::make_shared<engine::Engine>(ctx);
+  uint64_t warm = 0;
+  uint64_t steady = 0;
+  auto probe = std::make_shared<Probe>(engine, std::vector{EventType::kMessage},
+                                       [&](Probe& probe) -> asio::awaitable<void> {
+    auto data = std::make_shared<engine::MessageData>("ping");
+    for (int i = 0; i < kEvents; ++i) {
+      co_await probe.emit(EventType::kMessage, data);
+    }
+    co_await probe.sleep(50);
+    warm = heap_allocs();
+
+    for (int i = 0; i < kEvents; ++i) {
+      co_await probe.emit(EventType::kMessage, data);
+    }
+    co_await probe.sleep(50);
+    steady = heap_allocs();
+  });
+  engine->register_component(probe);
+  ASSERT_TRUE(testing_support::run_engine(ctx, engine));
+  if (probe->error()) {
+    std::rethrow_exception(probe->error());
+  }
+
+  EXPECT_EQ(probe->events<engine::MessageData>(EventType::kMessage).size(), size_t(kEvents * 2));
+  EXPECT_GT(warm, 0u);
+  EXPECT_EQ(steady, warm);
+}
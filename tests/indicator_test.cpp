@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "indicator/indicator.hpp"
+
+using namespace Common::indicator;
+
+namespace {
+
+std::vector<double> series(size_t n) {
+  std::vector<double> v(n);
+  for (size_t i = 0; i < n; ++i) {
+    v[i] = 100.0 + std::sin(i * 0.1) * 5 + (i % 7) * 0.3;
+  }
+  return v;
+}
+
+}  // namespace
+
+TEST(IndicatorTest, EmaMatchesBatch) {
+  auto in = series(500);
+  std::vector<double> out(in.size());
+  batch::ema(in.data(), out.data(), in.size(), 20);
+
+  Ema ema(20);
+  for (size_t i = 0; i < in.size(); ++i) {
+    EXPECT_DOUBLE_EQ(ema.update(in[i]), out[i]);
+  }
+}
+
+TEST(IndicatorTest, SmaMatchesBatch) {
+  auto in = series(500);
+  std::vector<double> out(in.size());
+  batch::sma(in.data(), out.data(), in.size(), 30);
+
+  Sma sma(30);
+  for (size_t i = 0; i < in.size(); ++i) {
+    EXPECT_NEAR(sma.update(in[i]), out[i], 1e-9);
+  }
+}
+
+TEST(IndicatorTest, ZScoreMatchesBatch) {
+  auto in = series(500);
+  std::vector<double> out(in.size());
+  batch::zscore(in.data(), out.data(), in.size(), 50);
+
+  ZScore z(50);
+  for (size_t i = 0; i < in.size(); ++i) {
+    EXPECT_NEAR(z.update(in[i]), out[i], 1e-6);
+  }
+}
+
+TEST(IndicatorTest, RollingVwap) {
+  Vwap vwap(2);
+  vwap.update(100.0, 1.0);
+  vwap.update(110.0, 1.0);
+  EXPECT_DOUBLE_EQ(vwap.update(120.0, 3.0), (110.0 + 360.0) / 4.0);
+}
+
+TEST(IndicatorTest, BookImbalance) {
+  EXPECT_DOUBLE_EQ(book_imbalance(3.0, 1.0), 0.5);
+  EXPECT_DOUBLE_EQ(book_imbalance(0.0, 0.0), 0.0);
+  EXPECT_DOUBLE_EQ(microprice(100.0, 1.0, 102.0, 3.0), (100.0 * 3 + 102.0 * 1) / 4);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include "engine_probe.hpp"
+#include "order/order_manager.h"
+
+using engine::EventType;
+using engine::OrderStatus;
+using service::order::OrderManager;
+using testing_support::Probe;
+
+namespace {
+
+std::shared_ptr<engine::OrderData> send_order(const std::string& client_order_id) {
+  auto order = std::make_shared<engine::OrderData>();
+  auto item = std::make_shared<engine::OrderDataItem>();
+  item->symbol = "BTC-USDT-SWAP";
+  item->exchange = "okx";
+  item->client_order_id = client_order_id;
+  item->direction = engine::Direction::BUY;
+  item->price = 100;
+  item->volume = 1;
+  order->items.push_back(item);
+  return order;
+}
+
+std::shared_ptr<engine::OrderData> report(const std::string& client_order_id, OrderStatus status, int64_t ts,
+                                          int filled = 0) {
+  auto order = std::make_shared<engine::OrderData>();
+  order->exchange = "okx";
+  auto item = std::make_shared<engine::OrderDataItem>();
+  item->symbol = "BTC-USDT-SWAP";
+  item->exchange = "okx";
+  item->client_order_id = client_order_id;
+  item->order_id = "ex-" + client_order_id;
+  item->direction = engine::Direction::BUY;
+  item->status = status;
+  item->timestamp_ms = ts;
+  item->volume = 1;
+  item->filled_volume = filled;
+  item->avg_price = filled > 0 ? 100 : 0;
+  order->items.push_back(item);
+  return order;
+}
+
+// 场景在协程中执行，只能使用 EXPECT_*，ASSERT_* 含有 return
+class OrderManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto pt = std::make_shared<Config::ptree>();
+    pt->put("order.ack_timeout_ms", 50);
+    order_config->load(pt);
+  }
+
+  void run(Probe::Scenario scenario) {
+    engine_ = std::make_shared<engine::Engine>(ctx_);
+    manager_ = std::make_shared<OrderManager>(engine_);
+    probe_ = std::make_shared<Probe>(engine_, std::vector{EventType::kSubmitOrder, EventType::kQueryOrder},
+                                     std::move(scenario));
+    engine_->register_component(manager_);
+    engine_->register_component(probe_);
+    ASSERT_TRUE(testing_support::run_engine(ctx_, engine_));
+    if (probe_->error()) {
+      std::rethrow_exception(probe_->error());
+    }
+  }
+
+  asio::io_context ctx_;
+  engine::EnginePtr engine_;
+  std::shared_ptr<OrderManager> manager_;
+  std::shared_ptr<Probe> probe_;
+};
+
+}  // namespace
+
+TEST_F(OrderManagerTest, AckTimeoutQueriesByClientOrderId) {
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    co_await probe.emit(EventType::kSendOrder, send_order("c1"));
+    co_await probe.sleep(120);
+
+    // 超时后只查询这一笔，而不是全部挂单
+    auto queries = probe.events<engine::QueryOrderData>(EventType::kQueryOrder);
+    EXPECT_EQ(queries.size(), 1u);
+    if (!queries.empty()) {
+      EXPECT_EQ(queries[0]->client_order_id, "c1");
+      EXPECT_EQ(queries[0]->symbol, "BTC-USDT-SWAP");
+      EXPECT_EQ(queries[0]->exchange, "okx");
+    }
+
+    // 交易所回报该订单已成交，订单结束
+    co_await probe.emit(EventType::kOrder, report("c1", OrderStatus::FILLED, 1000, 1));
+    co_await probe.sleep(10);
+    EXPECT_EQ(manager_->open_count(), 0u);
+  });
+}
+
+TEST_F(OrderManagerTest, SnapshotQueriesAbsentAckedOrders) {
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    co_await probe.emit(EventType::kSendOrder, send_order("c1"));
+    co_await probe.emit(EventType::kSendOrder, send_order("c2"));
+    co_await probe.sleep(5);
+    co_await probe.emit(EventType::kOrder, report("c1", OrderStatus::PENDING, 1000));
+    co_await probe.sleep(5);
+
+    // 快照中没有已确认的 c1；c2 仍在等待确认，交给确认超时处理
+    auto snapshot = std::make_shared<engine::OrderData>();
+    snapshot->exchange = "okx";
+    snapshot->snapshot = true;
+    co_await probe.emit(EventType::kOrder, snapshot);
+    co_await probe.sleep(10);
+
+    auto queries = probe.events<engine::QueryOrderData>(EventType::kQueryOrder);
+    EXPECT_EQ(queries.size(), 1u);
+    if (!queries.empty()) {
+      EXPECT_EQ(queries[0]->client_order_id, "c1");
+    }
+
+    co_await probe.emit(EventType::kOrder, report("c1", OrderStatus::CANCELLED, 2000));
+    co_await probe.emit(EventType::kOrder, report("c2", OrderStatus::PENDING, 2000));
+    co_await probe.sleep(10);
+    EXPECT_EQ(manager_->open_count(), 1u);
+    EXPECT_NE(manager_->find("c2"), nullptr);
+  });
+}
+
+TEST_F(OrderManagerTest, SnapshotKeepsListedOrders) {
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    co_await probe.emit(EventType::kSendOrder, send_order("c1"));
+    co_await probe.sleep(5);
+    co_await probe.emit(EventType::kOrder, report("c1", OrderStatus::PENDING, 1000));
+    co_await probe.sleep(5);
+
+    auto snapshot = report("c1", OrderStatus::PENDING, 1500);
+    snapshot->snapshot = true;
+    co_await probe.emit(EventType::kOrder, snapshot);
+    co_await probe.sleep(10);
+
+    EXPECT_TRUE(probe.events<engine::QueryOrderData>(EventType::kQueryOrder).empty());
+    EXPECT_EQ(manager_->open_count(), 1u);
+  });
+}
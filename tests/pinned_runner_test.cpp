@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <mutex>
+
+#include "base/pinned_runner.h"
+#include "base/strategy.h"
+#include "engine_probe.hpp"
+
+using engine::EventType;
+using strategy::base::PinnedRunner;
+using testing_support::Probe;
+
+namespace {
+
+/// 记录收到的订单簿时间戳，在策略线程上调用
+class RecordingStrategy : public strategy::base::Strategy {
+ public:
+  using Strategy::Strategy;
+
+  asio::awaitable<void> run() override { co_return; }
+  asio::awaitable<void> recv_account(engine::AccountDataPtr account) override { co_return; }
+  asio::awaitable<void> recv_position(engine::PositionDataPtr position) override { co_return; }
+  asio::awaitable<void> recv_tick(engine::TickDataPtr tick) override { co_return; }
+  asio::awaitable<void> recv_order(engine::OrderDataPtr order) override { co_return; }
+
+  asio::awaitable<void> recv_book(engine::BookPtr book) override {
+    std::lock_guard lock(mutex_);
+    received_.push_back(book->timestamp_ms);
+    co_return;
+  }
+
+  std::vector<int64_t> received() {
+    std::lock_guard lock(mutex_);
+    return received_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<int64_t> received_;
+};
+
+}  // namespace
+
+TEST(PinnedRunnerTest, DeliversInOrderWhenQueueIsFull) {
+  constexpr int64_t kEvents = 200;
+  asio::io_context ctx;
+  auto engine = std::make_shared<engine::Engine>(ctx);
+  auto strategy = std::make_shared<RecordingStrategy>(engine);
+  // 队列远小于事件数，大部分事件经过积压缓冲
+  auto runner = std::make_shared<PinnedRunner>(engine, strategy, -1, 4);
+  auto probe = std::make_shared<Probe>(engine, std::vector<EventType>{}, [&](Probe& probe) -> asio::awaitable<void> {
+    for (int64_t i = 0; i < kEvents; ++i) {
+      auto book = std::make_shared<engine::Book>();
+      book->symbol = "BTC-USDT-SWAP";
+      book->timestamp_ms = i;
+      co_await probe.emit(EventType::kBook, book);
+    }
+    for (int i = 0; i < 100 && strategy->received().size() < size_t(kEvents); ++i) {
+      co_await probe.sleep(10);
+    }
+  });
+  engine->register_component(runner);
+  engine->register_component(probe);
+  ASSERT_TRUE(testing_support::run_engine(ctx, engine));
+  if (probe->error()) {
+    std::rethrow_exception(probe->error());
+  }
+
+  auto received = strategy->received();
+  ASSERT_EQ(received.size(), size_t(kEvents));
+  for (int64_t i = 0; i < kEvents; ++i) {
+    EXPECT_EQ(received[i], i);
+  }
+}
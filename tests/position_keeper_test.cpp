@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include "engine_probe.hpp"
+#include "position/position_keeper.h"
+
+using Common::Fixed;
+using engine::EventType;
+using service::position::PositionKeeper;
+using testing_support::Probe;
+
+namespace {
+
+engine::PositionItemPtr leg(const std::string& symbol, engine::Direction direction, const char* volume,
+                            const char* price) {
+  auto item = std::make_shared<engine::PositionItem>();
+  item->symbol = symbol;
+  item->direction = direction;
+  item->volume = dec_float(volume);
+  item->price = dec_float(price);
+  return item;
+}
+
+std::shared_ptr<engine::PositionData> positions(bool snapshot, std::vector<engine::PositionItemPtr> items) {
+  auto data = std::make_shared<engine::PositionData>();
+  data->exchange = "okx";
+  data->snapshot = snapshot;
+  data->items = std::move(items);
+  return data;
+}
+
+// 场景在协程中执行，只能使用 EXPECT_*，ASSERT_* 含有 return
+class PositionKeeperTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto pt = std::make_shared<Config::ptree>();
+    pt->put("position.enable", true);
+    position_config->load(pt);
+  }
+
+  void run(Probe::Scenario scenario) {
+    engine_ = std::make_shared<engine::Engine>(ctx_);
+    keeper_ = std::make_shared<PositionKeeper>(engine_);
+    probe_ = std::make_shared<Probe>(engine_, std::vector{EventType::kMessage}, std::move(scenario));
+    engine_->register_component(keeper_);
+    engine_->register_component(probe_);
+    ASSERT_TRUE(testing_support::run_engine(ctx_, engine_));
+    if (probe_->error()) {
+      std::rethrow_exception(probe_->error());
+    }
+  }
+
+  Fixed net(const std::string& symbol) const {
+    auto state = keeper_->position(symbol);
+    return state ? state->net : Fixed();
+  }
+
+  asio::io_context ctx_;
+  engine::EnginePtr engine_;
+  std::shared_ptr<PositionKeeper> keeper_;
+  std::shared_ptr<Probe> probe_;
+};
+
+}  // namespace
+
+TEST_F(PositionKeeperTest, HedgeLegsUseSignedCost) {
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    auto hedge = positions(true, {leg("BTC-USDT-SWAP", engine::Direction::BUY, "2", "100"),
+                                  leg("BTC-USDT-SWAP", engine::Direction::SELL, "1", "110")});
+    co_await probe.emit(EventType::kPosition, hedge);
+    co_await probe.sleep(10);
+
+    auto state = keeper_->position("BTC-USDT-SWAP");
+    EXPECT_NE(state, nullptr);
+    if (state) {
+      EXPECT_EQ(state->net, Fixed::from_int(1));
+      EXPECT_EQ(state->avg_cost, Fixed::from_int(90));
+    }
+  });
+}
+
+TEST_F(PositionKeeperTest, FullSnapshotZeroesAbsentSymbols) {
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    auto both = positions(true, {leg("BTC-USDT-SWAP", engine::Direction::BUY, "1", "100"),
+                                 leg("ETH-USDT-SWAP", engine::Direction::SELL, "3", "50")});
+    co_await probe.emit(EventType::kPosition, both);
+    co_await probe.sleep(10);
+    EXPECT_EQ(net("ETH-USDT-SWAP"), Fixed::from_int(-3));
+
+    // ETH 已在交易所平仓
+    auto btc_only = positions(true, {leg("BTC-USDT-SWAP", engine::Direction::BUY, "1", "100")});
+    co_await probe.emit(EventType::kPosition, btc_only);
+    co_await probe.sleep(10);
+    EXPECT_EQ(net("ETH-USDT-SWAP"), Fixed());
+    EXPECT_EQ(net("BTC-USDT-SWAP"), Fixed::from_int(1));
+    EXPECT_EQ(probe.events<engine::MessageData>(EventType::kMessage).size(), 1u);
+  });
+}
+
+TEST_F(PositionKeeperTest, PartialPushDoesNotOverride) {
+  run([this](Probe& probe) -> asio::awaitable<void> {
+    auto hedge = positions(true, {leg("BTC-USDT-SWAP", engine::Direction::BUY, "2", "100"),
+                                  leg("BTC-USDT-SWAP", engine::Direction::SELL, "1", "110")});
+    co_await probe.emit(EventType::kPosition, hedge);
+    co_await probe.sleep(10);
+
+    // 只推送了变化的空头腿，不能当作净持仓
+    auto short_leg = positions(false, {leg("BTC-USDT-SWAP", engine::Direction::SELL, "2", "110")});
+    co_await probe.emit(EventType::kPosition, short_leg);
+    co_await probe.sleep(10);
+    EXPECT_EQ(net("BTC-USDT-SWAP"), Fixed::from_int(1));
+    EXPECT_TRUE(probe.events<engine::MessageData>(EventType::kMessage).empty());
+  });
+}
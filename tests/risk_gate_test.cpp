@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include "risk/risk_gate.h"
+
+using Common::Fixed;
+using engine::OrderType;
+using service::risk::RiskGate;
+using service::risk::RiskReason;
+
+namespace {
+
+std::shared_ptr<RiskGate> make_gate(int64_t price_band_bps, const std::string& max_notional) {
+  auto pt = std::make_shared<Config::ptree>();
+  pt->put("risk.enable", true);
+  pt->put("risk.max_order_volume", "10");
+  pt->put("risk.max_order_notional", max_notional);
+  pt->put("risk.price_band_bps", price_band_bps);
+  pt->put("risk.symbol_limits", "BTC-USDT-SWAP:1:100000");
+  risk_config->load(pt);
+  return std::make_shared<RiskGate>(nullptr);
+}
+
+}  // namespace
+
+TEST(RiskGateTest, NoReferenceFailsClosed) {
+  auto gate = make_gate(200, "100000");
+  // 市价单无法估算金额，限价单无法判断偏离
+  EXPECT_EQ(gate->check("ETH-USDT-SWAP", OrderType::MARKET, Fixed::from_int(1), Fixed(), 0, 0),
+            RiskReason::kNoReference);
+  EXPECT_EQ(gate->check("ETH-USDT-SWAP", OrderType::LIMIT, Fixed::from_int(1), Fixed::from_int(3000), 0, 0),
+            RiskReason::kNoReference);
+
+  gate->set_reference("ETH-USDT-SWAP", Fixed::from_int(3000));
+  EXPECT_EQ(gate->check("ETH-USDT-SWAP", OrderType::MARKET, Fixed::from_int(1), Fixed(), 0, 0), RiskReason::kPass);
+  EXPECT_EQ(gate->check("ETH-USDT-SWAP", OrderType::LIMIT, Fixed::from_int(1), Fixed::from_int(3000), 0, 0),
+            RiskReason::kPass);
+}
+
+TEST(RiskGateTest, NoReferenceNeededWithoutReferenceChecks) {
+  auto gate = make_gate(0, "0");
+  EXPECT_EQ(gate->check("ETH-USDT-SWAP", OrderType::MARKET, Fixed::from_int(1), Fixed(), 0, 0), RiskReason::kPass);
+  EXPECT_EQ(gate->check("ETH-USDT-SWAP", OrderType::LIMIT, Fixed::from_int(1), Fixed::from_int(3000), 0, 0),
+            RiskReason::kPass);
+}
+
+TEST(RiskGateTest, Limits) {
+  auto gate = make_gate(200, "100000");
+  gate->set_reference("BTC-USDT-SWAP", Fixed::from_int(60000));
+
+  // 交易对限额：最大数量1，最大名义金额100000
+  EXPECT_EQ(gate->check("BTC-USDT-SWAP", OrderType::LIMIT, Fixed::from_int(2), Fixed::from_int(60000), 0, 0),
+            RiskReason::kVolume);
+  EXPECT_EQ(gate->check("BTC-USDT-SWAP", OrderType::MARKET, Fixed::from_double(0.5), Fixed(), 0, 0),
+            RiskReason::kPass);
+  EXPECT_EQ(gate->check("BTC-USDT-SWAP", OrderType::LIMIT, Fixed::from_double(0.5), Fixed::from_int(62000), 0, 0),
+            RiskReason::kPriceBand);
+  EXPECT_EQ(gate->check("BTC-USDT-SWAP", OrderType::LIMIT, Fixed(), Fixed::from_int(60000), 0, 0),
+            RiskReason::kInvalid);
+}
+
+TEST(RiskGateTest, OrderItemConvertsOnce) {
+  auto gate = make_gate(200, "100000");
+  gate->set_reference("BTC-USDT-SWAP", Fixed::from_int(60000));
+
+  engine::OrderDataItem item;
+  item.symbol = "BTC-USDT-SWAP";
+  item.otype = OrderType::LIMIT;
+  item.volume = dec_float("0.1");
+  item.price = dec_float("60100");
+  EXPECT_EQ(gate->check(item, 0, 0), RiskReason::kPass);
+  item.volume = dec_float("1.5");
+  EXPECT_EQ(gate->check(item, 0, 0), RiskReason::kVolume);
+}
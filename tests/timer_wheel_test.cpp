@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "timer_wheel.h"
+
+using engine::TimerWheel;
+
+TEST(TimerWheelTest, NextDeadlineEmpty) {
+  TimerWheel wheel(1000);
+  EXPECT_EQ(wheel.next_deadline(), std::numeric_limits<int64_t>::max());
+}
+
+TEST(TimerWheelTest, NextDeadlineAcrossLevels) {
+  TimerWheel wheel(1000);
+  // 分别落在第0、1、2层和溢出列表
+  auto far = wheel.schedule(int64_t(1) << 30, [] {});
+  auto l2 = wheel.schedule(10000, [] {});
+  auto l1 = wheel.schedule(300, [] {});
+  EXPECT_EQ(wheel.next_deadline(), 1300);
+  auto l0 = wheel.schedule(5, [] {});
+  EXPECT_EQ(wheel.next_deadline(), 1005);
+
+  wheel.cancel(l0);
+  EXPECT_EQ(wheel.next_deadline(), 1300);
+  wheel.cancel(l1);
+  EXPECT_EQ(wheel.next_deadline(), 11000);
+  wheel.cancel(l2);
+  EXPECT_EQ(wheel.next_deadline(), 1000 + (int64_t(1) << 30));
+  wheel.cancel(far);
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, NextDeadlineMatchesFiring) {
+  TimerWheel wheel(0);
+  std::vector<int64_t> fired;
+  for (int64_t delay : {7, 64, 65, 130, 4095, 4096, 5000, 300000}) {
+    wheel.schedule(delay, [&fired, &wheel] { fired.push_back(wheel.now()); });
+  }
+
+  // 每次直接跳到 next_deadline，触发时间应与到期时间一致
+  while (!wheel.empty()) {
+    auto deadline = wheel.next_deadline();
+    ASSERT_EQ(wheel.advance(deadline - 1), 0u);
+    ASSERT_GT(wheel.advance(deadline), 0u);
+    EXPECT_EQ(fired.back(), deadline);
+  }
+  EXPECT_EQ(fired, (std::vector<int64_t>{7, 64, 65, 130, 4095, 4096, 5000, 300000}));
+}
+
+TEST(TimerWheelTest, RescheduleMovesDeadline) {
+  TimerWheel wheel(0);
+  auto id = wheel.schedule(1000, [] {});
+  EXPECT_EQ(wheel.next_deadline(), 1000);
+  wheel.advance(200);
+  EXPECT_TRUE(wheel.reschedule(id, 10));
+  EXPECT_EQ(wheel.next_deadline(), 210);
+}
+
+// 与 Engine::schedule_timer 相同，回调中先对齐时间再添加定时器，advance 被重入
+TEST(TimerWheelTest, RescheduleFromCallback) {
+  TimerWheel wheel(0);
+  std::vector<std::string> fired;
+  std::function<void(std::string)> arm = [&](std::string name) {
+    wheel.schedule(10, [&, name] {
+      wheel.advance(wheel.now());
+      if (fired.size() < 6) {
+        arm(name);
+      }
+      // 重入之后回调自身的捕获仍然有效
+      fired.push_back(name);
+    });
+  };
+  arm("interval-a");
+  arm("interval-b");
+
+  for (int64_t now = 10; now <= 100; now += 10) {
+    wheel.advance(now);
+  }
+  EXPECT_EQ(fired.size(), 8u);
+  EXPECT_EQ(std::count(fired.begin(), fired.end(), "interval-a"), 4);
+  EXPECT_EQ(std::count(fired.begin(), fired.end(), "interval-b"), 4);
+  EXPECT_TRUE(wheel.empty());
+}
@@ -2,24 +2,68 @@ add_repositories("qitrader-repo git@github.com:qitrader/repo.git")
 
 add_requires("fmt", "openssl", "cryptopp", "glog", "liburing", "jsoncpp", "httpcpp")
 add_requires("boost[hash2,asio,beast,url,json,system,program_options,multiprecision,pfr,math,chrono,filesystem,serialization,thread]")
+add_requires("gtest", "benchmark")
 add_rules("plugin.compile_commands.autoupdate", {outputdir = "build/"})
 set_languages("c++23")
 
 add_rules("mode.debug")
 
-target("qitrader")
-    set_kind("binary")
-    add_includedirs("market/", "common/", "engine/", "strategy/", "notice/")
+-- 开启后 asio 以 io_uring 代替 epoll 作为默认后端，套接字读写也经 io_uring 提交
+option("io_uring")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Use io_uring instead of epoll as the asio backend")
+option_end()
 
+-- 所有目标共用的编译设置
+add_includedirs("market/", "common/", "engine/", "strategy/", "notice/", "service/")
+add_packages("httpcpp", "fmt", "openssl", "glog","cryptopp", "liburing", "jsoncpp")
+add_packages("boost")
+add_defines("BOOST_ASIO_HAS_IO_URING", "BOOST_ASIO_HAS_FILE")
+-- asio 协程帧的线程本地回收缓存，默认只保留2块，回调嵌套较深时大部分帧仍走全局堆
+add_defines("BOOST_ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE=16")
+if has_config("io_uring") then
+    add_defines("BOOST_ASIO_DISABLE_EPOLL")
+end
+set_toolset("cxx", "clang")
+set_toolset("ld", "clang++")
+
+-- 除入口外的全部代码，主程序、单元测试和基准测试共用
+target("qitrader_core")
+    set_kind("static")
     add_files("market/**/*.cpp")
     add_files("common/**/*.cpp")
     add_files("notice/**/*.cpp")
-    add_files("*.cpp")
     add_files("engine/*.cpp")
     add_files("strategy/**/*.cpp")
-    
-    add_packages("httpcpp", "fmt", "openssl", "glog","cryptopp", "liburing", "jsoncpp")
-    add_packages("boost")
-    add_defines("BOOST_ASIO_HAS_IO_URING", "BOOST_ASIO_HAS_FILE")
-    set_toolset("cxx", "clang")
-    set_toolset("ld", "clang++")
+    add_files("service/**/*.cpp")
+
+target("qitrader")
+    set_kind("binary")
+    add_deps("qitrader_core")
+    add_files("main.cpp")
+
+-- 单元测试：tests/*_test.cpp 各自编译为一个目标，xmake test 运行
+for _, file in ipairs(os.files("tests/*_test.cpp")) do
+    target(path.basename(file))
+        set_kind("binary")
+        set_default(false)
+        set_group("tests")
+        add_deps("qitrader_core")
+        add_files(file)
+        add_packages("gtest")
+        add_links("gtest_main")
+        add_tests("default")
+end
+
+-- 基准测试：bench/*_bench.cpp 各自编译为一个目标，xmake run <名称> 运行
+for _, file in ipairs(os.files("bench/*_bench.cpp")) do
+    target(path.basename(file))
+        set_kind("binary")
+        set_default(false)
+        set_group("bench")
+        add_deps("qitrader_core")
+        add_files(file)
+        add_packages("benchmark")
+        add_links("benchmark_main")
+end